@@ -38,6 +38,8 @@ SUBDIRS += math grab
 src.depends = math grab
 
 win32:SUBDIRS += libraryinjector hooks unhook tests
+unix:SUBDIRS += simulator
+simulator.subdir = tests/simulator
 contains(QMAKE_TARGET.arch, x86_64) {
     SUBDIRS += offsetfinder hooks32 unhook32
     hooks32.file = hooks/hooks32.pro
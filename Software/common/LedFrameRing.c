@@ -0,0 +1,222 @@
+/*
+ * LedFrameRing.c
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/* shm_open() and syscall() with a strict -std */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#include "LedFrameRing.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+/* a writer lapping the reader this often in a row publishes faster than anyone can read */
+#define MAX_RETRIES 16
+#define MAX_NAME 256
+
+static uint64_t load_acquire(const uint64_t *value)
+{
+	return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+int led_frame_ring_open(LedFrameRing *ring, const char *name)
+{
+	char path[MAX_NAME];
+	struct stat info;
+	const LedFrameRingHeader *header;
+	void *memory;
+	int fd;
+
+	ring->header = NULL;
+	ring->size = 0;
+
+	if (snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name) >= (int)sizeof(path)) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	fd = shm_open(path, O_RDONLY, 0);
+	if (fd < 0)
+		return -1;
+
+	if (fstat(fd, &info) < 0) {
+		close(fd);
+		return -1;
+	}
+	if ((size_t)info.st_size < LED_FRAME_RING_HEADER_SIZE) {
+		close(fd);
+		errno = EINVAL;
+		return -1;
+	}
+
+	memory = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (memory == MAP_FAILED)
+		return -1;
+
+	/* the writer stores the magic last, a ring that is still being created is refused */
+	header = (const LedFrameRingHeader *)memory;
+	if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != LED_FRAME_RING_MAGIC
+			|| header->version != LED_FRAME_RING_VERSION
+			|| header->slotCount == 0
+			|| header->slotSize < led_frame_ring_slot_size(header->maxLeds)
+			|| led_frame_ring_size(header->slotCount, header->slotSize) > (size_t)info.st_size) {
+		munmap(memory, (size_t)info.st_size);
+		errno = EINVAL;
+		return -1;
+	}
+
+	ring->header = header;
+	ring->size = (size_t)info.st_size;
+	return 0;
+}
+
+void led_frame_ring_close(LedFrameRing *ring)
+{
+	if (ring->header)
+		munmap((void *)ring->header, ring->size);
+	ring->header = NULL;
+	ring->size = 0;
+}
+
+const LedFrameRingSlot * led_frame_ring_latest(const LedFrameRing *ring, uint64_t *sequence)
+{
+	int i;
+	for (i = 0; i < MAX_RETRIES; ++i) {
+		const uint64_t latest = load_acquire(&ring->header->sequence);
+		const LedFrameRingSlot *slot;
+
+		if (latest == 0)
+			return NULL;
+
+		slot = led_frame_ring_slot(ring->header, latest);
+		if (load_acquire(&slot->sequence) == latest) {
+			*sequence = latest;
+			return slot;
+		}
+	}
+	return NULL;
+}
+
+int led_frame_ring_is_valid(const LedFrameRingSlot *slot, uint64_t sequence)
+{
+	/* orders the reads of the slot before the check */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == sequence;
+}
+
+int led_frame_ring_read(const LedFrameRing *ring, uint8_t *rgb, int maxLeds, uint64_t *sequence, uint64_t *timestampUs)
+{
+	int i;
+
+	if (__atomic_load_n(&ring->header->isClosed, __ATOMIC_ACQUIRE))
+		return LED_FRAME_RING_CLOSED;
+
+	for (i = 0; i < MAX_RETRIES; ++i) {
+		uint64_t latest, timestamp;
+		uint32_t count;
+		const LedFrameRingSlot *slot = led_frame_ring_latest(ring, &latest);
+
+		if (slot == NULL)
+			return 0;
+
+		timestamp = slot->timestampUs;
+		count = slot->ledsCount;
+		if (count > ring->header->maxLeds)
+			count = ring->header->maxLeds;
+		if (maxLeds >= 0 && count > (uint32_t)maxLeds)
+			count = (uint32_t)maxLeds;
+		memcpy(rgb, led_frame_ring_rgb(slot), (size_t)count * 3);
+
+		if (led_frame_ring_is_valid(slot, latest)) {
+			if (sequence)
+				*sequence = latest;
+			if (timestampUs)
+				*timestampUs = timestamp;
+			return (int)count;
+		}
+	}
+	return 0;
+}
+
+uint64_t led_frame_ring_now_us(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
+
+int led_frame_ring_wait(const LedFrameRing *ring, uint64_t sequence, int timeoutMs)
+{
+	const LedFrameRingHeader *header = ring->header;
+	const uint64_t deadline = led_frame_ring_now_us() + (uint64_t)(timeoutMs < 0 ? 0 : timeoutMs) * 1000u;
+
+	for (;;) {
+		/* taken before the checks: a frame published after them changes the word and the wait returns at once */
+		const uint32_t word = __atomic_load_n(&header->futexWord, __ATOMIC_ACQUIRE);
+		uint64_t now, remaining;
+
+		if (__atomic_load_n(&header->isClosed, __ATOMIC_ACQUIRE))
+			return LED_FRAME_RING_CLOSED;
+		if (load_acquire(&header->sequence) > sequence)
+			return LED_FRAME_RING_OK;
+
+		now = led_frame_ring_now_us();
+		if (timeoutMs >= 0 && now >= deadline)
+			return LED_FRAME_RING_TIMEOUT;
+		remaining = timeoutMs >= 0 ? deadline - now : 0;
+
+#ifdef __linux__
+		{
+			struct timespec timeout;
+			timeout.tv_sec = (time_t)(remaining / 1000000u);
+			timeout.tv_nsec = (long)(remaining % 1000000u) * 1000;
+			/* not FUTEX_PRIVATE: the writer is another process */
+			syscall(SYS_futex, &header->futexWord, FUTEX_WAIT, word, timeoutMs >= 0 ? &timeout : NULL, NULL, 0);
+		}
+#else
+		{
+			/* no cross process wait on this system, poll */
+			struct timespec pause;
+			(void)word;
+			pause.tv_sec = 0;
+			pause.tv_nsec = 100000;
+			if (timeoutMs >= 0 && remaining < 100)
+				pause.tv_nsec = (long)remaining * 1000;
+			nanosleep(&pause, NULL);
+		}
+#endif
+	}
+}
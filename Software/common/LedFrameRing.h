@@ -0,0 +1,147 @@
+/*
+ * LedFrameRing.h
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/*
+	Shared memory ring the virtual LED device publishes its frames to, and a small
+	reader for other processes. Plain C so that any consumer can link it.
+
+	The POSIX shared memory object starts with a LedFrameRingHeader, the slots follow
+	at LED_FRAME_RING_HEADER_SIZE, slotSize bytes each. Frame n (counting from 1) is
+	stored in slot n % slotCount as a LedFrameRingSlot followed by ledsCount 8 bit RGB
+	triples. The writer clears the slot sequence, fills the slot, stores n into the
+	slot and then into the header. A reader takes the frame the header names and keeps
+	it if the slot still carries n after reading, otherwise the writer has lapped the
+	reader and it retries with a newer frame.
+
+	On Linux every frame also bumps futexWord and wakes its waiters, so readers can
+	block in led_frame_ring_wait() instead of polling.
+*/
+
+#ifndef LEDFRAMERING_H
+#define LEDFRAMERING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_FRAME_RING_MAGIC		0x3152464cu /* "LFR1" */
+#define LED_FRAME_RING_VERSION		1u
+#define LED_FRAME_RING_HEADER_SIZE	64u
+
+typedef struct LedFrameRingHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slotCount;
+	uint32_t slotSize;
+	uint32_t maxLeds;
+	/* set when the writer is gone, the name has to be opened again */
+	uint32_t isClosed;
+	/* changes with every frame and on close */
+	uint32_t futexWord;
+	uint32_t reserved0;
+	/* last published frame, 0 before the first one */
+	uint64_t sequence;
+	uint8_t reserved[24];
+} LedFrameRingHeader;
+
+typedef struct LedFrameRingSlot {
+	/* frame stored in the slot, 0 while the writer fills it */
+	uint64_t sequence;
+	/* CLOCK_MONOTONIC when the frame was published */
+	uint64_t timestampUs;
+	uint32_t ledsCount;
+	uint32_t reserved;
+	/* ledsCount RGB triples follow */
+} LedFrameRingSlot;
+
+/* slots are cache line aligned so that a reader never shares a line with the next slot */
+static inline uint32_t led_frame_ring_slot_size(uint32_t maxLeds)
+{
+	return ((uint32_t)sizeof(LedFrameRingSlot) + maxLeds * 3u + 63u) & ~63u;
+}
+
+static inline size_t led_frame_ring_size(uint32_t slotCount, uint32_t slotSize)
+{
+	return LED_FRAME_RING_HEADER_SIZE + (size_t)slotCount * slotSize;
+}
+
+static inline const LedFrameRingSlot * led_frame_ring_slot(const LedFrameRingHeader *header, uint64_t sequence)
+{
+	return (const LedFrameRingSlot *)((const uint8_t *)header + LED_FRAME_RING_HEADER_SIZE
+		+ (size_t)(sequence % header->slotCount) * header->slotSize);
+}
+
+static inline const uint8_t * led_frame_ring_rgb(const LedFrameRingSlot *slot)
+{
+	return (const uint8_t *)(slot + 1);
+}
+
+enum {
+	LED_FRAME_RING_OK = 0,
+	LED_FRAME_RING_TIMEOUT = 1,
+	LED_FRAME_RING_CLOSED = -1,
+	LED_FRAME_RING_ERROR = -2
+};
+
+typedef struct LedFrameRing {
+	const LedFrameRingHeader *header;
+	size_t size;
+} LedFrameRing;
+
+/* maps the ring read only, 0 on success, -1 with errno set otherwise */
+int led_frame_ring_open(LedFrameRing *ring, const char *name);
+void led_frame_ring_close(LedFrameRing *ring);
+
+/*
+	Zero copy access: the newest slot and its frame in *sequence, NULL before the first
+	frame. The slot may be overwritten while it is read, the data is only good if
+	led_frame_ring_is_valid() still says so afterwards.
+*/
+const LedFrameRingSlot * led_frame_ring_latest(const LedFrameRing *ring, uint64_t *sequence);
+int led_frame_ring_is_valid(const LedFrameRingSlot *slot, uint64_t sequence);
+
+/*
+	Copies the newest frame, up to maxLeds LEDs, into rgb.
+	Returns the number of LEDs copied, 0 before the first frame or LED_FRAME_RING_CLOSED.
+	sequence and timestampUs may be NULL.
+*/
+int led_frame_ring_read(const LedFrameRing *ring, uint8_t *rgb, int maxLeds, uint64_t *sequence, uint64_t *timestampUs);
+
+/*
+	Waits until a frame newer than sequence is published.
+	timeoutMs < 0 waits forever. Returns LED_FRAME_RING_OK, LED_FRAME_RING_TIMEOUT
+	or LED_FRAME_RING_CLOSED.
+*/
+int led_frame_ring_wait(const LedFrameRing *ring, uint64_t sequence, int timeoutMs);
+
+/* CLOCK_MONOTONIC in microseconds, the clock of LedFrameRingSlot::timestampUs */
+uint64_t led_frame_ring_now_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFRAMERING_H */
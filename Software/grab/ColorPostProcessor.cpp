@@ -0,0 +1,111 @@
+/*
+ * ColorPostProcessor.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <climits>
+#include <cmath>
+
+#include "ColorPostProcessor.hpp"
+#include "calculations.hpp"
+#include "GrabWidget.hpp"
+#include "PrismatikMath.hpp"
+
+namespace Grab {
+
+ColorPostProcessor::ColorPostProcessor()
+{
+	setColorTemperature(false, 0, 1.0);
+	setOverBrighten(0);
+}
+
+void ColorPostProcessor::setColorTemperature(bool isEnabled, int colorTemperature, double gamma)
+{
+	if (!isEnabled) {
+		for (int i = 0; i < 256; ++i)
+			m_temperatureLut[0][i] = m_temperatureLut[1][i] = m_temperatureLut[2][i] = i;
+		return;
+	}
+
+	// same curve as PrismatikMath::applyColorTemperature()
+	const StructRgb wp = PrismatikMath::whitePoint(colorTemperature);
+	const unsigned whitePoint[3] = { wp.r, wp.g, wp.b };
+	gamma = 1.0 / gamma; // encoding
+	for (int channel = 0; channel < 3; ++channel)
+		for (int i = 0; i < 256; ++i)
+			m_temperatureLut[channel][i] = ::pow((i * whitePoint[channel]) / (double)USHRT_MAX, gamma) * UCHAR_MAX;
+}
+
+void ColorPostProcessor::setOverBrighten(int overBrighten)
+{
+	m_overBrighten = overBrighten;
+
+	Calculations::buildScaleByMaxChannelLut((100 + 5 * overBrighten) / 100.0, m_overBrightenLut);
+}
+
+bool ColorPostProcessor::process(const QList<QRgb> &colors, const QList<GrabWidget *> &widgets, bool isAvgColors, QList<QRgb> &result)
+{
+	const int count = qMin(qMin(colors.size(), widgets.size()), result.size());
+
+	m_r.resize(count);
+	m_g.resize(count);
+	m_b.resize(count);
+	if (isAvgColors)
+		m_mask.resize(count);
+
+	uint32_t * const r = m_r.data();
+	uint32_t * const g = m_g.data();
+	uint32_t * const b = m_b.data();
+	uint32_t * const mask = m_mask.data();
+
+	for (int i = 0; i < count; ++i) {
+		const QRgb color = colors[i];
+		r[i] = m_temperatureLut[0][qRed(color)];
+		g[i] = m_temperatureLut[1][qGreen(color)];
+		b[i] = m_temperatureLut[2][qBlue(color)];
+		if (isAvgColors)
+			mask[i] = widgets[i]->isAreaEnabled() ? 0xffffffffU : 0;
+	}
+
+	if (isAvgColors) {
+		const QRgb avg = Calculations::calculateMaskedAvgColor(r, g, b, mask, count);
+		const uint32_t avgR = qRed(avg), avgG = qGreen(avg), avgB = qBlue(avg);
+		for (int i = 0; i < count; ++i) {
+			r[i] = (avgR & mask[i]) | (r[i] & ~mask[i]);
+			g[i] = (avgG & mask[i]) | (g[i] & ~mask[i]);
+			b[i] = (avgB & mask[i]) | (b[i] & ~mask[i]);
+		}
+	}
+
+	if (m_overBrighten)
+		Calculations::scaleByMaxChannel(r, g, b, count, m_overBrightenLut);
+
+	bool isColorsChanged = false;
+	for (int i = 0; i < count; ++i) {
+		const QRgb color = qRgb(r[i], g[i], b[i]);
+		if (result[i] != color) {
+			result[i] = color;
+			isColorsChanged = true;
+		}
+	}
+	return isColorsChanged;
+}
+
+}
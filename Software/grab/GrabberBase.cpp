@@ -27,6 +27,7 @@
 #include "GrabWidget.hpp"
 #include "GrabberBase.hpp"
 #include "src/debug.h"
+#include <QElapsedTimer>
 #include <cmath>
 
 namespace
@@ -118,6 +119,8 @@ bool GrabberBase::isReallocationNeeded(const QList< ScreenInfo > &screensWithWid
 void GrabberBase::grab()
 {
 	DEBUG_HIGH_LEVEL << Q_FUNC_INFO << this->metaObject()->className();
+	QElapsedTimer costTimer;
+	costTimer.start();
 	QList< ScreenInfo > screens2Grab;
 	screens2Grab.reserve(5);
 	screensWithWidgets(&screens2Grab, *_context->grabWidgets);
@@ -224,5 +227,6 @@ void GrabberBase::grab()
 		}
 
 	}
+	m_lastGrabCostNs = costTimer.nsecsElapsed();
 	emit frameGrabAttempted(_lastGrabResult);
 }
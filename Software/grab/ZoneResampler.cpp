@@ -0,0 +1,204 @@
+/*
+ * ZoneResampler.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QStringList>
+#include <cmath>
+
+#include "ZoneResampler.hpp"
+#include "calculations.hpp"
+#include "src/debug.h"
+
+namespace Grab {
+
+namespace {
+const int LinearTaps = 2;
+const int CubicTaps = 4;
+const int WeightOne = 1 << Calculations::ResampleWeightBits;
+}
+
+QList<ZoneResampler::Segment> ZoneResampler::parseSegments(const QString &segments)
+{
+	QList<Segment> result;
+	const QString trimmed = segments.trimmed();
+	if (trimmed.isEmpty())
+		return result;
+
+	for (const QString &item : trimmed.split(QLatin1Char(','))) {
+		const QStringList parts = item.trimmed().split(QLatin1Char(':'));
+		if (parts.size() != 2) {
+			qWarning() << Q_FUNC_INFO << "bad segment" << item;
+			return QList<Segment>();
+		}
+		Segment segment;
+		QString leds = parts[1].trimmed();
+		if (leds.endsWith(QLatin1Char('r'), Qt::CaseInsensitive)) {
+			segment.isReversed = true;
+			leds.chop(1);
+		}
+		bool isZonesOk = false, isLedsOk = false;
+		segment.zones = parts[0].trimmed().toInt(&isZonesOk);
+		segment.leds = leds.toInt(&isLedsOk);
+		if (!isZonesOk || !isLedsOk || segment.zones <= 0 || segment.leds <= 0) {
+			qWarning() << Q_FUNC_INFO << "bad segment" << item;
+			return QList<Segment>();
+		}
+		result.append(segment);
+	}
+	return result;
+}
+
+ZoneResampler::Interpolation ZoneResampler::parseInterpolation(const QString &interpolation)
+{
+	if (interpolation.compare(QLatin1String("Cubic"), Qt::CaseInsensitive) == 0)
+		return InterpolationCubic;
+	return InterpolationLinear;
+}
+
+ZoneResampler::ZoneResampler()
+{
+	clear();
+}
+
+void ZoneResampler::clear()
+{
+	m_zoneCount = 0;
+	m_ledCount = 0;
+	m_taps = 0;
+	m_indices.clear();
+	m_weights.clear();
+}
+
+void ZoneResampler::configure(const QList<Segment> &segments, Interpolation interpolation)
+{
+	clear();
+
+	int zoneCount = 0, ledCount = 0;
+	for (const Segment &segment : segments) {
+		zoneCount += segment.zones;
+		ledCount += segment.leds;
+	}
+	if (ledCount == 0)
+		return;
+
+	m_zoneCount = zoneCount;
+	m_ledCount = ledCount;
+	m_taps = interpolation == InterpolationCubic ? CubicTaps : LinearTaps;
+	m_indices.fill(0, m_taps * m_ledCount);
+	m_weights.fill(0, m_taps * m_ledCount);
+
+	int zoneFirst = 0, ledFirst = 0;
+	for (const Segment &segment : segments) {
+		const int zoneLast = zoneFirst + segment.zones - 1;
+		const double step = (double)segment.zones / segment.leds;
+		for (int j = 0; j < segment.leds; ++j) {
+			const int led = ledFirst + (segment.isReversed ? segment.leds - 1 - j : j);
+			// LED and zone centers are aligned
+			const double x = qBound(0.0, (j + 0.5) * step - 0.5, (double)(segment.zones - 1));
+			const int i0 = (int)x;
+			const double t = x - i0;
+			const int zone = zoneFirst + i0;
+
+			if (m_taps == LinearTaps) {
+				setTap(led, 0, zone, 1.0 - t);
+				setTap(led, 1, qMin(zone + 1, zoneLast), t);
+			} else {
+				// Catmull-Rom
+				const double t2 = t * t, t3 = t2 * t;
+				setTap(led, 0, qMax(zone - 1, zoneFirst), (-t3 + 2 * t2 - t) / 2);
+				setTap(led, 1, zone, (3 * t3 - 5 * t2 + 2) / 2);
+				setTap(led, 2, qMin(zone + 1, zoneLast), (-3 * t3 + 4 * t2 + t) / 2);
+				setTap(led, 3, qMin(zone + 2, zoneLast), (t3 - t2) / 2);
+			}
+
+			// make the fixed point weights add up to exactly one so flat colors stay flat
+			int sum = 0, largest = 0;
+			for (int tap = 0; tap < m_taps; ++tap) {
+				sum += m_weights[tap * m_ledCount + led];
+				if (m_weights[tap * m_ledCount + led] > m_weights[largest * m_ledCount + led])
+					largest = tap;
+			}
+			m_weights[largest * m_ledCount + led] += WeightOne - sum;
+		}
+		zoneFirst += segment.zones;
+		ledFirst += segment.leds;
+	}
+
+	for (int channel = 0; channel < 3; ++channel) {
+		m_zones[channel].resize(m_zoneCount);
+		m_leds[channel].resize(m_ledCount);
+	}
+
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_zoneCount << "zones ->" << m_ledCount << "LEDs," << m_taps << "taps";
+}
+
+void ZoneResampler::setTap(int led, int tap, int zone, double weight)
+{
+	m_indices[tap * m_ledCount + led] = zone;
+	m_weights[tap * m_ledCount + led] = (int32_t)std::lround(weight * WeightOne);
+}
+
+bool ZoneResampler::resample(const QList<QRgb> &zones, QList<QRgb> &leds)
+{
+	if (!isEnabled() || zones.size() < m_zoneCount)
+		return false;
+
+	int32_t * const r = m_zones[0].data();
+	int32_t * const g = m_zones[1].data();
+	int32_t * const b = m_zones[2].data();
+	for (int i = 0; i < m_zoneCount; ++i) {
+		const QRgb color = zones[i];
+		r[i] = qRed(color);
+		g[i] = qGreen(color);
+		b[i] = qBlue(color);
+	}
+
+	for (int channel = 0; channel < 3; ++channel)
+		Calculations::resample(m_zones[channel].constData(), m_indices.constData(), m_weights.constData(),
+			m_taps, m_ledCount, m_leds[channel].data());
+
+	if (leds.size() != m_ledCount) {
+		leds.clear();
+		leds.reserve(m_ledCount);
+		for (int i = 0; i < m_ledCount; ++i)
+			leds.append(0);
+	}
+	for (int i = 0; i < m_ledCount; ++i)
+		leds[i] = qRgb(m_leds[0][i], m_leds[1][i], m_leds[2][i]);
+	return true;
+}
+
+bool ZoneResampler::resample(const QVector<double> &zones, QVector<double> &leds) const
+{
+	if (!isEnabled() || zones.size() < m_zoneCount)
+		return false;
+
+	leds.fill(0.0, m_ledCount);
+	for (int tap = 0; tap < m_taps; ++tap) {
+		const int32_t * const indices = m_indices.constData() + tap * m_ledCount;
+		const int32_t * const weights = m_weights.constData() + tap * m_ledCount;
+		for (int i = 0; i < m_ledCount; ++i)
+			leds[i] += zones[indices[i]] * weights[i] / WeightOne;
+	}
+	return true;
+}
+
+}
@@ -25,6 +25,7 @@
 
 #include "calculations.hpp"
 #include <stdint.h>
+#include <cmath>
 #ifdef __SSE4_1__
 #include <immintrin.h>
 #endif // ifdef __SSE4_1__
@@ -89,6 +90,69 @@ auto accumulateABGR = accumulateBuffer<PIXEL_FORMAT_ABGR>;
 auto accumulateRGBA = accumulateBuffer<PIXEL_FORMAT_RGBA>;
 auto accumulateBGRA = accumulateBuffer<PIXEL_FORMAT_BGRA>;
 
+	// planar (one array per channel) post-processing kernels
+
+	static void scaleByMaxChannelPlanar(
+		uint32_t * const r, uint32_t * const g, uint32_t * const b,
+		const size_t count,
+		const uint32_t * const scaleLut) {
+		for (size_t i = 0; i < count; ++i) {
+			const uint32_t highest = r[i] > g[i] ? (r[i] > b[i] ? r[i] : b[i]) : (g[i] > b[i] ? g[i] : b[i]);
+			const uint32_t scale = scaleLut[highest];
+			r[i] = (r[i] * scale) >> 16;
+			g[i] = (g[i] * scale) >> 16;
+			b[i] = (b[i] * scale) >> 16;
+		}
+	}
+
+	static ColorValue accumulateMaskedPlanar(
+		const uint32_t * const r, const uint32_t * const g, const uint32_t * const b,
+		const uint32_t * const mask,
+		const size_t count,
+		size_t * const maskedCount) {
+		ColorValue color{0,0,0};
+		size_t n = 0;
+		for (size_t i = 0; i < count; ++i) {
+			color.r += r[i] & mask[i];
+			color.g += g[i] & mask[i];
+			color.b += b[i] & mask[i];
+			n += mask[i] & 1;
+		}
+		*maskedCount = n;
+		return color;
+	}
+
+	static void resamplePlanarScalar(
+		const int32_t * const src,
+		const int32_t * const indices,
+		const int32_t * const weights,
+		const size_t taps,
+		const size_t count,
+		const size_t first,
+		uint32_t * const dst) {
+		for (size_t i = first; i < count; ++i) {
+			int32_t acc = 0;
+			for (size_t tap = 0; tap < taps; ++tap)
+				acc += weights[tap * count + i] * src[indices[tap * count + i]];
+			acc = (acc + (1 << (Grab::Calculations::ResampleWeightBits - 1))) >> Grab::Calculations::ResampleWeightBits;
+			dst[i] = acc < 0 ? 0 : (acc > 255 ? 255 : acc);
+		}
+	}
+
+	static void resamplePlanar(
+		const int32_t * const src,
+		const int32_t * const indices,
+		const int32_t * const weights,
+		const size_t taps,
+		const size_t count,
+		uint32_t * const dst) {
+		resamplePlanarScalar(src, indices, weights, taps, count, 0, dst);
+	}
+
+auto scalePlanarByMaxChannel = scaleByMaxChannelPlanar;
+auto accumulatePlanarMasked = accumulateMaskedPlanar;
+auto resamplePlanarWeighted = resamplePlanar;
+
 #if defined(__SSE4_1__) || defined(__AVX2__)
 #ifdef __SSE4_1__
 	template<uint8_t offsetR, uint8_t offsetG, uint8_t offsetB>
@@ -164,6 +228,89 @@ auto accumulateBGRA = accumulateBuffer<PIXEL_FORMAT_BGRA>;
 		color.b = ((color.b + _mm_extract_epi32(horizontalSum128, offsetB)) / count) & 0xff;
 		return color;
 	};
+
+	static void scaleByMaxChannel128(
+		uint32_t * const r, uint32_t * const g, uint32_t * const b,
+		const size_t count,
+		const uint32_t * const scaleLut) {
+		size_t i = 0;
+		for (; i + pixelsPerStep <= count; i += pixelsPerStep) {
+			__m128i vr = _mm_loadu_si128((const __m128i*)&r[i]);
+			__m128i vg = _mm_loadu_si128((const __m128i*)&g[i]);
+			__m128i vb = _mm_loadu_si128((const __m128i*)&b[i]);
+			const __m128i highest = _mm_max_epu32(vr, _mm_max_epu32(vg, vb));
+			// no gather before AVX2
+			const __m128i scale = _mm_setr_epi32(
+				scaleLut[_mm_extract_epi32(highest, 0)],
+				scaleLut[_mm_extract_epi32(highest, 1)],
+				scaleLut[_mm_extract_epi32(highest, 2)],
+				scaleLut[_mm_extract_epi32(highest, 3)]
+			);
+			// channel (8 bit) * scale (16.16) fits in 32 bits as long as the result is <= 255
+			vr = _mm_srli_epi32(_mm_mullo_epi32(vr, scale), 16);
+			vg = _mm_srli_epi32(_mm_mullo_epi32(vg, scale), 16);
+			vb = _mm_srli_epi32(_mm_mullo_epi32(vb, scale), 16);
+			_mm_storeu_si128((__m128i*)&r[i], vr);
+			_mm_storeu_si128((__m128i*)&g[i], vg);
+			_mm_storeu_si128((__m128i*)&b[i], vb);
+		}
+		scaleByMaxChannelPlanar(r + i, g + i, b + i, count - i, scaleLut);
+	}
+
+	static ColorValue accumulateMasked128(
+		const uint32_t * const r, const uint32_t * const g, const uint32_t * const b,
+		const uint32_t * const mask,
+		const size_t count,
+		size_t * const maskedCount) {
+		__m128i sumR = _mm_setzero_si128();
+		__m128i sumG = _mm_setzero_si128();
+		__m128i sumB = _mm_setzero_si128();
+		__m128i sumN = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi32(1);
+		size_t i = 0;
+		for (; i + pixelsPerStep <= count; i += pixelsPerStep) {
+			const __m128i m = _mm_loadu_si128((const __m128i*)&mask[i]);
+			sumR = _mm_add_epi32(sumR, _mm_and_si128(_mm_loadu_si128((const __m128i*)&r[i]), m));
+			sumG = _mm_add_epi32(sumG, _mm_and_si128(_mm_loadu_si128((const __m128i*)&g[i]), m));
+			sumB = _mm_add_epi32(sumB, _mm_and_si128(_mm_loadu_si128((const __m128i*)&b[i]), m));
+			sumN = _mm_add_epi32(sumN, _mm_and_si128(one, m));
+		}
+		// (R G B N) in one register
+		const __m128i horizontalSum128 = _mm_hadd_epi32(_mm_hadd_epi32(sumR, sumG), _mm_hadd_epi32(sumB, sumN));
+		ColorValue color = accumulateMaskedPlanar(r + i, g + i, b + i, mask + i, count - i, maskedCount);
+		color.r += _mm_extract_epi32(horizontalSum128, 0);
+		color.g += _mm_extract_epi32(horizontalSum128, 1);
+		color.b += _mm_extract_epi32(horizontalSum128, 2);
+		*maskedCount += _mm_extract_epi32(horizontalSum128, 3);
+		return color;
+	}
+
+	static void resamplePlanar128(
+		const int32_t * const src,
+		const int32_t * const indices,
+		const int32_t * const weights,
+		const size_t taps,
+		const size_t count,
+		uint32_t * const dst) {
+		const __m128i round = _mm_set1_epi32(1 << (Grab::Calculations::ResampleWeightBits - 1));
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i max = _mm_set1_epi32(255);
+		size_t i = 0;
+		for (; i + pixelsPerStep <= count; i += pixelsPerStep) {
+			__m128i acc = _mm_setzero_si128();
+			for (size_t tap = 0; tap < taps; ++tap) {
+				// tap-major layout: the 4 LEDs' indices and weights of one tap are contiguous
+				const int32_t * const index = &indices[tap * count + i];
+				const __m128i values = _mm_setr_epi32(src[index[0]], src[index[1]], src[index[2]], src[index[3]]);
+				const __m128i weight = _mm_loadu_si128((const __m128i*)&weights[tap * count + i]);
+				acc = _mm_add_epi32(acc, _mm_mullo_epi32(values, weight));
+			}
+			acc = _mm_srai_epi32(_mm_add_epi32(acc, round), Grab::Calculations::ResampleWeightBits);
+			acc = _mm_min_epi32(_mm_max_epi32(acc, zero), max);
+			_mm_storeu_si128((__m128i*)&dst[i], acc);
+		}
+		resamplePlanarScalar(src, indices, weights, taps, count, i, dst);
+	}
 #endif // ifdef __SSE4_1__
 
 #ifdef __AVX2__
@@ -244,6 +391,81 @@ auto accumulateBGRA = accumulateBuffer<PIXEL_FORMAT_BGRA>;
 		color.b = (_mm_extract_epi32(horizontalSum128, offsetB) / count) & 0xff;
 		return color;
 	};
+
+	static void scaleByMaxChannel256(
+		uint32_t * const r, uint32_t * const g, uint32_t * const b,
+		const size_t count,
+		const uint32_t * const scaleLut) {
+		size_t i = 0;
+		for (; i + pixelsPerStep * 2 <= count; i += pixelsPerStep * 2) {
+			__m256i vr = _mm256_loadu_si256((const __m256i*)&r[i]);
+			__m256i vg = _mm256_loadu_si256((const __m256i*)&g[i]);
+			__m256i vb = _mm256_loadu_si256((const __m256i*)&b[i]);
+			const __m256i highest = _mm256_max_epu32(vr, _mm256_max_epu32(vg, vb));
+			const __m256i scale = _mm256_i32gather_epi32((const int*)scaleLut, highest, sizeof(uint32_t));
+			vr = _mm256_srli_epi32(_mm256_mullo_epi32(vr, scale), 16);
+			vg = _mm256_srli_epi32(_mm256_mullo_epi32(vg, scale), 16);
+			vb = _mm256_srli_epi32(_mm256_mullo_epi32(vb, scale), 16);
+			_mm256_storeu_si256((__m256i*)&r[i], vr);
+			_mm256_storeu_si256((__m256i*)&g[i], vg);
+			_mm256_storeu_si256((__m256i*)&b[i], vb);
+		}
+		scaleByMaxChannelPlanar(r + i, g + i, b + i, count - i, scaleLut);
+	}
+
+	static ColorValue accumulateMasked256(
+		const uint32_t * const r, const uint32_t * const g, const uint32_t * const b,
+		const uint32_t * const mask,
+		const size_t count,
+		size_t * const maskedCount) {
+		__m256i sumR = _mm256_setzero_si256();
+		__m256i sumG = _mm256_setzero_si256();
+		__m256i sumB = _mm256_setzero_si256();
+		__m256i sumN = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi32(1);
+		size_t i = 0;
+		for (; i + pixelsPerStep * 2 <= count; i += pixelsPerStep * 2) {
+			const __m256i m = _mm256_loadu_si256((const __m256i*)&mask[i]);
+			sumR = _mm256_add_epi32(sumR, _mm256_and_si256(_mm256_loadu_si256((const __m256i*)&r[i]), m));
+			sumG = _mm256_add_epi32(sumG, _mm256_and_si256(_mm256_loadu_si256((const __m256i*)&g[i]), m));
+			sumB = _mm256_add_epi32(sumB, _mm256_and_si256(_mm256_loadu_si256((const __m256i*)&b[i]), m));
+			sumN = _mm256_add_epi32(sumN, _mm256_and_si256(one, m));
+		}
+		const __m256i horizontalSum256 = _mm256_hadd_epi32(_mm256_hadd_epi32(sumR, sumG), _mm256_hadd_epi32(sumB, sumN));
+		const __m128i horizontalSum128 = _mm_add_epi32(_mm256_extracti128_si256(horizontalSum256, 0), _mm256_extracti128_si256(horizontalSum256, 1));
+		ColorValue color = accumulateMaskedPlanar(r + i, g + i, b + i, mask + i, count - i, maskedCount);
+		color.r += _mm_extract_epi32(horizontalSum128, 0);
+		color.g += _mm_extract_epi32(horizontalSum128, 1);
+		color.b += _mm_extract_epi32(horizontalSum128, 2);
+		*maskedCount += _mm_extract_epi32(horizontalSum128, 3);
+		return color;
+	}
+
+	static void resamplePlanar256(
+		const int32_t * const src,
+		const int32_t * const indices,
+		const int32_t * const weights,
+		const size_t taps,
+		const size_t count,
+		uint32_t * const dst) {
+		const __m256i round = _mm256_set1_epi32(1 << (Grab::Calculations::ResampleWeightBits - 1));
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i max = _mm256_set1_epi32(255);
+		size_t i = 0;
+		for (; i + pixelsPerStep * 2 <= count; i += pixelsPerStep * 2) {
+			__m256i acc = _mm256_setzero_si256();
+			for (size_t tap = 0; tap < taps; ++tap) {
+				const __m256i index = _mm256_loadu_si256((const __m256i*)&indices[tap * count + i]);
+				const __m256i values = _mm256_i32gather_epi32((const int*)src, index, sizeof(int32_t));
+				const __m256i weight = _mm256_loadu_si256((const __m256i*)&weights[tap * count + i]);
+				acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(values, weight));
+			}
+			acc = _mm256_srai_epi32(_mm256_add_epi32(acc, round), Grab::Calculations::ResampleWeightBits);
+			acc = _mm256_min_epi32(_mm256_max_epi32(acc, zero), max);
+			_mm256_storeu_si256((__m256i*)&dst[i], acc);
+		}
+		resamplePlanarScalar(src, indices, weights, taps, count, i, dst);
+	}
 #endif // ifdef __AVX2__
 
 enum SIMDLevel {
@@ -355,6 +577,9 @@ struct simdupgrade {
 			accumulateABGR = accumulateBuffer128<PIXEL_FORMAT_ABGR>;
 			accumulateRGBA = accumulateBuffer128<PIXEL_FORMAT_RGBA>;
 			accumulateBGRA = accumulateBuffer128<PIXEL_FORMAT_BGRA>;
+			scalePlanarByMaxChannel = scaleByMaxChannel128;
+			accumulatePlanarMasked = accumulateMasked128;
+			resamplePlanarWeighted = resamplePlanar128;
 		}
 		#endif // ifdef __SSE4_1__
 		#ifdef __AVX2__
@@ -363,6 +588,9 @@ struct simdupgrade {
 			accumulateABGR = accumulateBuffer256<PIXEL_FORMAT_ABGR>;
 			accumulateRGBA = accumulateBuffer256<PIXEL_FORMAT_RGBA>;
 			accumulateBGRA = accumulateBuffer256<PIXEL_FORMAT_BGRA>;
+			scalePlanarByMaxChannel = scaleByMaxChannel256;
+			accumulatePlanarMasked = accumulateMasked256;
+			resamplePlanarWeighted = resamplePlanar256;
 		}
 		#endif // ifdef __AVX2__
 	}
@@ -399,5 +627,29 @@ namespace Grab {
 
 			return qRgb(color.r, color.g, color.b);
 		}
+
+		void scaleByMaxChannel(uint32_t * const r, uint32_t * const g, uint32_t * const b, const size_t count, const uint32_t * const scaleLut) {
+			scalePlanarByMaxChannel(r, g, b, count, scaleLut);
+		}
+
+		void buildScaleByMaxChannelLut(const double factor, uint32_t * const scaleLut) {
+			for (int highest = 0; highest < 256; ++highest) {
+				const double scale = highest == 0 ? factor : qMin(factor, 255.0 / highest);
+				// rounded up, highest * scale >> 16 truncates and would stop at 254
+				scaleLut[highest] = static_cast<uint32_t>(std::ceil(scale * 65536.0));
+			}
+		}
+
+		QRgb calculateMaskedAvgColor(const uint32_t * const r, const uint32_t * const g, const uint32_t * const b, const uint32_t * const mask, const size_t count) {
+			size_t maskedCount = 0;
+			const ColorValue color = accumulatePlanarMasked(r, g, b, mask, count, &maskedCount);
+			if (maskedCount == 0)
+				return qRgb(0, 0, 0);
+			return qRgb(color.r / maskedCount, color.g / maskedCount, color.b / maskedCount);
+		}
+
+		void resample(const int32_t * const src, const int32_t * const indices, const int32_t * const weights, const size_t taps, const size_t count, uint32_t * const dst) {
+			resamplePlanarWeighted(src, indices, weights, taps, count, dst);
+		}
 	}
 }
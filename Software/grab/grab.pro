@@ -83,6 +83,8 @@ HEADERS += \
     include/ColorProvider.hpp \
     include/GrabberContext.hpp \
     include/BlueLightReduction.hpp \
+    include/ColorPostProcessor.hpp \
+    include/ZoneResampler.hpp \
     $${GRABBERS_HEADERS}
 
 SOURCES += \
@@ -90,6 +92,8 @@ SOURCES += \
     GrabberBase.cpp \
     include/ColorProvider.cpp \
     BlueLightReduction.cpp \
+    ColorPostProcessor.cpp \
+    ZoneResampler.cpp \
     $${GRABBERS_SOURCES}
 
 win32 {
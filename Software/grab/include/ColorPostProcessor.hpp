@@ -0,0 +1,68 @@
+/*
+ * ColorPostProcessor.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QList>
+#include <QRgb>
+#include <QVector>
+#include <stdint.h>
+
+class GrabWidget;
+
+namespace Grab {
+
+/*!
+	Post-processing of grabbed colors in a single pass over planar buffers:
+	color temperature, average on all LEDs, over-brighten and change detection.
+	Color temperature and over-brighten curves are lookup tables rebuilt only when
+	the corresponding settings change.
+*/
+class ColorPostProcessor
+{
+public:
+	ColorPostProcessor();
+
+	void setColorTemperature(bool isEnabled, int colorTemperature, double gamma);
+	void setOverBrighten(int overBrighten);
+
+	/*!
+		\param colors grabbed colors
+		\param widgets grab widgets, LEDs with disabled areas are left out of the average
+		\param isAvgColors set one average color to all LEDs with enabled areas
+		\param result processed colors are written here, only LEDs that changed are touched
+		\return true if any color in \a result changed
+	*/
+	bool process(const QList<QRgb> &colors, const QList<GrabWidget *> &widgets, bool isAvgColors, QList<QRgb> &result);
+
+private:
+	uint8_t m_temperatureLut[3][256];
+	uint32_t m_overBrightenLut[256];
+	int m_overBrighten;
+
+	QVector<uint32_t> m_r;
+	QVector<uint32_t> m_g;
+	QVector<uint32_t> m_b;
+	QVector<uint32_t> m_mask;
+};
+
+}
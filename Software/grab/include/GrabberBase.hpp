@@ -94,6 +94,11 @@ public:
 	virtual void startGrabbing();
 	virtual void stopGrabbing();
 	virtual bool isGrabbingStarted() const;
+
+	/*!
+		\return time spent in the last \a GrabberBase#grab() call, nanoseconds
+	*/
+	qint64 lastGrabCost() const { return m_lastGrabCostNs; }
 public slots:
 
 	virtual void setGrabInterval(int msec);
@@ -137,4 +142,5 @@ protected:
 	int grabScreensCount;
 	QList<GrabbedScreen> _screensWithWidgets;
 	QScopedPointer<QTimer> m_timer;
+	qint64 m_lastGrabCostNs = 0;
 };
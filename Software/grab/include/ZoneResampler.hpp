@@ -0,0 +1,99 @@
+/*
+ * ZoneResampler.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QList>
+#include <QRgb>
+#include <QString>
+#include <QVector>
+#include <stdint.h>
+
+namespace Grab {
+
+/*!
+	Interpolates a small number of capture zones onto a denser LED array.
+	Zones and LEDs are split into consecutive segments (usually one per screen edge),
+	every LED of a segment is a weighted sum of up to four neighbouring zones of the
+	same segment. The weights are computed once in \a configure().
+	Per-LED settings such as white balance are configured per zone then and are
+	interpolated with the same weights, see AbstractLedDevice::resampleWBAdjustments().
+*/
+class ZoneResampler
+{
+public:
+	enum Interpolation {
+		InterpolationLinear,
+		InterpolationCubic
+	};
+
+	struct Segment {
+		int zones = 0;
+		int leds = 0;
+		bool isReversed = false;
+	};
+
+	/*!
+		Parses "zones:leds[r],..." e.g. "64:300,36:170r,64:300,36:170r",
+		an 'r' after the LED count reverses the LED order of that segment.
+		\return empty list if \a segments is empty or malformed
+	*/
+	static QList<Segment> parseSegments(const QString &segments);
+	static Interpolation parseInterpolation(const QString &interpolation);
+
+	ZoneResampler();
+
+	void configure(const QList<Segment> &segments, Interpolation interpolation);
+	void clear();
+
+	bool isEnabled() const { return m_ledCount > 0; }
+	int zoneCount() const { return m_zoneCount; }
+	int ledCount() const { return m_ledCount; }
+
+	/*!
+		\return false if there are less than \a zoneCount() zones, \a leds is left untouched then
+	*/
+	bool resample(const QList<QRgb> &zones, QList<QRgb> &leds);
+
+	/*!
+		Same weights for one value per zone, used for per-LED settings that are
+		configured per zone. Cubic weights can overshoot, clamp if needed.
+		\return false if there are less than \a zoneCount() zones, \a leds is left untouched then
+	*/
+	bool resample(const QVector<double> &zones, QVector<double> &leds) const;
+
+private:
+	void setTap(int led, int tap, int zone, double weight);
+
+	int m_zoneCount;
+	int m_ledCount;
+	int m_taps;
+
+	// tap-major: [tap * m_ledCount + led]
+	QVector<int32_t> m_indices;
+	QVector<int32_t> m_weights;
+
+	QVector<int32_t> m_zones[3];
+	QVector<uint32_t> m_leds[3];
+};
+
+}
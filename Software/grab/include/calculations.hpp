@@ -28,10 +28,35 @@
 #include <QRect>
 #include <QRgb>
 #include <QList>
+#include <stdint.h>
 #include "common/BufferFormat.h"
 
 namespace Grab {
 	namespace Calculations {
 		QRgb calculateAvgColor(const unsigned char * const buffer, BufferFormat bufferFormat, const size_t pitch, const QRect &rect);
+
+		/*!
+			Scales every color of planar \a r, \a g, \a b (8 bit values in 32 bit lanes)
+			by \a scaleLut[max(r, g, b)], a 16.16 fixed point factor.
+		*/
+		void scaleByMaxChannel(uint32_t * const r, uint32_t * const g, uint32_t * const b, const size_t count, const uint32_t * const scaleLut);
+		/*!
+			Fills the 256 entries of \a scaleLut for scaleByMaxChannel(): scales by \a factor,
+			but the brightest channel no further than 255, which it then reaches exactly.
+		*/
+		void buildScaleByMaxChannelLut(const double factor, uint32_t * const scaleLut);
+		/*!
+			Average of the planar colors whose \a mask is 0xffffffff, black if there are none.
+		*/
+		QRgb calculateMaskedAvgColor(const uint32_t * const r, const uint32_t * const g, const uint32_t * const b, const uint32_t * const mask, const size_t count);
+
+		constexpr const int ResampleWeightBits = 14;
+		/*!
+			Sparse matrix-vector product for one color channel:
+			dst[i] = clamp(sum(weights[t * count + i] * src[indices[t * count + i]]) >> ResampleWeightBits, 0, 255)
+			for every tap t < \a taps. Indices and weights are stored tap-major so that
+			neighbouring outputs of one tap are contiguous.
+		*/
+		void resample(const int32_t * const src, const int32_t * const indices, const int32_t * const weights, const size_t taps, const size_t count, uint32_t * const dst);
 	}
 }
@@ -28,6 +28,12 @@
 #include "colorspace_types.h"
 #include "PrismatikMath.hpp"
 #include "Settings.hpp"
+#include "ZoneResampler.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LED_DEVICE_SSE2
+#endif
 
 void AbstractLedDevice::setUsbPowerLedDisabled(bool isDisabled) {
 	Q_UNUSED(isDisabled);
@@ -89,10 +95,45 @@ void AbstractLedDevice::updateWBAdjustments() {
 void AbstractLedDevice::updateWBAdjustments(const QList<WBAdjustment> &coefs, bool updateColors) {
 	m_wbAdjustments.clear();
 	m_wbAdjustments.append(coefs);
+	resampleWBAdjustments();
+	m_isLutCoefsValid = false;
 	if (updateColors)
 		setColors(m_colorsSaved);
 }
 
+/*!
+	With Grab/ZoneResampling the white balance is configured per zone while the device gets
+	one color per LED, the zone coefficients are interpolated onto the LEDs like the colors
+*/
+void AbstractLedDevice::resampleWBAdjustments() {
+	using namespace SettingsScope;
+	m_wbAdjustmentsResampled.clear();
+
+	Grab::ZoneResampler resampler;
+	resampler.configure(
+		Grab::ZoneResampler::parseSegments(Settings::getGrabZoneResampling()),
+		Grab::ZoneResampler::parseInterpolation(Settings::getGrabZoneResamplingInterpolation()));
+	if (!resampler.isEnabled() || resampler.zoneCount() != m_wbAdjustments.count())
+		return;
+
+	QVector<double> zones[3], leds[3];
+	for (const WBAdjustment &wb : m_wbAdjustments) {
+		zones[0].append(wb.red);
+		zones[1].append(wb.green);
+		zones[2].append(wb.blue);
+	}
+	for (int channel = 0; channel < 3; ++channel)
+		resampler.resample(zones[channel], leds[channel]);
+
+	for (int i = 0; i < resampler.ledCount(); ++i) {
+		WBAdjustment wb;
+		wb.red = qBound(0.0, leds[0][i], 1.0);
+		wb.green = qBound(0.0, leds[1][i], 1.0);
+		wb.blue = qBound(0.0, leds[2][i], 1.0);
+		m_wbAdjustmentsResampled.append(wb);
+	}
+}
+
 void AbstractLedDevice::updateDeviceSettings()
 {
 	using namespace SettingsScope;
@@ -107,40 +148,172 @@ void AbstractLedDevice::updateDeviceSettings()
 	setColors(m_colorsSaved);
 }
 
+namespace {
+// Rec. 709 luminance weights, 0.15 fixed point, sum is 1.0
+const qint32 LuminanceRed = 6966;
+const qint32 LuminanceGreen = 23436;
+const qint32 LuminanceBlue = 2366;
+const int CoefBits = 15;
+
+// 12 bit sRGB -> linear light, 0.15 fixed point, same curve as PrismatikMath::toXyz()
+const QVector<quint16> & linearLut()
+{
+	static const QVector<quint16> lut = [] {
+		QVector<quint16> result(4096);
+		for (int i = 0; i < result.size(); ++i) {
+			const double c = i / 4095.0;
+			const double linear = c > 0.04045 ? pow((c + 0.055) / 1.055, 2.4) : c / 12.92;
+			result[i] = (quint16)qRound(linear * (1 << 15));
+		}
+		return result;
+	}();
+	return lut;
+}
+
+// channels = channels * coefs / 2^15, coefs <= 1.0
+void scaleChannels(quint16 * const channels, const quint16 * const coefs, const int count)
+{
+	int i = 0;
+#ifdef LED_DEVICE_SSE2
+	const __m128i round = _mm_set1_epi32(1 << (CoefBits - 1));
+	for (; i + 8 <= count; i += 8) {
+		const __m128i a = _mm_loadu_si128((const __m128i*)&channels[i]);
+		const __m128i b = _mm_loadu_si128((const __m128i*)&coefs[i]);
+		const __m128i lo = _mm_mullo_epi16(a, b);
+		const __m128i hi = _mm_mulhi_epu16(a, b);
+		const __m128i p0 = _mm_srli_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), CoefBits);
+		const __m128i p1 = _mm_srli_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), CoefBits);
+		_mm_storeu_si128((__m128i*)&channels[i], _mm_packs_epi32(p0, p1));
+	}
+#endif
+	for (; i < count; ++i)
+		channels[i] = ((quint32)channels[i] * coefs[i] + (1 << (CoefBits - 1))) >> CoefBits;
+}
+}
+
+/*!
+	Rebuilds the tables applyColorModifications() works from when the settings they depend on changed
+*/
+void AbstractLedDevice::updateColorLuts(const int count, const QList<WBAdjustment> * const wbAdjustments)
+{
+	if (m_lutGamma != m_gamma) {
+		m_lutGamma = m_gamma;
+		// identical to the former per-LED renormalization and PrismatikMath::gammaCorrection()
+		for (int i = 0; i < 256; ++i) {
+			const unsigned extended = i * (4095 / 255.0);
+			m_gammaLut[i] = (quint16)(unsigned)(4095 * pow(extended / 4095.0, m_gamma));
+		}
+	}
+
+	if (m_lutLuminosityThreshold != m_luminosityThreshold) {
+		m_lutLuminosityThreshold = m_luminosityThreshold;
+		// L* = round(116 * f(Y) - 16) < threshold  <=>  Y < f^-1((threshold + 15.5) / 116)
+		// with some headroom for rounding, candidates are checked against the exact L* afterwards
+		if (m_luminosityThreshold <= 0) {
+			m_luminanceThreshold = -1;
+		} else {
+			const double t = (m_luminosityThreshold + 15.5) / 116.0;
+			const double y = t * t * t > 0.008856 ? t * t * t : (t - 16.0 / 116) / 7.787;
+			m_luminanceThreshold = (qint64)ceil(y * 1.02 * (1 << 30)) + 64;
+		}
+	}
+
+	if (!m_isLutCoefsValid || m_lutBrightness != m_brightness || m_channelCoefs.size() != count * 3) {
+		m_isLutCoefsValid = true;
+		m_lutBrightness = m_brightness;
+		m_channelCoefs.resize(count * 3);
+		quint16 * const r = m_channelCoefs.data();
+		quint16 * const g = r + count;
+		quint16 * const b = g + count;
+		const double brightness = m_brightness / 100.0 * (1 << CoefBits);
+		for (int i = 0; i < count; ++i) {
+			const WBAdjustment wb = wbAdjustments ? wbAdjustments->at(i) : WBAdjustment();
+			r[i] = (quint16)qBound(0.0, brightness * wb.red + 0.5, (double)(1 << CoefBits));
+			g[i] = (quint16)qBound(0.0, brightness * wb.green + 0.5, (double)(1 << CoefBits));
+			b[i] = (quint16)qBound(0.0, brightness * wb.blue + 0.5, (double)(1 << CoefBits));
+		}
+	}
+}
+
 /*!
 	Modifies colors according to gamma, luminosity threshold, white balance and brightness settings
 	All modifications are made over extended 12bit RGB, so \code outColors \endcode will contain 12bit
 	RGB instead of 8bit.
+	Gamma comes from a table, brightness and white balance are one fixed point coefficient per channel,
+	and the Lab conversion is only done for LEDs below the luminosity threshold.
 */
 void AbstractLedDevice::applyColorModifications(const QList<QRgb> &inColors, QList<StructRgb> &outColors, const bool rawColors) {
 
-	const bool isApplyWBAdjustments = m_wbAdjustments.count() == inColors.count();
-
-	for(int i = 0; i < inColors.count(); i++) {
+	const int count = qMin(inColors.count(), outColors.count());
 
+	// we can't completely bypass this function because of the Qrgb / StructRgb conversion
+	if (rawColors) {
 		//renormalize to 12bit
 		const constexpr double k = 4095/255.0;
-		outColors[i].r = qRed(inColors[i]) * k;
-		outColors[i].g = qGreen(inColors[i]) * k;
-		outColors[i].b = qBlue(inColors[i]) * k;
-
-		if (!rawColors)
-			PrismatikMath::gammaCorrection(m_gamma, outColors[i]);
-	}
-
-	// we can't completely bypass this function because of the Qrgb / StructRgb conversion above
-	if (rawColors)
+		for (int i = 0; i < count; i++) {
+			outColors[i].r = qRed(inColors[i]) * k;
+			outColors[i].g = qGreen(inColors[i]) * k;
+			outColors[i].b = qBlue(inColors[i]) * k;
+		}
 		return;
+	}
 
-	const StructLab avgColor = PrismatikMath::toLab(PrismatikMath::avgColor(outColors));
-
-	const double ampCoef = m_ledMilliAmps / (4095.0 * 3.0) / 1000.0;
-	double estimatedTotalAmps = 0.0;
+	// per-LED white balance only lines up with as many colors as it has entries
+	const QList<WBAdjustment> *wbAdjustments = NULL;
+	if (m_wbAdjustments.count() == inColors.count())
+		wbAdjustments = &m_wbAdjustments;
+	else if (m_wbAdjustmentsResampled.count() == inColors.count())
+		wbAdjustments = &m_wbAdjustmentsResampled;
+
+	const bool isApplyWBAdjustments = wbAdjustments != NULL;
+	if (isApplyWBAdjustments != m_isLutWBApplied) {
+		m_isLutWBApplied = isApplyWBAdjustments;
+		m_isLutCoefsValid = false;
+		if (!isApplyWBAdjustments && !m_wbAdjustments.isEmpty())
+			qWarning() << Q_FUNC_INFO << "white balance is set for" << m_wbAdjustments.count() << "LEDs, got" << inColors.count() << "colors, not applied";
+	}
+	updateColorLuts(count, wbAdjustments);
+
+	m_channels.resize(count * 3);
+	quint16 * const r = m_channels.data();
+	quint16 * const g = r + count;
+	quint16 * const b = g + count;
+
+	const quint16 * const linear = linearLut().constData();
+	m_darkLeds.clear();
+	for (int i = 0; i < count; i++) {
+		const QRgb color = inColors[i];
+		r[i] = m_gammaLut[qRed(color)];
+		g[i] = m_gammaLut[qGreen(color)];
+		b[i] = m_gammaLut[qBlue(color)];
+
+		const qint64 luminance = LuminanceRed * linear[r[i]] + LuminanceGreen * linear[g[i]] + LuminanceBlue * linear[b[i]];
+		if (luminance < m_luminanceThreshold)
+			m_darkLeds.append(i);
+	}
 
-	for (int i = 0; i < outColors.count(); ++i) {
-		StructLab lab = PrismatikMath::toLab(outColors[i]);
-		const int dl = m_luminosityThreshold - lab.l;
-		if (dl > 0) {
+	if (!m_darkLeds.isEmpty()) {
+		StructRgb avgRgb;
+		quint64 sumR = 0, sumG = 0, sumB = 0;
+		for (int i = 0; i < count; i++) {
+			sumR += r[i];
+			sumG += g[i];
+			sumB += b[i];
+		}
+		avgRgb.r = sumR / count;
+		avgRgb.g = sumG / count;
+		avgRgb.b = sumB / count;
+		const StructLab avgColor = PrismatikMath::toLab(avgRgb);
+
+		for (const int i : m_darkLeds) {
+			StructRgb rgb;
+			rgb.r = r[i];
+			rgb.g = g[i];
+			rgb.b = b[i];
+			StructLab lab = PrismatikMath::toLab(rgb);
+			const int dl = m_luminosityThreshold - lab.l;
+			if (dl <= 0)
+				continue;
 			if (m_isMinimumLuminosityEnabled) { // apply minimum luminosity or dead-zone
 				// Cross-fade a and b channels to avarage value within kFadingRange, fadingFactor = (dL - fadingRange)^2 / (fadingRange^2)
 				constexpr int kFadingRange = 5;
@@ -150,34 +323,41 @@ void AbstractLedDevice::applyColorModifications(const QList<QRgb> &inColors, QLi
 				lab.l = m_luminosityThreshold;
 				lab.a += PrismatikMath::round(da * fadingCoeff);
 				lab.b += PrismatikMath::round(db * fadingCoeff);
-				const StructRgb rgb = PrismatikMath::toRgb(lab);
-				outColors[i] = rgb;
+				rgb = PrismatikMath::toRgb(lab);
+				r[i] = qMin(rgb.r, 4095u);
+				g[i] = qMin(rgb.g, 4095u);
+				b[i] = qMin(rgb.b, 4095u);
 			} else {
-				outColors[i].r = 0;
-				outColors[i].g = 0;
-				outColors[i].b = 0;
+				r[i] = 0;
+				g[i] = 0;
+				b[i] = 0;
 			}
 		}
+	}
 
-		PrismatikMath::brightnessCorrection(m_brightness, outColors[i]);
-
-		if (isApplyWBAdjustments) {
-			outColors[i].r *= m_wbAdjustments[i].red;
-			outColors[i].g *= m_wbAdjustments[i].green;
-			outColors[i].b *= m_wbAdjustments[i].blue;
-		}
-		if (m_brightnessCap < SettingsScope::Profile::Device::BrightnessCapMax) {
-			const double bcapFactor = (m_brightnessCap / 100.0 * 4095 * 3) / (outColors[i].r + outColors[i].g + outColors[i].b);
-			if (bcapFactor < 1.0) {
-				outColors[i].r *= bcapFactor;
-				outColors[i].g *= bcapFactor;
-				outColors[i].b *= bcapFactor;
-			}
+	// brightness and white balance for all channels at once
+	scaleChannels(m_channels.data(), m_channelCoefs.constData(), count * 3);
+
+	const bool isApplyBrightnessCap = m_brightnessCap < SettingsScope::Profile::Device::BrightnessCapMax;
+	const unsigned brightnessCapSum = m_brightnessCap * 4095 * 3 / 100;
+	quint64 totalSum = 0;
+	for (int i = 0; i < count; ++i) {
+		unsigned red = r[i], green = g[i], blue = b[i];
+		const unsigned sum = red + green + blue;
+		if (isApplyBrightnessCap && sum > brightnessCapSum) {
+			red = red * brightnessCapSum / sum;
+			green = green * brightnessCapSum / sum;
+			blue = blue * brightnessCapSum / sum;
 		}
-
-		estimatedTotalAmps += ((double)outColors[i].r + (double)outColors[i].g + (double)outColors[i].b) * ampCoef;
+		outColors[i].r = red;
+		outColors[i].g = green;
+		outColors[i].b = blue;
+		totalSum += red + green + blue;
 	}
 
+	const double ampCoef = m_ledMilliAmps / (4095.0 * 3.0) / 1000.0;
+	const double estimatedTotalAmps = totalSum * ampCoef;
+
 	if (m_powerSupplyAmps > 0.0 && m_powerSupplyAmps < estimatedTotalAmps) {
 		const double powerRatio = m_powerSupplyAmps / estimatedTotalAmps;
 		for (StructRgb& color : outColors) {
@@ -111,7 +111,26 @@ protected:
 	bool m_isDitheringEnabled{ SettingsScope::Profile::Device::IsDitheringEnabledDefault };
 
 	QList<WBAdjustment> m_wbAdjustments;
+	// m_wbAdjustments interpolated onto the LEDs when zone resampling is on
+	QList<WBAdjustment> m_wbAdjustmentsResampled;
 
 	QList<QRgb> m_colorsSaved;
 	QList<StructRgb> m_colorsBuffer;
+
+private:
+	void resampleWBAdjustments();
+	void updateColorLuts(const int count, const QList<WBAdjustment> * const wbAdjustments);
+
+	// tables of applyColorModifications(), rebuilt when the values they were made from change
+	double m_lutGamma{ -1.0 };
+	int m_lutBrightness{ -1 };
+	int m_lutLuminosityThreshold{ -1 };
+	bool m_isLutCoefsValid{ false };
+	bool m_isLutWBApplied{ false };
+	quint16 m_gammaLut[256];
+	qint64 m_luminanceThreshold{ -1 };
+	// planar, all red values, then green, then blue
+	QVector<quint16> m_channelCoefs; // brightness * white balance, 0.15 fixed point
+	QVector<quint16> m_channels;
+	QVector<int> m_darkLeds;
 };
@@ -0,0 +1,216 @@
+/*
+ * AbstractLedDeviceDmx.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AbstractLedDeviceDmx.hpp"
+#include "debug.h"
+#include <QHostInfo>
+
+AbstractLedDeviceDmx::AbstractLedDeviceDmx(const QString& address, const QString& port, const int startUniverse, const bool isSyncEnabled, QObject * parent)
+	: AbstractLedDevice(parent)
+	, m_startUniverse(startUniverse)
+	, m_isSyncEnabled(isSyncEnabled)
+	, m_hostName(address)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+	bool ok = false;
+	m_port = port.toUShort(&ok);
+	if (m_port == 0 || !ok)
+		qCritical() << "could not parse UDP port" << port;
+}
+
+AbstractLedDeviceDmx::~AbstractLedDeviceDmx()
+{
+	close();
+}
+
+void AbstractLedDeviceDmx::open()
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+	if (m_socket == NULL)
+		m_socket = new QUdpSocket(this);
+
+	// host names are looked up once, frames go out by address
+	m_address = QHostAddress(m_hostName);
+	if (m_address.isNull() && !m_hostName.isEmpty()) {
+		const QHostInfo info = QHostInfo::fromName(m_hostName);
+		if (!info.addresses().isEmpty())
+			m_address = info.addresses().first();
+	}
+	m_packetsLedsCount = -1;
+
+	const bool ok = m_port != 0 && (!m_address.isNull() || !destination(m_startUniverse).isNull());
+	if (!ok)
+		qWarning() << Q_FUNC_INFO << "could not resolve" << m_hostName;
+	emit openDeviceSuccess(ok);
+}
+
+void AbstractLedDeviceDmx::close()
+{
+	if (m_socket != NULL) {
+		m_socket->close();
+
+		delete m_socket;
+		m_socket = NULL;
+	}
+}
+
+void AbstractLedDeviceDmx::setColors(const QList<QRgb> & colors, const bool rawColors)
+{
+	int count = colors.count();
+	if (count > maxLedsCount()) {
+		qCritical() << Q_FUNC_INFO << "colors.count() > maxLedsCount()" << count << ">" << maxLedsCount();
+		count = maxLedsCount();
+	}
+	if (m_colorsBuffer.count() != count) {
+		m_colorsBuffer.clear();
+		m_colorsBuffer.reserve(count);
+		for (int i = 0; i < count; i++)
+			m_colorsBuffer << StructRgb();
+	}
+
+	applyColorModifications(colors, m_colorsBuffer, rawColors);
+	// both paths leave 12 bit channels, DMX slots are 8 bit
+	applyDithering(m_colorsBuffer, 8);
+
+	if (m_packetsLedsCount != count)
+		reinitPackets(count);
+
+	bool ok = true;
+	const quint8 sequence = nextSequence();
+	const int offset = dataOffset();
+	for (int universe = 0; universe < m_packets.count(); universe++) {
+		QByteArray &packet = m_packets[universe];
+		char *data = packet.data();
+		data[sequenceOffset()] = (char)sequence;
+
+		char *channel = data + offset;
+		const int first = universe * LedsPerUniverse;
+		const int last = qMin(first + LedsPerUniverse, count);
+		for (int i = first; i < last; i++) {
+			const StructRgb &color = m_colorsBuffer[i];
+			*channel++ = (char)color.r;
+			*channel++ = (char)color.g;
+			*channel++ = (char)color.b;
+		}
+		ok &= writeDatagram(packet, m_destinations[universe]);
+	}
+
+	if (!m_syncPacket.isEmpty()) {
+		if (syncSequenceOffset() >= 0)
+			m_syncPacket.data()[syncSequenceOffset()] = (char)sequence;
+		ok &= writeDatagram(m_syncPacket, m_syncDestination);
+	}
+
+	m_colorsSaved = colors;
+
+	emit commandCompleted(ok);
+}
+
+void AbstractLedDeviceDmx::switchOffLeds()
+{
+	const int count = m_colorsSaved.count();
+	QList<QRgb> blackFrame;
+	blackFrame.reserve(count);
+	for (int i = 0; i < count; i++)
+		blackFrame << 0;
+	setColors(blackFrame, true);
+}
+
+void AbstractLedDeviceDmx::setRefreshDelay(int value)
+{
+	Q_UNUSED(value);
+	emit commandCompleted(true);
+}
+
+void AbstractLedDeviceDmx::setSmoothSlowdown(int value)
+{
+	Q_UNUSED(value);
+	emit commandCompleted(true);
+}
+
+void AbstractLedDeviceDmx::setColorSequence(const QString& value)
+{
+	Q_UNUSED(value);
+	emit commandCompleted(true);
+}
+
+void AbstractLedDeviceDmx::setColorDepth(int value)
+{
+	Q_UNUSED(value);
+	emit commandCompleted(true);
+}
+
+void AbstractLedDeviceDmx::requestFirmwareVersion()
+{
+	emit firmwareVersion(QStringLiteral("N/A (%1 device)").arg(name()));
+	emit commandCompleted(true);
+}
+
+QHostAddress AbstractLedDeviceDmx::destination(int universe) const
+{
+	Q_UNUSED(universe);
+	return m_address;
+}
+
+quint8 AbstractLedDeviceDmx::nextSequence()
+{
+	return m_sequence++;
+}
+
+void AbstractLedDeviceDmx::reinitPackets(int ledsCount)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << ledsCount;
+
+	m_packets.clear();
+	m_destinations.clear();
+	const int universes = (ledsCount + LedsPerUniverse - 1) / LedsPerUniverse;
+	for (int i = 0; i < universes; i++) {
+		const int leds = qMin(LedsPerUniverse, ledsCount - i * LedsPerUniverse);
+		m_packets << dataPacket(m_startUniverse + i, leds * 3);
+		m_destinations << destination(m_startUniverse + i);
+	}
+
+	m_syncPacket = m_isSyncEnabled ? syncPacket() : QByteArray();
+	m_syncDestination = destination(m_startUniverse);
+	m_packetsLedsCount = ledsCount;
+}
+
+bool AbstractLedDeviceDmx::writeDatagram(const QByteArray& packet, const QHostAddress& destination)
+{
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << destination << "Hex:" << packet.toHex();
+
+	if (m_socket == NULL)
+		return false;
+
+	const qint64 bytesWritten = m_socket->writeDatagram(packet, destination, m_port);
+	if (bytesWritten != packet.size())
+	{
+		qWarning() << Q_FUNC_INFO << "bytesWritten != packet.size():" << bytesWritten << packet.size() << " " << m_socket->errorString();
+		emit ioDeviceSuccess(false);
+		return false;
+	}
+
+	emit ioDeviceSuccess(true);
+	return true;
+}
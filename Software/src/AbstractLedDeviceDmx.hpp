@@ -0,0 +1,95 @@
+/*
+ * AbstractLedDeviceDmx.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "AbstractLedDevice.hpp"
+#include "colorspace_types.h"
+#include <QHostAddress>
+#include <QUdpSocket>
+
+/*!
+	Base of the DMX over UDP devices (E1.31, Art-Net).
+	LEDs are packed into consecutive universes of LedsPerUniverse RGB LEDs starting at
+	\a startUniverse. A packet per universe is built once when the LED count changes, a
+	frame only writes the sequence number and the channels into it. With sync enabled a
+	sync packet follows the data so receivers show all universes at once.
+*/
+class AbstractLedDeviceDmx : public AbstractLedDevice
+{
+	Q_OBJECT
+public:
+	AbstractLedDeviceDmx(const QString& address, const QString& port, const int startUniverse, const bool isSyncEnabled, QObject * parent = 0);
+	virtual ~AbstractLedDeviceDmx();
+	int defaultLedsCount() { return 10; }
+
+	// 510 channels, a LED never straddles two universes
+	constexpr static const int LedsPerUniverse = 170;
+
+public slots:
+	void open();
+	void close();
+	void setColors(const QList<QRgb> & colors, const bool rawColors);
+	void setColors(const QList<QRgb> & colors) {setColors(colors, false);};
+	void switchOffLeds();
+	void setRefreshDelay(int value);
+	void setSmoothSlowdown(int value);
+	void setColorSequence(const QString& value);
+	void setColorDepth(int value);
+	void requestFirmwareVersion();
+
+protected:
+	/*!
+		\return packet for the \a universe with \a channels channels, all 0
+	*/
+	virtual QByteArray dataPacket(int universe, int channels) const = 0;
+	virtual int dataOffset() const = 0;
+	virtual int sequenceOffset() const = 0;
+	/*!
+		\return sync packet, empty if the protocol has none
+	*/
+	virtual QByteArray syncPacket() const = 0;
+	// -1 if sync packets carry no sequence number
+	virtual int syncSequenceOffset() const { return -1; }
+	virtual QHostAddress destination(int universe) const;
+	virtual quint8 nextSequence();
+
+	int syncUniverse() const { return m_isSyncEnabled ? m_startUniverse : 0; }
+
+	const int m_startUniverse;
+	const bool m_isSyncEnabled;
+	QHostAddress m_address;
+	quint16 m_port;
+
+private:
+	void reinitPackets(int ledsCount);
+	bool writeDatagram(const QByteArray& packet, const QHostAddress& destination);
+
+	QString m_hostName;
+	QUdpSocket* m_socket{nullptr};
+	QList<QByteArray> m_packets;
+	QList<QHostAddress> m_destinations;
+	QByteArray m_syncPacket;
+	QHostAddress m_syncDestination;
+	int m_packetsLedsCount{-1};
+	quint8 m_sequence{0};
+};
@@ -143,6 +143,11 @@ bool AbstractLedDeviceUdp::writeBuffer(const QByteArray& buff)
 	if (m_Socket == NULL)
 		return false;
 
+	if (m_isBatching) {
+		m_batchSender.append(buff);
+		return true;
+	}
+
 	const qint64 bytesWritten = m_Socket->write(buff.data(), buff.size());
 
 	if (bytesWritten != buff.count())
@@ -155,3 +160,34 @@ bool AbstractLedDeviceUdp::writeBuffer(const QByteArray& buff)
 	emit ioDeviceSuccess(true);
 	return true;
 }
+
+void AbstractLedDeviceUdp::beginPackets()
+{
+	// a host name is still being looked up until the socket connects
+	m_isBatching = UdpBatchSender::isSupported()
+		&& m_Socket != NULL
+		&& m_Socket->state() == QAbstractSocket::ConnectedState;
+	if (m_isBatching)
+		m_batchSender.setSocketDescriptor(m_Socket->socketDescriptor());
+}
+
+bool AbstractLedDeviceUdp::flushPackets()
+{
+	if (!m_isBatching)
+		return true;
+	m_isBatching = false;
+
+	const int packets = m_batchSender.count();
+	if (packets == 0)
+		return true;
+
+	if (!m_batchSender.send())
+	{
+		qWarning() << Q_FUNC_INFO << "failed to send" << packets << "packets:" << m_batchSender.errorString();
+		emit ioDeviceSuccess(false);
+		return false;
+	}
+
+	emit ioDeviceSuccess(true);
+	return true;
+}
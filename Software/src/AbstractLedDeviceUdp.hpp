@@ -28,6 +28,8 @@
 
 #include "AbstractLedDevice.hpp"
 #include "colorspace_types.h"
+#include "LedWireEncoder.hpp"
+#include "UdpBatchSender.hpp"
 #include <QUdpSocket>
 
 class AbstractLedDeviceUdp : public AbstractLedDevice
@@ -53,16 +55,22 @@ public slots:
 protected:
 	QByteArray m_writeBufferHeader;
 	QByteArray m_writeBuffer;
+	LedWireEncoder m_encoder;
+	UdpBatchSender m_batchSender;
 
 	void resizeColorsBuffer(int buffSize);
 	virtual void reinitBufferHeader() = 0;
 	bool writeBuffer(const QByteArray& buff);
+	// buffers written until flushPackets() go out in one system call where supported
+	void beginPackets();
+	bool flushPackets();
 
 	uint8_t m_timeout;
 	constexpr static const uint8_t InfiniteTimeout = (uint8_t)255;
 
 private:
 	QUdpSocket* m_Socket;
+	bool m_isBatching{false};
 
 	QString m_address;
 	uint16_t m_port {21324};
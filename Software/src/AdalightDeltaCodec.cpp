@@ -0,0 +1,282 @@
+/*
+ * AdalightDeltaCodec.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#include <cstring>
+
+#include "AdalightDeltaCodec.hpp"
+
+using namespace AdalightDelta;
+
+namespace {
+const int DefaultKeyFrameInterval = 60;
+
+inline bool isSameLed(const char *a, const char *b)
+{
+	return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+}
+
+quint16 AdalightDelta::fletcher16(const char *data, int size)
+{
+	unsigned sum1 = 0;
+	unsigned sum2 = 0;
+	for (int i = 0; i < size; ++i) {
+		sum1 = (sum1 + (quint8)data[i]) % 255;
+		sum2 = (sum2 + sum1) % 255;
+	}
+	return (quint16)((sum2 << 8) | sum1);
+}
+
+AdalightDeltaEncoder::AdalightDeltaEncoder()
+	: m_keyFrameInterval(DefaultKeyFrameInterval)
+	, m_framesSinceKeyFrame(0)
+	, m_isKeyFrameNeeded(true)
+	, m_isLastKeyFrame(false)
+{
+}
+
+void AdalightDeltaEncoder::setKeyFrameInterval(int frames)
+{
+	m_keyFrameInterval = qMax(1, frames);
+}
+
+void AdalightDeltaEncoder::reset()
+{
+	m_isKeyFrameNeeded = true;
+}
+
+const QByteArray & AdalightDeltaEncoder::encode(const char *rgb, int count)
+{
+	const int size = count * 3;
+	const bool isDelta = !m_isKeyFrameNeeded
+			&& m_previous.size() == size
+			&& m_framesSinceKeyFrame + 1 < m_keyFrameInterval;
+
+	m_frame.resize(HeaderSize);
+	encodeOps(rgb, count, isDelta);
+	if (isDelta && m_frame.size() > HeaderSize + size + (count + MaxLiteral - 1) / MaxLiteral) {
+		// nothing to gain, a key frame is no larger
+		m_frame.resize(HeaderSize);
+		encodeOps(rgb, count, false);
+		m_isLastKeyFrame = true;
+	} else {
+		m_isLastKeyFrame = !isDelta;
+	}
+
+	const int type = m_isLastKeyFrame ? KeyFrame : DeltaFrame;
+	const int hi = ((count - 1) >> 8) & 0xff;
+	const int lo = (count - 1) & 0xff;
+	char *header = m_frame.data();
+	header[0] = 'A';
+	header[1] = 'd';
+	header[2] = 'z';
+	header[3] = (char)type;
+	header[4] = (char)hi;
+	header[5] = (char)lo;
+	header[6] = (char)(hi ^ lo ^ type ^ 0x55);
+
+	const quint16 checksum = fletcher16(m_frame.constData() + HeaderSize, m_frame.size() - HeaderSize);
+	m_frame.append((char)(checksum >> 8));
+	m_frame.append((char)checksum);
+
+	m_previous.resize(size);
+	memcpy(m_previous.data(), rgb, size);
+	m_framesSinceKeyFrame = m_isLastKeyFrame ? 0 : m_framesSinceKeyFrame + 1;
+	m_isKeyFrameNeeded = false;
+
+	return m_frame;
+}
+
+void AdalightDeltaEncoder::encodeOps(const char *rgb, int count, bool isDelta)
+{
+	const char *previous = m_previous.constData();
+	int i = 0;
+	while (i < count) {
+		const char *led = rgb + i * 3;
+
+		if (isDelta && isSameLed(led, previous + i * 3)) {
+			int n = 1;
+			while (n < MaxRun && i + n < count && isSameLed(rgb + (i + n) * 3, previous + (i + n) * 3))
+				++n;
+			m_frame.append((char)(OpSkip | (n - 1)));
+			i += n;
+			continue;
+		}
+
+		int run = 1;
+		while (run < MaxRun && i + run < count && isSameLed(rgb + (i + run) * 3, led))
+			++run;
+		if (run >= 2) {
+			m_frame.append((char)(OpRepeat | (run - 1)));
+			m_frame.append(led, 3);
+			i += run;
+			continue;
+		}
+
+		// literals until something cheaper starts: an unchanged LED or a run of three
+		int n = 1;
+		while (n < MaxLiteral && i + n < count) {
+			const char *next = rgb + (i + n) * 3;
+			if (isDelta && isSameLed(next, previous + (i + n) * 3))
+				break;
+			if (i + n + 2 < count && isSameLed(next, next + 3) && isSameLed(next, next + 6))
+				break;
+			++n;
+		}
+		m_frame.append((char)(OpLiteral | (n - 1)));
+		m_frame.append(led, n * 3);
+		i += n;
+	}
+}
+
+AdalightDeltaDecoder::AdalightDeltaDecoder()
+	: m_isSynced(false)
+	, m_framesDecoded(0)
+	, m_framesRejected(0)
+{
+}
+
+int AdalightDeltaDecoder::feed(const QByteArray &data)
+{
+	m_buffer.append(data);
+
+	int frames = 0;
+	for (;;) {
+		const ParseResult result = parse();
+		if (result == NeedMore)
+			break;
+		if (result == Decoded) {
+			++frames;
+			++m_framesDecoded;
+		} else {
+			++m_framesRejected;
+		}
+	}
+	return frames;
+}
+
+AdalightDeltaDecoder::ParseResult AdalightDeltaDecoder::parse()
+{
+	// sync on the magic, like the firmware would
+	int start = 0;
+	while (start + 3 <= m_buffer.size()) {
+		if (m_buffer[start] == 'A' && m_buffer[start + 1] == 'd'
+				&& (m_buffer[start + 2] == 'a' || m_buffer[start + 2] == 'z'))
+			break;
+		++start;
+	}
+	m_buffer.remove(0, start);
+
+	if (m_buffer.size() < 6)
+		return NeedMore;
+
+	const bool isExtended = m_buffer[2] == 'z';
+	const int headerSize = isExtended ? HeaderSize : 6;
+	if (m_buffer.size() < headerSize)
+		return NeedMore;
+
+	const int type = isExtended ? (quint8)m_buffer[3] : 0;
+	const int hi = (quint8)m_buffer[headerSize - 3];
+	const int lo = (quint8)m_buffer[headerSize - 2];
+	const int checksum = (quint8)m_buffer[headerSize - 1];
+	if (checksum != (hi ^ lo ^ type ^ 0x55) || type > DeltaFrame) {
+		// not a header after all, look for the next one
+		m_buffer.remove(0, 1);
+		return Rejected;
+	}
+	const int count = (hi << 8) + lo + 1;
+
+	if (isExtended)
+		return parseExtended(count, type);
+
+	if (m_buffer.size() < headerSize + count * 3)
+		return NeedMore;
+	m_leds = m_buffer.mid(headerSize, count * 3);
+	m_buffer.remove(0, headerSize + count * 3);
+	m_isSynced = true;
+	return Decoded;
+}
+
+AdalightDeltaDecoder::ParseResult AdalightDeltaDecoder::parseExtended(int count, int type)
+{
+	// walk the ops first, the frame is only applied once it is complete and valid
+	int pos = HeaderSize;
+	int covered = 0;
+	bool hasSkip = false;
+	while (covered < count) {
+		if (pos >= m_buffer.size())
+			return NeedMore;
+		const int op = (quint8)m_buffer[pos];
+		int n;
+		int size;
+		if ((op & 0x80) == OpLiteral) {
+			n = (op & 0x7f) + 1;
+			size = 1 + n * 3;
+		} else if ((op & 0xC0) == OpSkip) {
+			n = (op & 0x3f) + 1;
+			size = 1;
+			hasSkip = true;
+		} else {
+			n = (op & 0x3f) + 1;
+			size = 4;
+		}
+		covered += n;
+		pos += size;
+	}
+	if (pos + ChecksumSize > m_buffer.size())
+		return NeedMore;
+
+	const quint16 expected = ((quint8)m_buffer[pos] << 8) | (quint8)m_buffer[pos + 1];
+	const bool isValid = covered == count
+			&& expected == fletcher16(m_buffer.constData() + HeaderSize, pos - HeaderSize)
+			&& (type == KeyFrame ? !hasSkip : m_isSynced && m_leds.size() == count * 3);
+	if (!isValid) {
+		m_buffer.remove(0, 1);
+		// whatever this frame changed is lost, wait for the next key frame
+		m_isSynced = false;
+		return Rejected;
+	}
+
+	if (type == KeyFrame)
+		m_leds.resize(count * 3);
+	char *led = m_leds.data();
+	const char *op = m_buffer.constData() + HeaderSize;
+	while (op < m_buffer.constData() + pos) {
+		const int code = (quint8)*op++;
+		if ((code & 0x80) == OpLiteral) {
+			const int n = (code & 0x7f) + 1;
+			memcpy(led, op, n * 3);
+			op += n * 3;
+			led += n * 3;
+		} else if ((code & 0xC0) == OpSkip) {
+			led += ((code & 0x3f) + 1) * 3;
+		} else {
+			for (int n = (code & 0x3f) + 1; n > 0; --n, led += 3)
+				memcpy(led, op, 3);
+			op += 3;
+		}
+	}
+	m_buffer.remove(0, pos + ChecksumSize);
+	m_isSynced = true;
+	return Decoded;
+}
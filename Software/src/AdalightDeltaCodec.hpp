@@ -0,0 +1,125 @@
+/*
+ * AdalightDeltaCodec.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QByteArray>
+
+/*!
+	Extended Adalight framing, sent instead of the classic "Ada" frames when the
+	firmware supports it. Classic firmware looks for "Ada" and skips these frames.
+
+	\code
+	'A' 'd' 'z' type (LEDs - 1) hi (LEDs - 1) lo  hi ^ lo ^ type ^ 0x55  ops...  fletcher16 hi lo
+	\endcode
+
+	\a type is KeyFrame or DeltaFrame. The ops cover exactly all LEDs, triples are in wire order:
+	- 0x00 | (n - 1), n <= 128: n literal triples follow
+	- 0x80 | (n - 1), n <= 64: n LEDs keep their color, delta frames only
+	- 0xC0 | (n - 1), n <= 64: n LEDs get the one triple that follows
+
+	The Fletcher-16 checksum covers the ops. A receiver that loses or rejects a frame
+	ignores delta frames until the next key frame or classic frame, key frames are
+	sent periodically for that.
+*/
+namespace AdalightDelta
+{
+enum FrameType {
+	KeyFrame = 0,
+	DeltaFrame = 1
+};
+
+enum {
+	HeaderSize = 7,
+	ChecksumSize = 2,
+	OpLiteral = 0x00,
+	OpSkip = 0x80,
+	OpRepeat = 0xC0,
+	MaxLiteral = 128,
+	MaxRun = 64
+};
+
+quint16 fletcher16(const char *data, int size);
+}
+
+class AdalightDeltaEncoder
+{
+public:
+	AdalightDeltaEncoder();
+
+	// at least every \a frames frames is a key frame
+	void setKeyFrameInterval(int frames);
+
+	// the next frame is a key frame, e.g. the receiver missed one
+	void reset();
+
+	/*!
+		Encodes \a count triples at \a rgb against the previously encoded ones.
+		\return the frame to send, valid until the next call
+	*/
+	const QByteArray & encode(const char *rgb, int count);
+
+	bool isLastKeyFrame() const { return m_isLastKeyFrame; }
+
+private:
+	void encodeOps(const char *rgb, int count, bool isDelta);
+
+	QByteArray m_previous;
+	QByteArray m_frame;
+	int m_keyFrameInterval;
+	int m_framesSinceKeyFrame;
+	bool m_isKeyFrameNeeded;
+	bool m_isLastKeyFrame;
+};
+
+/*!
+	Reference receiver for classic and extended Adalight frames, fed byte by byte
+	the same way firmware would read them from the serial port.
+*/
+class AdalightDeltaDecoder
+{
+public:
+	AdalightDeltaDecoder();
+
+	// \return number of frames completed by \a data
+	int feed(const QByteArray &data);
+
+	// triples of the last complete frame, in wire order
+	const QByteArray & leds() const { return m_leds; }
+	int framesDecoded() const { return m_framesDecoded; }
+	int framesRejected() const { return m_framesRejected; }
+
+private:
+	enum ParseResult {
+		NeedMore,
+		Decoded,
+		Rejected
+	};
+	ParseResult parse();
+	ParseResult parseExtended(int count, int type);
+
+	QByteArray m_buffer;
+	QByteArray m_leds;
+	bool m_isSynced;
+	int m_framesDecoded;
+	int m_framesRejected;
+};
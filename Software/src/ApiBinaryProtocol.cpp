@@ -0,0 +1,97 @@
+/*
+ * ApiBinaryProtocol.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ApiBinaryProtocol.hpp"
+#include <QIODevice>
+#include <QtEndian>
+
+bool ApiBinaryProtocol::readFrame(QIODevice *device, quint8 *opcode, QByteArray *payload, bool *isMalformed)
+{
+	*isMalformed = false;
+
+	uchar header[HeaderSize];
+	if (device->peek(reinterpret_cast<char *>(header), HeaderSize) != HeaderSize)
+		return false;
+
+	const quint32 size = qFromLittleEndian<quint32>(header);
+	if (size > (quint32)MaximumPayloadSize) {
+		*isMalformed = true;
+		return false;
+	}
+	if (device->bytesAvailable() < HeaderSize + (qint64)size)
+		return false;
+
+	device->read(reinterpret_cast<char *>(header), HeaderSize);
+	*opcode = header[4];
+	*payload = device->read(size);
+	return true;
+}
+
+QByteArray ApiBinaryProtocol::frame(quint8 opcode, const QByteArray &payload)
+{
+	QByteArray result(HeaderSize + payload.size(), Qt::Uninitialized);
+	uchar *data = reinterpret_cast<uchar *>(result.data());
+
+	qToLittleEndian<quint32>(payload.size(), data);
+	data[4] = opcode;
+	memcpy(data + HeaderSize, payload.constData(), payload.size());
+	return result;
+}
+
+QByteArray ApiBinaryProtocol::statusFrame(quint8 opcode, Status status)
+{
+	return frame(opcode, QByteArray(1, (char)status));
+}
+
+bool ApiBinaryProtocol::decodeSetColors(const QByteArray &payload, int *firstLed, QByteArray *rgb)
+{
+	if (payload.size() < StartIndexSize || (payload.size() - StartIndexSize) % BytesPerLed != 0)
+		return false;
+
+	*firstLed = qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(payload.constData()));
+	*rgb = payload.mid(StartIndexSize);
+	return true;
+}
+
+QByteArray ApiBinaryProtocol::encodeColors(const QList<QRgb> &colors)
+{
+	QByteArray payload(StartIndexSize + colors.count() * BytesPerLed, Qt::Uninitialized);
+	uchar *data = reinterpret_cast<uchar *>(payload.data());
+
+	qToLittleEndian<quint16>(0, data);
+	data += StartIndexSize;
+	for (const QRgb color : colors) {
+		data[0] = qRed(color);
+		data[1] = qGreen(color);
+		data[2] = qBlue(color);
+		data += BytesPerLed;
+	}
+	return frame(OpcodeGetColors, payload);
+}
+
+QByteArray ApiBinaryProtocol::encodeFps(double fps)
+{
+	QByteArray payload(sizeof(quint32), Qt::Uninitialized);
+	qToLittleEndian<quint32>(fps > 0 ? (quint32)qRound64(fps * 1000) : 0, reinterpret_cast<uchar *>(payload.data()));
+	return frame(OpcodeGetFps, payload);
+}
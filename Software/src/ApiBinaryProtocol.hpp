@@ -0,0 +1,89 @@
+/*
+ * ApiBinaryProtocol.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QRgb>
+
+class QIODevice;
+
+/*!
+	Frames of the binary API mode, negotiated with the "binary" text command on the same port.
+	Every frame in both directions is a little endian 32 bit payload size, an opcode byte and
+	the payload, so neither side formats or scans text:
+	  SetColors  request: 16 bit index of the first LED, then R, G, B bytes per LED
+	             reply:   status byte
+	  GetColors  request: empty
+	             reply:   16 bit index of the first LED (0), then R, G, B bytes per LED
+	  GetFps     request: empty
+	             reply:   32 bit frames per 1000 seconds
+	  Text       request: empty, goes back to the text protocol
+	             reply:   status byte
+	Unknown opcodes are answered with StatusUnknown under the same opcode.
+*/
+class ApiBinaryProtocol
+{
+public:
+	enum Opcode : quint8 {
+		OpcodeText = 0,
+		OpcodeSetColors = 1,
+		OpcodeGetColors = 2,
+		OpcodeGetFps = 3
+	};
+
+	enum Status : quint8 {
+		StatusOk = 0,
+		StatusError = 1,
+		StatusBusy = 2,
+		StatusNotLocked = 3,
+		StatusUnknown = 4
+	};
+
+	constexpr static const int HeaderSize = 5;
+	constexpr static const int StartIndexSize = 2;
+	constexpr static const int BytesPerLed = 3;
+	// the largest SetColors payload, bigger sizes can only be garbage
+	constexpr static const int MaximumPayloadSize = 0xffff * BytesPerLed + StartIndexSize;
+
+	/*!
+		Reads the next frame off \a device if it has fully arrived.
+		\return false if the frame is incomplete, or \a isMalformed if it never can be
+	*/
+	static bool readFrame(QIODevice *device, quint8 *opcode, QByteArray *payload, bool *isMalformed);
+
+	static QByteArray frame(quint8 opcode, const QByteArray &payload);
+	static QByteArray statusFrame(quint8 opcode, Status status);
+
+	/*!
+		Splits a SetColors payload into the index of its first LED and the RGB bytes.
+		\return false if the payload is not a start index and whole LEDs
+	*/
+	static bool decodeSetColors(const QByteArray &payload, int *firstLed, QByteArray *rgb);
+
+	// GetColors reply
+	static QByteArray encodeColors(const QList<QRgb> &colors);
+	// GetFps reply
+	static QByteArray encodeFps(double fps);
+};
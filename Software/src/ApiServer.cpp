@@ -30,8 +30,10 @@
 #include "ApiServer.hpp"
 #include "LightpackPluginInterface.hpp"
 #include "ApiServerSetColorTask.hpp"
+#include "ApiBinaryProtocol.hpp"
 #include "Settings.hpp"
 #include "TimeEvaluations.hpp"
+#include "LedDeviceNullSink.hpp"
 #include "version.h"
 #include <QApplication>
 
@@ -89,6 +91,17 @@ const char * const ApiServer::CmdResultGetColors = "colors:";
 const char * const ApiServer::CmdGetFPS = "getfps";
 const char * const ApiServer::CmdResultFPS = "fps:";
 
+const char * const ApiServer::CmdBinary = "binary";
+const char * const ApiServer::CmdResultBinary_Ok = "binary:ok\r\n";
+
+const char * const ApiServer::CmdUdpStream = "udpstream";
+const char * const ApiServer::CmdResultUdpStream = "udpstream:";
+
+const char * const ApiServer::CmdGetDeviceStats = "getdevicestats";
+const char * const ApiServer::CmdResultDeviceStats = "devicestats:";
+const char * const ApiServer::CmdGetDeviceHistogram = "getdevicehistogram:";
+const char * const ApiServer::CmdResultDeviceHistogram = "devicehistogram:";
+
 const char * const ApiServer::CmdGetScreenSize = "getscreensize";
 const char * const ApiServer::CmdResultScreenSize = "screensize:";
 
@@ -179,13 +192,14 @@ const char * const ApiServer::CmdSetPersistOnUnlock = "setpersistonunlock:";
 const char * const ApiServer::CmdSetPersistOnUnlock_On = "on";
 const char * const ApiServer::CmdSetPersistOnUnlock_Off = "off";
 
-const int ApiServer::SignalWaitTimeoutMs = 1000; // 1 second
+const int ApiServer::SetColorsInFlightMax = 16;
 
 ApiServer::ApiServer(QObject *parent)
 	: QTcpServer(parent)
 {
 	initPrivateVariables();
 	initApiSetColorTask();
+	initUdpStream();
 	initHelpMessage();
 	initShortHelpMessage();
 }
@@ -197,6 +211,7 @@ ApiServer::ApiServer(quint16 port, QObject *parent)
 
 	initPrivateVariables();
 	initApiSetColorTask();
+	initUdpStream();
 	initHelpMessage();
 	initShortHelpMessage();
 
@@ -207,6 +222,12 @@ ApiServer::ApiServer(quint16 port, QObject *parent)
 	{
 		qFatal("%s listen(Any, %d) fail", Q_FUNC_INFO, m_apiPort);
 	}
+
+	// datagrams on the same port number
+	if (!m_udpStream->listen(QHostAddress::LocalHost, m_apiPort))
+	{
+		qFatal("%s udp listen(LocalHost, %d) fail", Q_FUNC_INFO, m_apiPort);
+	}
 }
 
 ApiServer::~ApiServer() {
@@ -221,6 +242,8 @@ void ApiServer::setInterface(LightpackPluginInterface *lightpackInterface)
 	lightpack = lightpackInterface;
 	connect(m_apiSetColorTask, &ApiServerSetColorTask::taskParseSetColorDone, lightpack, &LightpackPluginInterface::updateLedsColors, Qt::QueuedConnection);
 	connect(m_apiSetColorTask, &ApiServerSetColorTask::taskParseSetColorDone, lightpack, &LightpackPluginInterface::updateColorsCache, Qt::QueuedConnection);
+	connect(this, &ApiServer::streamColorsReceived, lightpack, &LightpackPluginInterface::updateLedsColors, Qt::QueuedConnection);
+	connect(this, &ApiServer::streamColorsReceived, lightpack, &LightpackPluginInterface::updateColorsCache, Qt::QueuedConnection);
 
 }
 
@@ -268,6 +291,10 @@ void ApiServer::incomingConnection(qintptr socketDescriptor)
 
 	ClientInfo cs;
 	cs.isAuthorized = !m_isAuthEnabled;
+	cs.isBinary = false;
+	cs.pendingSetColors = 0;
+	cs.isProcessing = false;
+	cs.isFlushPosted = false;
 	// set default sessionkey (disable lock priority)
 	cs.sessionKey = QStringLiteral("API%1%2").arg(lightpack->GetSessionKey(QStringLiteral("API")), QString::number(m_clients.count()));
 
@@ -290,6 +317,12 @@ void ApiServer::clientDisconnected()
 	QString sessionKey = m_clients[client].sessionKey;
 	if (lightpack->CheckLock(sessionKey)==1)
 		lightpack->UnLock(sessionKey);
+	m_udpStream->removeSession(sessionKey);
+
+	// its setcolor replies have nowhere to go
+	for (int i = 0; i < m_pendingSetColors.count(); i++)
+		if (m_pendingSetColors[i].client == client)
+			m_pendingSetColors[i].client = NULL;
 
 	m_clients.remove(client);
 
@@ -305,7 +338,98 @@ void ApiServer::clientProcessCommands()
 
 	QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
 
-	while (m_clients.contains(client) && client->canReadLine())
+	clientProcess(client);
+	flushReplies(client);
+}
+
+void ApiServer::clientProcess(QTcpSocket *client)
+{
+	// a nested event loop (see LightpackPluginInterface::GetStatus) must not run
+	// the next commands of a client before the current one has replied
+	if (m_clients.contains(client) == false || m_clients[client].isProcessing)
+		return;
+
+	m_clients[client].isProcessing = true;
+
+	// "binary" and OpcodeText switch the mode with commands of the other one right behind them
+	bool isBinary;
+	do {
+		isBinary = m_clients[client].isBinary;
+		if (isBinary)
+			clientProcessFrames(client);
+		else
+			clientProcessLines(client);
+	} while (m_clients.contains(client) && m_clients[client].isBinary != isBinary);
+
+	if (m_clients.contains(client))
+		m_clients[client].isProcessing = false;
+}
+
+bool ApiServer::isNextCommandAllowed(QTcpSocket *client)
+{
+	if (m_clients[client].pendingSetColors == 0)
+		return true;
+
+	if (m_clients[client].pendingSetColors >= SetColorsInFlightMax)
+		return false;
+
+	// setcolors behind setcolors are ordered by the task, anything else waits for their replies
+	if (m_clients[client].isBinary)
+	{
+		char header[ApiBinaryProtocol::HeaderSize];
+		return client->peek(header, sizeof(header)) == sizeof(header)
+				&& (quint8)header[4] == ApiBinaryProtocol::OpcodeSetColors;
+	}
+	return client->peek(qstrlen(CmdSetColor)) == CmdSetColor;
+}
+
+void ApiServer::startSetColorTask(QTcpSocket *client)
+{
+	PendingSetColor setColor;
+	setColor.client = client;
+	setColor.isTask = true;
+	m_pendingSetColors.enqueue(setColor);
+
+	// a client faster than the task is held off by TCP instead of queueing without end
+	if (++m_clients[client].pendingSetColors == SetColorsInFlightMax)
+		client->setReadBufferSize(1);
+}
+
+/*!
+	A setcolor rejected while earlier ones of the client are in flight replies after them.
+	\return false if nothing is in flight and \a reply is to be written right away
+*/
+bool ApiServer::deferSetColorReply(QTcpSocket *client, const QByteArray & reply)
+{
+	if (m_clients[client].pendingSetColors == 0)
+		return false;
+
+	PendingSetColor setColor;
+	setColor.client = client;
+	setColor.isTask = false;
+	setColor.reply = reply;
+	m_pendingSetColors.enqueue(setColor);
+
+	if (++m_clients[client].pendingSetColors == SetColorsInFlightMax)
+		client->setReadBufferSize(1);
+	return true;
+}
+
+void ApiServer::replySetColor(QTcpSocket *client, const QByteArray & reply)
+{
+	if (client == NULL || m_clients.contains(client) == false)
+		return;
+
+	if (m_clients[client].pendingSetColors-- == SetColorsInFlightMax)
+		client->setReadBufferSize(0);
+
+	m_clients[client].replies += reply;
+}
+
+void ApiServer::clientProcessLines(QTcpSocket *client)
+{
+	while (m_clients.contains(client) && m_clients[client].isBinary == false
+		   && client->canReadLine() && isNextCommandAllowed(client))
 	{
 		QString sessionKey =	m_clients[client].sessionKey;
 		int m_lockedClient = lightpack->CheckLock(sessionKey);
@@ -318,24 +442,25 @@ void ApiServer::clientProcessCommands()
 		if (cmdBuffer.isEmpty())
 		{
 			// Ignore empty lines
-			return;
+			continue;
 		}
 		else if (cmdBuffer == CmdExit)
 		{
 			writeData(client, QStringLiteral("Goodbye!\r\n"));
+			flushReplies(client);
 			if (m_clients.contains(client))
 				client->close();
-			return;
+			break;
 		}
 		else if (cmdBuffer == CmdHelp)
 		{
 			writeData(client, m_helpMessage);
-			return;
+			continue;
 		}
 		else if (cmdBuffer == CmdHelpShort)
 		{
 			writeData(client, m_shortHelpMessage);
-			return;
+			continue;
 		}
 		else if (cmdBuffer.startsWith(CmdApiKey))
 		{
@@ -368,13 +493,13 @@ void ApiServer::clientProcessCommands()
 			}
 
 			writeData(client, result);
-			return;
+			continue;
 		}
 
 		if (m_isAuthEnabled && m_clients[client].isAuthorized == false)
 		{
 			writeData(client, CmdApiCheck_AuthRequired);
-			return;
+			continue;
 		}
 
 		// We are working only with authorized clients!
@@ -463,6 +588,24 @@ void ApiServer::clientProcessCommands()
 			case SupportedDevices::DeviceTypeWarls:
 				max = MaximumNumberOfLeds::Warls;
 				break;
+			case SupportedDevices::DeviceTypeDdp:
+				max = MaximumNumberOfLeds::Ddp;
+				break;
+			case SupportedDevices::DeviceTypeE131:
+				max = MaximumNumberOfLeds::E131;
+				break;
+			case SupportedDevices::DeviceTypeArtNet:
+				max = MaximumNumberOfLeds::ArtNet;
+				break;
+			case SupportedDevices::DeviceTypeAdaptiveUdp:
+				max = MaximumNumberOfLeds::AdaptiveUdp;
+				break;
+			case SupportedDevices::DeviceTypeRecorder:
+				max = MaximumNumberOfLeds::Recorder;
+				break;
+			case SupportedDevices::DeviceTypeNullSink:
+				max = MaximumNumberOfLeds::NullSink;
+				break;
 			default:
 				max = MaximumNumberOfLeds::Default;
 			}
@@ -509,6 +652,68 @@ void ApiServer::clientProcessCommands()
 
 			result = QStringLiteral("%1%2\r\n").arg(CmdResultFPS).arg(lightpack->GetFPS());
 		}
+		else if (cmdBuffer == CmdBinary)
+		{
+			API_DEBUG_OUT << CmdBinary;
+
+			// frames may have arrived right behind the command, see clientProcess()
+			m_clients[client].isBinary = true;
+			writeData(client, CmdResultBinary_Ok);
+			continue;
+		}
+		else if (cmdBuffer == CmdGetDeviceStats)
+		{
+			API_DEBUG_OUT << CmdGetDeviceStats;
+
+			const LedDeviceNullSink::Statistics stats = LedDeviceNullSink::statistics();
+			const LatencyHistogram &total = stats.stages[LedDeviceNullSink::StageTotal];
+
+			result = QStringLiteral("%1encoder=%2;leds=%3;bytes=%4;packets=%5;frames=%6;maxfps=%7")
+					.arg(CmdResultDeviceStats)
+					.arg(stats.encoder)
+					.arg(stats.ledsCount)
+					.arg(stats.bytesPerFrame)
+					.arg(stats.packetsPerFrame)
+					.arg(total.count())
+					.arg(total.mean() > 0 ? 1e9 / total.mean() : 0.0, 0, 'f', 1);
+			for (int i = 0; i < LedDeviceNullSink::StagesCount; i++) {
+				const LatencyHistogram &stage = stats.stages[i];
+				result += QStringLiteral(";%1=%2,%3,%4,%5")
+						.arg(LedDeviceNullSink::stageName((LedDeviceNullSink::Stage)i))
+						.arg(stage.percentile(0.5))
+						.arg(stage.percentile(0.9))
+						.arg(stage.percentile(0.99))
+						.arg(stage.max());
+			}
+			result += QStringLiteral("\r\n");
+		}
+		else if (cmdBuffer.startsWith(CmdGetDeviceHistogram))
+		{
+			API_DEBUG_OUT << CmdGetDeviceHistogram;
+
+			const QString stageName = QString(cmdBuffer.mid(qstrlen(CmdGetDeviceHistogram))).trimmed();
+			const LedDeviceNullSink::Statistics stats = LedDeviceNullSink::statistics();
+
+			bool isFound = false;
+			for (int i = 0; i < LedDeviceNullSink::StagesCount; i++) {
+				if (stageName != LedDeviceNullSink::stageName((LedDeviceNullSink::Stage)i))
+					continue;
+				isFound = true;
+
+				const LatencyHistogram &stage = stats.stages[i];
+				result = QStringLiteral("%1%2:").arg(CmdResultDeviceHistogram).arg(stageName);
+				for (int bucket = 0; bucket < LatencyHistogram::BucketsCount; bucket++) {
+					if (stage.bucketCount(bucket) > 0)
+						result += QStringLiteral("%1-%2;").arg(LatencyHistogram::bucketUpperBound(bucket)).arg(stage.bucketCount(bucket));
+				}
+				result += QStringLiteral("\r\n");
+			}
+			if (!isFound)
+			{
+				API_DEBUG_OUT << CmdGetDeviceHistogram << "Error (unknown stage):" << stageName;
+				result = CmdSetResult_Error;
+			}
+		}
 		else if (cmdBuffer == CmdGetScreenSize)
 		{
 			API_DEBUG_OUT << CmdGetScreenSize;
@@ -680,6 +885,29 @@ void ApiServer::clientProcessCommands()
 				result = CmdResultUnlock_Success;
 			}
 		}
+		else if (cmdBuffer == CmdUdpStream)
+		{
+			API_DEBUG_OUT << CmdUdpStream;
+
+			if (m_lockedClient == 1)
+			{
+				if (m_udpStream->isListening())
+				{
+					const quint64 token = m_udpStream->addSession(sessionKey);
+					result = QStringLiteral("%1%2;%3\r\n").arg(CmdResultUdpStream).arg(m_udpStream->port()).arg(token, 16, 16, QLatin1Char('0'));
+				}
+				else
+					result = CmdSetResult_Error;
+			}
+			else if (m_lockedClient == 0)
+			{
+				result = CmdSetResult_NotLocked;
+			}
+			else // m_lockedClient != client
+			{
+				result = CmdSetResult_Busy;
+			}
+		}
 		else if (cmdBuffer.startsWith(CmdSetColor))
 		{
 			API_DEBUG_OUT << CmdSetColor;
@@ -689,44 +917,10 @@ void ApiServer::clientProcessCommands()
 				cmdBuffer.remove(0, cmdBuffer.indexOf(':') + 1);
 				API_DEBUG_OUT << QString(cmdBuffer);
 
-				if (m_isTaskSetColorDone)
-				{
-					m_isTaskSetColorDone = false;
-					m_isTaskSetColorParseSuccess = false;
-
-					// Start task
-					emit startParseSetColorTask(cmdBuffer);
-
-					// Wait signal from m_apiSetColorTask with success or fail result of parsing buffer.
-					// After SignalWaitTimeoutMs milliseconds, the cycle of waiting will end and the
-					// variable m_isTaskSetColorDone will be reset to 'true' state.
-					// Also in cycle we process requests from over clients, if this request is setcolor when
-					// it will be ignored because of m_isTaskSetColorDone == false
-
-					m_timer.restart();
-
-					while (m_isTaskSetColorDone == false && m_timer.hasExpired(SignalWaitTimeoutMs) == false)
-					{
-						QApplication::processEvents(QEventLoop::WaitForMoreEvents, SignalWaitTimeoutMs);
-					}
-
-					if (m_isTaskSetColorDone)
-					{
-						if (m_isTaskSetColorParseSuccess)
-						{
-							lightpack->SetLockAlive(sessionKey);
-							result = CmdSetResult_Ok;
-						}
-						else
-							result = CmdSetResult_Error;
-					} else {
-						m_isTaskSetColorDone = true; // cmd setcolor is available
-						result = CmdSetResult_Error;
-						qWarning() << Q_FUNC_INFO << "Timeout waiting taskIsSuccess() signal from m_apiSetColorTask";
-					}
-				} else {
-					qWarning() << Q_FUNC_INFO << "Task setcolor is not completed (you should increase the delay to not skip commands), skip setcolor.";
-				}
+				// Start task, taskSetColorIsSuccess() replies
+				startSetColorTask(client);
+				emit startParseSetColorTask(cmdBuffer);
+				continue;
 			}
 			else if (m_lockedClient == 0)
 			{
@@ -736,6 +930,9 @@ void ApiServer::clientProcessCommands()
 			{
 				result = CmdSetResult_Busy;
 			}
+
+			if (deferSetColorReply(client, result.toUtf8()))
+				continue;
 		}
 		else if (cmdBuffer.startsWith(CmdSetGamma))
 		{
@@ -1235,15 +1432,163 @@ void ApiServer::clientProcessCommands()
 	}
 }
 
+void ApiServer::clientProcessFrames(QTcpSocket *client)
+{
+	quint8 opcode;
+	QByteArray payload;
+	bool isMalformed;
+
+	while (m_clients.contains(client) && m_clients[client].isBinary && isNextCommandAllowed(client))
+	{
+		if (!ApiBinaryProtocol::readFrame(client, &opcode, &payload, &isMalformed))
+		{
+			if (isMalformed)
+			{
+				// there is no way to find the next frame
+				qWarning() << Q_FUNC_INFO << "Malformed frame, closing the connection";
+				flushReplies(client);
+				client->close();
+			}
+			break;
+		}
+
+		QString sessionKey = m_clients[client].sessionKey;
+		int m_lockedClient = lightpack->CheckLock(sessionKey);
+
+		if (opcode == ApiBinaryProtocol::OpcodeSetColors)
+		{
+			API_DEBUG_OUT << "binary SetColors" << payload.size();
+
+			ApiBinaryProtocol::Status status = ApiBinaryProtocol::StatusError;
+			int firstLed;
+			QByteArray rgb;
+
+			if (m_lockedClient == 0)
+			{
+				status = ApiBinaryProtocol::StatusNotLocked;
+			}
+			else if (m_lockedClient != 1)
+			{
+				status = ApiBinaryProtocol::StatusBusy;
+			}
+			else if (ApiBinaryProtocol::decodeSetColors(payload, &firstLed, &rgb))
+			{
+				// see CmdSetColor
+				startSetColorTask(client);
+				emit startSetColorsTask(firstLed, rgb);
+				continue;
+			}
+
+			const QByteArray reply = ApiBinaryProtocol::statusFrame(opcode, status);
+			if (!deferSetColorReply(client, reply))
+				writeFrame(client, reply);
+		}
+		else if (opcode == ApiBinaryProtocol::OpcodeGetColors)
+		{
+			writeFrame(client, ApiBinaryProtocol::encodeColors(lightpack->GetColors()));
+		}
+		else if (opcode == ApiBinaryProtocol::OpcodeGetFps)
+		{
+			writeFrame(client, ApiBinaryProtocol::encodeFps(lightpack->GetFPS()));
+		}
+		else if (opcode == ApiBinaryProtocol::OpcodeText)
+		{
+			API_DEBUG_OUT << "binary Text";
+
+			// see CmdBinary
+			m_clients[client].isBinary = false;
+			writeFrame(client, ApiBinaryProtocol::statusFrame(opcode, ApiBinaryProtocol::StatusOk));
+		}
+		else
+		{
+			qWarning() << Q_FUNC_INFO << "unknown opcode" << opcode;
+			writeFrame(client, ApiBinaryProtocol::statusFrame(opcode, ApiBinaryProtocol::StatusUnknown));
+		}
+	}
+}
+
+void ApiServer::udpColorsReceived(const QString &sessionKey, const QList<QRgb> &colors)
+{
+	// only while the client holds the lock, otherwise dropped like a busy setcolor
+	if (lightpack->CheckLock(sessionKey) != 1)
+		return;
+
+	lightpack->SetLockAlive(sessionKey);
+	emit streamColorsReceived(colors);
+}
+
 void ApiServer::taskSetColorIsSuccess(bool isSuccess)
 {
-	m_isTaskSetColorDone = true;
-	m_isTaskSetColorParseSuccess = isSuccess;
+	if (m_pendingSetColors.isEmpty())
+		return;
+
+	QTcpSocket *client = m_pendingSetColors.dequeue().client;
+	QSet<QTcpSocket*> clients;
+
+	if (client != NULL && m_clients.contains(client))
+	{
+		if (isSuccess)
+			lightpack->SetLockAlive(m_clients[client].sessionKey);
+
+		if (m_clients[client].isBinary)
+			replySetColor(client, ApiBinaryProtocol::statusFrame(ApiBinaryProtocol::OpcodeSetColors,
+																 isSuccess ? ApiBinaryProtocol::StatusOk : ApiBinaryProtocol::StatusError));
+		else
+			replySetColor(client, isSuccess ? CmdSetResult_Ok : CmdSetResult_Error);
+		clients.insert(client);
+	}
+
+	// the rejected ones that were waiting for this answer, the head is a task again after them
+	while (!m_pendingSetColors.isEmpty() && !m_pendingSetColors.head().isTask)
+	{
+		const PendingSetColor setColor = m_pendingSetColors.dequeue();
+		replySetColor(setColor.client, setColor.reply);
+		if (setColor.client != NULL)
+			clients.insert(setColor.client);
+	}
+
+	// once the last setcolor is answered the commands held behind them, the replies of
+	// the task results that are already queued go out together
+	for (QTcpSocket *c : clients)
+	{
+		clientProcess(c);
+		postFlushReplies(c);
+	}
+}
+
+void ApiServer::postFlushReplies(QTcpSocket* client)
+{
+	if (m_clients.contains(client) == false)
+		return;
+
+	m_clients[client].isFlushPosted = true;
+	if (m_isFlushPosted == false)
+	{
+		m_isFlushPosted = true;
+		QMetaObject::invokeMethod(this, "flushPostedReplies", Qt::QueuedConnection);
+	}
+}
+
+void ApiServer::flushPostedReplies()
+{
+	m_isFlushPosted = false;
+
+	QMap<QTcpSocket*, ClientInfo>::iterator i;
+	for (i = m_clients.begin(); i != m_clients.end(); ++i)
+	{
+		if (i.value().isFlushPosted)
+		{
+			i.value().isFlushPosted = false;
+			flushReplies(i.key());
+		}
+	}
 }
 
 void ApiServer::initPrivateVariables()
 {
 	m_apiPort = Settings::getApiPort();
+	m_isUdpEnabled = Settings::isApiUdpEnabled();
+	m_udpPort = Settings::getApiUdpPort();
 	m_listenOnlyOnLoInterface = Settings::isListenOnlyOnLoInterface();
 	m_apiAuthKey = Settings::getApiAuthKey();
 	m_isAuthEnabled = !m_apiAuthKey.isEmpty();
@@ -1251,7 +1596,7 @@ void ApiServer::initPrivateVariables()
 
 void ApiServer::initApiSetColorTask()
 {
-	m_isTaskSetColorDone = true;
+	m_isFlushPosted = false;
 
 	m_apiSetColorTaskThread = new QThread();
 	m_apiSetColorTask = new ApiServerSetColorTask();
@@ -1261,6 +1606,7 @@ void ApiServer::initApiSetColorTask()
 	connect(m_apiSetColorTask, &ApiServerSetColorTask::taskParseSetColorIsSuccess, this, &ApiServer::taskSetColorIsSuccess, Qt::QueuedConnection);
 
 	connect(this, &ApiServer::startParseSetColorTask, m_apiSetColorTask, &ApiServerSetColorTask::startParseSetColorTask, Qt::QueuedConnection);
+	connect(this, &ApiServer::startSetColorsTask, m_apiSetColorTask, &ApiServerSetColorTask::startSetColorsTask, Qt::QueuedConnection);
 	connect(this, &ApiServer::updateApiDeviceNumberOfLeds,	m_apiSetColorTask, &ApiServerSetColorTask::setApiDeviceNumberOfLeds, Qt::QueuedConnection);
 	connect(this, &ApiServer::clearColorBuffers,				m_apiSetColorTask, &ApiServerSetColorTask::reinitColorBuffers);
 
@@ -1269,6 +1615,15 @@ void ApiServer::initApiSetColorTask()
 	m_apiSetColorTaskThread->start();
 }
 
+void ApiServer::initUdpStream()
+{
+	m_udpStream = new ApiUdpStream(this);
+	m_udpStream->setNumberOfLeds(Settings::getNumberOfLeds(Settings::getConnectedDevice()));
+
+	connect(this, &ApiServer::updateApiDeviceNumberOfLeds, m_udpStream, &ApiUdpStream::setNumberOfLeds);
+	connect(m_udpStream, &ApiUdpStream::colorsReceived, this, &ApiServer::udpColorsReceived);
+}
+
 void ApiServer::startListening()
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_apiPort;
@@ -1285,6 +1640,15 @@ void ApiServer::startListening()
 
 		emit errorOnStartListening(errorStr);
 	}
+
+	if (m_isUdpEnabled && m_udpStream->listen(address, m_udpPort) == false)
+	{
+		QString errorStr = tr("API server unable to receive datagrams (port: %1).").arg(m_udpPort);
+
+		qCritical() << Q_FUNC_INFO << errorStr;
+
+		emit errorOnStartListening(errorStr);
+	}
 }
 
 void ApiServer::stopListening()
@@ -1293,6 +1657,7 @@ void ApiServer::stopListening()
 
 	// Closes the server. The server will no longer listen for incoming connections.
 	close();
+	m_udpStream->close();
 
 	QMap<QTcpSocket*, ClientInfo>::iterator i;
 	for (i = m_clients.begin(); i != m_clients.end(); ++i)
@@ -1303,6 +1668,7 @@ void ApiServer::stopListening()
 		QString sessionKey = m_clients[client].sessionKey;
 		if (lightpack->CheckLock(sessionKey)==1)
 			lightpack->UnLock(sessionKey);
+		m_udpStream->removeSession(sessionKey);
 
 		disconnect(client, &QTcpSocket::readyRead, this, &ApiServer::clientProcessCommands);
 		disconnect(client, &QTcpSocket::disconnected, this, &ApiServer::clientDisconnected);
@@ -1312,6 +1678,10 @@ void ApiServer::stopListening()
 	}
 
 	m_clients.clear();
+
+	// the tasks in flight still answer
+	for (int i = 0; i < m_pendingSetColors.count(); i++)
+		m_pendingSetColors[i].client = NULL;
 }
 
 void ApiServer::writeData(QTcpSocket* client, const QString & data)
@@ -1323,7 +1693,27 @@ void ApiServer::writeData(QTcpSocket* client, const QString & data)
 	}
 
 	API_DEBUG_OUT << Q_FUNC_INFO << data;
-	client->write(data.toUtf8());
+	m_clients[client].replies += data.toUtf8();
+}
+
+void ApiServer::writeFrame(QTcpSocket* client, const QByteArray & frame)
+{
+	if (m_clients.contains(client) == false)
+	{
+		API_DEBUG_OUT << Q_FUNC_INFO << "client disconected, cancel writing frame";
+		return;
+	}
+
+	m_clients[client].replies += frame;
+}
+
+void ApiServer::flushReplies(QTcpSocket* client)
+{
+	if (m_clients.contains(client) == false || m_clients[client].replies.isEmpty())
+		return;
+
+	client->write(m_clients[client].replies);
+	m_clients[client].replies.clear();
 }
 
 QString ApiServer::formatHelp(const QString & cmd)
@@ -1436,6 +1826,36 @@ void ApiServer::initHelpMessage()
 				QStringLiteral("Get FPS grabing"),
 				formatHelp(CmdResultFPS + QStringLiteral("25.57"))
 				);
+	m_helpMessage += formatHelp(
+				CmdBinary,
+				QStringLiteral("Switch this connection to binary frames: 32 bit little endian payload size, opcode byte, payload. "
+							   "Opcodes: 1 set colors (16 bit first LED, then R,G,B bytes; reply status byte), "
+							   "2 get colors (reply 16 bit first LED, then R,G,B bytes), 3 get FPS (reply 32 bit FPS * 1000), "
+							   "0 back to text (reply status byte). Status: 0 ok, 1 error, 2 busy, 3 not locked, 4 unknown opcode."),
+				formatHelp(CmdResultBinary_Ok)
+				);
+	m_helpMessage += formatHelp(
+				CmdUdpStream,
+				QStringLiteral("Get the port and token for streaming colors in datagrams, if API/IsUdpEnabled is set. "
+							   "Datagram: 64 bit token, 32 bit sequence number, 16 bit first LED (zero-based), then R,G,B bytes, little endian. "
+							   "Nothing is replied, datagrams older than the last one are dropped. Works only on locking time (see lock)."),
+				formatHelp(CmdResultUdpStream + QStringLiteral("3636;0123456789abcdef")) +
+				formatHelp(CmdSetResult_Error) +
+				formatHelp(CmdSetResult_Busy) +
+				formatHelp(CmdSetResult_NotLocked)
+				);
+	m_helpMessage += formatHelp(
+				CmdGetDeviceStats,
+				QStringLiteral("Get the frame costs measured by the NullSink device. Format: \"STAGE=P50,P90,P99,MAX\" in nanoseconds for the modify, dither, encode and total stages, maxfps is the frame rate the mean total cost allows."),
+				formatHelp(CmdResultDeviceStats + QStringLiteral("encoder=Adalight;leds=300;bytes=906;packets=1;frames=1200;maxfps=21645.0;modify=23551,26623,40959,61013;dither=16383,17407,24575,30114;encode=1983,2175,3327,5120;total=43007,47103,69631,96233"))
+				);
+	m_helpMessage += formatHelp(
+				CmdGetDeviceHistogram,
+				QStringLiteral("Get the histogram of a stage measured by the NullSink device. Format: \"NS-COUNT;\", where NS - largest nanoseconds of the bucket, COUNT - frames in it."),
+				formatHelp(CmdGetDeviceHistogram + QStringLiteral("total")),
+				formatHelp(CmdResultDeviceHistogram + QStringLiteral("total:40959-301;43007-650;45055-249;")) +
+				formatHelp(CmdSetResult_Error)
+				);
 	m_helpMessage += formatHelp(
 				CmdGetScreenSize,
 				QStringLiteral("Get size screen"),
@@ -1601,7 +2021,7 @@ void ApiServer::initShortHelpMessage()
 			<< CmdGetStatus << CmdGetStatusAPI
 			<< CmdGetProfile << CmdGetProfiles
 			<< CmdGetCountLeds << CmdGetLeds << CmdGetColors
-			<< CmdGetFPS << CmdGetScreenSize << CmdGetBacklight
+			<< CmdGetFPS << CmdBinary << CmdUdpStream << CmdGetScreenSize << CmdGetBacklight
 			<< CmdGetGamma << CmdGetBrightness << CmdGetSmooth
 #ifdef SOUNDVIZ_SUPPORT
 			<< CmdGetSoundVizColors << CmdGetSoundVizLiquid
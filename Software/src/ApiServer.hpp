@@ -31,17 +31,29 @@
 #include <QTcpSocket>
 #include <QMap>
 #include <QSet>
+#include <QQueue>
 #include <QRgb>
 #include <QTime>
 #include "SettingsWindow.hpp"
 #include "LightpackPluginInterface.hpp"
 #include "ApiServerSetColorTask.hpp"
+#include "ApiUdpStream.hpp"
 #include "debug.h"
 #include "enums.hpp"
 
 struct ClientInfo
 {
 	bool isAuthorized;
+	// frames of ApiBinaryProtocol instead of text lines
+	bool isBinary;
+	// setcolor replies still to come from the task, other commands wait in the socket until then
+	int pendingSetColors;
+	// set while its commands run, some of them spin an event loop
+	bool isProcessing;
+	// replies of the commands handled in this pass, sent in one write
+	QByteArray replies;
+	// replies of setcolor tasks wait for flushPostedReplies()
+	bool isFlushPosted;
 	QString sessionKey;
 	// Think about it. May be we need to save gamma,
 	// smooth and brightness and after success lock send
@@ -110,6 +122,17 @@ public:
 	static const char * const CmdGetFPS;
 	static const char * const CmdResultFPS;
 
+	static const char * const CmdBinary;
+	static const char * const CmdResultBinary_Ok;
+
+	static const char * const CmdUdpStream;
+	static const char * const CmdResultUdpStream;
+
+	static const char * const CmdGetDeviceStats;
+	static const char * const CmdResultDeviceStats;
+	static const char * const CmdGetDeviceHistogram;
+	static const char * const CmdResultDeviceHistogram;
+
 	static const char * const CmdGetScreenSize;
 	static const char * const CmdResultScreenSize;
 
@@ -198,13 +221,16 @@ public:
 	static const char * const CmdSetPersistOnUnlock_On;
 	static const char * const CmdSetPersistOnUnlock_Off;
 
-	static const int SignalWaitTimeoutMs;
+	// setcolors of one client in flight, its socket is not read beyond
+	static const int SetColorsInFlightMax;
 
 signals:
 	void startParseSetColorTask(QByteArray buffer);
+	void startSetColorsTask(int firstLed, QByteArray rgb);
 	void errorOnStartListening(QString errorMessage);
 	void clearColorBuffers();
 	void updateApiDeviceNumberOfLeds(int value);
+	void streamColorsReceived(const QList<QRgb> &colors);
 
 public slots:
 	void apiServerSettingsChanged();
@@ -217,14 +243,27 @@ private slots:
 	void clientDisconnected();
 	void clientProcessCommands();
 	void taskSetColorIsSuccess(bool isSuccess);
+	void flushPostedReplies();
+	void udpColorsReceived(const QString &sessionKey, const QList<QRgb> &colors);
 
 private:
 	LightpackPluginInterface *lightpack;
 	void initPrivateVariables();
 	void initApiSetColorTask();
+	void initUdpStream();
+	void clientProcess(QTcpSocket *client);
+	void clientProcessLines(QTcpSocket *client);
+	void clientProcessFrames(QTcpSocket *client);
+	bool isNextCommandAllowed(QTcpSocket *client);
+	void startSetColorTask(QTcpSocket *client);
+	bool deferSetColorReply(QTcpSocket *client, const QByteArray & reply);
+	void replySetColor(QTcpSocket *client, const QByteArray & reply);
 	void startListening();
 	void stopListening();
 	void writeData(QTcpSocket* client, const QString & data);
+	void writeFrame(QTcpSocket* client, const QByteArray & frame);
+	void flushReplies(QTcpSocket* client);
+	void postFlushReplies(QTcpSocket* client);
 	QString formatHelp(const QString & cmd);
 	QString formatHelp(const QString & cmd, const QString & description);
 	QString formatHelp(const QString & cmd, const QString & description, const QString & results);
@@ -234,18 +273,28 @@ private:
 
 private:
 	int m_apiPort;
+	bool m_isUdpEnabled;
+	int m_udpPort;
 	bool m_listenOnlyOnLoInterface;
 	QString m_apiAuthKey;
 	bool m_isAuthEnabled;
-	QElapsedTimer m_timer;
 
 	QMap <QTcpSocket*, ClientInfo> m_clients;
 
 	QThread *m_apiSetColorTaskThread;
 	ApiServerSetColorTask *m_apiSetColorTask;
 
-	bool m_isTaskSetColorDone;
-	bool m_isTaskSetColorParseSuccess;
+	ApiUdpStream *m_udpStream;
+
+	// setcolors in the order of their replies: waiting for the task, which answers in
+	// this order, or rejected on the spot behind setcolors of the same client in flight
+	struct PendingSetColor {
+		QTcpSocket *client;
+		bool isTask;
+		QByteArray reply;
+	};
+	QQueue<PendingSetColor> m_pendingSetColors;
+	bool m_isFlushPosted;
 
 	QString m_helpMessage;
 	QString m_shortHelpMessage;
@@ -41,141 +41,116 @@ ApiServerSetColorTask::ApiServerSetColorTask(QObject *parent) :
 void ApiServerSetColorTask::startParseSetColorTask(QByteArray buffer)
 {
 	API_DEBUG_OUT << QString(buffer) << "task thread:" << thread()->currentThreadId();
-	bool isReadFail = false;
 
+	if (parseSetColor(buffer, m_numberOfLeds, &m_parsed) == false)
+	{
+		API_DEBUG_OUT << "errors while reading buffer";
+		emit taskParseSetColorIsSuccess(false);
+		return;
+	}
+
+	for (const LedColor &ledColor : qAsConst(m_parsed))
+		m_colors[ledColor.led] = ledColor.color;
+
+	API_DEBUG_OUT << "read setcolor buffer - ok";
+	emit taskParseSetColorDone(m_colors);
+	emit taskParseSetColorIsSuccess(true);
+}
+
+bool ApiServerSetColorTask::parseSetColor(const QByteArray &buffer, int numberOfLeds, QVector<LedColor> *result)
+{
 	// buffer can contains only something like this:
 	// 1-34,9,125
-	// 2-0,255,0;3-0,255,0;6-0,255,0;
+	// 2-0,255,0;3-0,255,0;1500-0,255,0;
 
-	while (buffer.isEmpty() == false)
-	{
-		if (isReadFail == true)
-		{
-			qWarning() << "got it!";
-		}
+	result->resize(0);
+
+	const char *it = buffer.constData();
+	const char * const end = it + buffer.size();
 
-		// Check buffer length, minimum 7 - '2-0,0,0'
-		if (buffer.length() < 7)
+	while (it != end)
+	{
+		// Read led number, without leading zeros
+		if (*it < '1' || *it > '9')
 		{
-			API_DEBUG_OUT << "error: buffer.length() < 7";
-			isReadFail = true;
-			goto end;
+			API_DEBUG_OUT << "lednumber fail at" << (it - buffer.constData());
+			return false;
 		}
 
-		// Read led number
-		int ledNumber = PrismatikMath::getDigit(buffer[0]); // first char of ledNumber
-		int ledNumber2 = PrismatikMath::getDigit(buffer[1]); // second char of ledNumber
-		int ledNumber3 = PrismatikMath::getDigit(buffer[2]); // third char of ledNumber
-		if (ledNumber > 0)
+		int ledNumber = 0;
+		while (it != end && PrismatikMath::getDigit(*it) >= 0)
 		{
-			if (buffer[1] == '-') // single digit number
+			ledNumber = ledNumber * 10 + PrismatikMath::getDigit(*it++);
+			if (ledNumber > numberOfLeds)
 			{
-				buffer.remove(0, 2); // remove "2-"
+				API_DEBUG_OUT << "ledNumber is out of bounds:" << ledNumber;
+				return false;
 			}
-			else if (ledNumber2 >= 0 && buffer[2] == '-') // 2 digit number
-			{
-				ledNumber = ledNumber * 10 + ledNumber2; // 10,11,12..99
-				buffer.remove(0, 3); // remove "10-"
-			}
-			else if (ledNumber3 >= 0 && buffer[3] == '-') // 3 digit number
-			{
-				ledNumber = (ledNumber * 100) + (ledNumber2 * 10) + ledNumber3;
-				buffer.remove(0, 4); // remove "100-" from the buffer
-			} else {
-				API_DEBUG_OUT << "lednumber fail:" << QString(buffer);
-				isReadFail = true;
-				goto end;
-			}
-		} else {
-			API_DEBUG_OUT << "isdigit fail:" << QString(buffer);
-			isReadFail = true;
-			goto end;
 		}
 
-		API_DEBUG_OUT << "lednumber-" << ledNumber << "buff-" << QString(buffer);
-
-		if (ledNumber <= 0 || ledNumber > m_numberOfLeds)
+		if (it == end || *it++ != '-')
 		{
-			API_DEBUG_OUT << "ledNumber is out of bounds:" << ledNumber;
-			isReadFail = true;
-			goto end;
+			API_DEBUG_OUT << "expected '-' at" << (it - buffer.constData());
+			return false;
 		}
 
-		// Convert for using in zero-based arrays
-		ledNumber = ledNumber - 1;
-
-		// Read led red, green and blue colors to buffer buffRgb[]
-		int indexBuffer = 0;
-		int indexRgb = 0;		
-		memset(buffRgb, 0, sizeof(buffRgb));
-
-		bool isDigitExpected = true;
-		for (indexBuffer = 0; indexBuffer < buffer.length(); indexBuffer++)
+		// Read red, green and blue
+		int rgb[3];
+		for (int i = 0; i < 3; i++)
 		{
-			int d = PrismatikMath::getDigit(buffer[indexBuffer]);
-			if (d < 0)
+			if (i > 0 && (it == end || *it++ != ','))
 			{
-				if (buffer[indexBuffer] == ';')
-				{
-					break;
-				}
-				else if (buffer[indexBuffer] != ',')
-				{
-					API_DEBUG_OUT << "expected comma, buffer:" << QString(buffer) << indexBuffer << buffer[indexBuffer];
-					isReadFail = true;
-					goto end;
-				}
-				else if (isDigitExpected)
-				{
-					API_DEBUG_OUT << "expected digit, buffer:" << QString(buffer) << indexBuffer << buffer[indexBuffer];
-					isReadFail = true;
-					goto end;
-				}
-				isDigitExpected = true;
-				indexRgb++;
-			} else {
-				buffRgb[indexRgb] *= 10;
-				buffRgb[indexRgb] += d;
-
-				isDigitExpected = false;
+				API_DEBUG_OUT << "expected comma at" << (it - buffer.constData());
+				return false;
+			}
+			if (it == end || PrismatikMath::getDigit(*it) < 0)
+			{
+				API_DEBUG_OUT << "expected digit at" << (it - buffer.constData());
+				return false;
+			}
 
-				if (buffRgb[indexRgb] > 255)
+			rgb[i] = 0;
+			while (it != end && PrismatikMath::getDigit(*it) >= 0)
+			{
+				rgb[i] = rgb[i] * 10 + PrismatikMath::getDigit(*it++);
+				if (rgb[i] > 255)
 				{
 					API_DEBUG_OUT << "rgb value > 255";
-					isReadFail = true;
-					goto end;
+					return false;
 				}
 			}
 		}
 
-		// Remove read colors
-		buffer.remove(0, indexBuffer);
-
-		// Save colors
-		m_colors[ledNumber] = qRgb(buffRgb[bRed], buffRgb[bGreen], buffRgb[bBlue]);
+		result->append({ ledNumber - 1, qRgb(rgb[0], rgb[1], rgb[2]) });
 
-		API_DEBUG_OUT << "result color:" << buffRgb[bRed] << buffRgb[bGreen] << buffRgb[bBlue]
-						<< "buffer:" << QString(buffer);
-
-		if (buffer[0] == ';')
+		// The last semicolon is optional, an empty entry is not
+		if (it != end && *it++ != ';')
 		{
-			// Remove semicolon
-			buffer.remove(0, 1);
-
-			API_DEBUG_OUT << "buffer.isEmpty() == " << buffer.isEmpty();
+			API_DEBUG_OUT << "expected semicolon at" << (it - buffer.constData());
+			return false;
 		}
 	}
 
-end:
-	if (isReadFail)
+	return true;
+}
+
+void ApiServerSetColorTask::startSetColorsTask(int firstLed, QByteArray rgb)
+{
+	const int count = rgb.size() / 3;
+
+	if (firstLed < 0 || firstLed + count > m_numberOfLeds)
 	{
-		API_DEBUG_OUT << "errors while reading buffer";
+		API_DEBUG_OUT << "leds are out of bounds:" << firstLed << count;
 		emit taskParseSetColorIsSuccess(false);
-	} else {
-		API_DEBUG_OUT << "read setcolor buffer - ok";
-		emit taskParseSetColorDone(m_colors);
-		emit taskParseSetColorIsSuccess(true);
+		return;
 	}
+
+	const uchar *data = reinterpret_cast<const uchar *>(rgb.constData());
+	for (int i = 0; i < count; i++, data += 3)
+		m_colors[firstLed + i] = qRgb(data[0], data[1], data[2]);
+
+	emit taskParseSetColorDone(m_colors);
+	emit taskParseSetColorIsSuccess(true);
 }
 
 void ApiServerSetColorTask::reinitColorBuffers()
@@ -184,10 +159,6 @@ void ApiServerSetColorTask::reinitColorBuffers()
 
 	for (int i = 0; i < m_numberOfLeds; i++)
 		m_colors << 0;
-
-	buffRgb[bRed] = 0;
-	buffRgb[bGreen] = 0;
-	buffRgb[bBlue] = 0;
 }
 
 void ApiServerSetColorTask::setApiDeviceNumberOfLeds(int value)
@@ -28,6 +28,7 @@
 
 #include <QObject>
 #include <QRgb>
+#include <QVector>
 #include "debug.h"
 
 class ApiServerSetColorTask : public QObject
@@ -36,12 +37,27 @@ class ApiServerSetColorTask : public QObject
 public:
 	explicit ApiServerSetColorTask(QObject *parent = 0);
 
+	struct LedColor
+	{
+		int led; // zero-based
+		QRgb color;
+	};
+
+	/*!
+		Parses "N-R,G,B;N-R,G,B;..." in a single pass, N from 1 to \a numberOfLeds.
+		\a result is overwritten, its capacity is kept between calls.
+		\return false if any part of \a buffer is invalid, \a result is undefined then
+	*/
+	static bool parseSetColor(const QByteArray &buffer, int numberOfLeds, QVector<LedColor> *result);
+
 signals:
 	void taskParseSetColorDone(const QList<QRgb> & colors);
 	void taskParseSetColorIsSuccess(bool isSuccess);
 
 public slots:
 	void startParseSetColorTask(QByteArray buffer);
+	// binary API SetColors, 3 bytes per LED from the zero-based \a firstLed
+	void startSetColorsTask(int firstLed, QByteArray rgb);
 	void reinitColorBuffers();
 	void setApiDeviceNumberOfLeds(int value);
 
@@ -49,9 +65,6 @@ private:
 	QList<QRgb> m_colors;
 	int m_numberOfLeds;
 
-	enum BuffRgbIndexes{
-		bRed, bGreen, bBlue, bSize
-	};
-	int buffRgb[bSize]; // buffer for store temp red, green and blue values
-
+	// parsed setcolor, applied to m_colors only when the whole command is valid
+	QVector<LedColor> m_parsed;
 };
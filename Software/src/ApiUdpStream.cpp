@@ -0,0 +1,174 @@
+/*
+ * ApiUdpStream.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ApiUdpStream.hpp"
+#include <QUdpSocket>
+#include <QtEndian>
+#include "debug.h"
+#include "enums.hpp"
+
+namespace {
+// the largest UDP payload
+const int MaximumDatagramSize = 65507;
+}
+
+ApiUdpStream::ApiUdpStream(QObject *parent)
+	: QObject(parent)
+	, m_socket(new QUdpSocket(this))
+	, m_datagram(MaximumDatagramSize + 1, Qt::Uninitialized)
+	, m_numberOfLeds(MaximumNumberOfLeds::Default)
+	, m_datagramsDropped(0)
+	, m_random(std::random_device()())
+{
+	connect(m_socket, &QUdpSocket::readyRead, this, &ApiUdpStream::readDatagrams);
+}
+
+bool ApiUdpStream::listen(const QHostAddress &address, quint16 port)
+{
+	close();
+
+	if (!m_socket->bind(address, port))
+	{
+		qWarning() << Q_FUNC_INFO << "bind" << address.toString() << port << "fail:" << m_socket->errorString();
+		return false;
+	}
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_socket->localPort();
+	return true;
+}
+
+void ApiUdpStream::close()
+{
+	if (m_socket->state() != QAbstractSocket::UnconnectedState)
+		m_socket->close();
+}
+
+bool ApiUdpStream::isListening() const
+{
+	return m_socket->state() == QAbstractSocket::BoundState;
+}
+
+quint16 ApiUdpStream::port() const
+{
+	return m_socket->localPort();
+}
+
+quint64 ApiUdpStream::addSession(const QString &sessionKey)
+{
+	for (auto it = m_sessions.cbegin(); it != m_sessions.cend(); ++it)
+		if (it.value().key == sessionKey)
+			return it.key();
+
+	quint64 token;
+	do {
+		token = m_random();
+	} while (token == 0 || m_sessions.contains(token));
+
+	Session session;
+	session.key = sessionKey;
+	session.sequence = 0;
+	session.hasSequence = false;
+	session.isUpdated = false;
+	for (int i = 0; i < m_numberOfLeds; i++)
+		session.colors << 0;
+	m_sessions.insert(token, session);
+
+	return token;
+}
+
+void ApiUdpStream::removeSession(const QString &sessionKey)
+{
+	for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it)
+	{
+		if (it.value().key == sessionKey)
+		{
+			m_sessions.erase(it);
+			return;
+		}
+	}
+}
+
+void ApiUdpStream::setNumberOfLeds(int numberOfLeds)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << numberOfLeds;
+
+	m_numberOfLeds = numberOfLeds;
+
+	for (Session &session : m_sessions)
+	{
+		session.colors.clear();
+		for (int i = 0; i < m_numberOfLeds; i++)
+			session.colors << 0;
+	}
+}
+
+void ApiUdpStream::readDatagrams()
+{
+	while (m_socket->hasPendingDatagrams())
+	{
+		const qint64 size = m_socket->readDatagram(m_datagram.data(), m_datagram.size());
+		if (size < 0 || !takeDatagram(size))
+			m_datagramsDropped++;
+	}
+
+	// the newest frame of every session that got one
+	for (Session &session : m_sessions)
+	{
+		if (session.isUpdated)
+		{
+			session.isUpdated = false;
+			emit colorsReceived(session.key, session.colors);
+		}
+	}
+}
+
+bool ApiUdpStream::takeDatagram(int size)
+{
+	if (size < HeaderSize || size > MaximumDatagramSize || (size - HeaderSize) % BytesPerLed != 0)
+		return false;
+
+	const uchar *data = reinterpret_cast<const uchar *>(m_datagram.constData());
+
+	auto it = m_sessions.find(qFromLittleEndian<quint64>(data));
+	if (it == m_sessions.end())
+		return false;
+	Session &session = it.value();
+
+	// serial number arithmetic, so the counter may wrap
+	const quint32 sequence = qFromLittleEndian<quint32>(data + TokenSize);
+	if (session.hasSequence && (qint32)(sequence - session.sequence) <= 0)
+		return false;
+
+	const int firstLed = qFromLittleEndian<quint16>(data + TokenSize + SequenceSize);
+	const int count = (size - HeaderSize) / BytesPerLed;
+	if (firstLed + count > session.colors.count())
+		return false;
+
+	data += HeaderSize;
+	for (int i = firstLed; i < firstLed + count; i++, data += BytesPerLed)
+		session.colors[i] = qRgb(data[0], data[1], data[2]);
+
+	session.sequence = sequence;
+	session.hasSequence = true;
+	session.isUpdated = true;
+	return true;
+}
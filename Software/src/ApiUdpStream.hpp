@@ -0,0 +1,96 @@
+/*
+ * ApiUdpStream.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QObject>
+#include <QRgb>
+#include <random>
+
+class QUdpSocket;
+
+/*!
+	Fire-and-forget colors for API clients, e.g. games and visualizers streaming at 60-144 Hz.
+	A locked API client asks for a token ("udpstream"), then every datagram is
+	  64 bit token, 32 bit sequence number, 16 bit index of the first LED, R, G, B bytes per LED
+	all little endian, and carries a whole frame or the part of it from the first LED on.
+	Nothing is replied. Datagrams with an unknown token, a sequence number not newer than the
+	last one taken or LEDs past the end are dropped, and of the datagrams waiting on the
+	socket only the result of the newest is emitted.
+*/
+class ApiUdpStream : public QObject
+{
+	Q_OBJECT
+public:
+	explicit ApiUdpStream(QObject *parent = 0);
+
+	constexpr static const int TokenSize = 8;
+	constexpr static const int SequenceSize = 4;
+	constexpr static const int StartIndexSize = 2;
+	constexpr static const int HeaderSize = TokenSize + SequenceSize + StartIndexSize;
+	constexpr static const int BytesPerLed = 3;
+
+	bool listen(const QHostAddress &address, quint16 port);
+	void close();
+	bool isListening() const;
+	quint16 port() const;
+
+	// token of the datagrams of \a sessionKey, the same until the session is removed
+	quint64 addSession(const QString &sessionKey);
+	void removeSession(const QString &sessionKey);
+
+	quint64 datagramsDropped() const { return m_datagramsDropped; }
+
+signals:
+	void colorsReceived(const QString &sessionKey, const QList<QRgb> &colors);
+
+public slots:
+	void setNumberOfLeds(int numberOfLeds);
+
+private slots:
+	void readDatagrams();
+
+private:
+	bool takeDatagram(int size);
+
+	struct Session
+	{
+		QString key;
+		QList<QRgb> colors;
+		quint32 sequence;
+		bool hasSequence;
+		bool isUpdated;
+	};
+
+	QUdpSocket *m_socket;
+	QHash<quint64, Session> m_sessions;
+	// a datagram is read into it, never reallocated
+	QByteArray m_datagram;
+	int m_numberOfLeds;
+	quint64 m_datagramsDropped;
+	std::mt19937_64 m_random;
+};
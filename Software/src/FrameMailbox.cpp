@@ -0,0 +1,91 @@
+/*
+ * FrameMailbox.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "FrameMailbox.hpp"
+
+FrameMailbox::FrameMailbox(int capacity)
+	: m_middle(1)
+	, m_isWakeupPending(false)
+	, m_back(0)
+	, m_front(2)
+{
+	for (Slot &slot : m_slots) {
+		slot.colors.resize(capacity);
+		slot.count = 0;
+	}
+}
+
+bool FrameMailbox::post(const QList<QRgb> &colors)
+{
+	Slot &slot = m_slots[m_back];
+	const int count = colors.size();
+	if (count > slot.colors.size())
+		slot.colors.resize(count);
+
+	QRgb * const data = slot.colors.data();
+	for (int i = 0; i < count; ++i)
+		data[i] = colors[i];
+	slot.count = count;
+
+	// release the slot contents, take whatever the consumer left in the middle
+	m_back = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+
+	return !m_isWakeupPending.exchange(true, std::memory_order_acq_rel);
+}
+
+bool FrameMailbox::take(QList<QRgb> &colors)
+{
+	// clear first, a frame posted from now on wakes the consumer again
+	m_isWakeupPending.store(false, std::memory_order_release);
+
+	if ((m_middle.load(std::memory_order_acquire) & FreshBit) == 0)
+		return false;
+
+	m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & IndexMask;
+
+	const Slot &slot = m_slots[m_front];
+	if (colors.size() != slot.count) {
+		colors.clear();
+		colors.reserve(slot.count);
+		for (int i = 0; i < slot.count; ++i)
+			colors.append(slot.colors[i]);
+	} else {
+		for (int i = 0; i < slot.count; ++i)
+			colors[i] = slot.colors[i];
+	}
+	return true;
+}
+
+void FrameMailbox::copyFrame(const QList<QRgb> &frame, QList<QRgb> &colors)
+{
+	if (colors.size() == frame.size()) {
+		std::copy(frame.constBegin(), frame.constEnd(), colors.begin());
+		return;
+	}
+
+	colors.clear();
+	colors.reserve(frame.size());
+	for (const QRgb color : frame)
+		colors.append(color);
+}
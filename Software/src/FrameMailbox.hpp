@@ -0,0 +1,76 @@
+/*
+ * FrameMailbox.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <QList>
+#include <QRgb>
+#include <QVector>
+
+/*!
+	Single producer, single consumer hand-over of LED frames without locks.
+	Three preallocated slots are rotated through one atomic index: the producer always
+	overwrites its own slot and publishes it, the consumer always gets the newest
+	published frame, older ones are dropped. Frames up to \a capacity LEDs never allocate.
+*/
+class FrameMailbox
+{
+public:
+	explicit FrameMailbox(int capacity);
+
+	/*!
+		Producer side: publishes \a colors as the newest frame.
+		\return true if the consumer has to be woken up, false if a wake-up is already on its way
+	*/
+	bool post(const QList<QRgb> &colors);
+
+	/*!
+		Consumer side: copies the newest frame into \a colors.
+		\return false if nothing was posted since the last call
+	*/
+	bool take(QList<QRgb> &colors);
+
+	/*!
+		Copies \a frame into the own buffer of \a colors instead of sharing it,
+		so a kept frame doesn't make the next \a take() into \a frame allocate.
+	*/
+	static void copyFrame(const QList<QRgb> &frame, QList<QRgb> &colors);
+
+private:
+	enum {
+		IndexMask = 0x3,
+		FreshBit = 0x4
+	};
+
+	struct Slot {
+		QVector<QRgb> colors;
+		int count;
+	};
+
+	Slot m_slots[3];
+	// slot shared between both sides, FreshBit set when the producer published it
+	std::atomic<int> m_middle;
+	std::atomic<bool> m_isWakeupPending;
+	int m_back;  // producer only
+	int m_front; // consumer only
+};
@@ -0,0 +1,217 @@
+/*
+ * FrameRecording.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FrameRecording.hpp"
+#include <QIODevice>
+
+namespace {
+const char Magic[] = { 'P', 'R', 'E', 'C' };
+
+inline bool isSameColor(QRgb a, QRgb b)
+{
+	return ((a ^ b) & 0x00ffffff) == 0;
+}
+}
+
+QByteArray FrameRecording::header()
+{
+	QByteArray result(Magic, sizeof(Magic));
+	result.append((char)Version).append(3, '\0');
+	return result;
+}
+
+FrameRecordingWriter::FrameRecordingWriter()
+	: m_device(nullptr)
+	, m_lastTimeUs(0)
+	, m_framesCount(0)
+{
+}
+
+bool FrameRecordingWriter::start(QIODevice *device)
+{
+	m_device = device;
+	m_buffer = FrameRecording::header();
+	m_buffer.reserve(ChunkSize + 4 * 1024);
+	m_previous.clear();
+	m_lastTimeUs = 0;
+	m_framesCount = 0;
+	return flush();
+}
+
+bool FrameRecordingWriter::flush()
+{
+	if (m_device == nullptr)
+		return false;
+	if (m_buffer.isEmpty())
+		return true;
+	const qint64 written = m_device->write(m_buffer);
+	m_buffer.resize(0);
+	return written >= 0;
+}
+
+bool FrameRecordingWriter::flushIfFull()
+{
+	return m_buffer.size() < ChunkSize || flush();
+}
+
+void FrameRecordingWriter::appendNumber(quint64 value)
+{
+	while (value >= 0x80) {
+		m_buffer.append((char)(value | 0x80));
+		value >>= 7;
+	}
+	m_buffer.append((char)value);
+}
+
+void FrameRecordingWriter::appendRecord(FrameRecording::RecordType type, qint64 timeUs)
+{
+	m_buffer.append((char)type);
+	appendNumber(timeUs > m_lastTimeUs ? quint64(timeUs - m_lastTimeUs) : 0);
+	m_lastTimeUs = qMax(m_lastTimeUs, timeUs);
+}
+
+bool FrameRecordingWriter::writeFrame(qint64 timeUs, const QList<QRgb> &colors)
+{
+	const int count = colors.count();
+	appendRecord(FrameRecording::RecordFrame, timeUs);
+	appendNumber(count);
+
+	if (m_previous.count() != count) {
+		m_previous.clear();
+		m_previous.reserve(count);
+		for (int i = 0; i < count; ++i)
+			m_previous << 0;
+	}
+
+	int i = 0;
+	while (i < count) {
+		const int unchangedFrom = i;
+		while (i < count && isSameColor(colors[i], m_previous[i]))
+			++i;
+		const int changedFrom = i;
+		while (i < count && !isSameColor(colors[i], m_previous[i]))
+			++i;
+
+		appendNumber(changedFrom - unchangedFrom);
+		appendNumber(i - changedFrom);
+		for (int k = changedFrom; k < i; ++k) {
+			const QRgb color = colors[k];
+			m_buffer.append((char)qRed(color)).append((char)qGreen(color)).append((char)qBlue(color));
+			m_previous[k] = color;
+		}
+	}
+
+	++m_framesCount;
+	return flushIfFull();
+}
+
+bool FrameRecordingWriter::writeOff(qint64 timeUs)
+{
+	appendRecord(FrameRecording::RecordOff, timeUs);
+	return flushIfFull();
+}
+
+FrameRecordingReader::FrameRecordingReader(const QByteArray &data)
+{
+	setData(data);
+}
+
+void FrameRecordingReader::setData(const QByteArray &data)
+{
+	m_data = data;
+	m_isValid = data.size() >= FrameRecording::HeaderSize
+		&& data.startsWith(QByteArray(Magic, sizeof(Magic)))
+		&& data[sizeof(Magic)] == (char)FrameRecording::Version;
+	rewind();
+}
+
+void FrameRecordingReader::rewind()
+{
+	m_position = FrameRecording::HeaderSize;
+	m_timeUs = 0;
+	m_colors.clear();
+	m_hasError = !m_isValid;
+}
+
+bool FrameRecordingReader::readNumber(quint64 &value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64 && m_position < m_data.size(); shift += 7) {
+		const quint8 byte = (quint8)m_data[m_position++];
+		value |= quint64(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+bool FrameRecordingReader::readNext(Record &record)
+{
+	if (m_hasError || m_position >= m_data.size())
+		return false;
+
+	const quint8 type = (quint8)m_data[m_position++];
+	quint64 delta;
+	if ((type != FrameRecording::RecordFrame && type != FrameRecording::RecordOff) || !readNumber(delta)) {
+		m_hasError = true;
+		return false;
+	}
+	m_timeUs += (qint64)delta;
+
+	if (type == FrameRecording::RecordFrame) {
+		quint64 count;
+		if (!readNumber(count) || count > FrameRecording::MaxLedsCount) {
+			m_hasError = true;
+			return false;
+		}
+		if ((quint64)m_colors.count() != count) {
+			m_colors.clear();
+			m_colors.reserve((int)count);
+			for (quint64 i = 0; i < count; ++i)
+				m_colors << qRgb(0, 0, 0);
+		}
+
+		quint64 i = 0;
+		while (i < count) {
+			quint64 unchanged, changed;
+			if (!readNumber(unchanged) || !readNumber(changed)
+					|| unchanged + changed > count - i
+					|| (unchanged == 0 && changed == 0)
+					|| changed * 3 > (quint64)(m_data.size() - m_position)) {
+				m_hasError = true;
+				return false;
+			}
+			i += unchanged;
+			const char *rgb = m_data.constData() + m_position;
+			for (quint64 k = 0; k < changed; ++k, rgb += 3)
+				m_colors[(int)(i + k)] = qRgb((quint8)rgb[0], (quint8)rgb[1], (quint8)rgb[2]);
+			m_position += (int)changed * 3;
+			i += changed;
+		}
+	}
+
+	record.type = (FrameRecording::RecordType)type;
+	record.timeUs = m_timeUs;
+	record.colors = m_colors;
+	return true;
+}
@@ -0,0 +1,127 @@
+/*
+ * FrameRecording.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QRgb>
+
+class QIODevice;
+
+/*!
+	Binary recording of the frames handed to the device layer, for replaying real
+	workloads without a screen or hardware.
+
+	\code
+	'P' 'R' 'E' 'C' version 0 0 0  records...
+	\endcode
+
+	Numbers are unsigned LEB128 varints. Every record starts with its type and the
+	microseconds since the previous record:
+	- RecordFrame: LED count, then runs of (unchanged LEDs, changed LEDs, changed RGB
+	  triples) until the runs cover all LEDs. Changes are against the previous frame,
+	  a frame with another LED count is compared against black.
+	- RecordOff: the LEDs were switched off, nothing follows.
+*/
+namespace FrameRecording
+{
+enum RecordType {
+	RecordFrame = 1,
+	RecordOff = 2
+};
+
+enum {
+	HeaderSize = 8,
+	Version = 1,
+	// anything above is taken for a damaged record
+	MaxLedsCount = 0xffff
+};
+
+QByteArray header();
+}
+
+class FrameRecordingWriter
+{
+public:
+	// data is handed to the device in chunks of about this size
+	static const int ChunkSize = 64 * 1024;
+
+	FrameRecordingWriter();
+
+	// starts a recording on \a device, which must be open for writing
+	bool start(QIODevice *device);
+	// writes the buffered records, \return false if the device failed
+	bool flush();
+
+	bool writeFrame(qint64 timeUs, const QList<QRgb> &colors);
+	bool writeOff(qint64 timeUs);
+
+	int framesCount() const { return m_framesCount; }
+
+private:
+	void appendRecord(FrameRecording::RecordType type, qint64 timeUs);
+	void appendNumber(quint64 value);
+	bool flushIfFull();
+
+	QIODevice *m_device;
+	QByteArray m_buffer;
+	QList<QRgb> m_previous;
+	qint64 m_lastTimeUs;
+	int m_framesCount;
+};
+
+class FrameRecordingReader
+{
+public:
+	struct Record {
+		FrameRecording::RecordType type;
+		// microseconds since the start of the recording
+		qint64 timeUs;
+		QList<QRgb> colors;
+	};
+
+	explicit FrameRecordingReader(const QByteArray &data = QByteArray());
+
+	void setData(const QByteArray &data);
+	bool isValid() const { return m_isValid; }
+	// back to the first record
+	void rewind();
+
+	/*!
+		Decodes the next record into \a record.
+		\return false at the end of the recording or on a damaged record
+	*/
+	bool readNext(Record &record);
+	bool hasError() const { return m_hasError; }
+
+private:
+	bool readNumber(quint64 &value);
+
+	QByteArray m_data;
+	QList<QRgb> m_colors;
+	int m_position;
+	qint64 m_timeUs;
+	bool m_isValid;
+	bool m_hasError;
+};
@@ -0,0 +1,138 @@
+/*
+ * FrameReplayer.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QFile>
+#include "FrameReplayer.hpp"
+#include "debug.h"
+
+FrameReplayer::FrameReplayer(QObject *parent)
+	: QObject(parent)
+	, m_speed(1.0)
+	, m_hasNext(false)
+	, m_isRunning(false)
+	, m_isOff(false)
+	, m_recordsCount(0)
+	, m_maxLatenessUs(0)
+{
+	m_timer.setSingleShot(true);
+	m_timer.setTimerType(Qt::PreciseTimer);
+	connect(&m_timer, &QTimer::timeout, this, &FrameReplayer::replayNext);
+}
+
+bool FrameReplayer::load(const QString &path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		qWarning() << Q_FUNC_INFO << "can't open" << path << file.errorString();
+		return false;
+	}
+	if (!setRecording(file.readAll())) {
+		qWarning() << Q_FUNC_INFO << path << "is not a frame recording";
+		return false;
+	}
+	return true;
+}
+
+bool FrameReplayer::setRecording(const QByteArray &data)
+{
+	stop();
+	m_reader.setData(data);
+	return m_reader.isValid();
+}
+
+void FrameReplayer::setSpeed(double speed)
+{
+	m_speed = qMax(speed, 0.0);
+}
+
+qint64 FrameReplayer::dueUs(const FrameRecordingReader::Record &record) const
+{
+	return m_speed > 0 ? qint64(record.timeUs / m_speed) : 0;
+}
+
+void FrameReplayer::start()
+{
+	stop();
+	if (!m_reader.isValid())
+		return;
+
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << "speed" << m_speed;
+	m_reader.rewind();
+	m_recordsCount = 0;
+	m_maxLatenessUs = 0;
+	m_isOff = false;
+	m_isRunning = true;
+	m_hasNext = m_reader.readNext(m_next);
+	m_clock.start();
+	scheduleNext();
+}
+
+void FrameReplayer::stop()
+{
+	m_timer.stop();
+	m_isRunning = false;
+}
+
+void FrameReplayer::scheduleNext()
+{
+	if (!m_hasNext) {
+		if (m_reader.hasError())
+			qWarning() << Q_FUNC_INFO << "damaged record after" << m_recordsCount << "records, replay stopped";
+		DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_recordsCount << "records replayed, at most" << m_maxLatenessUs << "us late";
+		m_isRunning = false;
+		emit finished();
+		return;
+	}
+
+	// due records go out one per event loop pass, so consumers keep up with a late replay
+	const qint64 waitUs = dueUs(m_next) - m_clock.nsecsElapsed() / 1000;
+	m_timer.start(waitUs > 0 ? int((waitUs + 999) / 1000) : 0);
+}
+
+void FrameReplayer::replayNext()
+{
+	if (!m_isRunning || !m_hasNext)
+		return;
+
+	const qint64 latenessUs = m_clock.nsecsElapsed() / 1000 - dueUs(m_next);
+	if (m_speed > 0 && latenessUs > m_maxLatenessUs)
+		m_maxLatenessUs = latenessUs;
+
+	++m_recordsCount;
+	if (m_next.type == FrameRecording::RecordOff) {
+		m_isOff = true;
+		emit ledsSwitchedOff();
+	} else {
+		if (m_isOff) {
+			m_isOff = false;
+			emit ledsSwitchedOn();
+		}
+		emit frameReady(m_next.colors);
+	}
+
+	// a slot connected to the signals may have stopped the replay
+	if (!m_isRunning)
+		return;
+	m_hasNext = m_reader.readNext(m_next);
+	scheduleNext();
+}
@@ -0,0 +1,81 @@
+/*
+ * FrameReplayer.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include "FrameRecording.hpp"
+
+/*!
+	Plays a FrameRecording back into the device layer, with the recorded timing or
+	sped up. Every record is emitted in order, a late replay catches up instead of
+	dropping frames, so the same recording always produces the same output.
+*/
+class FrameReplayer : public QObject
+{
+	Q_OBJECT
+public:
+	explicit FrameReplayer(QObject *parent = 0);
+
+	// reads the whole recording into memory, so that replaying doesn't touch the disk
+	bool load(const QString &path);
+	bool setRecording(const QByteArray &data);
+
+	// 1.0 replays at the recorded cadence, 2.0 twice as fast, 0 as fast as possible
+	void setSpeed(double speed);
+	double speed() const { return m_speed; }
+
+	bool isRunning() const { return m_isRunning; }
+	int recordsCount() const { return m_recordsCount; }
+	// how far the most delayed record was behind its schedule
+	qint64 maxLatenessUs() const { return m_maxLatenessUs; }
+
+signals:
+	void frameReady(const QList<QRgb> &colors);
+	void ledsSwitchedOff();
+	// before the first frame after ledsSwitchedOff()
+	void ledsSwitchedOn();
+	void finished();
+
+public slots:
+	void start();
+	void stop();
+
+private:
+	void replayNext();
+	void scheduleNext();
+	qint64 dueUs(const FrameRecordingReader::Record &record) const;
+
+	FrameRecordingReader m_reader;
+	FrameRecordingReader::Record m_next;
+	QTimer m_timer;
+	QElapsedTimer m_clock;
+	double m_speed;
+	bool m_hasNext;
+	bool m_isRunning;
+	bool m_isOff;
+	int m_recordsCount;
+	qint64 m_maxLatenessUs;
+};
@@ -26,6 +26,7 @@
 
 #include <QtMath>
 #include <QApplication>
+#include <QElapsedTimer>
 
 #include "debug.h"
 #include "PrismatikMath.hpp"
@@ -40,6 +41,7 @@
 #include "MacOSAVGrabber.h"
 #include "D3D10Grabber.hpp"
 #include "GrabManager.hpp"
+#include "FrameMailbox.hpp"
 #include "BlueLightReduction.hpp"
 #ifdef Q_OS_WIN
 #include "WinUtils.hpp"
@@ -74,10 +76,14 @@ GrabManager::GrabManager(QWidget *parent) : QObject(parent)
 
 	m_blueLightClient = nullptr;
 
+	m_frameMailbox = nullptr;
+
 	m_grabberContext = new GrabberContext();
 
 	m_isSendDataOnlyIfColorsChanged = Settings::isSendDataOnlyIfColorsChanges();
 
+	m_rateGovernor.setBaseInterval(Settings::getGrabSlowdown());
+
 	initGrabbers();
 	m_grabber = queryGrabber(Settings::getGrabberType());
 
@@ -239,7 +245,7 @@ void GrabManager::onGrabberStateChangeRequested(bool isStartRequested) {
 			if (m_isGrabbingStarted && Settings::isDx1011GrabberEnabled()) {
 				m_grabber->stopGrabbing();
 				grabber->startGrabbing();
-				grabber->setGrabInterval(Settings::getGrabSlowdown());
+				grabber->setGrabInterval(m_rateGovernor.interval());
 			}
 		} else {
 			m_grabber->startGrabbing();
@@ -256,12 +262,67 @@ void GrabManager::onGrabberStateChangeRequested(bool isStartRequested) {
 void GrabManager::onGrabSlowdownChanged(int ms)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << ms;
+	m_rateGovernor.setBaseInterval(ms);
 	if (m_grabber)
-		m_grabber->setGrabInterval(ms);
+		m_grabber->setGrabInterval(m_rateGovernor.interval());
 	else
 		qWarning() << Q_FUNC_INFO << "trying to change grab slowdown while there is no grabber";
 }
 
+void GrabManager::onGrabAdaptiveRateEnabledChanged(bool state)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << state;
+	m_rateGovernor.setEnabled(state);
+	applyGrabInterval(m_rateGovernor.interval());
+}
+
+void GrabManager::onGrabAdaptiveRateFastestChanged(int ms)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << ms;
+	m_rateGovernor.setFastestInterval(ms);
+}
+
+void GrabManager::onGrabAdaptiveRateIdleChanged(int ms)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << ms;
+	m_rateGovernor.setIdleInterval(ms);
+}
+
+void GrabManager::onGrabAdaptiveRateCpuBudgetChanged(int percent)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << percent;
+	m_rateGovernor.setCpuBudget(percent);
+}
+
+void GrabManager::setFrameMailbox(FrameMailbox *mailbox)
+{
+	m_frameMailbox = mailbox;
+}
+
+void GrabManager::sendLedsColors()
+{
+	if (m_frameMailbox == nullptr)
+	{
+		emit updateLedsColors(m_colorsCurrent);
+		return;
+	}
+
+	// at most one wake-up in flight, the device thread always picks the newest frame
+	if (m_frameMailbox->post(m_colorsCurrent))
+		emit ledsColorsPosted();
+}
+
+void GrabManager::applyGrabInterval(int ms)
+{
+	if (m_grabber == NULL)
+		return;
+#ifdef D3D10_GRAB_SUPPORT
+	if (m_d3d10Grabber != NULL && m_d3d10Grabber->isGrabbingStarted())
+		m_d3d10Grabber->setGrabInterval(ms);
+#endif
+	m_grabber->setGrabInterval(ms);
+}
+
 void GrabManager::onGrabAvgColorsEnabledChanged(bool state)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << state;
@@ -271,6 +332,7 @@ void GrabManager::onGrabAvgColorsEnabledChanged(bool state)
 void GrabManager::onGrabOverBrightenChanged(int value) {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
 	m_overBrighten = value;
+	m_postProcessor.setOverBrighten(m_overBrighten);
 }
 
 void GrabManager::onGrabApplyBlueLightReductionChanged(bool state)
@@ -295,18 +357,21 @@ void GrabManager::onGrabApplyColorTemperatureChanged(bool state)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << state;
 	m_isApplyColorTemperature = state;
+	m_postProcessor.setColorTemperature(m_isApplyColorTemperature, m_colorTemperature, m_gamma);
 }
 
 void GrabManager::onGrabColorTemperatureChanged(int value)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
 	m_colorTemperature = value;
+	m_postProcessor.setColorTemperature(m_isApplyColorTemperature, m_colorTemperature, m_gamma);
 }
 
 void GrabManager::onGrabGammaChanged(double gamma)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << gamma;
 	m_gamma = gamma;
+	m_postProcessor.setColorTemperature(m_isApplyColorTemperature, m_colorTemperature, m_gamma);
 }
 
 void GrabManager::onSendDataOnlyIfColorsEnabledChanged(bool state)
@@ -360,6 +425,15 @@ void GrabManager::settingsProfileChanged(const QString &profileName)
 	m_isApplyColorTemperature = Settings::isGrabApplyColorTemperatureEnabled();
 	m_colorTemperature = Settings::getGrabColorTemperature();
 	m_gamma = Settings::getGrabGamma();
+	m_postProcessor.setColorTemperature(m_isApplyColorTemperature, m_colorTemperature, m_gamma);
+	m_postProcessor.setOverBrighten(m_overBrighten);
+
+	m_rateGovernor.setFastestInterval(Settings::getGrabAdaptiveRateFastest());
+	m_rateGovernor.setIdleInterval(Settings::getGrabAdaptiveRateIdle());
+	m_rateGovernor.setCpuBudget(Settings::getGrabAdaptiveRateCpuBudget());
+	m_rateGovernor.setBaseInterval(Settings::getGrabSlowdown());
+	m_rateGovernor.setEnabled(Settings::isGrabAdaptiveRateEnabled());
+	applyGrabInterval(m_rateGovernor.interval());
 
 	setNumberOfLeds(Settings::getNumberOfLeds(Settings::getConnectedDevice()));
 }
@@ -422,71 +496,25 @@ void GrabManager::handleGrabbedColors()
 		return;
 	}
 
-	// Work on a copy
-	m_colorsProcessing = m_colorsNew;
+	QElapsedTimer costTimer;
+	costTimer.start();
 
-	bool isColorsChanged = false;
-
-	int avgR = 0, avgG = 0, avgB = 0;
-	int countGrabEnabled = 0;
-
-	if (m_isApplyColorTemperature)
+	// Blue light reduction is applied by an external client, so it needs its own copy
+	const bool isBlueLightReduction = !m_isApplyColorTemperature && m_isApplyBlueLightReduction && m_blueLightClient;
+	if (isBlueLightReduction)
 	{
-		PrismatikMath::applyColorTemperature(m_colorsProcessing, m_colorTemperature, m_gamma);
-	}
-	else if (m_isApplyBlueLightReduction && m_blueLightClient)
+		m_colorsProcessing = m_colorsNew;
 		m_blueLightClient->apply(m_colorsProcessing, SettingsScope::Profile::Grab::GammaDefault);
-
-	if (m_avgColorsOnAllLeds)
-	{
-		for (int i = 0; i < m_ledWidgets.size(); i++)
-		{
-			if (m_ledWidgets[i]->isAreaEnabled())
-			{
-				avgR += qRed(m_colorsProcessing[i]);
-				avgG += qGreen(m_colorsProcessing[i]);
-				avgB += qBlue(m_colorsProcessing[i]);
-				countGrabEnabled++;
-			}
-		}
-		if (countGrabEnabled != 0)
-		{
-			avgR /= countGrabEnabled;
-			avgG /= countGrabEnabled;
-			avgB /= countGrabEnabled;
-		}
-		// Set one AVG color to all LEDs
-		for (int ledIndex = 0; ledIndex < m_ledWidgets.size(); ledIndex++)
-		{
-			if (m_ledWidgets[ledIndex]->isAreaEnabled())
-			{
-				m_colorsProcessing[ledIndex] = qRgb(avgR, avgG, avgB);
-			}
-		}
 	}
 
-	for (int i = 0; i < m_ledWidgets.size(); i++)
-	{
-		QRgb newColor = m_colorsProcessing[i];
-		if (m_overBrighten) {
-			int dRed = qRed(newColor);
-			int dGreen = qGreen(newColor);
-			int dBlue = qBlue(newColor);
-			int highest = qMax(dRed, qMax(dGreen, dBlue));
-			double scaleFactor = qMin((100 + 5 * m_overBrighten) / 100.0, 255.0 / highest);
-			newColor = qRgb(dRed * scaleFactor, dGreen * scaleFactor, dBlue * scaleFactor);
-		}
-
-		if (m_colorsCurrent[i] != newColor)
-		{
-			m_colorsCurrent[i] = newColor;
-			isColorsChanged = true;
-		}
-	}
+	// color temperature, average color, over-brighten and change detection in one pass
+	const bool isColorsChanged = m_postProcessor.process(
+		isBlueLightReduction ? m_colorsProcessing : m_colorsNew,
+		m_ledWidgets, m_avgColorsOnAllLeds, m_colorsCurrent);
 
 	if ((m_isSendDataOnlyIfColorsChanged == false) || isColorsChanged)
 	{
-		emit updateLedsColors(m_colorsCurrent);
+		sendLedsColors();
 	}
 
 	m_grabCountThisInterval++;
@@ -495,13 +523,25 @@ void GrabManager::handleGrabbedColors()
 	{
 		m_timerFakeGrab->start();
 	}
+
+	if (m_rateGovernor.isEnabled())
+	{
+		const int interval = m_rateGovernor.interval();
+		const qint64 frameCostNs = m_grabber->lastGrabCost() + costTimer.nsecsElapsed();
+		if (m_rateGovernor.update(m_colorsPreviousGrab, m_colorsNew, frameCostNs) != interval)
+		{
+			DEBUG_MID_LEVEL << Q_FUNC_INFO << "grab interval" << m_rateGovernor.interval() << "ms, motion" << m_rateGovernor.lastMotion();
+			applyGrabInterval(m_rateGovernor.interval());
+		}
+		m_colorsPreviousGrab = m_colorsNew;
+	}
 }
 
 void GrabManager::timeoutFakeGrab()
 {
 	if (m_isSendDataOnlyIfColorsChanged == false && m_isGrabbingStarted)
 	{
-		emit updateLedsColors(m_colorsCurrent);
+		sendLedsColors();
 	}
 	else
 	{
@@ -659,7 +699,7 @@ void GrabManager::initGrabbers()
 }
 
 GrabberBase *GrabManager::initGrabber(GrabberBase * grabber) {
-	QMetaObject::invokeMethod(grabber, "setGrabInterval", Qt::QueuedConnection, Q_ARG(int, Settings::getGrabSlowdown()));
+	QMetaObject::invokeMethod(grabber, "setGrabInterval", Qt::QueuedConnection, Q_ARG(int, m_rateGovernor.interval()));
 	bool isConnected = connect(grabber, &GrabberBase::frameGrabAttempted, this, &GrabManager::onFrameGrabAttempted, Qt::QueuedConnection);
 	Q_ASSERT_X(isConnected, "connecting grabber to grabManager", "failed");
 	Q_UNUSED(isConnected);
@@ -698,7 +738,7 @@ GrabberBase *GrabManager::queryGrabber(Grab::GrabberType grabberType)
 		result = m_grabbers[Grab::GrabberTypeQt];
 	}
 
-	result->setGrabInterval(Settings::getGrabSlowdown());
+	result->setGrabInterval(m_rateGovernor.interval());
 
 	return result;
 }
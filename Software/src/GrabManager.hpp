@@ -28,9 +28,12 @@
 #include <QtGui>
 
 #include "GrabberBase.hpp"
+#include "ColorPostProcessor.hpp"
+#include "GrabRateGovernor.hpp"
 #include "enums.hpp"
 
 class GrabberContext;
+class FrameMailbox;
 class TimeEvaluations;
 class D3D10Grabber;
 
@@ -46,6 +49,7 @@ public:
 
 signals:
 	void updateLedsColors(const QList<QRgb> & colors);
+	void ledsColorsPosted();
 	void ambilightTimeOfUpdatingColors(double ms);
 	void changeScreen();
 	void onSessionChange(int change);
@@ -58,6 +62,11 @@ public:
 	void setNumberOfLeds(int numberOfLeds);
 	void reset();
 
+	/*!
+		Colors go to \a mailbox followed by \a ledsColorsPosted() instead of \a updateLedsColors()
+	*/
+	void setFrameMailbox(FrameMailbox *mailbox);
+
 public slots:
 	void onGrabberTypeChanged(const Grab::GrabberType grabberType);
 	void onGrabSlowdownChanged(int ms);
@@ -67,6 +76,10 @@ public slots:
 	void onGrabApplyColorTemperatureChanged(bool state);
 	void onGrabColorTemperatureChanged(int value);
 	void onGrabGammaChanged(double value);
+	void onGrabAdaptiveRateEnabledChanged(bool state);
+	void onGrabAdaptiveRateFastestChanged(int ms);
+	void onGrabAdaptiveRateIdleChanged(int ms);
+	void onGrabAdaptiveRateCpuBudgetChanged(int percent);
 	void onSendDataOnlyIfColorsEnabledChanged(bool state);
 #ifdef D3D10_GRAB_SUPPORT
 	void onDx1011GrabberEnabledChanged(bool state);
@@ -103,6 +116,8 @@ private:
 	void clearColorsNew();
 	void clearColorsCurrent();
 	void initLedWidgets(int numberOfLeds);
+	void applyGrabInterval(int ms);
+	void sendLedsColors();
 
 private:
 	QList<GrabberBase*> m_grabbers;
@@ -125,6 +140,12 @@ private:
 	QList<QRgb> m_colorsCurrent;
 	QList<QRgb> m_colorsNew;
 	QList<QRgb> m_colorsProcessing;
+	QList<QRgb> m_colorsPreviousGrab;
+
+	GrabRateGovernor m_rateGovernor;
+	Grab::ColorPostProcessor m_postProcessor;
+
+	FrameMailbox *m_frameMailbox;
 
 	QRect m_screenSavedRect;
 	int m_screenSavedIndex;
@@ -0,0 +1,162 @@
+/*
+ * GrabRateGovernor.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#include <cstdlib>
+
+#include "GrabRateGovernor.hpp"
+#include "SettingsDefaults.hpp"
+
+using namespace SettingsScope;
+
+namespace {
+// mean per-LED change (0..255) at or below which the picture is considered static
+const int StillMotion = 2;
+// mean per-LED change at or above which the fastest interval is used
+const int FastMotion = 24;
+// static frames in a row before falling back to the idle interval
+const int StillFramesBeforeIdle = 10;
+}
+
+GrabRateGovernor::GrabRateGovernor()
+	: m_isEnabled(Profile::Grab::IsAdaptiveRateEnabledDefault)
+	, m_baseInterval(Profile::Grab::SlowdownDefault)
+	, m_fastestInterval(Profile::Grab::AdaptiveRateFastestDefault)
+	, m_idleInterval(Profile::Grab::AdaptiveRateIdleDefault)
+	, m_cpuBudget(Profile::Grab::AdaptiveRateCpuBudgetDefault)
+{
+	reset();
+}
+
+void GrabRateGovernor::setEnabled(bool isEnabled)
+{
+	m_isEnabled = isEnabled;
+	reset();
+}
+
+void GrabRateGovernor::setBaseInterval(int ms)
+{
+	m_baseInterval = qMax(1, ms);
+	reset();
+}
+
+void GrabRateGovernor::setFastestInterval(int ms)
+{
+	m_fastestInterval = qMax(1, ms);
+	m_interval = qBound(lowerBound(), m_interval, upperBound());
+}
+
+void GrabRateGovernor::setIdleInterval(int ms)
+{
+	m_idleInterval = qMax(1, ms);
+	m_interval = qBound(lowerBound(), m_interval, upperBound());
+}
+
+void GrabRateGovernor::setCpuBudget(int percent)
+{
+	m_cpuBudget = qBound(1, percent, 100);
+	m_interval = qBound(lowerBound(), m_interval, upperBound());
+}
+
+void GrabRateGovernor::reset()
+{
+	m_interval = m_baseInterval;
+	m_stillFrames = 0;
+	m_lastMotion = 0;
+	m_avgFrameCostNs = 0;
+}
+
+int GrabRateGovernor::interval() const
+{
+	return m_isEnabled ? m_interval : m_baseInterval;
+}
+
+int GrabRateGovernor::update(const QList<QRgb> &previous, const QList<QRgb> &current, qint64 frameCostNs)
+{
+	if (!m_isEnabled)
+		return m_baseInterval;
+
+	// smooth the cost over ~8 frames so one slow grab doesn't throttle the rate
+	if (m_avgFrameCostNs == 0)
+		m_avgFrameCostNs = frameCostNs;
+	else
+		m_avgFrameCostNs = (m_avgFrameCostNs * 7 + frameCostNs) / 8;
+
+	m_lastMotion = motion(previous, current);
+
+	const int fastest = qMin(m_fastestInterval, m_baseInterval);
+	int target;
+	if (m_lastMotion <= StillMotion) {
+		if (++m_stillFrames >= StillFramesBeforeIdle)
+			target = qMax(m_idleInterval, m_baseInterval);
+		else
+			target = m_interval;
+	} else {
+		m_stillFrames = 0;
+		if (m_lastMotion >= FastMotion)
+			target = fastest;
+		else
+			target = m_baseInterval - (m_baseInterval - fastest) * (m_lastMotion - StillMotion) / (FastMotion - StillMotion);
+	}
+
+	// speed up at once, slow down by at most 25% per frame
+	if (target < m_interval)
+		m_interval = target;
+	else
+		m_interval = qMin(target, m_interval + qMax(1, m_interval / 4));
+
+	m_interval = qBound(lowerBound(), m_interval, upperBound());
+	return m_interval;
+}
+
+int GrabRateGovernor::motion(const QList<QRgb> &previous, const QList<QRgb> &current)
+{
+	if (previous.size() != current.size())
+		return 255;
+	if (current.isEmpty())
+		return 0;
+
+	int sum = 0;
+	for (int i = 0; i < current.size(); ++i) {
+		const QRgb a = previous[i];
+		const QRgb b = current[i];
+		const int dr = std::abs(qRed(a) - qRed(b));
+		const int dg = std::abs(qGreen(a) - qGreen(b));
+		const int db = std::abs(qBlue(a) - qBlue(b));
+		sum += qMax(dr, qMax(dg, db));
+	}
+	return sum / current.size();
+}
+
+int GrabRateGovernor::lowerBound() const
+{
+	const int fastest = qMin(m_fastestInterval, m_baseInterval);
+	// cost / interval <= budget  =>  interval >= cost * 100 / budget
+	const qint64 budgetNs = m_avgFrameCostNs * 100 / m_cpuBudget;
+	const int budgetMs = static_cast<int>((budgetNs + 999999) / 1000000);
+	return qMax(fastest, budgetMs);
+}
+
+int GrabRateGovernor::upperBound() const
+{
+	return qMax(lowerBound(), qMax(m_idleInterval, m_baseInterval));
+}
@@ -0,0 +1,80 @@
+/*
+ * GrabRateGovernor.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QList>
+#include <QRgb>
+
+/*!
+	Picks the grab interval from what is happening on screen.
+	Fast motion pulls the interval down to \a fastestInterval, a static picture lets it
+	drift up to \a idleInterval, and the averaged per-frame cost never takes more than
+	\a cpuBudget percent of the interval.
+*/
+class GrabRateGovernor
+{
+public:
+	GrabRateGovernor();
+
+	void setEnabled(bool isEnabled);
+	bool isEnabled() const { return m_isEnabled; }
+
+	void setBaseInterval(int ms);
+	void setFastestInterval(int ms);
+	void setIdleInterval(int ms);
+	void setCpuBudget(int percent);
+
+	void reset();
+
+	/*!
+		Feeds one grabbed frame to the governor.
+		\param previous colors of the previous frame
+		\param current colors of this frame
+		\param frameCostNs time spent grabbing and processing this frame
+		\return interval (ms) the grabber should use from now on
+	*/
+	int update(const QList<QRgb> &previous, const QList<QRgb> &current, qint64 frameCostNs);
+
+	int interval() const;
+	int lastMotion() const { return m_lastMotion; }
+
+	/*!
+		Mean of the largest per-channel difference of each LED, 0..255
+	*/
+	static int motion(const QList<QRgb> &previous, const QList<QRgb> &current);
+
+private:
+	int lowerBound() const;
+	int upperBound() const;
+
+	bool m_isEnabled;
+	int m_baseInterval;
+	int m_fastestInterval;
+	int m_idleInterval;
+	int m_cpuBudget;
+
+	int m_interval;
+	int m_stillFrames;
+	int m_lastMotion;
+	qint64 m_avgFrameCostNs;
+};
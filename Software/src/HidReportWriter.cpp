@@ -0,0 +1,173 @@
+/*
+ * HidReportWriter.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "HidReportWriter.hpp"
+#include <QThread>
+#include <string.h>
+
+class HidReportWriter::Worker : public QThread
+{
+public:
+	Worker(HidReportWriter *writer, int device, quint64 generation)
+		: m_writer(writer)
+		, m_device(device)
+		, m_generation(generation)
+	{
+	}
+
+protected:
+	void run() override
+	{
+		m_writer->runWorker(m_device, m_generation);
+	}
+
+private:
+	HidReportWriter *m_writer;
+	const int m_device;
+	const quint64 m_generation;
+};
+
+void HidReportWriter::encodeColors(const QList<StructRgb> &colors, unsigned char *reports)
+{
+	const int kLedRemap[] = {4, 3, 0, 1, 2, 5, 6, 7, 8, 9};
+	const size_t kSizeOfLedColor = 6;
+
+	memset(reports, 0, reportsCount(colors.count()) * ReportSize);
+
+	for (int i = 0; i < colors.count(); i++)
+	{
+		const StructRgb color = colors[i];
+
+		unsigned char *report = reports + i / LedsPerReport * ReportSize;
+		int buffIndex = DataIndex + kLedRemap[i % LedsPerReport] * kSizeOfLedColor;
+
+		// Send main 8 bits for compability with existing devices
+		report[buffIndex++] = (color.r & 0x0FF0) >> 4;
+		report[buffIndex++] = (color.g & 0x0FF0) >> 4;
+		report[buffIndex++] = (color.b & 0x0FF0) >> 4;
+
+		// Send over 4 bits for devices revision >= 6
+		// All existing devices ignore it
+		report[buffIndex++] = (color.r & 0x000F);
+		report[buffIndex++] = (color.g & 0x000F);
+		report[buffIndex++] = (color.b & 0x000F);
+	}
+}
+
+HidReportWriter::HidReportWriter(Backend &backend)
+	: m_backend(backend)
+{
+}
+
+HidReportWriter::~HidReportWriter()
+{
+	stopWorkers();
+}
+
+void HidReportWriter::setDevices(const QList<hid_device*> &devices)
+{
+	stopWorkers();
+
+	m_devices = devices;
+	m_reports.fill(0, devices.count() * ReportSize);
+	m_isWritten.fill(false, devices.count());
+
+	// the generation is passed in, a worker started late must not miss the first write
+	m_isStopping = false;
+	for (int i = 1; i < devices.count(); i++) {
+		QThread *worker = new Worker(this, i, m_generation);
+		worker->start(QThread::HighPriority);
+		m_workers.append(worker);
+	}
+}
+
+bool HidReportWriter::writeReports(int devices)
+{
+	devices = qMin(devices, m_devices.count());
+	if (devices <= 0)
+		return true;
+
+	if (devices > 1) {
+		QMutexLocker locker(&m_mutex);
+		m_devicesToWrite = devices;
+		// every worker wakes up, the ones above \a devices go back to sleep
+		m_pending = m_workers.count();
+		++m_generation;
+		m_workReady.wakeAll();
+	}
+
+	const bool isFirstWritten = writeReport(0);
+
+	QMutexLocker locker(&m_mutex);
+	while (m_pending > 0)
+		m_allWritten.wait(&m_mutex);
+	m_isWritten[0] = isFirstWritten;
+
+	bool ok = true;
+	for (int i = 0; i < devices; i++)
+		ok &= m_isWritten[i];
+	return ok;
+}
+
+void HidReportWriter::stopWorkers()
+{
+	{
+		QMutexLocker locker(&m_mutex);
+		m_isStopping = true;
+		m_workReady.wakeAll();
+	}
+	for (QThread *worker : m_workers) {
+		worker->wait();
+		delete worker;
+	}
+	m_workers.clear();
+}
+
+void HidReportWriter::runWorker(int device, quint64 generation)
+{
+	QMutexLocker locker(&m_mutex);
+	forever {
+		while (m_generation == generation && !m_isStopping)
+			m_workReady.wait(&m_mutex);
+		if (m_isStopping)
+			return;
+		generation = m_generation;
+
+		if (device < m_devicesToWrite) {
+			locker.unlock();
+			const bool ok = writeReport(device);
+			locker.relock();
+			m_isWritten[device] = ok;
+		}
+		if (--m_pending == 0)
+			m_allWritten.wakeAll();
+	}
+}
+
+bool HidReportWriter::writeReport(int device)
+{
+	const unsigned char *data = reinterpret_cast<const unsigned char *>(m_reports.constData()) + device * ReportSize;
+	if (m_backend.write(m_devices[device], data, ReportSize) >= 0)
+		return true;
+	// Trying to repeat sending data:
+	return m_backend.write(m_devices[device], data, ReportSize) >= 0;
+}
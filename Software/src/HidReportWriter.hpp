@@ -0,0 +1,108 @@
+/*
+ * HidReportWriter.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include "hidapi.h"
+#include "colorspace_types.h"
+
+class QThread;
+
+/*!
+	Writes one HID report to each of several devices at the same time.
+	Every device but the first has a writer thread, the calling thread writes the first
+	report itself and writeReports() returns once all are written, so a frame takes one
+	USB transaction however many devices there are. Reports live in preallocated buffers
+	filled through report().
+*/
+class HidReportWriter
+{
+public:
+	// where the reports go, hidapi in the application and a mock in tests
+	class Backend
+	{
+	public:
+		virtual ~Backend() {}
+		// as hid_write(): bytes written or -1, may be called from several threads at once
+		virtual int write(hid_device *device, const unsigned char *data, size_t length) = 0;
+	};
+
+	// report id and 64 bytes of data
+	constexpr static const int ReportSize = 65;
+	constexpr static const int CommandIndex = 1;
+	constexpr static const int DataIndex = 2;
+	// LEDs in the report of one Lightpack
+	constexpr static const int LedsPerReport = 10;
+
+	static int reportsCount(int ledsCount) { return (ledsCount + LedsPerReport - 1) / LedsPerReport; }
+
+	/*!
+		Clears the reports and writes 12 bit \a colors in the Lightpack layout, the report
+		id and the command are left to the caller. \a reports holds reportsCount() reports.
+	*/
+	static void encodeColors(const QList<StructRgb> &colors, unsigned char *reports);
+
+	explicit HidReportWriter(Backend &backend);
+	~HidReportWriter();
+
+	/*!
+		Starts a writer thread per device after the first one, all reports are cleared.
+	*/
+	void setDevices(const QList<hid_device*> &devices);
+	int count() const { return m_devices.count(); }
+
+	unsigned char * report(int device) { return reinterpret_cast<unsigned char *>(m_reports.data()) + device * ReportSize; }
+
+	/*!
+		Writes the reports of the first \a devices devices, each retried once on error.
+		\return true if all were written, see isWritten() otherwise
+	*/
+	bool writeReports(int devices);
+	bool isWritten(int device) const { return m_isWritten[device]; }
+
+private:
+	class Worker;
+
+	void stopWorkers();
+	void runWorker(int device, quint64 generation);
+	bool writeReport(int device);
+
+	Backend &m_backend;
+	QList<hid_device*> m_devices;
+	QByteArray m_reports;
+	QVector<bool> m_isWritten;
+	QList<QThread*> m_workers;
+
+	// guards everything below, workers wait for a new generation, the caller for m_pending 0
+	QMutex m_mutex;
+	QWaitCondition m_workReady;
+	QWaitCondition m_allWritten;
+	quint64 m_generation{0};
+	int m_devicesToWrite{0};
+	int m_pending{0};
+	bool m_isStopping{false};
+};
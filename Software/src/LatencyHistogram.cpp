@@ -0,0 +1,92 @@
+/*
+ * LatencyHistogram.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "LatencyHistogram.hpp"
+#include <QtAlgorithms>
+#include <math.h>
+#include <string.h>
+
+LatencyHistogram::LatencyHistogram()
+{
+	reset();
+}
+
+void LatencyHistogram::reset()
+{
+	memset(m_buckets, 0, sizeof(m_buckets));
+	m_count = 0;
+	m_sum = 0;
+	m_min = 0;
+	m_max = 0;
+}
+
+int LatencyHistogram::bucket(qint64 ns)
+{
+	if (ns < SubBuckets)
+		return ns < 0 ? 0 : (int)ns;
+
+	const int exponent = 63 - qCountLeadingZeroBits((quint64)ns);
+	if (exponent >= MaxExponent)
+		return BucketsCount - 1;
+	const int subBucket = (int)(ns >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+	return (exponent - SubBucketBits + 1) * SubBuckets + subBucket;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int bucket)
+{
+	if (bucket < SubBuckets)
+		return bucket;
+
+	const int exponent = bucket / SubBuckets + SubBucketBits - 1;
+	const qint64 subBucket = bucket % SubBuckets;
+	const int shift = exponent - SubBucketBits;
+	return ((SubBuckets + subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::add(qint64 ns)
+{
+	if (ns < 0)
+		ns = 0;
+	m_buckets[bucket(ns)]++;
+	if (m_count == 0 || ns < m_min)
+		m_min = ns;
+	if (ns > m_max)
+		m_max = ns;
+	m_count++;
+	m_sum += ns;
+}
+
+qint64 LatencyHistogram::percentile(double fraction) const
+{
+	if (m_count == 0)
+		return 0;
+
+	const quint64 rank = qBound<quint64>(1, (quint64)ceil(fraction * m_count), m_count);
+	quint64 seen = 0;
+	for (int i = 0; i < BucketsCount; i++) {
+		seen += m_buckets[i];
+		if (seen >= rank)
+			return qMin(bucketUpperBound(i), m_max);
+	}
+	return m_max;
+}
@@ -0,0 +1,70 @@
+/*
+ * LatencyHistogram.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QtGlobal>
+
+/*!
+	Histogram of durations in nanoseconds with a fixed memory footprint.
+	Each power of two is split into SubBuckets buckets, so a percentile is off by at most
+	1/SubBuckets of its value, whatever the range. Adding a sample is a few instructions
+	and never allocates.
+*/
+class LatencyHistogram
+{
+public:
+	constexpr static const int SubBucketBits = 3;
+	constexpr static const int SubBuckets = 1 << SubBucketBits;
+	// durations of 2^MaxExponent ns (about 18 minutes) and above share the last bucket
+	constexpr static const int MaxExponent = 40;
+	constexpr static const int BucketsCount = (MaxExponent - SubBucketBits + 1) * SubBuckets;
+
+	LatencyHistogram();
+
+	void add(qint64 ns);
+	void reset();
+
+	quint64 count() const { return m_count; }
+	qint64 min() const { return m_count ? m_min : 0; }
+	qint64 max() const { return m_max; }
+	double mean() const { return m_count ? (double)m_sum / m_count : 0.0; }
+
+	/*!
+		\param fraction 0..1, e.g. 0.99 for the 99th percentile
+		\return the largest duration of the bucket holding that sample, at most max()
+	*/
+	qint64 percentile(double fraction) const;
+
+	// samples in the bucket, and the largest duration the bucket holds
+	quint64 bucketCount(int bucket) const { return m_buckets[bucket]; }
+	static qint64 bucketUpperBound(int bucket);
+	static int bucket(qint64 ns);
+
+private:
+	quint64 m_buckets[BucketsCount];
+	quint64 m_count;
+	quint64 m_sum;
+	qint64 m_min;
+	qint64 m_max;
+};
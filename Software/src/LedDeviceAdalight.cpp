@@ -47,6 +47,8 @@ LedDeviceAdalight::LedDeviceAdalight(const QString &portName, const int baudRate
 	m_lastWillTimer = new QTimer(this);
 	m_lastWillTimer->setTimerType(Qt::PreciseTimer);
 	connect(m_lastWillTimer, &QTimer::timeout, this, qOverload<>(&LedDeviceAdalight::writeLastWill));
+	m_pacer.setBaudRate(baudRate);
+	m_clock.start();
 	// TODO: think about init m_savedColors in all ILedDevices
 
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << "initialized";
@@ -68,7 +70,7 @@ void LedDeviceAdalight::close()
 	if (m_AdalightDevice == NULL)
 		return;
 
-	if (m_lastWillTimer->isActive()) {
+	if (m_pacer.isFrameDeferred()) {
 		m_lastWillTimer->stop();
 		writeLastWill(true);
 	}
@@ -83,59 +85,21 @@ void LedDeviceAdalight::setColors(const QList<QRgb> & colors)
 	// Save colors for showing changes of the brightness
 	m_colorsSaved = colors;
 
+	bool ok = writeColors(colors);
+	emit commandCompleted(ok);
+}
+
+bool LedDeviceAdalight::writeColors(const QList<QRgb> & colors)
+{
 	resizeColorsBuffer(colors.count());
 
 	applyColorModifications(colors, m_colorsBuffer);
 	applyDithering(m_colorsBuffer, 8);
 
-	m_writeBuffer.clear();
-	m_writeBuffer.append(m_writeBufferHeader);
-
-	for (int i = 0; i < m_colorsBuffer.count(); i++)
-	{
-		StructRgb color = m_colorsBuffer[i];
-
-		if (m_colorSequence == QStringLiteral("RBG"))
-		{
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.g);
-		}
-		else if (m_colorSequence == QStringLiteral("BRG"))
-		{
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.g);
-		}
-		else if (m_colorSequence == QStringLiteral("BGR"))
-		{
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.r);
-		}
-		else if (m_colorSequence == QStringLiteral("GRB"))
-		{
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.b);
-		}
-		else if (m_colorSequence == QStringLiteral("GBR"))
-		{
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.r);
-		}
-		else
-		{
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.b);
-		}
-	}
-
-	bool ok = writeBuffer(m_writeBuffer);
-
-	emit commandCompleted(ok);
+	const QByteArray &frame = m_encoder.encode(m_colorsBuffer);
+	if (m_isDeltaFramesEnabled)
+		return writeBuffer(m_deltaEncoder.encode(frame.constData() + m_writeBufferHeader.size(), m_colorsBuffer.count()));
+	return writeBuffer(frame);
 }
 
 void LedDeviceAdalight::switchOffLeds()
@@ -155,6 +119,8 @@ void LedDeviceAdalight::switchOffLeds()
 						.append((char)0);
 	}
 
+	// a classic frame replaces whatever the receiver had
+	m_deltaEncoder.reset();
 	bool ok = writeBuffer(m_writeBuffer);
 	emit commandCompleted(ok);
 }
@@ -179,6 +145,7 @@ void LedDeviceAdalight::setColorSequence(const QString& value)
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
 
 	m_colorSequence = value;
+	m_encoder.setColorSequence(value);
 	setColors(m_colorsSaved);
 }
 
@@ -193,9 +160,39 @@ void LedDeviceAdalight::updateDeviceSettings()
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
 	AbstractLedDevice::updateDeviceSettings();
+	setDeltaFramesEnabled(Settings::isAdalightDeltaFramesEnabled());
+	setAckEnabled(Settings::isAdalightAckEnabled());
 	setColorSequence(Settings::getColorSequence(SupportedDevices::DeviceTypeAdalight));
 }
 
+void LedDeviceAdalight::setDeltaFramesEnabled(bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << isEnabled;
+
+	m_isDeltaFramesEnabled = isEnabled;
+	m_deltaEncoder.reset();
+}
+
+void LedDeviceAdalight::setAckEnabled(bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << isEnabled;
+
+	m_pacer.setAckEnabled(isEnabled);
+}
+
+void LedDeviceAdalight::readAck()
+{
+	// any byte from the controller acknowledges the frame on the line
+	if (m_AdalightDevice->readAll().isEmpty() || !m_pacer.isAwaitingAck())
+		return;
+
+	m_pacer.ackReceived();
+	if (m_pacer.isFrameDeferred()) {
+		m_lastWillTimer->stop();
+		writeLastWill(false);
+	}
+}
+
 void LedDeviceAdalight::open()
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << sender();
@@ -205,12 +202,18 @@ void LedDeviceAdalight::open()
 
 	if (m_AdalightDevice != NULL)
 		m_AdalightDevice->close();
-	else
+	else {
 		m_AdalightDevice = new QSerialPort();
+		connect(m_AdalightDevice, &QSerialPort::readyRead, this, &LedDeviceAdalight::readAck);
+		connect(m_AdalightDevice, &QSerialPort::bytesWritten, this, &LedDeviceAdalight::portBytesWritten);
+	}
 
+	m_deltaEncoder.reset();
+	m_pacer.reset();
 	m_AdalightDevice->setPortName(m_portName);// Settings::getAdalightSerialPortName());
 
-	m_AdalightDevice->open(QIODevice::WriteOnly);
+	// read back for acks; without them incoming bytes are just discarded
+	m_AdalightDevice->open(QIODevice::ReadWrite);
 	bool ok = m_AdalightDevice->isOpen();
 
 	// Ubuntu 10.04: on every second attempt to open the device leads to failure
@@ -218,7 +221,7 @@ void LedDeviceAdalight::open()
 	{
 		qWarning() << Q_FUNC_INFO << "Serial device" << m_AdalightDevice->portName() << "open fail, will retry. Error" << (int)m_AdalightDevice->error() << m_AdalightDevice->errorString();
 		// Try one more time
-		m_AdalightDevice->open(QIODevice::WriteOnly);
+		m_AdalightDevice->open(QIODevice::ReadWrite);
 		ok = m_AdalightDevice->isOpen();
 	}
 
@@ -255,6 +258,13 @@ void LedDeviceAdalight::open()
 	emit openDeviceSuccess(ok);
 }
 
+void LedDeviceAdalight::portBytesWritten()
+{
+	// the port buffer was all that held the deferred frame back
+	if (m_pacer.isFrameDeferred() && !m_lastWillTimer->isActive())
+		writeLastWill(false);
+}
+
 void LedDeviceAdalight::writeLastWill()
 {
 	writeLastWill(false);
@@ -262,10 +272,11 @@ void LedDeviceAdalight::writeLastWill()
 
 void LedDeviceAdalight::writeLastWill(const bool force)
 {
-	if (force || m_AdalightDevice->bytesToWrite() == 0) {
-		DEBUG_MID_LEVEL << Q_FUNC_INFO << "Writing last will frame";
-		setColors(m_colorsSaved);
-	}
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << "Writing last will frame";
+	if (force)
+		m_pacer.reset();
+	// not a command, nothing to complete
+	writeColors(m_colorsSaved);
 }
 
 bool LedDeviceAdalight::writeBuffer(const QByteArray & buff)
@@ -275,17 +286,24 @@ bool LedDeviceAdalight::writeBuffer(const QByteArray & buff)
 	if (m_AdalightDevice == NULL || m_AdalightDevice->isOpen() == false)
 		return false;
 
-	if (m_AdalightDevice->bytesToWrite() > 0) {
-		DEBUG_MID_LEVEL << Q_FUNC_INFO << "Serial bytesToWrite:" << m_AdalightDevice->bytesToWrite() << ", skipping current frame";
-		// If no more writes will be done ("Send data only of colors changed")
-		// re-schedule last skipped frame in case it's important (for ex a black frame to turn off)
-		using namespace std::chrono_literals;
-		m_lastWillTimer->start(100ms);
+	const qint64 nowNs = m_clock.nsecsElapsed();
+	const int retryMs = m_pacer.offerFrame(nowNs, m_AdalightDevice->bytesToWrite());
+	if (retryMs != 0) {
+		DEBUG_MID_LEVEL << Q_FUNC_INFO << "Serial line busy, retry in" << retryMs << "ms, skipping current frame";
+		// Keep at most one frame on the wire and send the latest skipped one as soon as
+		// the line is free, also in case no more writes come ("Send data only if colors changed")
+		if (retryMs == SerialFramePacer::RetryOnBytesWritten)
+			m_lastWillTimer->stop(); // see portBytesWritten()
+		else
+			m_lastWillTimer->start(std::chrono::milliseconds(retryMs));
+		// the receiver's colors no longer match what the next delta is based on
+		m_deltaEncoder.reset();
 		return true;
 	}
 	m_lastWillTimer->stop();
 
 	int bytesWritten = m_AdalightDevice->write(buff);
+	m_pacer.frameWritten(buff.count(), nowNs);
 
 	if (bytesWritten != buff.count())
 	{
@@ -322,16 +340,24 @@ void LedDeviceAdalight::resizeColorsBuffer(int buffSize)
 
 void LedDeviceAdalight::reinitBufferHeader(int ledsCount)
 {
-	m_writeBufferHeader.clear();
+	m_writeBufferHeader = frameHeader(ledsCount);
+
+	m_encoder.setHeader(m_writeBufferHeader);
+	m_encoder.reserve(ledsCount);
+}
+
+QByteArray LedDeviceAdalight::frameHeader(int ledsCount)
+{
+	QByteArray header;
 
-	// Initialize buffer header
 	int ledsCountHi = ((ledsCount - 1) >> 8) & 0xff;
 	int ledsCountLo = (ledsCount	- 1) & 0xff;
 
-	m_writeBufferHeader.append((char)'A');
-	m_writeBufferHeader.append((char)'d');
-	m_writeBufferHeader.append((char)'a');
-	m_writeBufferHeader.append((char)ledsCountHi);
-	m_writeBufferHeader.append((char)ledsCountLo);
-	m_writeBufferHeader.append((char)(ledsCountHi ^ ledsCountLo ^ 0x55));
+	header.append((char)'A');
+	header.append((char)'d');
+	header.append((char)'a');
+	header.append((char)ledsCountHi);
+	header.append((char)ledsCountLo);
+	header.append((char)(ledsCountHi ^ ledsCountLo ^ 0x55));
+	return header;
 }
@@ -28,6 +28,10 @@
 
 #include "AbstractLedDevice.hpp"
 #include "colorspace_types.h"
+#include "LedWireEncoder.hpp"
+#include "AdalightDeltaCodec.hpp"
+#include "SerialFramePacer.hpp"
+#include <QElapsedTimer>
 #include <QtSerialPort/QSerialPort>
 
 class LedDeviceAdalight : public AbstractLedDevice
@@ -40,6 +44,9 @@ public:
 	int maxLedsCount();
 	virtual int defaultLedsCount() { return 25; }
 
+	// "Ada", the LED count - 1 and its checksum
+	static QByteArray frameHeader(int ledsCount);
+
 public slots:
 	void open();
 	void close();
@@ -53,8 +60,15 @@ public slots:
 	void updateDeviceSettings();
 	void writeLastWill();
 	void writeLastWill(const bool force);
+	void setDeltaFramesEnabled(bool isEnabled);
+	void setAckEnabled(bool isEnabled);
+
+private slots:
+	void readAck();
+	void portBytesWritten();
 
 private:
+	bool writeColors(const QList<QRgb> & colors);
 	bool writeBuffer(const QByteArray & buff);
 	void resizeColorsBuffer(int buffSize);
 	void reinitBufferHeader(int ledsCount);
@@ -64,6 +78,12 @@ private:
 
 	QByteArray m_writeBufferHeader;
 	QByteArray m_writeBuffer;
+	LedWireEncoder m_encoder;
+	// extended "Adz" frames, see AdalightDeltaCodec.hpp
+	AdalightDeltaEncoder m_deltaEncoder;
+	bool m_isDeltaFramesEnabled{false};
+	SerialFramePacer m_pacer;
+	QElapsedTimer m_clock;
 	QString m_portName;
 	int m_baudRate;
 	QTimer* m_lastWillTimer{nullptr};
@@ -0,0 +1,246 @@
+/*
+ * LedDeviceAdaptiveUdp.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstring>
+#include <limits>
+
+#include "LedDeviceAdaptiveUdp.hpp"
+#include "enums.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ADAPTIVE_UDP_SSE2
+#endif
+
+namespace {
+const int HeaderSize = 2;
+const int DnrgbHeaderSize = 4;
+
+// index of the first byte from \a from on where \a a and \a b differ, \a size if none
+int nextDifference(const char *a, const char *b, int from, const int size)
+{
+	int i = from;
+#ifdef ADAPTIVE_UDP_SSE2
+	for (; i + 16 <= size; i += 16) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+		const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+		const uint equal = (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+		if (equal != 0xffff)
+			return i + qCountTrailingZeroBits(~equal);
+	}
+#else
+	for (; i + 8 <= size; i += 8) {
+		quint64 x, y;
+		memcpy(&x, a + i, sizeof(x));
+		memcpy(&y, b + i, sizeof(y));
+		if (x != y)
+			break;
+	}
+#endif
+	for (; i < size; i++) {
+		if (a[i] != b[i])
+			return i;
+	}
+	return size;
+}
+
+int dnrgbCost(int count)
+{
+	const int packets = (count + LedDeviceAdaptiveUdp::DnrgbLedsPerPacket - 1) / LedDeviceAdaptiveUdp::DnrgbLedsPerPacket;
+	return packets * (LedDeviceAdaptiveUdp::PacketOverhead + DnrgbHeaderSize) + count * 3;
+}
+}
+
+LedDeviceAdaptiveUdp::LedDeviceAdaptiveUdp(const QString& address, const QString& port, const uint8_t timeout, const int refreshInterval, QObject * parent)
+	: AbstractLedDeviceUdp(address, port, timeout, parent)
+	, m_refreshInterval(refreshInterval)
+{
+}
+
+QString LedDeviceAdaptiveUdp::name() const
+{
+	return QStringLiteral("adaptiveudp");
+}
+
+int LedDeviceAdaptiveUdp::maxLedsCount()
+{
+	return MaximumNumberOfLeds::AdaptiveUdp;
+}
+
+void LedDeviceAdaptiveUdp::setColors(const QList<QRgb> & colors, const bool rawColors)
+{
+	bool ok = true;
+
+	resizeColorsBuffer(colors.count());
+
+	applyColorModifications(colors, m_colorsBuffer, rawColors);
+	if (!rawColors)
+		applyDithering(m_colorsBuffer, 8);
+
+	const int totalColors = m_colorsBuffer.count();
+	m_frame.resize(totalColors * 3);
+	char *out = m_frame.data();
+	for (const StructRgb &color : m_colorsBuffer) {
+		*out++ = (char)color.r;
+		*out++ = (char)color.g;
+		*out++ = (char)color.b;
+	}
+
+	const bool isRefresh = m_sent.size() != m_frame.size()
+		|| !m_refreshTimer.isValid()
+		|| (m_refreshInterval > 0 && m_refreshTimer.hasExpired(m_refreshInterval));
+	m_spans.clear();
+	if (isRefresh) {
+		m_spans.append({ 0, totalColors });
+		m_sent.resize(m_frame.size());
+		m_refreshTimer.start();
+	} else {
+		findSpans();
+	}
+
+	int allDnrgbCost = 0;
+	// WARLS only sends what differs from m_sent, a refresh must not rely on it
+	int mixedCost = isRefresh ? std::numeric_limits<int>::max() : 0;
+	if (!isRefresh && m_changedWarlsLeds > 0)
+		mixedCost += PacketOverhead + HeaderSize + m_changedWarlsLeds * 4;
+	for (const Span &span : m_spans) {
+		allDnrgbCost += dnrgbCost(span.count);
+		const int first = qMax(span.first, (int)MaximumNumberOfLeds::Warls);
+		const int end = span.first + span.count;
+		if (!isRefresh && end > first)
+			mixedCost += dnrgbCost(end - first);
+	}
+	const int drgbCost = totalColors <= MaximumNumberOfLeds::Drgb
+		? PacketOverhead + HeaderSize + totalColors * 3
+		: std::numeric_limits<int>::max();
+
+	beginPackets();
+	if (m_spans.isEmpty()) {
+		// if no packets are sent, send empty packet to not timeout
+		if (m_timeout != InfiniteTimeout)
+			ok &= writeWarls(0);
+	} else if (drgbCost <= allDnrgbCost && drgbCost <= mixedCost) {
+		ok &= writeDrgb();
+	} else if (mixedCost < allDnrgbCost) {
+		ok &= writeWarls(MaximumNumberOfLeds::Warls);
+		for (const Span &span : m_spans) {
+			const int first = qMax(span.first, (int)MaximumNumberOfLeds::Warls);
+			const int end = span.first + span.count;
+			if (end > first)
+				ok &= writeDnrgb(first, end - first);
+		}
+	} else {
+		for (const Span &span : m_spans)
+			ok &= writeDnrgb(span.first, span.count);
+	}
+	ok &= flushPackets();
+
+	memcpy(m_sent.data(), m_frame.constData(), m_frame.size());
+	m_colorsSaved = colors;
+
+	emit commandCompleted(ok);
+}
+
+void LedDeviceAdaptiveUdp::findSpans()
+{
+	const char *current = m_frame.constData();
+	const char *sent = m_sent.constData();
+	const int size = m_frame.size();
+	const int totalColors = size / 3;
+
+	m_changedWarlsLeds = 0;
+	int led = nextDifference(current, sent, 0, size) / 3;
+	while (led < totalColors) {
+		const int first = led;
+		int last;
+		do {
+			last = led;
+			if (led < MaximumNumberOfLeds::Warls)
+				m_changedWarlsLeds++;
+			led = nextDifference(current, sent, (led + 1) * 3, size) / 3;
+		} while (led < totalColors && led - last - 1 <= MaxGap);
+		m_spans.append({ first, last - first + 1 });
+	}
+}
+
+bool LedDeviceAdaptiveUdp::writeDrgb()
+{
+	m_packet.resize(HeaderSize + m_frame.size());
+	char *out = m_packet.data();
+	*out++ = (char)UdpDevice::Drgb;
+	*out++ = (char)m_timeout;
+	memcpy(out, m_frame.constData(), m_frame.size());
+	return writeBuffer(m_packet);
+}
+
+bool LedDeviceAdaptiveUdp::writeDnrgb(int first, int count)
+{
+	bool ok = true;
+	while (count > 0) {
+		const int leds = qMin(count, (int)DnrgbLedsPerPacket);
+		m_packet.resize(DnrgbHeaderSize + leds * 3);
+		char *out = m_packet.data();
+		*out++ = (char)UdpDevice::Dnrgb;
+		*out++ = (char)m_timeout;
+		*out++ = (char)(first >> 8);
+		*out++ = (char)(first & 0xff);
+		memcpy(out, m_frame.constData() + first * 3, leds * 3);
+		ok &= writeBuffer(m_packet);
+		first += leds;
+		count -= leds;
+	}
+	return ok;
+}
+
+bool LedDeviceAdaptiveUdp::writeWarls(int end)
+{
+	const char *current = m_frame.constData();
+	const char *sent = m_sent.constData();
+	end = qMin(end, m_frame.size() / 3);
+
+	m_packet.resize(HeaderSize + end * 4);
+	char *out = m_packet.data();
+	*out++ = (char)UdpDevice::Warls;
+	*out++ = (char)m_timeout;
+	for (const Span &span : m_spans) {
+		const int spanEnd = qMin(span.first + span.count, end);
+		for (int i = span.first; i < spanEnd; i++) {
+			if (memcmp(current + i * 3, sent + i * 3, 3) == 0)
+				continue;
+			*out++ = (char)i;
+			memcpy(out, current + i * 3, 3);
+			out += 3;
+		}
+	}
+	m_packet.resize(out - m_packet.constData());
+	return writeBuffer(m_packet);
+}
+
+void LedDeviceAdaptiveUdp::reinitBufferHeader()
+{
+	m_writeBufferHeader.clear();
+	m_sent.clear();
+
+	// the largest packet is a whole DRGB frame
+	m_packet.reserve(HeaderSize + MaximumNumberOfLeds::Drgb * 3);
+	m_batchSender.reserve((maxLedsCount() + DnrgbLedsPerPacket - 1) / DnrgbLedsPerPacket + 1, DnrgbHeaderSize + DnrgbLedsPerPacket * 3);
+}
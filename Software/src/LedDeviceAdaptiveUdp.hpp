@@ -0,0 +1,77 @@
+/*
+ * LedDeviceAdaptiveUdp.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "AbstractLedDeviceUdp.hpp"
+#include <QElapsedTimer>
+#include <QVector>
+
+/*!
+	WLED realtime UDP device choosing the protocol frame by frame.
+	Each frame is diffed against what the receiver shows and goes out as whichever of
+	DRGB (whole frame), DNRGB (spans of changed LEDs) or WARLS (single changed LEDs below
+	255) plus DNRGB costs the fewest bytes on the wire, IP and UDP headers included.
+	Every \a refreshInterval ms (0 for never) the whole frame is sent again in case packets
+	were lost.
+*/
+class LedDeviceAdaptiveUdp : public AbstractLedDeviceUdp
+{
+	Q_OBJECT
+public:
+	LedDeviceAdaptiveUdp(const QString& address, const QString& port, const uint8_t timeout, const int refreshInterval, QObject * parent = 0);
+	QString name() const;
+	int maxLedsCount();
+
+	// IPv4 and UDP headers, paid once per packet
+	constexpr static const int PacketOverhead = 28;
+	constexpr static const int DnrgbLedsPerPacket = 489;
+	// unchanged LEDs between two changed ones cost less than another DNRGB packet
+	constexpr static const int MaxGap = (PacketOverhead + 4) / 3;
+
+public slots:
+	void setColors(const QList<QRgb> & colors, const bool rawColors);
+
+protected:
+	virtual void reinitBufferHeader();
+
+private:
+	struct Span
+	{
+		int first;
+		int count;
+	};
+
+	void findSpans();
+	bool writeDrgb();
+	bool writeDnrgb(int first, int count);
+	bool writeWarls(int end);
+
+	// 8 bit RGB of this frame and of what the receiver shows
+	QByteArray m_frame;
+	QByteArray m_sent;
+	QByteArray m_packet;
+	QVector<Span> m_spans;
+	int m_changedWarlsLeds{0};
+	QElapsedTimer m_refreshTimer;
+	const int m_refreshInterval;
+};
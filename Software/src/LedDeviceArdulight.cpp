@@ -25,7 +25,6 @@
  */
 
 #include "LedDeviceArdulight.hpp"
-#include "PrismatikMath.hpp"
 #include "Settings.hpp"
 #include "debug.h"
 #include "stdio.h"
@@ -43,7 +42,10 @@ LedDeviceArdulight::LedDeviceArdulight(const QString &portName, const int baudRa
 //	m_gamma = Settings::getDeviceGamma();
 //	m_brightness = Settings::getDeviceBrightness();
 
-	m_writeBufferHeader.append((char)255);
+	m_writeBufferHeader = frameHeader();
+	m_encoder.setHeader(m_writeBufferHeader);
+	// 255 only starts a frame
+	m_encoder.setMaxValue(254);
 
 //	m_colorSequence = Settings::getColorSequence(SupportedDevices::DeviceTypeArdulight);
 	m_ArdulightDevice = NULL;
@@ -51,6 +53,8 @@ LedDeviceArdulight::LedDeviceArdulight(const QString &portName, const int baudRa
 	m_lastWillTimer = new QTimer(this);
 	m_lastWillTimer->setTimerType(Qt::PreciseTimer);
 	connect(m_lastWillTimer, &QTimer::timeout, this, qOverload<>(&LedDeviceArdulight::writeLastWill));
+	m_pacer.setBaudRate(baudRate);
+	m_clock.start();
 
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << "initialized";
 }
@@ -66,7 +70,7 @@ void LedDeviceArdulight::close()
 	if (m_ArdulightDevice == NULL)
 		return;
 
-	if (m_lastWillTimer->isActive()) {
+	if (m_pacer.isFrameDeferred()) {
 		m_lastWillTimer->stop();
 		writeLastWill(true);
 	}
@@ -83,63 +87,18 @@ void LedDeviceArdulight::setColors(const QList<QRgb> & colors)
 	// Save colors for showing changes of the brightness
 	m_colorsSaved = colors;
 
+	bool ok = writeColors(colors);
+	emit commandCompleted(ok);
+}
+
+bool LedDeviceArdulight::writeColors(const QList<QRgb> & colors)
+{
 	resizeColorsBuffer(colors.count());
 
 	applyColorModifications(colors, m_colorsBuffer);
 	applyDithering(m_colorsBuffer, 8);
 
-	for(int i=0; i < m_colorsBuffer.count(); i++) {
-		PrismatikMath::maxCorrection(254, m_colorsBuffer[i]);
-	}
-
-	m_writeBuffer.clear();
-	m_writeBuffer.append(m_writeBufferHeader);
-
-	for (int i = 0; i < m_colorsBuffer.count(); i++)
-	{
-		StructRgb color = m_colorsBuffer[i];
-
-		if (m_colorSequence == QStringLiteral("RBG"))
-		{
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.g);
-		}
-		else if (m_colorSequence == QStringLiteral("BRG"))
-		{
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.g);
-		}
-		else if (m_colorSequence == QStringLiteral("BGR"))
-		{
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.r);
-		}
-		else if (m_colorSequence == QStringLiteral("GRB"))
-		{
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.b);
-		}
-		else if (m_colorSequence == QStringLiteral("GBR"))
-		{
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.b);
-			m_writeBuffer.append(color.r);
-		}
-		else
-		{
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.b);
-		}
-	}
-
-	bool ok = writeBuffer(m_writeBuffer);
-
-	emit commandCompleted(ok);
+	return writeBuffer(m_encoder.encode(m_colorsBuffer));
 }
 
 void LedDeviceArdulight::switchOffLeds()
@@ -184,6 +143,7 @@ void LedDeviceArdulight::setColorSequence(const QString& value)
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
 
 	m_colorSequence = value;
+	m_encoder.setColorSequence(value);
 	setColors(m_colorsSaved);
 }
 
@@ -211,9 +171,12 @@ void LedDeviceArdulight::open()
 
 	if (m_ArdulightDevice != NULL)
 		m_ArdulightDevice->close();
-	else
+	else {
 		m_ArdulightDevice = new QSerialPort();
+		connect(m_ArdulightDevice, &QSerialPort::bytesWritten, this, &LedDeviceArdulight::portBytesWritten);
+	}
 
+	m_pacer.reset();
 	m_ArdulightDevice->setPortName(m_portName);
 
 	m_ArdulightDevice->open(QIODevice::WriteOnly);
@@ -262,6 +225,13 @@ void LedDeviceArdulight::open()
 	emit openDeviceSuccess(ok);
 }
 
+void LedDeviceArdulight::portBytesWritten()
+{
+	// the port buffer was all that held the deferred frame back
+	if (m_pacer.isFrameDeferred() && !m_lastWillTimer->isActive())
+		writeLastWill(false);
+}
+
 void LedDeviceArdulight::writeLastWill()
 {
 	writeLastWill(false);
@@ -269,10 +239,11 @@ void LedDeviceArdulight::writeLastWill()
 
 void LedDeviceArdulight::writeLastWill(const bool force)
 {
-	if (force || m_ArdulightDevice->bytesToWrite() == 0) {
-		DEBUG_MID_LEVEL << Q_FUNC_INFO << "Writing last will frame";
-		setColors(m_colorsSaved);
-	}
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << "Writing last will frame";
+	if (force)
+		m_pacer.reset();
+	// not a command, nothing to complete
+	writeColors(m_colorsSaved);
 }
 
 bool LedDeviceArdulight::writeBuffer(const QByteArray & buff)
@@ -282,17 +253,22 @@ bool LedDeviceArdulight::writeBuffer(const QByteArray & buff)
 	if (m_ArdulightDevice == NULL || m_ArdulightDevice->isOpen() == false)
 		return false;
 
-	if (m_ArdulightDevice->bytesToWrite() > 0) {
-		DEBUG_MID_LEVEL << Q_FUNC_INFO << "Serial bytesToWrite:" << m_ArdulightDevice->bytesToWrite() << ", skipping current frame";
-		// If no more writes will be done ("Send data only of colors changed")
-		// re-schedule last skipped frame in case it's important (for ex a black frame to turn off)
-		using namespace std::chrono_literals;
-		m_lastWillTimer->start(100ms);
+	const qint64 nowNs = m_clock.nsecsElapsed();
+	const int retryMs = m_pacer.offerFrame(nowNs, m_ArdulightDevice->bytesToWrite());
+	if (retryMs != 0) {
+		DEBUG_MID_LEVEL << Q_FUNC_INFO << "Serial line busy, retry in" << retryMs << "ms, skipping current frame";
+		// Keep at most one frame on the wire and send the latest skipped one as soon as
+		// the line is free, also in case no more writes come ("Send data only if colors changed")
+		if (retryMs == SerialFramePacer::RetryOnBytesWritten)
+			m_lastWillTimer->stop(); // see portBytesWritten()
+		else
+			m_lastWillTimer->start(std::chrono::milliseconds(retryMs));
 		return true;
 	}
 	m_lastWillTimer->stop();
 
 	int bytesWritten = m_ArdulightDevice->write(buff);
+	m_pacer.frameWritten(buff.count(), nowNs);
 
 	if (bytesWritten != buff.count())
 	{
@@ -325,6 +301,11 @@ void LedDeviceArdulight::resizeColorsBuffer(int buffSize)
 	}
 }
 
+QByteArray LedDeviceArdulight::frameHeader()
+{
+	return QByteArray(1, (char)255);
+}
+
 int LedDeviceArdulight::maxLedsCount()
 {
 	return MaximumNumberOfLeds::Ardulight;
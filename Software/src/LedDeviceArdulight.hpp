@@ -28,6 +28,9 @@
 
 #include "AbstractLedDevice.hpp"
 #include "colorspace_types.h"
+#include "LedWireEncoder.hpp"
+#include "SerialFramePacer.hpp"
+#include <QElapsedTimer>
 #include <QtSerialPort/QSerialPort>
 
 class LedDeviceArdulight : public AbstractLedDevice
@@ -40,6 +43,9 @@ public:
 	int maxLedsCount();
 	virtual int defaultLedsCount() { return 25; }
 
+	// a single 255, the colors never reach it
+	static QByteArray frameHeader();
+
 public slots:
 	void open();
 	void close();
@@ -54,7 +60,11 @@ public slots:
 	void writeLastWill();
 	void writeLastWill(const bool force);
 
+private slots:
+	void portBytesWritten();
+
 private:
+	bool writeColors(const QList<QRgb> & colors);
 	bool writeBuffer(const QByteArray & buff);
 	void resizeColorsBuffer(int buffSize);
 
@@ -63,6 +73,9 @@ private:
 
 	QByteArray m_writeBufferHeader;
 	QByteArray m_writeBuffer;
+	LedWireEncoder m_encoder;
+	SerialFramePacer m_pacer;
+	QElapsedTimer m_clock;
 
 	QString m_portName;
 	int m_baudRate;
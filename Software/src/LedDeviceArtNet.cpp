@@ -0,0 +1,91 @@
+/*
+ * LedDeviceArtNet.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceArtNet.hpp"
+#include "enums.hpp"
+#include <QtEndian>
+
+namespace {
+const char ArtNetId[8] = { 'A', 'r', 't', '-', 'N', 'e', 't', 0 };
+const quint16 OpDmx = 0x5000;
+const quint16 OpSync = 0x5200;
+const quint16 ProtocolVersion = 14;
+
+const int OpCodeOffset = 8;
+const int VersionOffset = 10;
+const int SequenceOffset = 12;
+const int PortAddressOffset = 14;
+const int LengthOffset = 16;
+
+QByteArray artNetPacket(int size, quint16 opCode)
+{
+	QByteArray packet(size, 0);
+	char *data = packet.data();
+	memcpy(data, ArtNetId, sizeof(ArtNetId));
+	qToLittleEndian<quint16>(opCode, (uchar *)data + OpCodeOffset);
+	qToBigEndian<quint16>(ProtocolVersion, (uchar *)data + VersionOffset);
+	return packet;
+}
+}
+
+LedDeviceArtNet::LedDeviceArtNet(const QString& address, const QString& port, const int startUniverse, const bool isSyncEnabled, QObject * parent)
+	: AbstractLedDeviceDmx(address, port, startUniverse, isSyncEnabled, parent)
+{
+}
+
+QString LedDeviceArtNet::name() const
+{
+	return QStringLiteral("artnet");
+}
+
+int LedDeviceArtNet::maxLedsCount()
+{
+	return MaximumNumberOfLeds::ArtNet;
+}
+
+QByteArray LedDeviceArtNet::dataPacket(int universe, int channels) const
+{
+	// the length must be even, a trailing pad channel stays 0
+	const int length = channels + (channels & 1);
+	QByteArray packet = artNetPacket(HeaderSize + length, OpDmx);
+	char *data = packet.data();
+	qToLittleEndian<quint16>(universe & 0x7fff, (uchar *)data + PortAddressOffset);
+	qToBigEndian<quint16>(length, (uchar *)data + LengthOffset);
+	return packet;
+}
+
+int LedDeviceArtNet::sequenceOffset() const
+{
+	return SequenceOffset;
+}
+
+QByteArray LedDeviceArtNet::syncPacket() const
+{
+	return artNetPacket(SyncPacketSize, OpSync);
+}
+
+quint8 LedDeviceArtNet::nextSequence()
+{
+	// 1..255, 0 disables reordering on the node
+	const quint8 sequence = AbstractLedDeviceDmx::nextSequence();
+	return sequence == 0 ? AbstractLedDeviceDmx::nextSequence() : sequence;
+}
@@ -0,0 +1,49 @@
+/*
+ * LedDeviceArtNet.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "AbstractLedDeviceDmx.hpp"
+
+/*!
+	Art-Net 4 ArtDmx packets to a node, or to a broadcast address for several nodes.
+	Universes are the 15 bit port address (net, sub-net and universe). With sync enabled
+	an ArtSync follows the frame, nodes hold the data until it arrives.
+*/
+class LedDeviceArtNet : public AbstractLedDeviceDmx
+{
+	Q_OBJECT
+public:
+	LedDeviceArtNet(const QString& address, const QString& port, const int startUniverse, const bool isSyncEnabled, QObject * parent = 0);
+	QString name() const;
+	int maxLedsCount();
+
+	constexpr static const int HeaderSize = 18;
+	constexpr static const int SyncPacketSize = 14;
+
+protected:
+	QByteArray dataPacket(int universe, int channels) const;
+	int dataOffset() const { return HeaderSize; }
+	int sequenceOffset() const;
+	QByteArray syncPacket() const;
+	quint8 nextSequence();
+};
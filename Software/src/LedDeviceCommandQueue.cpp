@@ -0,0 +1,113 @@
+/*
+ * LedDeviceCommandQueue.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceCommandQueue.hpp"
+
+using namespace LedDeviceCommands;
+
+LedDeviceCommandQueue::LedDeviceCommandQueue()
+	: m_isLastHostSide(false)
+{
+}
+
+bool LedDeviceCommandQueue::isHostSide(Cmd cmd)
+{
+	switch (cmd) {
+	case SetGamma:
+	case SetBrightness:
+	case SetBrightnessCap:
+	case SetLuminosityThreshold:
+	case SetMinimumLuminosityEnabled:
+	case SetDitheringEnabled:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool LedDeviceCommandQueue::append(Cmd cmd, const QVariant &value)
+{
+	if (value.isValid()) {
+		auto sent = m_sentValues.constFind(cmd);
+		if (sent != m_sentValues.cend() && sent.value() == value) {
+			// back to what the device has, whatever is pending is obsolete
+			remove(cmd);
+			return false;
+		}
+	}
+
+	m_values[cmd] = value;
+	if (!m_cmds.contains(cmd))
+		m_cmds.append(cmd);
+	return true;
+}
+
+QList<Cmd> LedDeviceCommandQueue::takeNext()
+{
+	QList<Cmd> hostSide;
+	int other = -1;
+	for (int i = 0; i < m_cmds.size(); ++i) {
+		const Cmd cmd = m_cmds[i];
+		if (isHostSide(cmd))
+			hostSide.append(cmd);
+		else if (cmd != SetColors && other < 0)
+			other = i;
+	}
+	const bool isColorsPending = m_cmds.contains(SetColors);
+
+	QList<Cmd> cmds;
+	if ((hostSide.isEmpty() && !isColorsPending) || (other >= 0 && m_isLastHostSide)) {
+		if (other >= 0)
+			cmds.append(m_cmds.takeAt(other));
+		m_isLastHostSide = false;
+	} else {
+		for (const Cmd cmd : hostSide)
+			m_cmds.removeOne(cmd);
+		cmds = hostSide;
+		// the device sends the colors with all of the above applied
+		if (m_cmds.removeOne(SetColors))
+			cmds.append(SetColors);
+		m_isLastHostSide = true;
+	}
+
+	for (const Cmd cmd : cmds) {
+		const QVariant value = m_values.value(cmd);
+		if (value.isValid())
+			m_sentValues[cmd] = value;
+	}
+	return cmds;
+}
+
+void LedDeviceCommandQueue::remove(Cmd cmd)
+{
+	m_cmds.removeOne(cmd);
+}
+
+void LedDeviceCommandQueue::clear()
+{
+	m_cmds.clear();
+}
+
+void LedDeviceCommandQueue::invalidate()
+{
+	m_sentValues.clear();
+}
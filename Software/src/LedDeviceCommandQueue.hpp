@@ -0,0 +1,73 @@
+/*
+ * LedDeviceCommandQueue.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QVariant>
+#include "enums.hpp"
+
+/*!
+	Pending commands of LedDeviceManager, at most one of each kind.
+	A command queued again only gets its value replaced, and a value the device
+	already has is not queued at all. Settings the device applies on the host side
+	(gamma, brightness, ...) are handed out together with SetColors, so they cost
+	a single round-trip no matter how many of them changed.
+*/
+class LedDeviceCommandQueue
+{
+public:
+	LedDeviceCommandQueue();
+
+	/*!
+		Queues \a cmd with \a value, commands without a value (colors, firmware version
+		request, ...) are never considered redundant.
+		\return false if the device already has \a value and nothing has to be sent
+	*/
+	bool append(LedDeviceCommands::Cmd cmd, const QVariant &value = QVariant());
+
+	/*!
+		Takes the commands of the next device transaction and remembers their values as sent:
+		either all pending host side settings, followed by SetColors if it is pending,
+		or a single other command. The two kinds take turns so neither stalls the other.
+	*/
+	QList<LedDeviceCommands::Cmd> takeNext();
+
+	QVariant value(LedDeviceCommands::Cmd cmd) const { return m_values.value(cmd); }
+	bool contains(LedDeviceCommands::Cmd cmd) const { return m_cmds.contains(cmd); }
+	bool isEmpty() const { return m_cmds.isEmpty(); }
+	void remove(LedDeviceCommands::Cmd cmd);
+
+	// drops pending commands
+	void clear();
+	// forgets what the device has, e.g. after it failed or reloaded its settings
+	void invalidate();
+
+	static bool isHostSide(LedDeviceCommands::Cmd cmd);
+
+private:
+	QList<LedDeviceCommands::Cmd> m_cmds;
+	QMap<LedDeviceCommands::Cmd, QVariant> m_values;
+	QMap<LedDeviceCommands::Cmd, QVariant> m_sentValues;
+	bool m_isLastHostSide;
+};
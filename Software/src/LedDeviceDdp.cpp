@@ -0,0 +1,161 @@
+/*
+ * LedDeviceDdp.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceDdp.hpp"
+#include "enums.hpp"
+
+namespace {
+// header layout: flags, sequence, data type, destination, offset (32 bit), length (16 bit)
+const int FlagsOffset = 0;
+const int SequenceOffset = 1;
+const int DataOffsetOffset = 4;
+const int LengthOffset = 8;
+
+const quint8 FlagVersion1 = 0x40;
+const quint8 FlagPush = 0x01;
+// RGB, 8 bits per channel
+const quint8 DataTypeRgb8 = 0x0b;
+const quint8 DefaultOutput = 0x01;
+}
+
+LedDeviceDdp::LedDeviceDdp(const QString& address, const QString& port, const uint8_t timeout, QObject * parent) : AbstractLedDeviceUdp(address, port, timeout, parent)
+{
+	// deltas only fit one segment size when every LED changed; UdpBatchSender checks
+	// the sizes of each frame and sends other frames with sendmmsg()
+	m_batchSender.setGsoEnabled(true);
+}
+
+QString LedDeviceDdp::name() const
+{
+	return QStringLiteral("ddp");
+}
+
+int LedDeviceDdp::maxLedsCount()
+{
+	return MaximumNumberOfLeds::Ddp;
+}
+
+void LedDeviceDdp::setColors(const QList<QRgb> & colors, const bool rawColors)
+{
+	bool ok = true;
+
+	resizeColorsBuffer(colors.count());
+
+	applyColorModifications(colors, m_colorsBuffer, rawColors);
+	if (!rawColors)
+		applyDithering(m_colorsBuffer, 8);
+
+	const int totalColors = m_colorsBuffer.count();
+	if (m_processedColorsSaved.count() != totalColors) {
+		// 0 has no alpha, unlike every qRgb(), so all LEDs count as changed
+		m_processedColorsSaved.clear();
+		m_processedColorsSaved.reserve(totalColors);
+		for (int i = 0; i < totalColors; i++)
+			m_processedColorsSaved << 0;
+	}
+
+	beginPackets();
+	bool sentPackets = false;
+	int first = nextChange(0);
+	while (first < totalColors) {
+		// a packet spans from one changed LED to the last changed one that still fits
+		const int end = qMin(first + LedsPerPacket, totalColors);
+		int last = first;
+		for (int i = first + 1; i < end; i++) {
+			if (takeChange(i))
+				last = i;
+		}
+		const int next = nextChange(end);
+		ok &= writePacket(first, last - first + 1, next >= totalColors);
+		sentPackets = true;
+		first = next;
+	}
+
+	// if no packets are sent, push an empty one to not timeout
+	if (!sentPackets && m_timeout != InfiniteTimeout)
+		ok &= writePacket(0, 0, true);
+	ok &= flushPackets();
+
+	m_colorsSaved = colors;
+
+	emit commandCompleted(ok);
+}
+
+bool LedDeviceDdp::takeChange(int index)
+{
+	const StructRgb color = m_colorsBuffer[index];
+	const QRgb newColor = qRgb(color.r, color.g, color.b);
+	if (m_processedColorsSaved[index] == newColor)
+		return false;
+	m_processedColorsSaved[index] = newColor;
+	return true;
+}
+
+int LedDeviceDdp::nextChange(int from)
+{
+	const int totalColors = m_colorsBuffer.count();
+	while (from < totalColors && !takeChange(from))
+		from++;
+	return from;
+}
+
+QByteArray LedDeviceDdp::packetHeader()
+{
+	QByteArray header;
+	header.append((char)FlagVersion1);
+	header.append((char)0);        // sequence
+	header.append((char)DataTypeRgb8);
+	header.append((char)DefaultOutput);
+	// followed by the data offset and length
+	header.append(QByteArray(HeaderSize - header.size(), 0));
+	return header;
+}
+
+void LedDeviceDdp::setPacketHeader(LedWireEncoder &encoder, int first, int count, bool isPush, quint8 sequence)
+{
+	const quint32 dataOffset = first * 3;
+
+	encoder.setHeaderByte(FlagsOffset, FlagVersion1 | (isPush ? FlagPush : 0));
+	encoder.setHeaderByte(SequenceOffset, sequence);
+	encoder.setHeaderWord(DataOffsetOffset, dataOffset >> 16);
+	encoder.setHeaderWord(DataOffsetOffset + 2, dataOffset & 0xffff);
+	encoder.setHeaderWord(LengthOffset, count * 3);
+}
+
+bool LedDeviceDdp::writePacket(int first, int count, bool isPush)
+{
+	setPacketHeader(m_encoder, first, count, isPush, m_sequence);
+
+	// 1..15, 0 would tell the receiver sequence numbers are not used
+	m_sequence = m_sequence % 15 + 1;
+
+	return writeBuffer(m_encoder.encode(m_colorsBuffer, first, count));
+}
+
+void LedDeviceDdp::reinitBufferHeader()
+{
+	m_writeBufferHeader = packetHeader();
+
+	m_encoder.setHeader(m_writeBufferHeader);
+	m_encoder.reserve(LedsPerPacket);
+	m_batchSender.reserve((maxLedsCount() + LedsPerPacket - 1) / LedsPerPacket, HeaderSize + LedsPerPacket * 3);
+}
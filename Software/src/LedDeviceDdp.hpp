@@ -0,0 +1,62 @@
+/*
+ * LedDeviceDdp.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "AbstractLedDeviceUdp.hpp"
+
+/*!
+	Distributed Display Protocol (DDP), as spoken by WLED and many pixel controllers.
+	Each packet carries up to 480 RGB LEDs behind a 10 byte header with a 32 bit data
+	offset. Only spans with changed LEDs are sent and the last packet of a frame carries
+	the push flag, so the controller shows the whole update at once.
+*/
+class LedDeviceDdp : public AbstractLedDeviceUdp
+{
+	Q_OBJECT
+public:
+	LedDeviceDdp(const QString& address, const QString& port, const uint8_t timeout, QObject * parent = 0);
+	QString name() const;
+	int maxLedsCount();
+
+	constexpr static const int HeaderSize = 10;
+	constexpr static const int LedsPerPacket = 480;
+
+	// the header every packet starts from, see setPacketHeader()
+	static QByteArray packetHeader();
+	// patches the fields of the packet of \a count LEDs from \a first into the encoder's header
+	static void setPacketHeader(LedWireEncoder &encoder, int first, int count, bool isPush, quint8 sequence);
+
+public slots:
+	void setColors(const QList<QRgb> & colors, const bool rawColors);
+
+protected:
+	virtual void reinitBufferHeader();
+
+private:
+	bool takeChange(int index);
+	int nextChange(int from);
+	bool writePacket(int first, int count, bool isPush);
+
+	QList<QRgb> m_processedColorsSaved;
+	quint8 m_sequence{1};
+};
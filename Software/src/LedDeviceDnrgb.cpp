@@ -29,6 +29,9 @@
 
 LedDeviceDnrgb::LedDeviceDnrgb(const QString& address, const QString& port, const uint8_t timeout, QObject * parent) : AbstractLedDeviceUdp(address, port, timeout, parent)
 {
+	// deltas only fit one segment size when every LED changed; UdpBatchSender checks
+	// the sizes of each frame and sends other frames with sendmmsg()
+	m_batchSender.setGsoEnabled(true);
 }
 
 QString LedDeviceDnrgb::name() const
@@ -52,12 +55,15 @@ void LedDeviceDnrgb::setColors(const QList<QRgb> & colors, const bool rawColors)
 	if (!rawColors)
 		applyDithering(m_colorsBuffer, 8);
 
-	// Send multiple buffers
+	// Send multiple buffers, all in one go
+	beginPackets();
 	const int totalColorsSaved = m_processedColorsSaved.count();
-	const int totalColors = colors.count();
+	const int totalColors = m_colorsBuffer.count();
+	while (m_processedColorsSaved.count() < totalColors)
+		m_processedColorsSaved << 0;
+	while (m_processedColorsSaved.count() > totalColors)
+		m_processedColorsSaved.removeLast();
 	uint16_t startIndex = 0;
-	QList<QRgb> newColors;
-	newColors.reserve(colors.count());
 
 	while (startIndex < totalColors)
 	{
@@ -66,15 +72,12 @@ void LedDeviceDnrgb::setColors(const QList<QRgb> & colors, const bool rawColors)
 			&& startIndex < totalColorsSaved)
 		{
 			const StructRgb color = m_colorsBuffer[startIndex];
-			const QRgb newColor = qRgb(color.r, color.g, color.b);
-			if (m_processedColorsSaved[startIndex] != newColor)
+			if (m_processedColorsSaved[startIndex] != qRgb(color.r, color.g, color.b))
 				break;
-			newColors << newColor;
 			startIndex++;
 		}
 
 		// get diffs
-		QByteArray colorPacket;
 		uint16_t colorPacketLen = 0;
 		while (colorPacketLen < LedsPerPacket
 			&& startIndex + colorPacketLen < totalColors)
@@ -85,46 +88,45 @@ void LedDeviceDnrgb::setColors(const QList<QRgb> & colors, const bool rawColors)
 				&& m_processedColorsSaved[startIndex + colorPacketLen] == newColor)
 				break;
 
-			newColors << newColor;
-			colorPacket.append(color.r);
-			colorPacket.append(color.g);
-			colorPacket.append(color.b);
-
+			m_processedColorsSaved[startIndex + colorPacketLen] = newColor;
 			colorPacketLen++;
 		}
 
 		if (colorPacketLen > 0) {
-			m_writeBuffer.clear();
-			m_writeBuffer.append(m_writeBufferHeader);
-			m_writeBuffer.append((char)(startIndex >> 8));  //High byte
-			m_writeBuffer.append((char)startIndex);         //Low byte
-			m_writeBuffer.append(colorPacket);
+			m_encoder.setHeaderWord(StartIndexOffset, startIndex);
+			ok &= writeBuffer(m_encoder.encode(m_colorsBuffer, startIndex, colorPacketLen));
 			startIndex += colorPacketLen;
-			ok &= writeBuffer(m_writeBuffer);
 			sentPackets = true;
 		}
 	}
 
 	// if no packets are sent, send empty packet to not timeout
 	if (!sentPackets && m_timeout != InfiniteTimeout) {
-		m_writeBuffer.clear();
-		m_writeBuffer.append(m_writeBufferHeader);
-		m_writeBuffer.append((char)0);
-		m_writeBuffer.append((char)0);
-		ok &= writeBuffer(m_writeBuffer);
+		m_encoder.setHeaderWord(StartIndexOffset, 0);
+		ok &= writeBuffer(m_encoder.encode(m_colorsBuffer, 0, 0));
 	}
+	ok &= flushPackets();
 
 	m_colorsSaved = colors;
-	m_processedColorsSaved = newColors;
 
 	emit commandCompleted(ok);
 }
 
 void LedDeviceDnrgb::reinitBufferHeader()
 {
-	m_writeBufferHeader.clear();
+	m_writeBufferHeader = packetHeader(m_timeout);
 
-	// Initialize buffer header
-	m_writeBufferHeader.append((char)UdpDevice::Dnrgb);    // DNRGB protocol
-	m_writeBufferHeader.append((char)m_timeout);
+	m_encoder.setHeader(m_writeBufferHeader);
+	m_encoder.reserve(LedsPerPacket);
+	m_batchSender.reserve((maxLedsCount() + LedsPerPacket - 1) / LedsPerPacket, HeaderSize + LedsPerPacket * 3);
+}
+
+QByteArray LedDeviceDnrgb::packetHeader(quint8 timeout)
+{
+	QByteArray header;
+	header.append((char)UdpDevice::Dnrgb);    // DNRGB protocol
+	header.append((char)timeout);
+	// followed by the start index of the packet
+	header.append(QByteArray(HeaderSize - header.size(), 0));
+	return header;
 }
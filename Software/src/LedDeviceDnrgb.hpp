@@ -36,12 +36,18 @@ public:
 	QString name() const;
 	int maxLedsCount();
 
+	constexpr static const int HeaderSize = 4;
+	constexpr static const int StartIndexOffset = 2;
+	constexpr static const int LedsPerPacket = 489;
+
+	// the header with start index 0, patch it at StartIndexOffset for every packet
+	static QByteArray packetHeader(quint8 timeout);
+
 public slots:
 	void setColors(const QList<QRgb> & colors, const bool rawColors);
 
 protected:
 	virtual void reinitBufferHeader();
 
-	constexpr static const int LedsPerPacket = 489;
 	QList<QRgb> m_processedColorsSaved;
 };
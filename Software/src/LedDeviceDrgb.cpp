@@ -51,26 +51,22 @@ void LedDeviceDrgb::setColors(const QList<QRgb> & colors, const bool rawColors)
 	if (!rawColors)
 		applyDithering(m_colorsBuffer, 8);
 
-	m_writeBuffer.clear();
-	m_writeBuffer.reserve(m_writeBuffer.count() + m_colorsBuffer.count() * sizeof(char));
-	m_writeBuffer.append(m_writeBufferHeader);
-
-	for (const StructRgb& color : m_colorsBuffer)
-	{
-		m_writeBuffer.append(color.r);
-		m_writeBuffer.append(color.g);
-		m_writeBuffer.append(color.b);
-	}
-
-	const bool ok = writeBuffer(m_writeBuffer);
+	const bool ok = writeBuffer(m_encoder.encode(m_colorsBuffer));
 	emit commandCompleted(ok);
 }
 
 void LedDeviceDrgb::reinitBufferHeader()
 {
-	m_writeBufferHeader.clear();
+	m_writeBufferHeader = packetHeader(m_timeout);
 
-	// Initialize buffer header
-	m_writeBufferHeader.append((char)UdpDevice::Drgb);    // DRGB protocol
-	m_writeBufferHeader.append((char)m_timeout);
+	m_encoder.setHeader(m_writeBufferHeader);
+	m_encoder.reserve(maxLedsCount());
+}
+
+QByteArray LedDeviceDrgb::packetHeader(quint8 timeout)
+{
+	QByteArray header;
+	header.append((char)UdpDevice::Drgb);    // DRGB protocol
+	header.append((char)timeout);
+	return header;
 }
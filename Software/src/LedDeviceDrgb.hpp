@@ -36,6 +36,8 @@ public:
 	QString name() const;
 	int maxLedsCount();
 
+	static QByteArray packetHeader(quint8 timeout);
+
 public slots:
 	void setColors(const QList<QRgb> & colors, const bool rawColors);
 
@@ -0,0 +1,148 @@
+/*
+ * LedDeviceE131.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceE131.hpp"
+#include "enums.hpp"
+#include <QUuid>
+#include <QtEndian>
+
+namespace {
+const char AcnPacketIdentifier[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+const char SourceName[] = "Prismatik";
+
+const quint32 VectorRootE131Data = 0x00000004;
+const quint32 VectorRootE131Extended = 0x00000008;
+const quint32 VectorE131DataPacket = 0x00000002;
+const quint32 VectorE131ExtendedSynchronization = 0x00000001;
+const quint8 VectorDmpSetProperty = 0x02;
+const quint8 DmpAddressAndDataType = 0xa1;
+const quint8 DefaultPriority = 100;
+
+// root layer
+const int RootLengthOffset = 16;
+const int RootVectorOffset = 18;
+const int CidOffset = 22;
+// framing layer
+const int FramingOffset = 38;
+const int FramingVectorOffset = 40;
+const int SourceNameOffset = 44;
+const int PriorityOffset = 108;
+const int SyncAddressOffset = 109;
+const int SequenceOffset = 111;
+const int UniverseOffset = 113;
+// DMP layer
+const int DmpOffset = 115;
+const int PropertyCountOffset = 123;
+// sync packet framing layer
+const int SyncSequenceOffset = 44;
+const int SyncUniverseOffset = 45;
+
+// PDU length in the low 12 bits, flags 0x7 in the high 4
+void putPduLength(char *packet, int offset, int length)
+{
+	qToBigEndian<quint16>(0x7000 | (length & 0x0fff), (uchar *)packet + offset);
+}
+
+// preamble, postamble and ACN identifier are the same for every packet
+QByteArray rootLayer(int size, quint32 vector, const QByteArray &cid)
+{
+	QByteArray packet(size, 0);
+	char *data = packet.data();
+	qToBigEndian<quint16>(0x0010, (uchar *)data);
+	memcpy(data + 4, AcnPacketIdentifier, sizeof(AcnPacketIdentifier));
+	putPduLength(data, RootLengthOffset, size - RootLengthOffset);
+	qToBigEndian<quint32>(vector, (uchar *)data + RootVectorOffset);
+	memcpy(data + CidOffset, cid.constData(), qMin(cid.size(), 16));
+	return packet;
+}
+}
+
+LedDeviceE131::LedDeviceE131(const QString& address, const QString& port, const int startUniverse, const bool isMulticast, const bool isSyncEnabled, QObject * parent)
+	: AbstractLedDeviceDmx(address, port, startUniverse, isSyncEnabled, parent)
+	, m_isMulticast(isMulticast)
+	, m_cid(QUuid::createUuid().toRfc4122())
+{
+}
+
+QString LedDeviceE131::name() const
+{
+	return QStringLiteral("e131");
+}
+
+int LedDeviceE131::maxLedsCount()
+{
+	return MaximumNumberOfLeds::E131;
+}
+
+QHostAddress LedDeviceE131::multicastGroup(int universe)
+{
+	return QHostAddress(0xefff0000 | (universe & 0xffff));
+}
+
+QByteArray LedDeviceE131::dataPacket(int universe, int channels) const
+{
+	const int size = HeaderSize + channels;
+	QByteArray packet = rootLayer(size, VectorRootE131Data, m_cid);
+	char *data = packet.data();
+
+	putPduLength(data, FramingOffset, size - FramingOffset);
+	qToBigEndian<quint32>(VectorE131DataPacket, (uchar *)data + FramingVectorOffset);
+	memcpy(data + SourceNameOffset, SourceName, sizeof(SourceName));
+	data[PriorityOffset] = (char)DefaultPriority;
+	qToBigEndian<quint16>(syncUniverse(), (uchar *)data + SyncAddressOffset);
+	qToBigEndian<quint16>(universe, (uchar *)data + UniverseOffset);
+
+	putPduLength(data, DmpOffset, size - DmpOffset);
+	data[DmpOffset + 2] = (char)VectorDmpSetProperty;
+	data[DmpOffset + 3] = (char)DmpAddressAndDataType;
+	// first property address 0, increment 1
+	qToBigEndian<quint16>(1, (uchar *)data + DmpOffset + 6);
+	// the start code (0, dimmer data) counts as a property
+	qToBigEndian<quint16>(channels + 1, (uchar *)data + PropertyCountOffset);
+	return packet;
+}
+
+int LedDeviceE131::sequenceOffset() const
+{
+	return SequenceOffset;
+}
+
+QByteArray LedDeviceE131::syncPacket() const
+{
+	QByteArray packet = rootLayer(SyncPacketSize, VectorRootE131Extended, m_cid);
+	char *data = packet.data();
+
+	putPduLength(data, FramingOffset, SyncPacketSize - FramingOffset);
+	qToBigEndian<quint32>(VectorE131ExtendedSynchronization, (uchar *)data + FramingVectorOffset);
+	qToBigEndian<quint16>(syncUniverse(), (uchar *)data + SyncUniverseOffset);
+	return packet;
+}
+
+int LedDeviceE131::syncSequenceOffset() const
+{
+	return SyncSequenceOffset;
+}
+
+QHostAddress LedDeviceE131::destination(int universe) const
+{
+	return m_isMulticast ? multicastGroup(universe) : m_address;
+}
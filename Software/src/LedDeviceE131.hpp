@@ -0,0 +1,58 @@
+/*
+ * LedDeviceE131.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "AbstractLedDeviceDmx.hpp"
+
+/*!
+	Streaming ACN (ANSI E1.31), as spoken by most pixel controllers and lighting desks.
+	Unicast goes to the configured address, multicast to 239.255.x.y of each universe.
+	With sync enabled every data packet names the first universe as synchronization
+	address and a universe sync packet on it releases the frame.
+*/
+class LedDeviceE131 : public AbstractLedDeviceDmx
+{
+	Q_OBJECT
+public:
+	LedDeviceE131(const QString& address, const QString& port, const int startUniverse, const bool isMulticast, const bool isSyncEnabled, QObject * parent = 0);
+	QString name() const;
+	int maxLedsCount();
+
+	static QHostAddress multicastGroup(int universe);
+
+	constexpr static const int HeaderSize = 126;
+	constexpr static const int SyncPacketSize = 49;
+
+protected:
+	QByteArray dataPacket(int universe, int channels) const;
+	int dataOffset() const { return HeaderSize; }
+	int sequenceOffset() const;
+	QByteArray syncPacket() const;
+	int syncSequenceOffset() const;
+	QHostAddress destination(int universe) const;
+
+private:
+	const bool m_isMulticast;
+	// component identifier, the same for all packets of this source
+	const QByteArray m_cid;
+};
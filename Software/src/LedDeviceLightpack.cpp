@@ -35,10 +35,23 @@
 using namespace SettingsScope;
 
 const int LedDeviceLightpack::kPingDeviceInterval = 1000;
-const int LedDeviceLightpack::kLedsPerDevice = 10;
+
+namespace {
+class HidApiBackend : public HidReportWriter::Backend
+{
+public:
+	int write(hid_device *device, const unsigned char *data, size_t length) override
+	{
+		return hid_write(device, data, length);
+	}
+};
+
+HidApiBackend hidApiBackend;
+}
 
 LedDeviceLightpack::LedDeviceLightpack(QObject *parent) :
-	AbstractLedDevice(parent)
+	AbstractLedDevice(parent),
+	m_reportWriter(hidApiBackend)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << "thread id: " << this->thread()->currentThreadId();
@@ -96,39 +109,11 @@ void LedDeviceLightpack::setColors(const QList<QRgb> & colors)
 
 	// First write_buffer[0] == 0x00 - ReportID, i have problems with using it
 	// Second byte of usb buffer is command (write_buffer[1] == CMD_UPDATE_LEDS, see below)
-	int buffIndex = WRITE_BUFFER_INDEX_DATA_START;
-
-	bool ok = true;
-	const int kLedRemap[] = {4, 3, 0, 1, 2, 5, 6, 7, 8, 9};
-	const size_t kSizeOfLedColor = 6;
-
-	memset(m_writeBuffer, 0, sizeof(m_writeBuffer));
-	for (int i = 0; i < m_colorsBuffer.count(); i++)
-	{
-		StructRgb color = m_colorsBuffer[i];
+	// a report per device, all of them are written at once
+	const int devicesCount = HidReportWriter::reportsCount(m_colorsBuffer.count());
+	HidReportWriter::encodeColors(m_colorsBuffer, m_reportWriter.report(0));
 
-		buffIndex = WRITE_BUFFER_INDEX_DATA_START + kLedRemap[i % 10] * kSizeOfLedColor;
-
-		// Send main 8 bits for compability with existing devices
-		m_writeBuffer[buffIndex++] = (color.r & 0x0FF0) >> 4;
-		m_writeBuffer[buffIndex++] = (color.g & 0x0FF0) >> 4;
-		m_writeBuffer[buffIndex++] = (color.b & 0x0FF0) >> 4;
-
-		// Send over 4 bits for devices revision >= 6
-		// All existing devices ignore it
-		m_writeBuffer[buffIndex++] = (color.r & 0x000F);
-		m_writeBuffer[buffIndex++] = (color.g & 0x000F);
-		m_writeBuffer[buffIndex++] = (color.b & 0x000F);
-
-		if ((i+1) % kLedsPerDevice == 0 || i == m_colorsBuffer.size() - 1) {
-			if (m_devices.empty() || !writeBufferToDeviceWithCheck(CMD_UPDATE_LEDS, m_devices[(i+kLedsPerDevice)/kLedsPerDevice - 1])) {
-				ok = false;
-				break;
-			}
-			memset(m_writeBuffer, 0, sizeof(m_writeBuffer));
-			buffIndex = WRITE_BUFFER_INDEX_DATA_START;
-		}
-	}
+	const bool ok = writeReportsWithCheck(CMD_UPDATE_LEDS, devicesCount);
 
 //	locker.unlock();
 
@@ -141,7 +126,7 @@ int LedDeviceLightpack::maxLedsCount()
 {
 	if (m_devices.size() == 0)
 		tryToReopenDevice();
-	return m_devices.size() * kLedsPerDevice;
+	return m_devices.size() * HidReportWriter::LedsPerReport;
 }
 void LedDeviceLightpack::switchOffLeds()
 {
@@ -160,11 +145,7 @@ void LedDeviceLightpack::switchOffLeds()
 
 	memset(m_writeBuffer, 0, sizeof(m_writeBuffer));
 
-	bool ok = true;
-	for(int i = 0; i < m_devices.size(); i++) {
-		if (!writeBufferToDeviceWithCheck(CMD_UPDATE_LEDS, m_devices[i]))
-			ok = false;
-	}
+	const bool ok = writeBufferToAllDevices(CMD_UPDATE_LEDS);
 
 
 	emit commandCompleted(ok);
@@ -178,11 +159,7 @@ void LedDeviceLightpack::setRefreshDelay(int value)
 	m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START] = value & 0xff;
 	m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START+1] = (value >> 8);
 
-	bool ok = true;
-	for(int i = 0; i < m_devices.size(); i++) {
-		if (!writeBufferToDeviceWithCheck(CMD_SET_TIMER_OPTIONS, m_devices[i]))
-			ok = false;
-	}
+	const bool ok = writeBufferToAllDevices(CMD_SET_TIMER_OPTIONS);
 	emit commandCompleted(ok);
 }
 
@@ -191,11 +168,7 @@ void LedDeviceLightpack::setUsbPowerLedDisabled(bool isDisabled) {
 
 	m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START] = (unsigned char)!isDisabled;
 
-	bool ok = true;
-	for (int i = 0; i < m_devices.size(); ++i) {
-		if (!writeBufferToDeviceWithCheck(CMD_UNOFFICIAL_SET_USBLED, m_devices[i]))
-			ok = false;
-	}
+	const bool ok = writeBufferToAllDevices(CMD_UNOFFICIAL_SET_USBLED);
 	emit commandCompleted(ok);
 }
 
@@ -205,11 +178,7 @@ void LedDeviceLightpack::setColorDepth(int value)
 
 	m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START] = (unsigned char)value;
 
-	bool ok = true;
-	for(int i = 0; i < m_devices.size(); i++) {
-		if (!writeBufferToDeviceWithCheck(CMD_SET_PWM_LEVEL_MAX_VALUE, m_devices[i]))
-			ok = false;
-	}
+	const bool ok = writeBufferToAllDevices(CMD_SET_PWM_LEVEL_MAX_VALUE);
 	emit commandCompleted(ok);
 }
 
@@ -219,11 +188,7 @@ void LedDeviceLightpack::setSmoothSlowdown(int value)
 
 	m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START] = (unsigned char)value;
 
-	bool ok = true;
-	for(int i = 0; i < m_devices.size(); i++) {
-		if (!writeBufferToDeviceWithCheck(CMD_SET_SMOOTH_SLOWDOWN, m_devices[i]))
-			ok = false;
-	}
+	const bool ok = writeBufferToAllDevices(CMD_SET_SMOOTH_SLOWDOWN);
 	emit commandCompleted(ok);
 }
 
@@ -339,6 +304,7 @@ void LedDeviceLightpack::open(unsigned short vid, unsigned short pid)
 	hid_free_enumeration(devs);
 	m_devices.append(map.values());
 	m_devices.append(list);
+	m_reportWriter.setDevices(m_devices);
 }
 
 void LedDeviceLightpack::close() {
@@ -447,6 +413,46 @@ bool LedDeviceLightpack::writeBufferToDeviceWithCheck(int command, hid_device *p
 	}
 }
 
+bool LedDeviceLightpack::writeReportsWithCheck(int command, int devices)
+{
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << command << devices;
+
+	devices = qMin(devices, m_devices.size());
+	if (devices == 0)
+		return true;
+
+	for (int i = 0; i < devices; i++) {
+		unsigned char *report = m_reportWriter.report(i);
+		report[WRITE_BUFFER_INDEX_REPORT_ID] = 0x00;
+		report[WRITE_BUFFER_INDEX_COMMAND] = command;
+	}
+
+	if (m_reportWriter.writeReports(devices)) {
+		emit ioDeviceSuccess(true);
+		return true;
+	}
+
+	// the failed ones once more one after another, reopening the devices if need be;
+	// reopening clears the reports, the next command writes all devices again
+	const QList<hid_device*> devicesWritten = m_devices;
+	for (int i = 0; i < devices && m_devices == devicesWritten; i++) {
+		if (m_reportWriter.isWritten(i))
+			continue;
+		qWarning() << Q_FUNC_INFO << "Error writing data to device" << i;
+		memcpy(m_writeBuffer, m_reportWriter.report(i), sizeof(m_writeBuffer));
+		if (!writeBufferToDeviceWithCheck(command, m_devices[i]))
+			return false;
+	}
+	return true;
+}
+
+bool LedDeviceLightpack::writeBufferToAllDevices(int command)
+{
+	for (int i = 0; i < m_devices.size(); i++)
+		memcpy(m_reportWriter.report(i), m_writeBuffer, sizeof(m_writeBuffer));
+	return writeReportsWithCheck(command, m_devices.size());
+}
+
 void LedDeviceLightpack::resizeColorsBuffer(int buffSize)
 {
 	if (m_colorsBuffer.count() == buffSize || buffSize < 0)
@@ -472,6 +478,8 @@ void LedDeviceLightpack::closeDevices()
 	m_timerPingDevice->stop();
 	m_timerPingDevice->blockSignals(true);
 
+	// no writer thread may still use a handle
+	m_reportWriter.setDevices(QList<hid_device*>());
 	for(int i=0; i < m_devices.size(); i++) {
 		hid_close(m_devices[i]);
 	}
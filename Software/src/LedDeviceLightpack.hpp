@@ -30,6 +30,7 @@
 #include "AbstractLedDevice.hpp"
 #include "TimeEvaluations.hpp"
 #include "PrismatikMath.hpp"
+#include "HidReportWriter.hpp"
 
 #include "../../CommonHeaders/USB_ID.h"		/* For device VID, PID, vendor name and product name */
 #include "hidapi.h" /* USB HID API */
@@ -72,6 +73,9 @@ private:
 	bool tryToReopenDevice();
 	bool readDataFromDeviceWithCheck();
 	bool writeBufferToDeviceWithCheck(int command, hid_device *phid_device);
+	// writes the reports of the first \a devices devices at once
+	bool writeReportsWithCheck(int command, int devices);
+	bool writeBufferToAllDevices(int command);
 	void resizeColorsBuffer(int buffSize);
 	void closeDevices();
 
@@ -89,7 +93,7 @@ private:
 	unsigned char m_writeBuffer[65];	/* 0-ReportID, 1..65-data */
 
 	QTimer *m_timerPingDevice;
+	HidReportWriter m_reportWriter;
 
 	static const int kPingDeviceInterval;
-	static const int kLedsPerDevice;
 };
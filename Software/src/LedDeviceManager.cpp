@@ -39,12 +39,19 @@
 #include "LedDeviceDrgb.hpp"
 #include "LedDeviceDnrgb.hpp"
 #include "LedDeviceWarls.hpp"
+#include "LedDeviceDdp.hpp"
+#include "LedDeviceE131.hpp"
+#include "LedDeviceArtNet.hpp"
+#include "LedDeviceAdaptiveUdp.hpp"
+#include "LedDeviceRecorder.hpp"
+#include "LedDeviceNullSink.hpp"
 #include "Settings.hpp"
 
 using namespace SettingsScope;
 
 LedDeviceManager::LedDeviceManager(QObject *parent)
 	: QObject(parent)
+	, m_frameMailbox(MaximumNumberOfLeds::AbsoluteMaximum)
 {
 	m_isLastCommandCompleted = true;
 
@@ -58,11 +65,15 @@ LedDeviceManager::LedDeviceManager(QObject *parent)
 
 	m_recreateTimer = NULL;
 
-	m_failedCreationAttempts = 0;
+	m_smoothingTimer = NULL;
+
+	m_connectedDevice = SupportedDevices::DefaultDeviceType;
 
-	m_savedBrightness = SettingsScope::Profile::Device::BrightnessDefault;
+	// child, so it follows the manager to its thread
+	m_router = new LedDeviceRouter(this);
+	m_routesConnectedDevice = SupportedDevices::DeviceTypesCount;
 
-	m_savedBrightnessCap = SettingsScope::Profile::Device::BrightnessCapDefault;
+	m_failedCreationAttempts = 0;
 
 	m_ledDevices.reserve(SupportedDevices::DeviceTypesCount);
 	for (int i = 0; i < SupportedDevices::DeviceTypesCount; i++)
@@ -100,6 +111,17 @@ void LedDeviceManager::init()
 		connect(m_recreateTimer, &QTimer::timeout, this, &LedDeviceManager::recreateLedDevice);
 	}
 
+	if (!m_smoothingTimer) {
+		m_smoothingTimer = new QTimer(this);
+		m_smoothingTimer->setTimerType(Qt::PreciseTimer);
+		connect(m_smoothingTimer, &QTimer::timeout, this, &LedDeviceManager::smoothingTick);
+	}
+	m_smoother.setTimeConstant(Settings::getDeviceHostSmoothingTime());
+	m_smoother.setOutputRate(Settings::getDeviceHostSmoothingRate());
+	m_smoothingTimer->setInterval(m_smoother.interval());
+
+	initZoneResampler();
+
 	initLedDevice();
 }
 
@@ -117,8 +139,10 @@ void LedDeviceManager::switchOnLeds()
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
 	m_backlightStatus = Backlight::StatusOn;
-	if (m_isColorsSaved)
+	if (m_isColorsSaved) {
+		m_router->setColors(m_savedFrame);
 		emit ledDeviceSetColors(m_savedColors);
+	}
 }
 
 void LedDeviceManager::setColors(const QList<QRgb> & colors)
@@ -126,248 +150,279 @@ void LedDeviceManager::setColors(const QList<QRgb> & colors)
 	DEBUG_HIGH_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted
 					<< " m_backlightStatus = " << m_backlightStatus;
 
+	if (m_backlightStatus != Backlight::StatusOn)
+		return;
+
+	const QList<QRgb> & ledColors =
+		m_zoneResampler.resample(colors, m_resampledColors) ? m_resampledColors : colors;
+
+	if (isHostSmoothingActive()) {
+		// the smoothing timer sends the filtered colors at its own rate
+		m_smoother.setTarget(ledColors);
+		if (!m_smoothingTimer->isActive()) {
+			m_smoothingTimer->start();
+			smoothingTick();
+		}
+	} else {
+		sendColors(ledColors);
+	}
+}
+
+void LedDeviceManager::takeMailboxColors()
+{
+	if (m_frameMailbox.take(m_mailboxColors))
+		setColors(m_mailboxColors);
+}
+
+void LedDeviceManager::sendColors(const QList<QRgb> & colors)
+{
 	if (m_backlightStatus == Backlight::StatusOn)
 	{
-		m_savedColors = colors;
+		m_router->setColors(colors);
+
+		// copies, sharing would make the next mailbox, resampler or smoother frame allocate
+		FrameMailbox::copyFrame(colors, m_savedFrame);
+		if (m_primaryRoutes.isEmpty())
+			FrameMailbox::copyFrame(colors, m_savedColors);
+		else
+			LedDeviceRouter::route(colors, m_primaryRoutes, m_savedColors);
 		m_isColorsSaved = true;
-		if (m_isLastCommandCompleted)
-		{
-			m_cmdTimeoutTimer->start();
-			m_isLastCommandCompleted = false;
-			emit ledDeviceSetColors(colors);
-		} else {
-			cmdQueueAppend(LedDeviceCommands::SetColors);
+		cmdQueueAppend(LedDeviceCommands::SetColors);
+	}
+}
+
+void LedDeviceManager::smoothingTick()
+{
+	if (m_backlightStatus != Backlight::StatusOn || !isHostSmoothingActive()) {
+		stopHostSmoothing();
+		return;
+	}
+
+	const bool isMoving = m_smoother.step(m_smoothedColors);
+	sendColors(m_smoothedColors);
+	if (!isMoving)
+		m_smoothingTimer->stop();
+}
+
+bool LedDeviceManager::isHostSmoothingActive() const
+{
+	// Lightpack firmware smooths on its own, see setSmoothSlowdown()
+	return m_smoother.isEnabled() && m_connectedDevice != SupportedDevices::DeviceTypeLightpack;
+}
+
+void LedDeviceManager::stopHostSmoothing()
+{
+	if (m_smoothingTimer)
+		m_smoothingTimer->stop();
+	m_smoother.reset();
+}
+
+void LedDeviceManager::setHostSmoothingTime(int value)
+{
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << value;
+
+	m_smoother.setTimeConstant(value);
+	if (!m_smoother.isEnabled())
+		stopHostSmoothing();
+}
+
+void LedDeviceManager::setHostSmoothingRate(int value)
+{
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << value;
+
+	m_smoother.setOutputRate(value);
+	if (m_smoothingTimer)
+		m_smoothingTimer->setInterval(m_smoother.interval());
+}
+
+void LedDeviceManager::setDeviceRoutes(const QString & routes)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << routes;
+
+	initRoutes(routes);
+}
+
+void LedDeviceManager::initRoutes(const QString & routes)
+{
+	m_router->clear();
+	m_primaryRoutes.clear();
+	m_routes = routes;
+	m_routesConnectedDevice = m_connectedDevice;
+
+	QMap<SupportedDevices::DeviceType, QList<LedDeviceRouter::Route> > routesByDevice;
+	for (const LedDeviceRouter::Route &route : LedDeviceRouter::parseRoutes(routes)) {
+		bool ok = false;
+		const SupportedDevices::DeviceType deviceType = Settings::getDeviceTypeByName(route.device, &ok);
+		if (!ok) {
+			qWarning() << Q_FUNC_INFO << "unknown device in route:" << route.device;
+			continue;
 		}
+#		if !defined(Q_OS_WIN)
+		// createLedDevice() would reset the connected device
+		if (deviceType == SupportedDevices::DeviceTypeAlienFx) {
+			qWarning() << Q_FUNC_INFO << "AlienFx not supported on current platform";
+			continue;
+		}
+#		endif /* Q_OS_WIN */
+		routesByDevice[deviceType].append(route);
 	}
+
+	for (auto it = routesByDevice.cbegin(); it != routesByDevice.cend(); ++it) {
+		if (it.key() == m_connectedDevice)
+			m_primaryRoutes = it.value();
+		else
+			m_router->addOutput(createLedDevice(it.key()), it.value());
+	}
+	m_router->updateDeviceSettings();
 }
 
 void LedDeviceManager::switchOffLeds()
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_cmdTimeoutTimer->start();
-		m_isLastCommandCompleted = false;
-		processOffLeds();
-	} else {
-		cmdQueueAppend(LedDeviceCommands::OffLeds);
-	}
+	stopHostSmoothing();
+
+	cmdQueueAppend(LedDeviceCommands::OffLeds);
 }
 
 void LedDeviceManager::processOffLeds()
 {
 	m_backlightStatus = Backlight::StatusOff;
+	// grabbed before the leds were switched off
+	m_cmdQueue.remove(LedDeviceCommands::SetColors);
 
+	// the outputs go dark together with m_ledDevice, after the frames queued before OffLeds
+	m_router->switchOffLeds();
 	emit ledDeviceOffLeds();
 }
 
-void LedDeviceManager::setUsbPowerLedDisabled(bool isDisabled) {
-	DEBUG_MID_LEVEL << Q_FUNC_INFO << isDisabled
-		<< "Is last command completed:" << m_isLastCommandCompleted;
+void LedDeviceManager::setUsbPowerLedDisabled(bool isDisabled)
+{
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << isDisabled << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted) {
-		m_cmdTimeoutTimer->start();
-		m_isLastCommandCompleted = false;
-		emit ledDeviceSetUsbPowerLedDisabled(isDisabled);
-	} else {
-		m_savedUsbPowerLedDisabled = isDisabled;
-		cmdQueueAppend(LedDeviceCommands::SetUsbPowerLedDisabled);
-	}
+	cmdQueueAppend(LedDeviceCommands::SetUsbPowerLedDisabled, isDisabled);
 }
 
 void LedDeviceManager::setRefreshDelay(int value)
 {
-	DEBUG_MID_LEVEL << Q_FUNC_INFO << value
-					<< "Is last command completed:" << m_isLastCommandCompleted;
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_cmdTimeoutTimer->start();
-		m_isLastCommandCompleted = false;
-		emit ledDeviceSetRefreshDelay(value);
-	} else {
-		m_savedRefreshDelay = value;
-		cmdQueueAppend(LedDeviceCommands::SetRefreshDelay);
-	}
+	cmdQueueAppend(LedDeviceCommands::SetRefreshDelay, value);
 }
 
 void LedDeviceManager::setColorDepth(int value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_cmdTimeoutTimer->start();
-		m_isLastCommandCompleted = false;
-		emit ledDeviceSetColorDepth(value);
-	} else {
-		m_savedColorDepth = value;
-		cmdQueueAppend(LedDeviceCommands::SetColorDepth);
-	}
+	cmdQueueAppend(LedDeviceCommands::SetColorDepth, value);
 }
 
 void LedDeviceManager::setSmoothSlowdown(int value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceSetSmoothSlowdown(value);
-	} else {
-		m_savedSmoothSlowdown = value;
-		cmdQueueAppend(LedDeviceCommands::SetSmoothSlowdown);
-	}
+	cmdQueueAppend(LedDeviceCommands::SetSmoothSlowdown, value);
 }
 
 void LedDeviceManager::setGamma(double value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceSetGamma(value, m_backlightStatus != Backlight::StatusOff);
-	} else {
-		m_savedGamma = value;
-		cmdQueueAppend(LedDeviceCommands::SetGamma);
-	}
+	if (cmdQueueAppend(LedDeviceCommands::SetGamma, value))
+		m_router->updateDeviceSettings();
 }
 
 void LedDeviceManager::setBrightness(int value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceSetBrightness(value, m_backlightStatus != Backlight::StatusOff);
-	} else {
-		m_savedBrightness = value;
-		cmdQueueAppend(LedDeviceCommands::SetBrightness);
-	}
+	if (cmdQueueAppend(LedDeviceCommands::SetBrightness, value))
+		m_router->updateDeviceSettings();
 }
 
 void LedDeviceManager::setBrightnessCap(int value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceSetBrightnessCap(value, m_backlightStatus != Backlight::StatusOff);
-	}
-	else {
-		m_savedBrightnessCap = value;
-		cmdQueueAppend(LedDeviceCommands::SetBrightnessCap);
-	}
+	if (cmdQueueAppend(LedDeviceCommands::SetBrightnessCap, value))
+		m_router->updateDeviceSettings();
 }
 
 void LedDeviceManager::setLuminosityThreshold(int value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceSetLuminosityThreshold(value, m_backlightStatus != Backlight::StatusOff);
-	} else {
-		m_savedLuminosityThreshold = value;
-		cmdQueueAppend(LedDeviceCommands::SetLuminosityThreshold);
-	}
+	if (cmdQueueAppend(LedDeviceCommands::SetLuminosityThreshold, value))
+		m_router->updateDeviceSettings();
 }
 
 void LedDeviceManager::setMinimumLuminosityEnabled(bool value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceSetMinimumLuminosityEnabled(value, m_backlightStatus != Backlight::StatusOff);
-	} else {
-		m_savedIsMinimumLuminosityEnabled = value;
-		cmdQueueAppend(LedDeviceCommands::SetMinimumLuminosityEnabled);
-	}
+	if (cmdQueueAppend(LedDeviceCommands::SetMinimumLuminosityEnabled, value))
+		m_router->updateDeviceSettings();
 }
 
-void LedDeviceManager::setDitheringEnabled(bool isEnabled) {
-	DEBUG_MID_LEVEL << Q_FUNC_INFO << isEnabled
-		<< "Is last command completed:" << m_isLastCommandCompleted;
+void LedDeviceManager::setDitheringEnabled(bool isEnabled)
+{
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << isEnabled << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted) {
-		m_cmdTimeoutTimer->start();
-		m_isLastCommandCompleted = false;
-		emit ledDeviceSetDitheringEnabled(isEnabled, m_backlightStatus != Backlight::StatusOff);
-	}
-	else {
-		m_savedDitheringEnabled = isEnabled;
-		cmdQueueAppend(LedDeviceCommands::SetDitheringEnabled);
-	}
+	if (cmdQueueAppend(LedDeviceCommands::SetDitheringEnabled, isEnabled))
+		m_router->updateDeviceSettings();
 }
 
 void LedDeviceManager::setColorSequence(const QString& value)
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << value << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceSetColorSequence(value);
-	} else {
-		m_savedColorSequence = value;
-		cmdQueueAppend(LedDeviceCommands::SetColorSequence);
-	}
+	cmdQueueAppend(LedDeviceCommands::SetColorSequence, value);
 }
 
 void LedDeviceManager::requestFirmwareVersion()
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceRequestFirmwareVersion();
-	} else {
-		cmdQueueAppend(LedDeviceCommands::RequestFirmwareVersion);
-	}
+	cmdQueueAppend(LedDeviceCommands::RequestFirmwareVersion);
 }
 
 void LedDeviceManager::updateDeviceSettings()
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceUpdateDeviceSettings();
-	} else {
-		cmdQueueAppend(LedDeviceCommands::UpdateDeviceSettings);
-	}
+	m_router->updateDeviceSettings();
+
+	cmdQueueAppend(LedDeviceCommands::UpdateDeviceSettings);
 }
 
 void LedDeviceManager::updateWBAdjustments()
 {
 	DEBUG_MID_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted;
 
-	if (m_isLastCommandCompleted)
-	{
-		m_isLastCommandCompleted = false;
-		m_cmdTimeoutTimer->start();
-		emit ledDeviceUpdateWBAdjustments();
-	} else {
-		cmdQueueAppend(LedDeviceCommands::UpdateWBAdjustments);
-	}
+	m_router->updateDeviceSettings();
+
+	cmdQueueAppend(LedDeviceCommands::UpdateWBAdjustments);
+}
+
+void LedDeviceManager::updateZoneResampling()
+{
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << Settings::getGrabZoneResampling() << Settings::getGrabZoneResamplingInterpolation();
+
+	initZoneResampler();
+
+	// the device resamples its white balance with the same settings
+	updateWBAdjustments();
+}
+
+void LedDeviceManager::initZoneResampler()
+{
+	m_zoneResampler.configure(
+		Grab::ZoneResampler::parseSegments(Settings::getGrabZoneResampling()),
+		Grab::ZoneResampler::parseInterpolation(Settings::getGrabZoneResamplingInterpolation()));
+
+	const int numberOfLeds = Settings::getNumberOfLeds(Settings::getConnectedDevice());
+	if (m_zoneResampler.isEnabled() && m_zoneResampler.zoneCount() != numberOfLeds)
+		qWarning() << Q_FUNC_INFO << "zone resampling expects" << m_zoneResampler.zoneCount() << "zones, have" << numberOfLeds;
 }
 
 void LedDeviceManager::ledDeviceCommandCompleted(bool ok)
@@ -378,14 +433,12 @@ void LedDeviceManager::ledDeviceCommandCompleted(bool ok)
 
 	if (ok)
 	{
-		if (m_cmdQueue.isEmpty() == false)
-			cmdQueueProcessNext();
-		else
-			m_isLastCommandCompleted = true;
+		cmdQueueProcessNext();
 	}
 	else
 	{
 		m_cmdQueue.clear();
+		m_cmdQueue.invalidate();
 		m_isLastCommandCompleted = true;
 	}
 
@@ -435,9 +488,19 @@ void LedDeviceManager::initLedDevice()
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
 	m_isLastCommandCompleted = true;
+	// the device (re)loads everything from the settings below
+	m_cmdQueue.invalidate();
 
 	SupportedDevices::DeviceType connectedDevice = Settings::getConnectedDevice();
 
+	stopHostSmoothing();
+	m_connectedDevice = connectedDevice;
+
+	// a retried or recreated primary device must not reopen the other outputs
+	const QString routes = Settings::getDeviceRoutes();
+	if (routes != m_routes || connectedDevice != m_routesConnectedDevice)
+		initRoutes(routes);
+
 	if (m_ledDevices[connectedDevice] == NULL)
 	{
 		m_ledDevice = m_ledDevices[connectedDevice] = createLedDevice(connectedDevice);
@@ -511,9 +574,42 @@ AbstractLedDevice * LedDeviceManager::createLedDevice(SupportedDevices::DeviceTy
 		device = (AbstractLedDevice*)new LedDeviceWarls(Settings::getWarlsAddress(), Settings::getWarlsPort(), Settings::getWarlsTimeout());
 		break;
 
+	case SupportedDevices::DeviceTypeDdp:
+		DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::DdpDevice";
+		device = (AbstractLedDevice*)new LedDeviceDdp(Settings::getDdpAddress(), Settings::getDdpPort(), Settings::getDdpTimeout());
+		break;
+
+	case SupportedDevices::DeviceTypeE131:
+		DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::E131Device";
+		device = (AbstractLedDevice*)new LedDeviceE131(Settings::getE131Address(), Settings::getE131Port(), Settings::getE131Universe(),
+			Settings::isE131MulticastEnabled(), Settings::isE131SyncEnabled());
+		break;
+
+	case SupportedDevices::DeviceTypeArtNet:
+		DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::ArtNetDevice";
+		device = (AbstractLedDevice*)new LedDeviceArtNet(Settings::getArtNetAddress(), Settings::getArtNetPort(), Settings::getArtNetUniverse(),
+			Settings::isArtNetSyncEnabled());
+		break;
+
+	case SupportedDevices::DeviceTypeAdaptiveUdp:
+		DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::AdaptiveUdpDevice";
+		device = (AbstractLedDevice*)new LedDeviceAdaptiveUdp(Settings::getAdaptiveUdpAddress(), Settings::getAdaptiveUdpPort(), Settings::getAdaptiveUdpTimeout(),
+			Settings::getAdaptiveUdpRefreshInterval());
+		break;
+
+	case SupportedDevices::DeviceTypeRecorder:
+		DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::RecorderDevice";
+		device = (AbstractLedDevice*)new LedDeviceRecorder(Settings::getRecorderPath());
+		break;
+
+	case SupportedDevices::DeviceTypeNullSink:
+		DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::NullSinkDevice";
+		device = (AbstractLedDevice*)new LedDeviceNullSink(Settings::getNullSinkEncoder());
+		break;
+
 	case SupportedDevices::DeviceTypeVirtual:
 		DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::VirtualDevice";
-		device = (AbstractLedDevice *)new LedDeviceVirtual();
+		device = (AbstractLedDevice *)new LedDeviceVirtual(Settings::getVirtualSharedMemoryName());
 		break;
 
 	default:
@@ -579,108 +675,81 @@ void LedDeviceManager::disconnectSignalSlotsLedDevice()
 	disconnect(this, nullptr, m_ledDevice, nullptr);
 }
 
-void LedDeviceManager::cmdQueueAppend(LedDeviceCommands::Cmd cmd)
+bool LedDeviceManager::cmdQueueAppend(LedDeviceCommands::Cmd cmd, const QVariant &value)
 {
-	DEBUG_MID_LEVEL << Q_FUNC_INFO << cmd;
+	DEBUG_MID_LEVEL << Q_FUNC_INFO << cmd << value;
 
-	if (m_cmdQueue.contains(cmd) == false)
+	if (m_cmdQueue.append(cmd, value) == false)
 	{
-		m_cmdQueue.append(cmd);
+		DEBUG_MID_LEVEL << Q_FUNC_INFO << "device already has it, skipped";
+		return false;
 	}
+
+	if (m_isLastCommandCompleted)
+		cmdQueueProcessNext();
+	return true;
 }
 
 void LedDeviceManager::cmdQueueProcessNext()
 {
-	DEBUG_MID_LEVEL << Q_FUNC_INFO << m_cmdQueue;
-
-	if (m_cmdQueue.isEmpty() == false)
+	while (m_cmdQueue.isEmpty() == false)
 	{
-		LedDeviceCommands::Cmd cmd = m_cmdQueue.takeFirst();
+		const QList<LedDeviceCommands::Cmd> cmds = m_cmdQueue.takeNext();
 
-		DEBUG_HIGH_LEVEL << Q_FUNC_INFO << "processing cmd = " << cmd;
+		DEBUG_HIGH_LEVEL << Q_FUNC_INFO << "processing cmds = " << cmds;
 
-		switch(cmd)
+		const bool isWaiting = LedDeviceCommands::SetColors == cmds.first() || LedDeviceCommandQueue::isHostSide(cmds.first())
+				? cmdProcessHostSide(cmds)
+				: cmdProcess(cmds.first());
+		if (isWaiting)
 		{
-		case LedDeviceCommands::OffLeds:
-			m_cmdTimeoutTimer->start();
-			processOffLeds();
-			break;
-
-		case LedDeviceCommands::SetColors:
-			if (m_isColorsSaved) {
-				m_cmdTimeoutTimer->start();
-				emit ledDeviceSetColors(m_savedColors);
-			}
-			break;
-
-		case LedDeviceCommands::SetUsbPowerLedDisabled:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetUsbPowerLedDisabled(m_savedUsbPowerLedDisabled);
-			break;
-
-		case LedDeviceCommands::SetRefreshDelay:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetRefreshDelay(m_savedRefreshDelay);
-			break;
-
-		case LedDeviceCommands::SetColorDepth:
+			m_isLastCommandCompleted = false;
 			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetColorDepth(m_savedColorDepth);
-			break;
+			return;
+		}
+	}
+	m_isLastCommandCompleted = true;
+}
 
-		case LedDeviceCommands::SetSmoothSlowdown:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetSmoothSlowdown(m_savedSmoothSlowdown);
-			break;
+bool LedDeviceManager::cmdProcessHostSide(const QList<LedDeviceCommands::Cmd> & cmds)
+{
+	const bool isSendColors = cmds.last() == LedDeviceCommands::SetColors
+			&& m_isColorsSaved && m_backlightStatus == Backlight::StatusOn;
+	// the settings are applied on the host side, the last one makes the device
+	// resend its colors unless new colors follow anyway
+	const bool isUpdateColors = !isSendColors && m_backlightStatus != Backlight::StatusOff;
+	const int lastSetting = cmds.last() == LedDeviceCommands::SetColors ? cmds.size() - 2 : cmds.size() - 1;
+
+	for (int i = 0; i <= lastSetting; i++)
+	{
+		const LedDeviceCommands::Cmd cmd = cmds[i];
+		const QVariant value = m_cmdQueue.value(cmd);
+		const bool updateColors = isUpdateColors && i == lastSetting;
 
+		switch(cmd)
+		{
 		case LedDeviceCommands::SetGamma:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetGamma(m_savedGamma, m_backlightStatus != Backlight::StatusOff);
+			emit ledDeviceSetGamma(value.toDouble(), updateColors);
 			break;
 
 		case LedDeviceCommands::SetBrightness:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetBrightness(m_savedBrightness, m_backlightStatus != Backlight::StatusOff);
+			emit ledDeviceSetBrightness(value.toInt(), updateColors);
 			break;
 
 		case LedDeviceCommands::SetBrightnessCap:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetBrightnessCap(m_savedBrightnessCap, m_backlightStatus != Backlight::StatusOff);
-			break;
-
-		case LedDeviceCommands::SetColorSequence:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetColorSequence(m_savedColorSequence);
+			emit ledDeviceSetBrightnessCap(value.toInt(), updateColors);
 			break;
 
 		case LedDeviceCommands::SetLuminosityThreshold:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetLuminosityThreshold(m_savedLuminosityThreshold, m_backlightStatus != Backlight::StatusOff);
+			emit ledDeviceSetLuminosityThreshold(value.toInt(), updateColors);
 			break;
 
 		case LedDeviceCommands::SetMinimumLuminosityEnabled:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetMinimumLuminosityEnabled(m_savedIsMinimumLuminosityEnabled, m_backlightStatus != Backlight::StatusOff);
+			emit ledDeviceSetMinimumLuminosityEnabled(value.toBool(), updateColors);
 			break;
 
 		case LedDeviceCommands::SetDitheringEnabled:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceSetDitheringEnabled(m_savedDitheringEnabled, m_backlightStatus != Backlight::StatusOff);
-			break;
-
-		case LedDeviceCommands::RequestFirmwareVersion:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceRequestFirmwareVersion();
-			break;
-
-		case LedDeviceCommands::UpdateDeviceSettings:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceUpdateDeviceSettings();
-			break;
-
-		case LedDeviceCommands::UpdateWBAdjustments:
-			m_cmdTimeoutTimer->start();
-			emit ledDeviceUpdateWBAdjustments();
+			emit ledDeviceSetDitheringEnabled(value.toBool(), updateColors);
 			break;
 
 		default:
@@ -688,6 +757,63 @@ void LedDeviceManager::cmdQueueProcessNext()
 			break;
 		}
 	}
+
+	if (isSendColors)
+		emit ledDeviceSetColors(m_savedColors);
+
+	// the device only answers when it sends colors
+	return isSendColors || (isUpdateColors && lastSetting >= 0);
+}
+
+bool LedDeviceManager::cmdProcess(LedDeviceCommands::Cmd cmd)
+{
+	const QVariant value = m_cmdQueue.value(cmd);
+
+	switch(cmd)
+	{
+	case LedDeviceCommands::OffLeds:
+		processOffLeds();
+		break;
+
+	case LedDeviceCommands::SetUsbPowerLedDisabled:
+		emit ledDeviceSetUsbPowerLedDisabled(value.toBool());
+		break;
+
+	case LedDeviceCommands::SetRefreshDelay:
+		emit ledDeviceSetRefreshDelay(value.toInt());
+		break;
+
+	case LedDeviceCommands::SetColorDepth:
+		emit ledDeviceSetColorDepth(value.toInt());
+		break;
+
+	case LedDeviceCommands::SetSmoothSlowdown:
+		emit ledDeviceSetSmoothSlowdown(value.toInt());
+		break;
+
+	case LedDeviceCommands::SetColorSequence:
+		emit ledDeviceSetColorSequence(value.toString());
+		break;
+
+	case LedDeviceCommands::RequestFirmwareVersion:
+		emit ledDeviceRequestFirmwareVersion();
+		break;
+
+	case LedDeviceCommands::UpdateDeviceSettings:
+		// the device reloads everything from the settings
+		m_cmdQueue.invalidate();
+		emit ledDeviceUpdateDeviceSettings();
+		break;
+
+	case LedDeviceCommands::UpdateWBAdjustments:
+		emit ledDeviceUpdateWBAdjustments();
+		break;
+
+	default:
+		qCritical() << Q_FUNC_INFO << "fail process cmd =" << cmd;
+		return false;
+	}
+	return true;
 }
 
 void LedDeviceManager::ledDeviceCommandTimedOut()
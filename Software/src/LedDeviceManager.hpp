@@ -28,6 +28,11 @@
 
 #include "enums.hpp"
 #include "AbstractLedDevice.hpp"
+#include "TemporalSmoother.hpp"
+#include "LedDeviceRouter.hpp"
+#include "FrameMailbox.hpp"
+#include "LedDeviceCommandQueue.hpp"
+#include "ZoneResampler.hpp"
 
 class QTimer;
 
@@ -43,6 +48,12 @@ public:
 	explicit LedDeviceManager(QObject *parent = 0);
 	virtual ~LedDeviceManager();
 
+	/*!
+		Grabbed frames are posted here instead of being queued as signals,
+		\a takeMailboxColors() is the wake-up slot.
+	*/
+	FrameMailbox * frameMailbox() { return &m_frameMailbox; }
+
 signals:
 	void openDeviceSuccess(bool isSuccess);
 	void ioDeviceSuccess(bool isSuccess);
@@ -76,6 +87,7 @@ public slots:
 
 	// This slots are protected from the overflow of queries
 	void setColors(const QList<QRgb> & colors);
+	void takeMailboxColors();
 	void switchOffLeds();
 	void switchOnLeds();
 	void setUsbPowerLedDisabled(bool isDisabled);
@@ -91,22 +103,34 @@ public slots:
 	void setColorSequence(const QString& value);
 	void requestFirmwareVersion();
 	void updateWBAdjustments();
+	void updateZoneResampling();
 	void updateDeviceSettings();
+	void setHostSmoothingTime(int value);
+	void setHostSmoothingRate(int value);
+	void setDeviceRoutes(const QString & routes);
 
 private slots:
 	void ledDeviceCommandCompleted(bool ok);
 	void ledDeviceCommandTimedOut();
 	void ledDeviceOpenDeviceSuccess(bool isSuccess);
 	void ledDeviceIoDeviceSuccess(bool isSuccess);
+	void smoothingTick();
 
 private:
 	void initLedDevice();
 	AbstractLedDevice * createLedDevice(SupportedDevices::DeviceType deviceType);
 	void connectSignalSlotsLedDevice();
 	void disconnectSignalSlotsLedDevice();
-	void cmdQueueAppend(LedDeviceCommands::Cmd);
+	bool cmdQueueAppend(LedDeviceCommands::Cmd cmd, const QVariant &value = QVariant());
 	void cmdQueueProcessNext();
+	bool cmdProcessHostSide(const QList<LedDeviceCommands::Cmd> & cmds);
+	bool cmdProcess(LedDeviceCommands::Cmd cmd);
 	void processOffLeds();
+	void sendColors(const QList<QRgb> & colors);
+	bool isHostSmoothingActive() const;
+	void stopHostSmoothing();
+	void initZoneResampler();
+	void initRoutes(const QString & routes);
 	void triggerRecreateLedDevice();
 
 private:
@@ -114,20 +138,18 @@ private:
 	bool m_isColorsSaved;
 	Backlight::Status m_backlightStatus;
 
-	QList<LedDeviceCommands::Cmd> m_cmdQueue;
+	LedDeviceCommandQueue m_cmdQueue;
 
 	QList<QRgb> m_savedColors;
-	bool m_savedUsbPowerLedDisabled;
-	int m_savedRefreshDelay;
-	int m_savedColorDepth;
-	int m_savedSmoothSlowdown;
-	double m_savedGamma;
-	int m_savedBrightness;
-	int m_savedBrightnessCap;
-	int m_savedLuminosityThreshold;
-	bool m_savedIsMinimumLuminosityEnabled;
-	bool m_savedDitheringEnabled;
-	QString m_savedColorSequence;
+	// the whole frame m_savedColors was routed from, switchOnLeds() relights the outputs with it
+	QList<QRgb> m_savedFrame;
+
+	FrameMailbox m_frameMailbox;
+	QList<QRgb> m_mailboxColors;
+
+	// every color source (grab, mood lamp, sound, API) is stretched from zones to LEDs here
+	Grab::ZoneResampler m_zoneResampler;
+	QList<QRgb> m_resampledColors;
 
 	QList<AbstractLedDevice *> m_ledDevices;
 	AbstractLedDevice *m_ledDevice;
@@ -135,4 +157,16 @@ private:
 	QTimer *m_cmdTimeoutTimer;
 	QTimer *m_recreateTimer;
 	int m_failedCreationAttempts;
+
+	SupportedDevices::DeviceType m_connectedDevice;
+	TemporalSmoother m_smoother;
+	QList<QRgb> m_smoothedColors;
+	QTimer *m_smoothingTimer;
+
+	// extra devices next to m_ledDevice and the part of the frame m_ledDevice gets
+	LedDeviceRouter *m_router;
+	QList<LedDeviceRouter::Route> m_primaryRoutes;
+	// what m_router was built from, recreating m_ledDevice keeps its outputs
+	QString m_routes;
+	SupportedDevices::DeviceType m_routesConnectedDevice;
 };
@@ -0,0 +1,301 @@
+/*
+ * LedDeviceNullSink.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "LedDeviceNullSink.hpp"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicPointer>
+#include "LedDeviceAdalight.hpp"
+#include "LedDeviceArdulight.hpp"
+#include "LedDeviceDrgb.hpp"
+#include "LedDeviceDnrgb.hpp"
+#include "LedDeviceDdp.hpp"
+#include "HidReportWriter.hpp"
+#include "enums.hpp"
+#include "debug.h"
+
+#include "../../CommonHeaders/COMMANDS.h"	/* CMD defines */
+
+namespace {
+const char * const EncoderNames[LedDeviceNullSink::EncodersCount] = {
+	"Lightpack", "Adalight", "Ardulight", "DRGB", "DNRGB", "DDP"
+};
+const char * const StageNames[LedDeviceNullSink::StagesCount] = {
+	"modify", "dither", "encode", "total"
+};
+
+const quint8 UdpTimeout = 255;
+
+QMutex g_statisticsMutex;
+LedDeviceNullSink::Statistics g_statistics;
+// the null sink g_statistics belong to, there is only one at a time
+QAtomicPointer<LedDeviceNullSink> g_openSink;
+}
+
+LedDeviceNullSink::LedDeviceNullSink(const QString &encoder, QObject * parent)
+	: AbstractLedDevice(parent)
+	, m_encoder(EncoderAdalight)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << encoder;
+
+	bool isFound = false;
+	for (int i = 0; i < EncodersCount; i++) {
+		if (encoder.compare(QLatin1String(EncoderNames[i]), Qt::CaseInsensitive) == 0) {
+			m_encoder = (Encoder)i;
+			isFound = true;
+		}
+	}
+	if (!isFound)
+		qWarning() << Q_FUNC_INFO << "unknown encoder" << encoder << "using" << encoderName(m_encoder);
+
+	// the UDP protocols are 8 bit RGB and have no color sequence setting
+	m_wireEncoder.setColorSequence(QStringLiteral("RGB"));
+	if (m_encoder == EncoderArdulight)
+		m_wireEncoder.setMaxValue(254);
+}
+
+LedDeviceNullSink::~LedDeviceNullSink()
+{
+	close();
+}
+
+int LedDeviceNullSink::maxLedsCount()
+{
+	return MaximumNumberOfLeds::NullSink;
+}
+
+QString LedDeviceNullSink::encoderName(Encoder encoder)
+{
+	return QLatin1String(EncoderNames[encoder]);
+}
+
+QString LedDeviceNullSink::stageName(Stage stage)
+{
+	return QLatin1String(StageNames[stage]);
+}
+
+LedDeviceNullSink::Statistics LedDeviceNullSink::statistics()
+{
+	QMutexLocker locker(&g_statisticsMutex);
+	return g_statistics;
+}
+
+void LedDeviceNullSink::resetStatistics()
+{
+	QMutexLocker locker(&g_statisticsMutex);
+	g_statistics.ledsCount = 0;
+	g_statistics.bytesPerFrame = 0;
+	g_statistics.packetsPerFrame = 0;
+	for (LatencyHistogram &histogram : g_statistics.stages)
+		histogram.reset();
+}
+
+void LedDeviceNullSink::open()
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << encoderName(m_encoder);
+
+	if (!g_openSink.testAndSetOrdered(nullptr, this) && g_openSink.loadAcquire() != this) {
+		qWarning() << Q_FUNC_INFO << "another null sink is open, their statistics would mix";
+		emit openDeviceSuccess(false);
+		return;
+	}
+
+	resetStatistics();
+	{
+		QMutexLocker locker(&g_statisticsMutex);
+		g_statistics.encoder = encoderName(m_encoder);
+	}
+	m_colorsBuffer.clear();
+	emit openDeviceSuccess(true);
+}
+
+void LedDeviceNullSink::close()
+{
+	g_openSink.testAndSetOrdered(this, nullptr);
+}
+
+void LedDeviceNullSink::resizeColorsBuffer(int buffSize)
+{
+	if (m_colorsBuffer.count() == buffSize)
+		return;
+
+	if (buffSize > maxLedsCount()) {
+		qCritical() << Q_FUNC_INFO << "buffSize > maxLedsCount()" << buffSize << ">" << maxLedsCount();
+		buffSize = maxLedsCount();
+	}
+	m_colorsBuffer.clear();
+	m_colorsBuffer.reserve(buffSize);
+	for (int i = 0; i < buffSize; i++)
+		m_colorsBuffer << StructRgb();
+
+	// the same headers the real devices build
+	QByteArray header;
+	switch (m_encoder) {
+	case EncoderLightpack:
+		m_reports.fill(0, HidReportWriter::reportsCount(buffSize) * HidReportWriter::ReportSize);
+		break;
+	case EncoderAdalight:
+		header = LedDeviceAdalight::frameHeader(buffSize);
+		break;
+	case EncoderArdulight:
+		header = LedDeviceArdulight::frameHeader();
+		break;
+	case EncoderDrgb:
+		header = LedDeviceDrgb::packetHeader(UdpTimeout);
+		break;
+	case EncoderDnrgb:
+		header = LedDeviceDnrgb::packetHeader(UdpTimeout);
+		break;
+	case EncoderDdp:
+		header = LedDeviceDdp::packetHeader();
+		break;
+	default:
+		break;
+	}
+	m_wireEncoder.setHeader(header);
+	m_wireEncoder.reserve(buffSize);
+
+	resetStatistics();
+}
+
+void LedDeviceNullSink::setColors(const QList<QRgb> & colors)
+{
+	m_colorsSaved = colors;
+	if (colors.isEmpty()) {
+		emit commandCompleted(true);
+		return;
+	}
+
+	m_timer.start();
+	resizeColorsBuffer(colors.count());
+
+	applyColorModifications(colors, m_colorsBuffer);
+	const qint64 modified = m_timer.nsecsElapsed();
+
+	applyDithering(m_colorsBuffer, m_encoder == EncoderLightpack ? 12 : 8);
+	const qint64 dithered = m_timer.nsecsElapsed();
+
+	encode();
+	const qint64 encoded = m_timer.nsecsElapsed();
+
+	if (g_openSink.loadAcquire() == this) {
+		QMutexLocker locker(&g_statisticsMutex);
+		g_statistics.ledsCount = m_colorsBuffer.count();
+		g_statistics.bytesPerFrame = m_bytes;
+		g_statistics.packetsPerFrame = m_packets;
+		g_statistics.stages[StageColorModifications].add(modified);
+		g_statistics.stages[StageDithering].add(dithered - modified);
+		g_statistics.stages[StageEncoding].add(encoded - dithered);
+		g_statistics.stages[StageTotal].add(encoded);
+	}
+
+	emit commandCompleted(true);
+}
+
+void LedDeviceNullSink::encode()
+{
+	m_bytes = 0;
+	m_packets = 0;
+
+	switch (m_encoder) {
+	case EncoderLightpack:
+		encodeLightpack();
+		break;
+	case EncoderDnrgb:
+		encodePackets(LedDeviceDnrgb::LedsPerPacket);
+		break;
+	case EncoderDdp:
+		encodePackets(LedDeviceDdp::LedsPerPacket);
+		break;
+	default:
+		m_bytes = m_wireEncoder.encode(m_colorsBuffer).size();
+		m_packets = 1;
+		break;
+	}
+}
+
+void LedDeviceNullSink::encodeLightpack()
+{
+	unsigned char * const reports = reinterpret_cast<unsigned char *>(m_reports.data());
+	HidReportWriter::encodeColors(m_colorsBuffer, reports);
+
+	m_packets = m_reports.size() / HidReportWriter::ReportSize;
+	for (int i = 0; i < m_packets; i++)
+		reports[i * HidReportWriter::ReportSize + HidReportWriter::CommandIndex] = CMD_UPDATE_LEDS;
+	m_bytes = m_reports.size();
+}
+
+/*!
+	Every LED is sent, as if the whole frame changed, which is the worst case of the
+	devices that only send what changed.
+*/
+void LedDeviceNullSink::encodePackets(int ledsPerPacket)
+{
+	const int totalColors = m_colorsBuffer.count();
+	for (int first = 0; first < totalColors; first += ledsPerPacket) {
+		const int count = qMin(ledsPerPacket, totalColors - first);
+		if (m_encoder == EncoderDnrgb) {
+			m_wireEncoder.setHeaderWord(LedDeviceDnrgb::StartIndexOffset, first);
+		} else {
+			LedDeviceDdp::setPacketHeader(m_wireEncoder, first, count, first + count == totalColors, 1);
+		}
+		m_bytes += m_wireEncoder.encode(m_colorsBuffer, first, count).size();
+		m_packets++;
+	}
+}
+
+void LedDeviceNullSink::switchOffLeds()
+{
+	for (QRgb &color : m_colorsSaved)
+		color = 0;
+	emit commandCompleted(true);
+}
+
+void LedDeviceNullSink::setRefreshDelay(int /*value*/)
+{
+	emit commandCompleted(true);
+}
+
+void LedDeviceNullSink::setColorDepth(int /*value*/)
+{
+	emit commandCompleted(true);
+}
+
+void LedDeviceNullSink::setSmoothSlowdown(int /*value*/)
+{
+	emit commandCompleted(true);
+}
+
+void LedDeviceNullSink::setColorSequence(const QString& value)
+{
+	// only the serial devices have a color sequence
+	if (m_encoder == EncoderAdalight || m_encoder == EncoderArdulight)
+		m_wireEncoder.setColorSequence(value);
+	emit commandCompleted(true);
+}
+
+void LedDeviceNullSink::requestFirmwareVersion()
+{
+	emit firmwareVersion(QStringLiteral("1.0 (null sink)"));
+	emit commandCompleted(true);
+}
@@ -0,0 +1,116 @@
+/*
+ * LedDeviceNullSink.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include "AbstractLedDevice.hpp"
+#include "LatencyHistogram.hpp"
+#include "LedWireEncoder.hpp"
+
+/*!
+	Benchmark device that does everything a real device does to a frame, color
+	modifications, dithering and encoding into the wire format of \a encoder, and then
+	drops the bytes instead of writing them. Each stage is timed into a LatencyHistogram,
+	so the cost of Prismatik's side of a frame can be told from the device I/O and the
+	highest frame rate an encoder allows for a LED count can be read off.
+	The statistics of the open null sink are shared with the API server, see statistics();
+	only one null sink can be open at a time, opening a second one fails.
+*/
+class LedDeviceNullSink : public AbstractLedDevice
+{
+	Q_OBJECT
+public:
+	// protocols the frames are encoded with, named like the devices in the settings
+	enum Encoder {
+		EncoderLightpack,
+		EncoderAdalight,
+		EncoderArdulight,
+		EncoderDrgb,
+		EncoderDnrgb,
+		EncoderDdp,
+
+		EncodersCount
+	};
+
+	enum Stage {
+		StageColorModifications,
+		StageDithering,
+		StageEncoding,
+		StageTotal,
+
+		StagesCount
+	};
+
+	struct Statistics
+	{
+		QString encoder;
+		int ledsCount{0};
+		// wire bytes and packets (or HID reports) of the last frame
+		int bytesPerFrame{0};
+		int packetsPerFrame{0};
+		LatencyHistogram stages[StagesCount];
+	};
+
+	LedDeviceNullSink(const QString &encoder, QObject * parent = 0);
+	virtual ~LedDeviceNullSink();
+	QString name() const { return QStringLiteral("nullsink"); }
+	int maxLedsCount();
+	int defaultLedsCount() { return 10; }
+
+	Encoder encoder() const { return m_encoder; }
+	static QString encoderName(Encoder encoder);
+	static QString stageName(Stage stage);
+
+	/*!
+		Snapshot of the statistics of the null sink, safe to call from any thread.
+		They start over when the device is opened and when the LED count changes.
+	*/
+	static Statistics statistics();
+	static void resetStatistics();
+
+public slots:
+	void open();
+	void close();
+	void setColors(const QList<QRgb> & colors);
+	void switchOffLeds();
+	void setRefreshDelay(int /*value*/);
+	void setColorDepth(int /*value*/);
+	void setSmoothSlowdown(int /*value*/);
+	void setColorSequence(const QString& value);
+	void requestFirmwareVersion();
+
+private:
+	void resizeColorsBuffer(int buffSize);
+	void encode();
+	void encodeLightpack();
+	void encodePackets(int ledsPerPacket);
+
+	Encoder m_encoder;
+	LedWireEncoder m_wireEncoder;
+	// HID reports of chained Lightpacks
+	QByteArray m_reports;
+	int m_bytes{0};
+	int m_packets{0};
+	QElapsedTimer m_timer;
+};
@@ -0,0 +1,116 @@
+/*
+ * LedDeviceRecorder.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "LedDeviceRecorder.hpp"
+#include "enums.hpp"
+#include "debug.h"
+
+LedDeviceRecorder::LedDeviceRecorder(const QString &path, QObject * parent)
+	: AbstractLedDevice(parent)
+	, m_file(path)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << path;
+}
+
+LedDeviceRecorder::~LedDeviceRecorder()
+{
+	close();
+}
+
+int LedDeviceRecorder::maxLedsCount()
+{
+	return MaximumNumberOfLeds::Recorder;
+}
+
+void LedDeviceRecorder::open()
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_file.fileName();
+
+	close();
+	bool ok = m_file.open(QIODevice::WriteOnly | QIODevice::Truncate) && m_writer.start(&m_file);
+	if (!ok)
+		qWarning() << Q_FUNC_INFO << "can't record to" << m_file.fileName() << m_file.errorString();
+	m_clock.start();
+	emit openDeviceSuccess(ok);
+}
+
+void LedDeviceRecorder::close()
+{
+	if (!m_file.isOpen())
+		return;
+
+	m_writer.flush();
+	m_file.close();
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_writer.framesCount() << "frames recorded to" << m_file.fileName();
+}
+
+void LedDeviceRecorder::written(bool ok)
+{
+	if (!ok)
+		qWarning() << Q_FUNC_INFO << "recording to" << m_file.fileName() << "failed:" << m_file.errorString();
+	emit ioDeviceSuccess(ok);
+	emit commandCompleted(ok);
+}
+
+void LedDeviceRecorder::setColors(const QList<QRgb> & colors)
+{
+	if (colors.isEmpty()) {
+		emit commandCompleted(true);
+		return;
+	}
+	m_colorsSaved = colors;
+	written(m_file.isOpen() && m_writer.writeFrame(elapsedUs(), colors));
+}
+
+void LedDeviceRecorder::switchOffLeds()
+{
+	for (QRgb &color : m_colorsSaved)
+		color = 0;
+	written(m_file.isOpen() && m_writer.writeOff(elapsedUs()));
+}
+
+void LedDeviceRecorder::setRefreshDelay(int /*value*/)
+{
+	emit commandCompleted(true);
+}
+
+void LedDeviceRecorder::setColorDepth(int /*value*/)
+{
+	emit commandCompleted(true);
+}
+
+void LedDeviceRecorder::setSmoothSlowdown(int /*value*/)
+{
+	emit commandCompleted(true);
+}
+
+void LedDeviceRecorder::setColorSequence(const QString& /*value*/)
+{
+	emit commandCompleted(true);
+}
+
+void LedDeviceRecorder::requestFirmwareVersion()
+{
+	emit firmwareVersion(QStringLiteral("1.0 (recorder)"));
+	emit commandCompleted(true);
+}
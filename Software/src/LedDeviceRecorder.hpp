@@ -0,0 +1,67 @@
+/*
+ * LedDeviceRecorder.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include "AbstractLedDevice.hpp"
+#include "FrameRecording.hpp"
+
+/*!
+	Output device that records every frame handed to it, with its timestamp, into a
+	FrameRecording file. The colors are recorded as received, before any color
+	modification, so that FrameReplayer can push them through a real device later.
+	Routed next to another device it records that device's workload.
+*/
+class LedDeviceRecorder : public AbstractLedDevice
+{
+	Q_OBJECT
+public:
+	LedDeviceRecorder(const QString &path, QObject * parent = 0);
+	virtual ~LedDeviceRecorder();
+	QString name() const { return QStringLiteral("recorder"); }
+	int maxLedsCount();
+	int defaultLedsCount() { return 10; }
+
+	int framesCount() const { return m_writer.framesCount(); }
+
+public slots:
+	void open();
+	void close();
+	void setColors(const QList<QRgb> & colors);
+	void switchOffLeds();
+	void setRefreshDelay(int /*value*/);
+	void setColorDepth(int /*value*/);
+	void setSmoothSlowdown(int /*value*/);
+	void setColorSequence(const QString& /*value*/);
+	void requestFirmwareVersion();
+
+private:
+	qint64 elapsedUs() const { return m_clock.nsecsElapsed() / 1000; }
+	void written(bool ok);
+
+	QFile m_file;
+	FrameRecordingWriter m_writer;
+	QElapsedTimer m_clock;
+};
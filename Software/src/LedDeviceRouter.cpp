@@ -0,0 +1,224 @@
+/*
+ * LedDeviceRouter.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QStringList>
+#include <QThread>
+
+#include "LedDeviceRouter.hpp"
+#include "AbstractLedDevice.hpp"
+#include "debug.h"
+
+namespace {
+// same as the command timeout of LedDeviceManager
+const int OutputTimeoutMs = 500;
+}
+
+QList<LedDeviceRouter::Route> LedDeviceRouter::parseRoutes(const QString &routes)
+{
+	QList<Route> result;
+	const QString trimmed = routes.trimmed();
+	if (trimmed.isEmpty())
+		return result;
+
+	for (const QString &item : trimmed.split(QLatin1Char(','))) {
+		const QStringList parts = item.trimmed().split(QLatin1Char(':'));
+		if (parts.size() != 2 || parts[0].trimmed().isEmpty()) {
+			qWarning() << Q_FUNC_INFO << "bad route" << item;
+			continue;
+		}
+
+		Route route;
+		route.device = parts[0].trimmed();
+		route.isReversed = false;
+		route.isMirrored = false;
+
+		QString range = parts[1].trimmed();
+		while (range.endsWith(QLatin1Char('r'), Qt::CaseInsensitive) || range.endsWith(QLatin1Char('m'), Qt::CaseInsensitive)) {
+			if (range.endsWith(QLatin1Char('r'), Qt::CaseInsensitive))
+				route.isReversed = true;
+			else
+				route.isMirrored = true;
+			range.chop(1);
+		}
+
+		const QStringList bounds = range.split(QLatin1Char('-'));
+		bool isFirstOk = false, isLastOk = false;
+		const int first = bounds.first().trimmed().toInt(&isFirstOk);
+		const int last = bounds.last().trimmed().toInt(&isLastOk);
+		if (bounds.size() > 2 || !isFirstOk || !isLastOk || first < 0 || last < first) {
+			qWarning() << Q_FUNC_INFO << "bad route" << item;
+			continue;
+		}
+
+		route.first = first;
+		route.count = last - first + 1;
+		result.append(route);
+	}
+	return result;
+}
+
+int LedDeviceRouter::routedCount(const QList<Route> &routes)
+{
+	int count = 0;
+	for (const Route &route : routes)
+		count += route.isMirrored ? route.count * 2 : route.count;
+	return count;
+}
+
+void LedDeviceRouter::route(const QList<QRgb> &frame, const QList<Route> &routes, QList<QRgb> &colors)
+{
+	if (routes.size() == 1) {
+		const Route &only = routes.first();
+		if (only.first == 0 && only.count == frame.size() && !only.isReversed && !only.isMirrored) {
+			colors = frame;
+			return;
+		}
+	}
+
+	colors.clear();
+	colors.reserve(routedCount(routes));
+	for (const Route &route : routes) {
+		const int begin = colors.size();
+		for (int i = 0; i < route.count; ++i) {
+			const int index = route.isReversed ? route.first + route.count - 1 - i : route.first + i;
+			colors.append(index < frame.size() ? frame[index] : 0);
+		}
+		if (route.isMirrored) {
+			for (int i = route.count - 1; i >= 0; --i)
+				colors.append(colors[begin + i]);
+		}
+	}
+}
+
+LedDeviceRouter::LedDeviceRouter(QObject *parent)
+	: QObject(parent)
+{
+}
+
+LedDeviceRouter::~LedDeviceRouter()
+{
+	clear();
+}
+
+void LedDeviceRouter::addOutput(AbstractLedDevice *device, const QList<Route> &routes)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << device->name() << routedCount(routes);
+
+	Output *output = new Output();
+	output->device = device;
+	output->thread = new QThread();
+	output->routes = routes;
+	output->isBusy = false;
+	output->hasPending = false;
+
+	connect(device, &AbstractLedDevice::commandCompleted, this, [this, output](bool ok) {
+		outputCompleted(output, ok);
+	}, Qt::QueuedConnection);
+
+	device->moveToThread(output->thread);
+	output->thread->start();
+	m_outputs.append(output);
+
+	QMetaObject::invokeMethod(device, "open", Qt::QueuedConnection);
+}
+
+void LedDeviceRouter::clear()
+{
+	for (Output *output : m_outputs) {
+		disconnect(output->device, nullptr, this, nullptr);
+		// the device's sockets and timers belong to its thread, close and delete it there
+		QMetaObject::invokeMethod(output->device, "close", Qt::BlockingQueuedConnection);
+		connect(output->thread, &QThread::finished, output->device, &QObject::deleteLater);
+		output->thread->quit();
+		output->thread->wait();
+		delete output->thread;
+		delete output;
+	}
+	m_outputs.clear();
+}
+
+bool LedDeviceRouter::isBusy() const
+{
+	for (const Output *output : m_outputs) {
+		if (output->isBusy || output->hasPending)
+			return true;
+	}
+	return false;
+}
+
+void LedDeviceRouter::setColors(const QList<QRgb> &frame)
+{
+	for (Output *output : m_outputs) {
+		route(frame, output->routes, output->colors);
+
+		if (output->isBusy && output->sentAt.elapsed() > OutputTimeoutMs) {
+			qWarning() << Q_FUNC_INFO << output->device->name() << "timed out";
+			output->isBusy = false;
+		}
+
+		if (output->isBusy)
+			output->hasPending = true;
+		else
+			send(output);
+	}
+}
+
+void LedDeviceRouter::switchOffLeds()
+{
+	for (Output *output : m_outputs) {
+		output->hasPending = false;
+		QMetaObject::invokeMethod(output->device, "switchOffLeds", Qt::QueuedConnection);
+	}
+}
+
+void LedDeviceRouter::updateDeviceSettings()
+{
+	for (Output *output : m_outputs)
+		QMetaObject::invokeMethod(output->device, "updateDeviceSettings", Qt::QueuedConnection);
+}
+
+void LedDeviceRouter::send(Output *output)
+{
+	output->isBusy = true;
+	output->hasPending = false;
+	output->sentAt.start();
+	// the device gets its own implicitly shared copy, output->colors is rebuilt for the next frame
+	QMetaObject::invokeMethod(output->device, "setColors", Qt::QueuedConnection, Q_ARG(QList<QRgb>, output->colors));
+}
+
+void LedDeviceRouter::outputCompleted(Output *output, bool ok)
+{
+	// completion queued before the output was removed
+	if (!m_outputs.contains(output))
+		return;
+
+	DEBUG_HIGH_LEVEL << Q_FUNC_INFO << output->device->name() << ok;
+
+	output->isBusy = false;
+	if (output->hasPending) {
+		send(output);
+		return;
+	}
+
+	if (!isBusy())
+		emit frameCompleted();
+}
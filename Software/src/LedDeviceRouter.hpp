@@ -0,0 +1,114 @@
+/*
+ * LedDeviceRouter.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QRgb>
+#include <QString>
+
+class AbstractLedDevice;
+class QThread;
+
+/*!
+	Fans every frame out to several LED devices at once.
+	Each output owns its device and a dedicated I/O thread, receives only the LED ranges
+	routed to it and is throttled on its own, so a frame reaches all devices within the
+	time of the slowest one. A newer frame replaces one an output hasn't picked up yet.
+*/
+class LedDeviceRouter : public QObject
+{
+	Q_OBJECT
+
+public:
+	/*!
+		LEDs \a first .. \a first + \a count - 1 of the frame sent to \a device.
+		Reversed ranges are sent last to first, mirrored ranges are sent forward and then
+		backward (for strips that run along an edge and back).
+	*/
+	struct Route {
+		QString device;
+		int first;
+		int count;
+		bool isReversed;
+		bool isMirrored;
+	};
+
+	/*!
+		Parses "<device>:<first>-<last>[r][m]" entries separated by commas,
+		e.g. "Lightpack:0-9, DNRGB:10-69r". Malformed entries are skipped.
+	*/
+	static QList<Route> parseRoutes(const QString &routes);
+
+	/*!
+		Number of LEDs \a routes produce
+	*/
+	static int routedCount(const QList<Route> &routes);
+
+	/*!
+		Concatenates the ranges of \a routes taken from \a frame into \a colors.
+		LEDs outside the frame are black. A single route covering the whole frame in order
+		shares the frame's data instead of copying it.
+	*/
+	static void route(const QList<QRgb> &frame, const QList<Route> &routes, QList<QRgb> &colors);
+
+	explicit LedDeviceRouter(QObject *parent = 0);
+	virtual ~LedDeviceRouter();
+
+	/*!
+		Takes ownership of \a device, moves it to its own thread and opens it.
+	*/
+	void addOutput(AbstractLedDevice *device, const QList<Route> &routes);
+	void clear();
+
+	int outputsCount() const { return m_outputs.size(); }
+	bool isBusy() const;
+
+signals:
+	/*!
+		All outputs finished writing their latest frame
+	*/
+	void frameCompleted();
+
+public slots:
+	void setColors(const QList<QRgb> &frame);
+	void switchOffLeds();
+	void updateDeviceSettings();
+
+private:
+	struct Output {
+		AbstractLedDevice *device;
+		QThread *thread;
+		QList<Route> routes;
+		QList<QRgb> colors;
+		bool isBusy;
+		bool hasPending;
+		QElapsedTimer sentAt;
+	};
+
+	void send(Output *output);
+	void outputCompleted(Output *output, bool ok);
+
+	QList<Output *> m_outputs;
+};
@@ -33,7 +33,9 @@
 
 using namespace SettingsScope;
 
-LedDeviceVirtual::LedDeviceVirtual(QObject * parent) : AbstractLedDevice(parent)
+LedDeviceVirtual::LedDeviceVirtual(const QString &sharedMemoryName, QObject * parent)
+	: AbstractLedDevice(parent)
+	, m_sharedMemoryName(sharedMemoryName)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 }
@@ -55,6 +57,7 @@ void LedDeviceVirtual::setColors(const QList<QRgb> & colors)
 		for (const StructRgb& color : m_colorsBuffer)
 			callbackColors.append(qRgb(color.r, color.g, color.b));
 
+		m_frameRing.write(m_colorsBuffer);
 		emit colorsUpdated(callbackColors);
 	}
 	emit commandCompleted(true);
@@ -70,9 +73,12 @@ void LedDeviceVirtual::switchOffLeds()
 	int count = m_colorsSaved.count();
 	m_colorsSaved.clear();
 
+	QList<StructRgb> black;
 	for (int i = 0; i < count; i++) {
 		m_colorsSaved << 0;
+		black << StructRgb();
 	}
+	m_frameRing.write(black);
 	emit colorsUpdated(m_colorsSaved);
 	emit commandCompleted(true);
 }
@@ -107,9 +113,17 @@ void LedDeviceVirtual::requestFirmwareVersion()
 void LedDeviceVirtual::open()
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	// the preview works without the ring, a failure only costs the external readers
+	if (!m_sharedMemoryName.isEmpty() && !m_frameRing.isOpen())
+		m_frameRing.open(m_sharedMemoryName, MaximumNumberOfLeds::Virtual);
 	emit openDeviceSuccess(true);
 }
 
+void LedDeviceVirtual::close()
+{
+	m_frameRing.close();
+}
+
 void LedDeviceVirtual::resizeColorsBuffer(int buffSize)
 {
 	if (m_colorsBuffer.count() == buffSize)
@@ -27,12 +27,14 @@
 #pragma once
 
 #include "AbstractLedDevice.hpp"
+#include "LedFrameRingWriter.hpp"
 
 class LedDeviceVirtual : public AbstractLedDevice
 {
 	Q_OBJECT
 public:
-	LedDeviceVirtual(QObject * parent = 0);
+	// frames are also published to the shared memory ring \a sharedMemoryName, unless it is empty
+	LedDeviceVirtual(const QString &sharedMemoryName = QString(), QObject * parent = 0);
 	virtual ~LedDeviceVirtual() {}
 	QString name() const { return QStringLiteral("virtual"); }
 	int maxLedsCount();
@@ -40,7 +42,7 @@ public:
 
 public slots:
 	void open();
-	void close(){}
+	void close();
 	void setColors(const QList<QRgb> & colors);
 	void switchOffLeds();
 	void setRefreshDelay(int /*value*/);
@@ -51,4 +53,7 @@ public slots:
 
 private:
 	void resizeColorsBuffer(int buffSize);
+
+	QString m_sharedMemoryName;
+	LedFrameRingWriter m_frameRing;
 };
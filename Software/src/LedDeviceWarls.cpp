@@ -24,6 +24,8 @@
  *
  */
 
+#include <cstring>
+
 #include "LedDeviceWarls.hpp"
 #include "enums.hpp"
 
@@ -50,28 +52,34 @@ void LedDeviceWarls::setColors(const QList<QRgb> & colors, const bool rawColors)
 		applyDithering(m_colorsBuffer, 8);
 
 	const int totalColorsSaved = m_processedColorsSaved.count();
-	m_writeBuffer.clear();
-	m_writeBuffer.append(m_writeBufferHeader);
-	QList<QRgb> newColors;
-	newColors.reserve(colors.count());
+	const int totalColors = m_colorsBuffer.count();
+	while (m_processedColorsSaved.count() < totalColors)
+		m_processedColorsSaved << 0;
+	while (m_processedColorsSaved.count() > totalColors)
+		m_processedColorsSaved.removeLast();
+
+	// worst case size, the buffer keeps its capacity from frame to frame
+	m_writeBuffer.resize(m_writeBufferHeader.size() + totalColors * 4);
+	char *out = m_writeBuffer.data();
+	memcpy(out, m_writeBufferHeader.constData(), m_writeBufferHeader.size());
+	out += m_writeBufferHeader.size();
 
-	for (int i = 0; i < m_colorsBuffer.count(); i++)
+	for (int i = 0; i < totalColors; i++)
 	{
 		const StructRgb color = m_colorsBuffer[i];
 		const QRgb newColor = qRgb(color.r, color.g, color.b);
 		if (i >= totalColorsSaved || newColor != m_processedColorsSaved[i])
 		{
-
-			m_writeBuffer.append(i);
-			m_writeBuffer.append(color.r);
-			m_writeBuffer.append(color.g);
-			m_writeBuffer.append(color.b);
+			*out++ = (char)i;
+			*out++ = (char)color.r;
+			*out++ = (char)color.g;
+			*out++ = (char)color.b;
+			m_processedColorsSaved[i] = newColor;
 		}
-		newColors << newColor;
 	}
+	m_writeBuffer.resize(out - m_writeBuffer.constData());
 
 	m_colorsSaved = colors;
-	m_processedColorsSaved = newColors;
 
 	// This may send the header only
 	const bool ok = writeBuffer(m_writeBuffer);
@@ -0,0 +1,189 @@
+/*
+ * LedFrameRingWriter.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "LedFrameRingWriter.hpp"
+#include "../common/LedFrameRing.h"
+#include "debug.h"
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+QByteArray objectPath(const QString &name)
+{
+	return (name.startsWith(QLatin1Char('/')) ? name : QLatin1Char('/') + name).toLocal8Bit();
+}
+
+void wakeReaders(LedFrameRingHeader *header)
+{
+#ifdef Q_OS_LINUX
+	// shared between processes, so no FUTEX_PRIVATE_FLAG
+	syscall(SYS_futex, &header->futexWord, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+	Q_UNUSED(header);
+#endif
+}
+}
+
+LedFrameRingWriter::LedFrameRingWriter()
+	: m_header(nullptr)
+	, m_size(0)
+	, m_sequence(0)
+{
+}
+
+LedFrameRingWriter::~LedFrameRingWriter()
+{
+	close();
+}
+
+bool LedFrameRingWriter::isSupported()
+{
+#ifdef Q_OS_UNIX
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool LedFrameRingWriter::open(const QString &name, int maxLeds, int slotCount)
+{
+	close();
+
+#ifdef Q_OS_UNIX
+	if (name.isEmpty() || maxLeds <= 0 || slotCount <= 0)
+		return false;
+
+	const QByteArray path = objectPath(name);
+	const uint32_t slotSize = led_frame_ring_slot_size(maxLeds);
+	const size_t size = led_frame_ring_size(slotCount, slotSize);
+
+	// readers of a previous instance keep their mapping and see it closed, new ones get a fresh ring
+	shm_unlink(path.constData());
+	const int fd = shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		qWarning() << Q_FUNC_INFO << "shm_open" << name << "failed:" << strerror(errno);
+		return false;
+	}
+	if (ftruncate(fd, (off_t)size) < 0) {
+		qWarning() << Q_FUNC_INFO << "ftruncate" << name << "failed:" << strerror(errno);
+		::close(fd);
+		shm_unlink(path.constData());
+		return false;
+	}
+	void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (memory == MAP_FAILED) {
+		qWarning() << Q_FUNC_INFO << "mmap" << name << "failed:" << strerror(errno);
+		shm_unlink(path.constData());
+		return false;
+	}
+
+	// ftruncate zero fills, only the geometry is left to write
+	LedFrameRingHeader *header = static_cast<LedFrameRingHeader *>(memory);
+	header->version = LED_FRAME_RING_VERSION;
+	header->slotCount = slotCount;
+	header->slotSize = slotSize;
+	header->maxLeds = maxLeds;
+	__atomic_store_n(&header->magic, LED_FRAME_RING_MAGIC, __ATOMIC_RELEASE);
+
+	m_header = header;
+	m_size = size;
+	m_name = name;
+	m_sequence = 0;
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << name << maxLeds << "LEDs," << slotCount << "slots";
+	return true;
+#else
+	Q_UNUSED(maxLeds);
+	Q_UNUSED(slotCount);
+	qWarning() << Q_FUNC_INFO << "shared memory frames are not supported on this system, not publishing" << name;
+	return false;
+#endif
+}
+
+void LedFrameRingWriter::close()
+{
+#ifdef Q_OS_UNIX
+	if (m_header == nullptr)
+		return;
+
+	__atomic_store_n(&m_header->isClosed, 1u, __ATOMIC_RELEASE);
+	__atomic_add_fetch(&m_header->futexWord, 1u, __ATOMIC_RELEASE);
+	wakeReaders(m_header);
+
+	munmap(m_header, m_size);
+	shm_unlink(objectPath(m_name).constData());
+#endif
+	m_header = nullptr;
+	m_size = 0;
+	m_name.clear();
+}
+
+quint64 LedFrameRingWriter::write(const QList<StructRgb> &colors)
+{
+#ifdef Q_OS_UNIX
+	if (m_header == nullptr)
+		return 0;
+
+	const quint64 sequence = m_sequence + 1;
+	LedFrameRingSlot *slot = const_cast<LedFrameRingSlot *>(led_frame_ring_slot(m_header, sequence));
+	const int count = qMin(colors.count(), (int)m_header->maxLeds);
+
+	// readers of the slot's previous frame must notice before any byte of this one lands
+	__atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	uint8_t *rgb = reinterpret_cast<uint8_t *>(slot + 1);
+	for (int i = 0; i < count; ++i) {
+		const StructRgb &color = colors[i];
+		*rgb++ = color.r;
+		*rgb++ = color.g;
+		*rgb++ = color.b;
+	}
+	slot->ledsCount = count;
+	slot->timestampUs = led_frame_ring_now_us();
+
+	__atomic_store_n(&slot->sequence, sequence, __ATOMIC_RELEASE);
+	__atomic_store_n(&m_header->sequence, sequence, __ATOMIC_RELEASE);
+	__atomic_store_n(&m_header->futexWord, (uint32_t)sequence, __ATOMIC_RELEASE);
+	wakeReaders(m_header);
+
+	m_sequence = sequence;
+	return sequence;
+#else
+	Q_UNUSED(colors);
+	return 0;
+#endif
+}
@@ -0,0 +1,67 @@
+/*
+ * LedFrameRingWriter.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include "colorspace_types.h"
+
+struct LedFrameRingHeader;
+
+/*!
+	Publishes LED frames into a POSIX shared memory ring (see common/LedFrameRing.h)
+	that other processes read without copies or API round trips.
+	A frame costs one copy into the next slot, a few atomic stores and on Linux a futex
+	wake. Only available on Unix, open() fails elsewhere.
+*/
+class LedFrameRingWriter
+{
+public:
+	static const int DefaultSlotCount = 4;
+
+	LedFrameRingWriter();
+	~LedFrameRingWriter();
+
+	static bool isSupported();
+
+	// creates the object \a name, replacing a stale one, sized for frames of up to \a maxLeds
+	bool open(const QString &name, int maxLeds, int slotCount = DefaultSlotCount);
+	// tells the readers and unlinks the object
+	void close();
+	bool isOpen() const { return m_header != nullptr; }
+	const QString & name() const { return m_name; }
+
+	/*!
+		Publishes 8 bit \a colors, LEDs above the ring capacity are dropped.
+		\return the sequence number of the frame, 0 when the ring is not open
+	*/
+	quint64 write(const QList<StructRgb> &colors);
+	quint64 sequence() const { return m_sequence; }
+
+private:
+	LedFrameRingHeader *m_header;
+	size_t m_size;
+	QString m_name;
+	quint64 m_sequence;
+};
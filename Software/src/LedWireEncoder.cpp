@@ -0,0 +1,118 @@
+/*
+ * LedWireEncoder.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#include <cstring>
+
+#include "LedWireEncoder.hpp"
+
+LedWireEncoder::LedWireEncoder()
+	: m_maxValue(255)
+	, m_isHeaderWritten(false)
+{
+	m_offsets[0] = 0;
+	m_offsets[1] = 1;
+	m_offsets[2] = 2;
+}
+
+void LedWireEncoder::setHeader(const QByteArray &header)
+{
+	if (header == m_header)
+		return;
+	m_header = header;
+	m_isHeaderWritten = false;
+}
+
+void LedWireEncoder::setColorSequence(const QString &sequence)
+{
+	const QString upper = sequence.toUpper();
+	const int r = upper.indexOf(QLatin1Char('R'));
+	const int g = upper.indexOf(QLatin1Char('G'));
+	const int b = upper.indexOf(QLatin1Char('B'));
+
+	if (upper.size() == 3 && r >= 0 && g >= 0 && b >= 0) {
+		m_offsets[0] = r;
+		m_offsets[1] = g;
+		m_offsets[2] = b;
+	} else {
+		m_offsets[0] = 0;
+		m_offsets[1] = 1;
+		m_offsets[2] = 2;
+	}
+}
+
+void LedWireEncoder::setMaxValue(quint8 value)
+{
+	m_maxValue = value;
+}
+
+void LedWireEncoder::setHeaderWord(int offset, quint16 value)
+{
+	Q_ASSERT(offset >= 0 && offset + 1 < m_header.size());
+
+	m_header[offset] = (char)(value >> 8);
+	m_header[offset + 1] = (char)value;
+	if (m_isHeaderWritten) {
+		m_frame[offset] = m_header[offset];
+		m_frame[offset + 1] = m_header[offset + 1];
+	}
+}
+
+void LedWireEncoder::setHeaderByte(int offset, quint8 value)
+{
+	Q_ASSERT(offset >= 0 && offset < m_header.size());
+
+	m_header[offset] = (char)value;
+	if (m_isHeaderWritten)
+		m_frame[offset] = m_header[offset];
+}
+
+void LedWireEncoder::reserve(int ledsCount)
+{
+	m_frame.reserve(m_header.size() + ledsCount * 3);
+}
+
+const QByteArray & LedWireEncoder::encode(const QList<StructRgb> &colors, int first, int count)
+{
+	count = qBound(0, count, colors.count() - first);
+
+	// shrinking or growing within the capacity keeps the buffer and the header in it
+	m_frame.resize(m_header.size() + count * 3);
+	char *out = m_frame.data();
+	if (!m_isHeaderWritten) {
+		memcpy(out, m_header.constData(), m_header.size());
+		m_isHeaderWritten = true;
+	}
+	out += m_header.size();
+
+	const int r = m_offsets[0];
+	const int g = m_offsets[1];
+	const int b = m_offsets[2];
+	const unsigned maxValue = m_maxValue;
+	for (int i = first; i < first + count; ++i, out += 3) {
+		const StructRgb &color = colors.at(i);
+		out[r] = (char)qMin(color.r, maxValue);
+		out[g] = (char)qMin(color.g, maxValue);
+		out[b] = (char)qMin(color.b, maxValue);
+	}
+	return m_frame;
+}
@@ -0,0 +1,72 @@
+/*
+ * LedWireEncoder.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include "colorspace_types.h"
+
+/*!
+	Writes device frames of 8 bit RGB triples behind a fixed header.
+	The channel order, clamp and header are compiled into the encoder once, a frame only
+	stores the channels into a preallocated buffer: no string compares, no appends and
+	no allocations unless the frame outgrows every previous one.
+*/
+class LedWireEncoder
+{
+public:
+	LedWireEncoder();
+
+	// bytes in front of every frame, e.g. protocol id and timeout
+	void setHeader(const QByteArray &header);
+	const QByteArray & header() const { return m_header; }
+
+	// "RGB", "GRB", ... order of the channels on the wire, anything unknown means RGB
+	void setColorSequence(const QString &sequence);
+
+	// channels above are clamped, e.g. when 255 marks the start of a frame
+	void setMaxValue(quint8 value);
+
+	// patches a big endian 16 bit field of the header, e.g. the start index of a packet
+	void setHeaderWord(int offset, quint16 value);
+	void setHeaderByte(int offset, quint8 value);
+
+	// preallocates frames of up to \a ledsCount LEDs
+	void reserve(int ledsCount);
+
+	/*!
+		Encodes \a count LEDs of \a colors starting at \a first.
+		\return the whole frame, valid until the next call
+	*/
+	const QByteArray & encode(const QList<StructRgb> &colors, int first, int count);
+	const QByteArray & encode(const QList<StructRgb> &colors) { return encode(colors, 0, colors.count()); }
+
+private:
+	QByteArray m_header;
+	QByteArray m_frame;
+	// wire offset of red, green and blue inside a triple
+	int m_offsets[3];
+	unsigned m_maxValue;
+	bool m_isHeaderWritten;
+};
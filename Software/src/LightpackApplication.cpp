@@ -36,6 +36,7 @@
 #include "Plugin.hpp"
 #include "SystemSession.hpp"
 #include "LightpackCommandLineParser.hpp"
+#include "FrameReplayer.hpp"
 
 #ifdef Q_OS_WIN
 #include "WinUtils.hpp"
@@ -72,6 +73,7 @@ LightpackApplication::~LightpackApplication()
 
 	delete m_settingsWindow;
 	m_settingsWindow = NULL;
+	m_grabManager->setFrameMailbox(NULL);
 	delete m_ledDeviceManager;
 	m_ledDeviceManager = NULL;
 	delete m_ledDeviceManagerThread;
@@ -214,6 +216,9 @@ void LightpackApplication::initializeAll()
 
 	initGrabManager();
 
+	if (!m_replayPath.isEmpty())
+		startReplay();
+
 	if (!m_noGui && m_settingsWindow)
 	{
 		connect(m_settingsWindow, &SettingsWindow::backlightStatusChanged, this, &LightpackApplication::setStatusChanged);
@@ -554,6 +559,11 @@ void LightpackApplication::processCommandLineArguments()
 		::exit(0);
 	}
 
+	if (parser.isSetReplay()) {
+		m_replayPath = parser.replayPath();
+		m_replaySpeed = parser.replaySpeed();
+	}
+
 	if (parser.isSetDebuglevel())
 	{
 		g_debugLevel = parser.debugLevel();
@@ -698,6 +708,9 @@ void LightpackApplication::startLedDeviceManager()
 
 	connect(settings(), &Settings::deviceColorDepthChanged,			m_ledDeviceManager, &LedDeviceManager::setColorDepth,					Qt::QueuedConnection);
 	connect(settings(), &Settings::deviceSmoothChanged,				m_ledDeviceManager, &LedDeviceManager::setSmoothSlowdown,				Qt::QueuedConnection);
+	connect(settings(), &Settings::deviceHostSmoothingTimeChanged,	m_ledDeviceManager, &LedDeviceManager::setHostSmoothingTime,			Qt::QueuedConnection);
+	connect(settings(), &Settings::deviceRoutesChanged,				m_ledDeviceManager, &LedDeviceManager::setDeviceRoutes,				Qt::QueuedConnection);
+	connect(settings(), &Settings::deviceHostSmoothingRateChanged,	m_ledDeviceManager, &LedDeviceManager::setHostSmoothingRate,			Qt::QueuedConnection);
 	connect(settings(), &Settings::deviceRefreshDelayChanged,			m_ledDeviceManager, &LedDeviceManager::setRefreshDelay,					Qt::QueuedConnection);
 	connect(settings(), &Settings::deviceUsbPowerLedDisabledChanged, m_ledDeviceManager, &LedDeviceManager::setUsbPowerLedDisabled,			Qt::QueuedConnection);
 	connect(settings(), &Settings::deviceGammaChanged,				m_ledDeviceManager, &LedDeviceManager::setGamma,						Qt::QueuedConnection);
@@ -708,7 +721,12 @@ void LightpackApplication::startLedDeviceManager()
 	connect(settings(), &Settings::minimumLuminosityEnabledChanged,	m_ledDeviceManager, &LedDeviceManager::setMinimumLuminosityEnabled,	Qt::QueuedConnection);
 	connect(settings(), &Settings::ledCoefBlueChanged,			m_ledDeviceManager, &LedDeviceManager::updateWBAdjustments,				Qt::QueuedConnection);
 	connect(settings(), &Settings::ledCoefRedChanged,			m_ledDeviceManager, &LedDeviceManager::updateWBAdjustments,				Qt::QueuedConnection);
+	connect(settings(), &Settings::adalightDeltaFramesEnabledChanged,	m_ledDeviceManager, &LedDeviceManager::updateDeviceSettings,		Qt::QueuedConnection);
+	connect(settings(), &Settings::adalightAckEnabledChanged,	m_ledDeviceManager, &LedDeviceManager::updateDeviceSettings,		Qt::QueuedConnection);
 	connect(settings(), &Settings::ledCoefGreenChanged,		m_ledDeviceManager, &LedDeviceManager::updateWBAdjustments,				Qt::QueuedConnection);
+	connect(settings(), &Settings::grabZoneResamplingChanged,	m_ledDeviceManager, &LedDeviceManager::updateZoneResampling,				Qt::QueuedConnection);
+	connect(settings(), &Settings::grabZoneResamplingInterpolationChanged,	m_ledDeviceManager, &LedDeviceManager::updateZoneResampling,	Qt::QueuedConnection);
+	connect(settings(), &Settings::currentProfileInited,			m_ledDeviceManager, &LedDeviceManager::updateZoneResampling,				Qt::QueuedConnection);
 
 
 	if (!m_noGui)
@@ -775,6 +793,10 @@ void LightpackApplication::initGrabManager()
 	connect(settings(), &Settings::grabApplyColorTemperatureChanged,         m_grabManager, &GrabManager::onGrabApplyColorTemperatureChanged,           Qt::QueuedConnection);
 	connect(settings(), &Settings::grabColorTemperatureChanged,               m_grabManager, &GrabManager::onGrabColorTemperatureChanged,                 Qt::QueuedConnection);
 	connect(settings(), &Settings::grabGammaChanged,                       m_grabManager, &GrabManager::onGrabGammaChanged,                         Qt::QueuedConnection);
+	connect(settings(), &Settings::grabAdaptiveRateEnabledChanged,			m_grabManager, &GrabManager::onGrabAdaptiveRateEnabledChanged,			Qt::QueuedConnection);
+	connect(settings(), &Settings::grabAdaptiveRateFastestChanged,			m_grabManager, &GrabManager::onGrabAdaptiveRateFastestChanged,			Qt::QueuedConnection);
+	connect(settings(), &Settings::grabAdaptiveRateIdleChanged,				m_grabManager, &GrabManager::onGrabAdaptiveRateIdleChanged,				Qt::QueuedConnection);
+	connect(settings(), &Settings::grabAdaptiveRateCpuBudgetChanged,		m_grabManager, &GrabManager::onGrabAdaptiveRateCpuBudgetChanged,		Qt::QueuedConnection);
 	connect(settings(), &Settings::sendDataOnlyIfColorsChangesChanged,		m_grabManager, &GrabManager::onSendDataOnlyIfColorsEnabledChanged,		Qt::QueuedConnection);
 #ifdef D3D10_GRAB_SUPPORT
 	connect(settings(), &Settings::dx1011GrabberEnabledChanged,				m_grabManager, &GrabManager::onDx1011GrabberEnabledChanged,				Qt::QueuedConnection);
@@ -837,7 +859,8 @@ void LightpackApplication::initGrabManager()
 
 	connect(m_grabManager, &GrabManager::ambilightTimeOfUpdatingColors, m_pluginInterface, &LightpackPluginInterface::refreshAmbilightEvaluated);
 
-	connect(m_grabManager, &GrabManager::updateLedsColors,	m_ledDeviceManager, &LedDeviceManager::setColors, Qt::QueuedConnection);
+	m_grabManager->setFrameMailbox(m_ledDeviceManager->frameMailbox());
+	connect(m_grabManager, &GrabManager::ledsColorsPosted,	m_ledDeviceManager, &LedDeviceManager::takeMailboxColors, Qt::QueuedConnection);
 	connect(m_moodlampManager, &MoodLampManager::updateLedsColors,	m_ledDeviceManager, &LedDeviceManager::setColors, Qt::QueuedConnection);
 	if (!m_noGui && m_settingsWindow)
 		connect(m_moodlampManager, &MoodLampManager::moodlampFrametime,		m_settingsWindow, &SettingsWindow::refreshAmbilightEvaluated, Qt::QueuedConnection);
@@ -852,6 +875,32 @@ void LightpackApplication::initGrabManager()
 #endif
 }
 
+void LightpackApplication::startReplay()
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_replayPath << m_replaySpeed;
+
+	m_frameReplayer = new FrameReplayer(this);
+	if (!m_frameReplayer->load(m_replayPath)) {
+		outputMessage(QStringLiteral("Can't replay ") + m_replayPath);
+		::exit(WrongCommandLineArgument_ErrorCode);
+	}
+	m_frameReplayer->setSpeed(m_replaySpeed);
+
+	// the recording holds the device like an API client, grabber and mood lamp stay off
+	m_deviceLockStatus = DeviceLocked::Api;
+
+	connect(m_frameReplayer, &FrameReplayer::frameReady,		m_ledDeviceManager, &LedDeviceManager::setColors,		Qt::QueuedConnection);
+	connect(m_frameReplayer, &FrameReplayer::ledsSwitchedOff,	m_ledDeviceManager, &LedDeviceManager::switchOffLeds,	Qt::QueuedConnection);
+	connect(m_frameReplayer, &FrameReplayer::ledsSwitchedOn,	m_ledDeviceManager, &LedDeviceManager::switchOnLeds,	Qt::QueuedConnection);
+	connect(m_frameReplayer, &FrameReplayer::finished, this, [this]() {
+		qInfo() << "Replayed" << m_frameReplayer->recordsCount() << "records of" << m_replayPath
+				<< "at most" << m_frameReplayer->maxLatenessUs() << "us late";
+		// give the device manager time to send the queued frames
+		QTimer::singleShot(1000, this, &LightpackApplication::quit);
+	});
+	connect(this, &LightpackApplication::postInitialization, m_frameReplayer, &FrameReplayer::start);
+}
+
 void LightpackApplication::commitData(QSessionManager &sessionManager)
 {
 	Q_UNUSED(sessionManager);
@@ -37,6 +37,7 @@
 class LightpackPluginInterface;
 class ApiServer;
 class PluginsManager;
+class FrameReplayer;
 
 class LightpackApplication : public QtSingleApplication
 {
@@ -95,6 +96,7 @@ private:
 	void initGrabManager();
 	void startPluginManager();
 	void startBacklight();
+	void startReplay();
 
 	void runWizardLoop(bool isInitFromSettings);
 
@@ -110,6 +112,7 @@ private:
 	SettingsWindow *m_settingsWindow{nullptr};
 	ApiServer *m_apiServer{nullptr};
 	LedDeviceManager *m_ledDeviceManager{nullptr};
+	FrameReplayer *m_frameReplayer{nullptr};
 	QThread *m_ledDeviceManagerThread{nullptr};
 	QThread *m_apiServerThread{nullptr};
 	GrabManager *m_grabManager{nullptr};
@@ -123,6 +126,8 @@ private:
 	QWidget *consolePlugin{nullptr};
 
 	QString m_configDirPath;
+	QString m_replayPath;
+	double m_replaySpeed{1.0};
 	bool m_isDebugLevelObtainedFromCmdArgs;
 	bool m_noGui;
 	DeviceLocked::DeviceLockStatus m_deviceLockStatus;
@@ -14,6 +14,9 @@ LightpackCommandLineParser::LightpackCommandLineParser()
 	, m_helpOption(m_parser.addHelpOption())
 	, m_optionSetProfile(QStringLiteral("set-profile"), QStringLiteral("switch to another profile in already running instance"), QStringLiteral("profile"))
 	, m_optionConfigDir(QStringLiteral("config-dir"), QStringLiteral("use configurations in this directory"), QStringLiteral("profile"))
+	, m_optionReplay(QStringLiteral("replay"), QStringLiteral("play a frame recording to the device instead of grabbing, then quit"), QStringLiteral("file"))
+	, m_optionReplaySpeed(QStringLiteral("replay-speed"), QStringLiteral("replay speed factor, 0 for as fast as possible (default 1)"), QStringLiteral("factor"))
+	, m_replaySpeed(1.0)
 {
 	m_parser.setApplicationDescription(QStringLiteral("Prismatik of Lightpack"));
 	m_parser.addOption(m_noGUIOption);
@@ -27,6 +30,8 @@ LightpackCommandLineParser::LightpackCommandLineParser()
 	m_parser.addOption(m_debugLevelZeroOption);
 	m_parser.addOption(m_optionSetProfile);
 	m_parser.addOption(m_optionConfigDir);
+	m_parser.addOption(m_optionReplay);
+	m_parser.addOption(m_optionReplaySpeed);
 }
 
 bool LightpackCommandLineParser::isSetNoGUI() const
@@ -78,6 +83,11 @@ bool LightpackCommandLineParser::isSetConfigDir() const
 	return m_parser.isSet(m_optionConfigDir);
 }
 
+bool LightpackCommandLineParser::isSetReplay() const
+{
+	return m_parser.isSet(m_optionReplay);
+}
+
 Debug::DebugLevels LightpackCommandLineParser::debugLevel() const
 {
 	Q_ASSERT(isSetDebuglevel());
@@ -95,6 +105,15 @@ QString LightpackCommandLineParser::configDir() const {
 	return m_configDir;
 }
 
+QString LightpackCommandLineParser::replayPath() const {
+	Q_ASSERT(isSetReplay());
+	return m_replayPath;
+}
+
+double LightpackCommandLineParser::replaySpeed() const {
+	return m_replaySpeed;
+}
+
 QString LightpackCommandLineParser::helpText() const {
 	return m_parser.helpText();
 }
@@ -102,6 +121,8 @@ QString LightpackCommandLineParser::helpText() const {
 QString LightpackCommandLineParser::errorText() const {
 	if (isSetBacklightOff() && isSetBacklightOn())
 		return QStringLiteral("Bad options specified!");
+	if (m_replaySpeed < 0)
+		return QStringLiteral("Bad replay speed!");
 	return m_parser.errorText();
 }
 
@@ -130,6 +151,14 @@ bool LightpackCommandLineParser::parse(const QStringList &arguments)
 		m_profileName = m_parser.value(m_optionSetProfile);
 	if (m_parser.isSet(m_optionConfigDir))
 		m_configDir = m_parser.value(m_optionConfigDir);
+	if (m_parser.isSet(m_optionReplay))
+		m_replayPath = m_parser.value(m_optionReplay);
+	if (m_parser.isSet(m_optionReplaySpeed)) {
+		bool ok = false;
+		m_replaySpeed = m_parser.value(m_optionReplaySpeed).toDouble(&ok);
+		if (!ok)
+			m_replaySpeed = -1;
+	}
 
 	if (m_parser.isSet(m_debugLevelOption))
 	{
@@ -147,6 +176,8 @@ bool LightpackCommandLineParser::parse(const QStringList &arguments)
 
 	if (isSetBacklightOff() && isSetBacklightOn())
 		return false;
+	if (m_replaySpeed < 0)
+		return false;
 
 	return true;
 }
@@ -43,6 +43,7 @@ public:
 	bool isSetDebuglevel() const;
 	bool isSetProfile() const;
 	bool isSetConfigDir() const;
+	bool isSetReplay() const;
 	// Valid only if isSetDebuglevel() is true.
 	Debug::DebugLevels debugLevel() const;
 
@@ -50,6 +51,9 @@ public:
 	QString profileName() const;
 	// Valid only if isSetConfigDir() is true.
 	QString configDir() const;
+	// Valid only if isSetReplay() is true.
+	QString replayPath() const;
+	double replaySpeed() const;
 
 	QString helpText() const;
 	QString errorText() const;
@@ -83,11 +87,16 @@ private:
 	const QCommandLineOption m_helpOption;
 	const QCommandLineOption m_optionSetProfile;
 	const QCommandLineOption m_optionConfigDir;
+	// --replay=<file> [--replay-speed=<factor>]
+	const QCommandLineOption m_optionReplay;
+	const QCommandLineOption m_optionReplaySpeed;
 
 	// Values from command line.
 	Debug::DebugLevels m_debugLevel;
 	QString m_profileName;
 	QString m_configDir;
+	QString m_replayPath;
+	double m_replaySpeed;
 };
 
 #endif // LIGHTPACKCOMMANDLINEPARSER_H
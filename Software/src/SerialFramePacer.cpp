@@ -0,0 +1,108 @@
+/*
+ * SerialFramePacer.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SerialFramePacer.hpp"
+
+namespace {
+// start bit, 8 data bits, stop bit
+const int BitsPerByte = 10;
+const int AckTimeoutDefault = 100;
+}
+
+SerialFramePacer::SerialFramePacer()
+	: m_baudRate(115200)
+	, m_isAckEnabled(false)
+	, m_ackTimeoutNs(AckTimeoutDefault * 1000000LL)
+{
+	reset();
+}
+
+void SerialFramePacer::setBaudRate(int baudRate)
+{
+	m_baudRate = qMax(1, baudRate);
+}
+
+void SerialFramePacer::setAckEnabled(bool isEnabled)
+{
+	m_isAckEnabled = isEnabled;
+	m_isAwaitingAck = false;
+}
+
+void SerialFramePacer::setAckTimeout(int ms)
+{
+	m_ackTimeoutNs = qMax(1, ms) * 1000000LL;
+}
+
+void SerialFramePacer::reset()
+{
+	m_lineFreeAtNs = 0;
+	m_ackDeadlineNs = 0;
+	m_isAwaitingAck = false;
+	m_isFrameOnLine = false;
+	m_isFrameDeferred = false;
+}
+
+qint64 SerialFramePacer::waitNs(qint64 nowNs) const
+{
+	const qint64 freeAtNs = m_isAwaitingAck ? m_ackDeadlineNs : m_lineFreeAtNs;
+	return qMax<qint64>(0, freeAtNs - nowNs);
+}
+
+int SerialFramePacer::offerFrame(qint64 nowNs, qint64 bytesToWrite)
+{
+	const qint64 wait = waitNs(nowNs);
+	if (wait == 0 && (bytesToWrite == 0 || !m_isFrameOnLine))
+		return 0;
+
+	m_isFrameDeferred = true;
+	if (wait == 0)
+		return RetryOnBytesWritten;
+	// round up, a timer firing early would only defer the frame again
+	return static_cast<int>((wait + 999999) / 1000000);
+}
+
+void SerialFramePacer::frameWritten(int bytes, qint64 nowNs)
+{
+	m_isFrameOnLine = true;
+	m_isFrameDeferred = false;
+	// a frame written early (forced) queues behind the one still on the line
+	const qint64 startNs = qMax(nowNs, m_lineFreeAtNs);
+	m_lineFreeAtNs = startNs + lineTimeNs(bytes, m_baudRate);
+	if (m_isAckEnabled) {
+		m_ackDeadlineNs = m_lineFreeAtNs + m_ackTimeoutNs;
+		m_isAwaitingAck = true;
+	}
+}
+
+void SerialFramePacer::ackReceived()
+{
+	if (!m_isAwaitingAck)
+		return;
+	// the controller has the whole frame, so the line is free as well
+	m_isAwaitingAck = false;
+	m_lineFreeAtNs = 0;
+}
+
+qint64 SerialFramePacer::lineTimeNs(int bytes, int baudRate)
+{
+	return static_cast<qint64>(bytes) * BitsPerByte * 1000000000LL / qMax(1, baudRate);
+}
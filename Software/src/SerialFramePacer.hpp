@@ -0,0 +1,87 @@
+/*
+ * SerialFramePacer.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+/*!
+	Keeps a serial LED device at most one frame ahead of the wire.
+	A written frame holds the line for as long as its bytes take at the port's baud
+	rate (8N1, ten bits a byte); frames offered before then are dropped instead of
+	piling up in the OS buffer. With acknowledgements enabled the line is also held
+	until the controller answers or the ack timeout runs out.
+	All times are nanoseconds on one monotonic clock, e.g. QElapsedTimer::nsecsElapsed().
+*/
+class SerialFramePacer
+{
+public:
+	SerialFramePacer();
+
+	void setBaudRate(int baudRate);
+	void setAckEnabled(bool isEnabled);
+	bool isAckEnabled() const { return m_isAckEnabled; }
+	void setAckTimeout(int ms);
+
+	/*!
+		Forgets the frame on the line and any deferred one, the next one may be written at once
+	*/
+	void reset();
+
+	/*!
+		\return nanoseconds until the next frame may be written, 0 if the line is free
+	*/
+	qint64 waitNs(qint64 nowNs) const;
+	bool isReady(qint64 nowNs) const { return waitNs(nowNs) == 0; }
+
+	enum {
+		RetryOnBytesWritten = -1
+	};
+
+	/*!
+		Decides about a frame, \a bytesToWrite is what the serial port still buffers.
+		\return 0 if it may be written now. Otherwise the frame is deferred (the device
+		writes its latest one later) and the milliseconds until the line is free are
+		returned, or RetryOnBytesWritten if only the port buffer holds it back; the port's
+		bytesWritten() signal is the time to retry then.
+	*/
+	int offerFrame(qint64 nowNs, qint64 bytesToWrite);
+	bool isFrameDeferred() const { return m_isFrameDeferred; }
+
+	void frameWritten(int bytes, qint64 nowNs);
+	void ackReceived();
+	bool isAwaitingAck() const { return m_isAwaitingAck; }
+
+	static qint64 lineTimeNs(int bytes, int baudRate);
+
+private:
+	int m_baudRate;
+	bool m_isAckEnabled;
+	qint64 m_ackTimeoutNs;
+
+	qint64 m_lineFreeAtNs;
+	qint64 m_ackDeadlineNs;
+	bool m_isAwaitingAck;
+	// a frame was written since the last reset(), the port buffer may still hold it
+	bool m_isFrameOnLine;
+	bool m_isFrameDeferred;
+};
@@ -74,6 +74,7 @@ static const QString IsKeepLightsOnAfterScreenOff = QStringLiteral("IsKeepLights
 static const QString IsPingDeviceEverySecond = QStringLiteral("IsPingDeviceEverySecond");
 static const QString IsUpdateFirmwareMessageShown = QStringLiteral("IsUpdateFirmwareMessageShown");
 static const QString ConnectedDevice = QStringLiteral("ConnectedDevice");
+static const QString DeviceRoutes = QStringLiteral("DeviceRoutes");
 static const QString SupportedDevices = QStringLiteral("SupportedDevices");
 static const QString CheckForUpdates = QStringLiteral("CheckForUpdates");
 static const QString InstallUpdates = QStringLiteral("InstallForUpdates");
@@ -91,6 +92,8 @@ namespace Api
 static const QString IsEnabled = QStringLiteral("API/IsEnabled");
 static const QString ListenOnlyOnLoInterface = QStringLiteral("API/ListenOnlyOnLoInterface");
 static const QString Port = QStringLiteral("API/Port");
+static const QString IsUdpEnabled = QStringLiteral("API/IsUdpEnabled");
+static const QString UdpPort = QStringLiteral("API/UdpPort");
 static const QString AuthKey = QStringLiteral("API/AuthKey");
 }
 namespace Adalight
@@ -99,6 +102,8 @@ static const QString NumberOfLeds = QStringLiteral("Adalight/NumberOfLeds");
 static const QString ColorSequence = QStringLiteral("Adalight/ColorSequence");
 static const QString Port = QStringLiteral("Adalight/SerialPort");
 static const QString BaudRate = QStringLiteral("Adalight/BaudRate");
+static const QString IsDeltaFramesEnabled = QStringLiteral("Adalight/DeltaFrames");
+static const QString IsAckEnabled = QStringLiteral("Adalight/WaitForAck");
 static const QString LedMilliAmps = QStringLiteral("Adalight/LedMilliAmps");
 static const QString PowerSupplyAmps = QStringLiteral("Adalight/PowerSupplyAmps");
 }
@@ -128,6 +133,7 @@ namespace Virtual
 static const QString NumberOfLeds = QStringLiteral("Virtual/NumberOfLeds");
 static const QString LedMilliAmps = QStringLiteral("Virtual/LedMilliAmps");
 static const QString PowerSupplyAmps = QStringLiteral("Virtual/PowerSupplyAmps");
+static const QString SharedMemoryName = QStringLiteral("Virtual/SharedMemoryName");
 }
 namespace Drgb
 {
@@ -156,6 +162,60 @@ static const QString Timeout = QStringLiteral("Warls/Timeout");
 static const QString LedMilliAmps = QStringLiteral("Warls/LedMilliAmps");
 static const QString PowerSupplyAmps = QStringLiteral("Warls/PowerSupplyAmps");
 }
+namespace Ddp
+{
+static const QString NumberOfLeds = QStringLiteral("Ddp/NumberOfLeds");
+static const QString Address = QStringLiteral("Ddp/Address");
+static const QString Port = QStringLiteral("Ddp/Port");
+static const QString Timeout = QStringLiteral("Ddp/Timeout");
+static const QString LedMilliAmps = QStringLiteral("Ddp/LedMilliAmps");
+static const QString PowerSupplyAmps = QStringLiteral("Ddp/PowerSupplyAmps");
+}
+namespace E131
+{
+static const QString NumberOfLeds = QStringLiteral("E131/NumberOfLeds");
+static const QString Address = QStringLiteral("E131/Address");
+static const QString Port = QStringLiteral("E131/Port");
+static const QString Universe = QStringLiteral("E131/Universe");
+static const QString IsMulticastEnabled = QStringLiteral("E131/IsMulticastEnabled");
+static const QString IsSyncEnabled = QStringLiteral("E131/IsSyncEnabled");
+static const QString LedMilliAmps = QStringLiteral("E131/LedMilliAmps");
+static const QString PowerSupplyAmps = QStringLiteral("E131/PowerSupplyAmps");
+}
+namespace ArtNet
+{
+static const QString NumberOfLeds = QStringLiteral("ArtNet/NumberOfLeds");
+static const QString Address = QStringLiteral("ArtNet/Address");
+static const QString Port = QStringLiteral("ArtNet/Port");
+static const QString Universe = QStringLiteral("ArtNet/Universe");
+static const QString IsSyncEnabled = QStringLiteral("ArtNet/IsSyncEnabled");
+static const QString LedMilliAmps = QStringLiteral("ArtNet/LedMilliAmps");
+static const QString PowerSupplyAmps = QStringLiteral("ArtNet/PowerSupplyAmps");
+}
+namespace AdaptiveUdp
+{
+static const QString NumberOfLeds = QStringLiteral("AdaptiveUdp/NumberOfLeds");
+static const QString Address = QStringLiteral("AdaptiveUdp/Address");
+static const QString Port = QStringLiteral("AdaptiveUdp/Port");
+static const QString Timeout = QStringLiteral("AdaptiveUdp/Timeout");
+static const QString RefreshInterval = QStringLiteral("AdaptiveUdp/RefreshInterval");
+static const QString LedMilliAmps = QStringLiteral("AdaptiveUdp/LedMilliAmps");
+static const QString PowerSupplyAmps = QStringLiteral("AdaptiveUdp/PowerSupplyAmps");
+}
+namespace Recorder
+{
+static const QString NumberOfLeds = QStringLiteral("Recorder/NumberOfLeds");
+static const QString Path = QStringLiteral("Recorder/Path");
+static const QString LedMilliAmps = QStringLiteral("Recorder/LedMilliAmps");
+static const QString PowerSupplyAmps = QStringLiteral("Recorder/PowerSupplyAmps");
+}
+namespace NullSink
+{
+static const QString NumberOfLeds = QStringLiteral("NullSink/NumberOfLeds");
+static const QString Encoder = QStringLiteral("NullSink/Encoder");
+static const QString LedMilliAmps = QStringLiteral("NullSink/LedMilliAmps");
+static const QString PowerSupplyAmps = QStringLiteral("NullSink/PowerSupplyAmps");
+}
 } /*Key*/
 
 namespace Value
@@ -172,6 +232,12 @@ static const QString VirtualDevice = QStringLiteral("Virtual");
 static const QString DrgbDevice = QStringLiteral("DRGB");
 static const QString DnrgbDevice = QStringLiteral("DNRGB");
 static const QString WarlsDevice = QStringLiteral("WARLS");
+static const QString DdpDevice = QStringLiteral("DDP");
+static const QString E131Device = QStringLiteral("E131");
+static const QString ArtNetDevice = QStringLiteral("ArtNet");
+static const QString AdaptiveUdpDevice = QStringLiteral("AdaptiveUDP");
+static const QString RecorderDevice = QStringLiteral("Recorder");
+static const QString NullSinkDevice = QStringLiteral("NullSink");
 }
 
 } /*Value*/
@@ -200,6 +266,12 @@ static const QString IsApplyBlueLightReductionEnabled = QStringLiteral("Grab/IsA
 static const QString IsApplyColorTemperatureEnabled = QStringLiteral("Grab/IsApplyColorTemperatureEnabled");
 static const QString ColorTemperature = QStringLiteral("Grab/ColorTemperature");
 static const QString Gamma = QStringLiteral("Grab/Gamma");
+static const QString IsAdaptiveRateEnabled = QStringLiteral("Grab/IsAdaptiveRateEnabled");
+static const QString AdaptiveRateFastest = QStringLiteral("Grab/AdaptiveRateFastest");
+static const QString AdaptiveRateIdle = QStringLiteral("Grab/AdaptiveRateIdle");
+static const QString AdaptiveRateCpuBudget = QStringLiteral("Grab/AdaptiveRateCpuBudget");
+static const QString ZoneResampling = QStringLiteral("Grab/ZoneResampling");
+static const QString ZoneResamplingInterpolation = QStringLiteral("Grab/ZoneResamplingInterpolation");
 }
 // [MoodLamp]
 namespace MoodLamp
@@ -230,6 +302,8 @@ static const QString BrightnessCap = QStringLiteral("Device/BrightnessCap");
 static const QString ColorDepth = QStringLiteral("Device/ColorDepth");
 static const QString Gamma = QStringLiteral("Device/Gamma");
 static const QString IsDitheringEnabled = QStringLiteral("Device/IsDitheringEnabled");
+static const QString HostSmoothingTime = QStringLiteral("Device/HostSmoothingTime");
+static const QString HostSmoothingRate = QStringLiteral("Device/HostSmoothingRate");
 }
 // [LED_i]
 namespace Led
@@ -325,10 +399,13 @@ bool Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
 	setNewOptionMain(Main::Key::IsPingDeviceEverySecond,Main::IsPingDeviceEverySecond);
 	setNewOptionMain(Main::Key::IsUpdateFirmwareMessageShown, Main::IsUpdateFirmwareMessageShown);
 	setNewOptionMain(Main::Key::ConnectedDevice,		Main::ConnectedDeviceDefault);
+	setNewOptionMain(Main::Key::DeviceRoutes,			Main::DeviceRoutesDefault);
 	setNewOptionMain(Main::Key::SupportedDevices,		Main::SupportedDevices, true /* always rewrite this information to main config */);
 	setNewOptionMain(Main::Key::Api::IsEnabled,			Main::Api::IsEnabledDefault);
 	setNewOptionMain(Main::Key::Api::ListenOnlyOnLoInterface, Main::Api::ListenOnlyOnLoInterfaceDefault);
 	setNewOptionMain(Main::Key::Api::Port,				Main::Api::PortDefault);
+	setNewOptionMain(Main::Key::Api::IsUdpEnabled,		Main::Api::IsUdpEnabledDefault);
+	setNewOptionMain(Main::Key::Api::UdpPort,			Main::Api::UdpPortDefault);
 	// Generation AuthKey as new UUID
 	setNewOptionMain(Main::Key::Api::AuthKey,			Main::Api::AuthKey);
 
@@ -337,6 +414,8 @@ bool Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
 	setNewOptionMain(Main::Key::Adalight::BaudRate,			Main::Adalight::BaudRateDefault);
 	setNewOptionMain(Main::Key::Adalight::NumberOfLeds,		Main::Adalight::NumberOfLedsDefault);
 	setNewOptionMain(Main::Key::Adalight::ColorSequence,	Main::Adalight::ColorSequence);
+	setNewOptionMain(Main::Key::Adalight::IsDeltaFramesEnabled,	Main::Adalight::IsDeltaFramesEnabledDefault);
+	setNewOptionMain(Main::Key::Adalight::IsAckEnabled,		Main::Adalight::IsAckEnabledDefault);
 
 	setNewOptionMain(Main::Key::Ardulight::Port,			Main::Ardulight::PortDefault);
 	setNewOptionMain(Main::Key::Ardulight::BaudRate,		Main::Ardulight::BaudRateDefault);
@@ -349,6 +428,12 @@ bool Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
 	setNewOptionMain(Main::Key::Drgb::NumberOfLeds,			Main::Drgb::NumberOfLedsDefault);
 	setNewOptionMain(Main::Key::Dnrgb::NumberOfLeds,		Main::Dnrgb::NumberOfLedsDefault);
 	setNewOptionMain(Main::Key::Warls::NumberOfLeds,		Main::Warls::NumberOfLedsDefault);
+	setNewOptionMain(Main::Key::Ddp::NumberOfLeds,			Main::Ddp::NumberOfLedsDefault);
+	setNewOptionMain(Main::Key::E131::NumberOfLeds,			Main::E131::NumberOfLedsDefault);
+	setNewOptionMain(Main::Key::ArtNet::NumberOfLeds,		Main::ArtNet::NumberOfLedsDefault);
+	setNewOptionMain(Main::Key::AdaptiveUdp::NumberOfLeds,	Main::AdaptiveUdp::NumberOfLedsDefault);
+	setNewOptionMain(Main::Key::Recorder::NumberOfLeds,	Main::Recorder::NumberOfLedsDefault);
+	setNewOptionMain(Main::Key::NullSink::NumberOfLeds,	Main::NullSink::NumberOfLedsDefault);
 
 	setNewOptionMain(Main::Key::Adalight::LedMilliAmps,		Main::Device::LedMilliAmpsDefault);
 	setNewOptionMain(Main::Key::Ardulight::LedMilliAmps,	Main::Device::LedMilliAmpsDefault);
@@ -358,6 +443,12 @@ bool Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
 	setNewOptionMain(Main::Key::Drgb::LedMilliAmps,			Main::Device::LedMilliAmpsDefault);
 	setNewOptionMain(Main::Key::Dnrgb::LedMilliAmps,		Main::Device::LedMilliAmpsDefault);
 	setNewOptionMain(Main::Key::Warls::LedMilliAmps,		Main::Device::LedMilliAmpsDefault);
+	setNewOptionMain(Main::Key::Ddp::LedMilliAmps,			Main::Device::LedMilliAmpsDefault);
+	setNewOptionMain(Main::Key::E131::LedMilliAmps,			Main::Device::LedMilliAmpsDefault);
+	setNewOptionMain(Main::Key::ArtNet::LedMilliAmps,		Main::Device::LedMilliAmpsDefault);
+	setNewOptionMain(Main::Key::AdaptiveUdp::LedMilliAmps,	Main::Device::LedMilliAmpsDefault);
+	setNewOptionMain(Main::Key::Recorder::LedMilliAmps,	Main::Device::LedMilliAmpsDefault);
+	setNewOptionMain(Main::Key::NullSink::LedMilliAmps,	Main::Device::LedMilliAmpsDefault);
 
 	setNewOptionMain(Main::Key::Adalight::PowerSupplyAmps,	Main::Device::PowerSupplyAmpsDefault);
 	setNewOptionMain(Main::Key::Ardulight::PowerSupplyAmps,	Main::Device::PowerSupplyAmpsDefault);
@@ -367,6 +458,14 @@ bool Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
 	setNewOptionMain(Main::Key::Drgb::PowerSupplyAmps,		Main::Device::PowerSupplyAmpsDefault);
 	setNewOptionMain(Main::Key::Dnrgb::PowerSupplyAmps,		Main::Device::PowerSupplyAmpsDefault);
 	setNewOptionMain(Main::Key::Warls::PowerSupplyAmps,		Main::Device::PowerSupplyAmpsDefault);
+	setNewOptionMain(Main::Key::Ddp::PowerSupplyAmps,		Main::Device::PowerSupplyAmpsDefault);
+	setNewOptionMain(Main::Key::E131::PowerSupplyAmps,		Main::Device::PowerSupplyAmpsDefault);
+	setNewOptionMain(Main::Key::ArtNet::PowerSupplyAmps,	Main::Device::PowerSupplyAmpsDefault);
+	setNewOptionMain(Main::Key::AdaptiveUdp::PowerSupplyAmps,	Main::Device::PowerSupplyAmpsDefault);
+	setNewOptionMain(Main::Key::Recorder::PowerSupplyAmps,	Main::Device::PowerSupplyAmpsDefault);
+	setNewOptionMain(Main::Key::NullSink::PowerSupplyAmps,	Main::Device::PowerSupplyAmpsDefault);
+
+	setNewOptionMain(Main::Key::Virtual::SharedMemoryName,  Main::Virtual::SharedMemoryNameDefault);
 
 	setNewOptionMain(Main::Key::Drgb::Address,              Main::Drgb::AddressDefault);
 	setNewOptionMain(Main::Key::Drgb::Port,                 Main::Drgb::PortDefault);
@@ -380,6 +479,30 @@ bool Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
 	setNewOptionMain(Main::Key::Warls::Port,                Main::Warls::PortDefault);
 	setNewOptionMain(Main::Key::Warls::Timeout,             Main::Warls::TimeoutDefault);
 
+	setNewOptionMain(Main::Key::Ddp::Address,               Main::Ddp::AddressDefault);
+	setNewOptionMain(Main::Key::Ddp::Port,                  Main::Ddp::PortDefault);
+	setNewOptionMain(Main::Key::Ddp::Timeout,               Main::Ddp::TimeoutDefault);
+
+	setNewOptionMain(Main::Key::E131::Address,              Main::E131::AddressDefault);
+	setNewOptionMain(Main::Key::E131::Port,                 Main::E131::PortDefault);
+	setNewOptionMain(Main::Key::E131::Universe,             Main::E131::UniverseDefault);
+	setNewOptionMain(Main::Key::E131::IsMulticastEnabled,   Main::E131::IsMulticastEnabledDefault);
+	setNewOptionMain(Main::Key::E131::IsSyncEnabled,        Main::E131::IsSyncEnabledDefault);
+
+	setNewOptionMain(Main::Key::ArtNet::Address,            Main::ArtNet::AddressDefault);
+	setNewOptionMain(Main::Key::ArtNet::Port,               Main::ArtNet::PortDefault);
+	setNewOptionMain(Main::Key::ArtNet::Universe,           Main::ArtNet::UniverseDefault);
+	setNewOptionMain(Main::Key::ArtNet::IsSyncEnabled,      Main::ArtNet::IsSyncEnabledDefault);
+
+	setNewOptionMain(Main::Key::AdaptiveUdp::Address,         Main::AdaptiveUdp::AddressDefault);
+	setNewOptionMain(Main::Key::AdaptiveUdp::Port,            Main::AdaptiveUdp::PortDefault);
+	setNewOptionMain(Main::Key::AdaptiveUdp::Timeout,         Main::AdaptiveUdp::TimeoutDefault);
+	setNewOptionMain(Main::Key::AdaptiveUdp::RefreshInterval, Main::AdaptiveUdp::RefreshIntervalDefault);
+
+	setNewOptionMain(Main::Key::Recorder::Path,             Main::Recorder::PathDefault);
+
+	setNewOptionMain(Main::Key::NullSink::Encoder,          Main::NullSink::EncoderDefault);
+
 	setNewOptionMain(Main::Key::CheckForUpdates,			Main::CheckForUpdates);
 	setNewOptionMain(Main::Key::InstallUpdates,				Main::InstallUpdates);
 
@@ -693,6 +816,30 @@ void Settings::setApiPort(int apiPort)
 	emit m_this->apiServerSettingsChanged();
 }
 
+bool Settings::isApiUdpEnabled()
+{
+	return valueMain(Main::Key::Api::IsUdpEnabled).toBool();
+}
+
+void Settings::setIsApiUdpEnabled(bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::Api::IsUdpEnabled, isEnabled);
+	emit m_this->apiServerSettingsChanged();
+}
+
+int Settings::getApiUdpPort()
+{
+	return valueMain(Main::Key::Api::UdpPort).toInt();
+}
+
+void Settings::setApiUdpPort(int udpPort)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::Api::UdpPort, udpPort);
+	emit m_this->apiServerSettingsChanged();
+}
+
 QString Settings::getApiAuthKey()
 {
 	QString apikey = valueMain(Main::Key::Api::AuthKey).toString();
@@ -809,6 +956,32 @@ QString Settings::getConnectedDeviceName()
 	return m_devicesTypeToNameMap.value(getConnectedDevice(), Main::ConnectedDeviceDefault);
 }
 
+SupportedDevices::DeviceType Settings::getDeviceTypeByName(const QString & deviceName, bool *ok)
+{
+	for (auto it = m_devicesTypeToNameMap.cbegin(); it != m_devicesTypeToNameMap.cend(); ++it) {
+		if (it.value().compare(deviceName, Qt::CaseInsensitive) == 0) {
+			if (ok)
+				*ok = true;
+			return it.key();
+		}
+	}
+	if (ok)
+		*ok = false;
+	return SupportedDevices::DefaultDeviceType;
+}
+
+QString Settings::getDeviceRoutes()
+{
+	return valueMain(Main::Key::DeviceRoutes).toString();
+}
+
+void Settings::setDeviceRoutes(const QString & routes)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::DeviceRoutes, routes);
+	emit m_this->deviceRoutesChanged(routes);
+}
+
 void Settings::setConnectedDeviceName(const QString & deviceName)
 {
 	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
@@ -881,6 +1054,30 @@ void Settings::setAdalightSerialPortBaudRate(const QString & baud)
 	emit m_this->adalightSerialPortBaudRateChanged(baud);
 }
 
+bool Settings::isAdalightDeltaFramesEnabled()
+{
+	return valueMain(Main::Key::Adalight::IsDeltaFramesEnabled).toBool();
+}
+
+void Settings::setAdalightDeltaFramesEnabled(bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << isEnabled;
+	setValueMain(Main::Key::Adalight::IsDeltaFramesEnabled, isEnabled);
+	emit m_this->adalightDeltaFramesEnabledChanged(isEnabled);
+}
+
+bool Settings::isAdalightAckEnabled()
+{
+	return valueMain(Main::Key::Adalight::IsAckEnabled).toBool();
+}
+
+void Settings::setAdalightAckEnabled(bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << isEnabled;
+	setValueMain(Main::Key::Adalight::IsAckEnabled, isEnabled);
+	emit m_this->adalightAckEnabledChanged(isEnabled);
+}
+
 QString Settings::getArdulightSerialPortName()
 {
 	return valueMain(Main::Key::Ardulight::Port).toString();
@@ -1015,6 +1212,235 @@ void Settings::setWarlsTimeout(const int timeout)
 	emit m_this->warlsTimeoutChanged(timeout);
 }
 
+QString Settings::getDdpAddress()
+{
+	return valueMain(Main::Key::Ddp::Address).toString();
+}
+
+void Settings::setDdpAddress(const QString& address)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::Ddp::Address, address);
+	emit m_this->ddpAddressChanged(address);
+}
+
+QString Settings::getDdpPort()
+{
+	return valueMain(Main::Key::Ddp::Port).toString();
+}
+
+void Settings::setDdpPort(const QString& port)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::Ddp::Port, port);
+	emit m_this->ddpPortChanged(port);
+}
+
+int Settings::getDdpTimeout()
+{
+	return valueMain(Main::Key::Ddp::Timeout).toInt();
+}
+
+void Settings::setDdpTimeout(const int timeout)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::Ddp::Timeout, timeout);
+	emit m_this->ddpTimeoutChanged(timeout);
+}
+
+QString Settings::getE131Address()
+{
+	return valueMain(Main::Key::E131::Address).toString();
+}
+
+void Settings::setE131Address(const QString& address)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::E131::Address, address);
+	emit m_this->e131AddressChanged(address);
+}
+
+QString Settings::getE131Port()
+{
+	return valueMain(Main::Key::E131::Port).toString();
+}
+
+void Settings::setE131Port(const QString& port)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::E131::Port, port);
+	emit m_this->e131PortChanged(port);
+}
+
+int Settings::getE131Universe()
+{
+	return valueMain(Main::Key::E131::Universe).toInt();
+}
+
+void Settings::setE131Universe(const int universe)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::E131::Universe, universe);
+	emit m_this->e131UniverseChanged(universe);
+}
+
+bool Settings::isE131MulticastEnabled()
+{
+	return valueMain(Main::Key::E131::IsMulticastEnabled).toBool();
+}
+
+void Settings::setE131MulticastEnabled(const bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::E131::IsMulticastEnabled, isEnabled);
+	emit m_this->e131MulticastEnabledChanged(isEnabled);
+}
+
+bool Settings::isE131SyncEnabled()
+{
+	return valueMain(Main::Key::E131::IsSyncEnabled).toBool();
+}
+
+void Settings::setE131SyncEnabled(const bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::E131::IsSyncEnabled, isEnabled);
+	emit m_this->e131SyncEnabledChanged(isEnabled);
+}
+
+QString Settings::getArtNetAddress()
+{
+	return valueMain(Main::Key::ArtNet::Address).toString();
+}
+
+void Settings::setArtNetAddress(const QString& address)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::ArtNet::Address, address);
+	emit m_this->artNetAddressChanged(address);
+}
+
+QString Settings::getArtNetPort()
+{
+	return valueMain(Main::Key::ArtNet::Port).toString();
+}
+
+void Settings::setArtNetPort(const QString& port)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::ArtNet::Port, port);
+	emit m_this->artNetPortChanged(port);
+}
+
+int Settings::getArtNetUniverse()
+{
+	return valueMain(Main::Key::ArtNet::Universe).toInt();
+}
+
+void Settings::setArtNetUniverse(const int universe)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::ArtNet::Universe, universe);
+	emit m_this->artNetUniverseChanged(universe);
+}
+
+bool Settings::isArtNetSyncEnabled()
+{
+	return valueMain(Main::Key::ArtNet::IsSyncEnabled).toBool();
+}
+
+void Settings::setArtNetSyncEnabled(const bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::ArtNet::IsSyncEnabled, isEnabled);
+	emit m_this->artNetSyncEnabledChanged(isEnabled);
+}
+
+QString Settings::getVirtualSharedMemoryName()
+{
+	return valueMain(Main::Key::Virtual::SharedMemoryName).toString();
+}
+
+void Settings::setVirtualSharedMemoryName(const QString& name)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::Virtual::SharedMemoryName, name);
+	emit m_this->virtualSharedMemoryNameChanged(name);
+}
+
+QString Settings::getAdaptiveUdpAddress()
+{
+	return valueMain(Main::Key::AdaptiveUdp::Address).toString();
+}
+
+void Settings::setAdaptiveUdpAddress(const QString& address)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::AdaptiveUdp::Address, address);
+	emit m_this->adaptiveUdpAddressChanged(address);
+}
+
+QString Settings::getAdaptiveUdpPort()
+{
+	return valueMain(Main::Key::AdaptiveUdp::Port).toString();
+}
+
+void Settings::setAdaptiveUdpPort(const QString& port)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::AdaptiveUdp::Port, port);
+	emit m_this->adaptiveUdpPortChanged(port);
+}
+
+int Settings::getAdaptiveUdpTimeout()
+{
+	return valueMain(Main::Key::AdaptiveUdp::Timeout).toInt();
+}
+
+void Settings::setAdaptiveUdpTimeout(const int timeout)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::AdaptiveUdp::Timeout, timeout);
+	emit m_this->adaptiveUdpTimeoutChanged(timeout);
+}
+
+int Settings::getAdaptiveUdpRefreshInterval()
+{
+	return valueMain(Main::Key::AdaptiveUdp::RefreshInterval).toInt();
+}
+
+void Settings::setAdaptiveUdpRefreshInterval(const int interval)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::AdaptiveUdp::RefreshInterval, interval);
+	emit m_this->adaptiveUdpRefreshIntervalChanged(interval);
+}
+
+QString Settings::getRecorderPath()
+{
+	const QString path = valueMain(Main::Key::Recorder::Path).toString();
+	return path.isEmpty() ? QDir(m_configDirPath).absoluteFilePath(QStringLiteral("recording.prec")) : path;
+}
+
+void Settings::setRecorderPath(const QString& path)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::Recorder::Path, path);
+	emit m_this->recorderPathChanged(path);
+}
+
+QString Settings::getNullSinkEncoder()
+{
+	return valueMain(Main::Key::NullSink::Encoder).toString();
+}
+
+void Settings::setNullSinkEncoder(const QString& encoder)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValueMain(Main::Key::NullSink::Encoder, encoder);
+	emit m_this->nullSinkEncoderChanged(encoder);
+}
+
 QStringList Settings::getSupportedSerialPortBaudRates()
 {
 	QStringList list;
@@ -1097,6 +1523,30 @@ void Settings::setNumberOfLeds(SupportedDevices::DeviceType device, int numberOf
 			case DeviceTypeWarls:
 			emit m_this->warlsNumberOfLedsChanged(numberOfLeds);
 			break;
+
+			case DeviceTypeDdp:
+			emit m_this->ddpNumberOfLedsChanged(numberOfLeds);
+			break;
+
+			case DeviceTypeE131:
+			emit m_this->e131NumberOfLedsChanged(numberOfLeds);
+			break;
+
+			case DeviceTypeArtNet:
+			emit m_this->artNetNumberOfLedsChanged(numberOfLeds);
+			break;
+
+			case DeviceTypeAdaptiveUdp:
+			emit m_this->adaptiveUdpNumberOfLedsChanged(numberOfLeds);
+			break;
+
+			case DeviceTypeRecorder:
+			emit m_this->recorderNumberOfLedsChanged(numberOfLeds);
+			break;
+
+			case DeviceTypeNullSink:
+			emit m_this->nullSinkNumberOfLedsChanged(numberOfLeds);
+			break;
 		default:
 			qCritical() << Q_FUNC_INFO << "Device type not recognized, device ==" << device << "numberOfLeds ==" << numberOfLeds;
 		}
@@ -1164,6 +1614,30 @@ void Settings::setDeviceLedMilliAmps(const SupportedDevices::DeviceType device,
 			case DeviceTypeWarls:
 			emit m_this->warlsLedMilliAmpsChanged(mAmps);
 			break;
+
+			case DeviceTypeDdp:
+			emit m_this->ddpLedMilliAmpsChanged(mAmps);
+			break;
+
+			case DeviceTypeE131:
+			emit m_this->e131LedMilliAmpsChanged(mAmps);
+			break;
+
+			case DeviceTypeArtNet:
+			emit m_this->artNetLedMilliAmpsChanged(mAmps);
+			break;
+
+			case DeviceTypeAdaptiveUdp:
+			emit m_this->adaptiveUdpLedMilliAmpsChanged(mAmps);
+			break;
+
+			case DeviceTypeRecorder:
+			emit m_this->recorderLedMilliAmpsChanged(mAmps);
+			break;
+
+			case DeviceTypeNullSink:
+			emit m_this->nullSinkLedMilliAmpsChanged(mAmps);
+			break;
 		default:
 			qCritical() << Q_FUNC_INFO << "Device type not recognized, device ==" << device << "LedMilliAmps ==" << mAmps;
 		}
@@ -1232,6 +1706,30 @@ void Settings::setDevicePowerSupplyAmps(const SupportedDevices::DeviceType devic
 			case DeviceTypeWarls:
 			emit m_this->warlsPowerSupplyAmpsChanged(amps);
 			break;
+
+			case DeviceTypeDdp:
+			emit m_this->ddpPowerSupplyAmpsChanged(amps);
+			break;
+
+			case DeviceTypeE131:
+			emit m_this->e131PowerSupplyAmpsChanged(amps);
+			break;
+
+			case DeviceTypeArtNet:
+			emit m_this->artNetPowerSupplyAmpsChanged(amps);
+			break;
+
+			case DeviceTypeAdaptiveUdp:
+			emit m_this->adaptiveUdpPowerSupplyAmpsChanged(amps);
+			break;
+
+			case DeviceTypeRecorder:
+			emit m_this->recorderPowerSupplyAmpsChanged(amps);
+			break;
+
+			case DeviceTypeNullSink:
+			emit m_this->nullSinkPowerSupplyAmpsChanged(amps);
+			break;
 		default:
 			qCritical() << Q_FUNC_INFO << "Device type not recognized, device ==" << device << "PowerSupplyAmps ==" << amps;
 		}
@@ -1380,6 +1878,78 @@ void Settings::setGrabGamma(double gamma)
 	emit m_this->grabGammaChanged(gamma);
 }
 
+bool Settings::isGrabAdaptiveRateEnabled()
+{
+	return value(Profile::Key::Grab::IsAdaptiveRateEnabled).toBool();
+}
+
+void Settings::setGrabAdaptiveRateEnabled(bool isEnabled)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValue(Profile::Key::Grab::IsAdaptiveRateEnabled, isEnabled);
+	emit m_this->grabAdaptiveRateEnabledChanged(isEnabled);
+}
+
+int Settings::getGrabAdaptiveRateFastest()
+{
+	return getValidGrabSlowdown(value(Profile::Key::Grab::AdaptiveRateFastest).toInt());
+}
+
+void Settings::setGrabAdaptiveRateFastest(int value)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValue(Profile::Key::Grab::AdaptiveRateFastest, getValidGrabSlowdown(value));
+	emit m_this->grabAdaptiveRateFastestChanged(getValidGrabSlowdown(value));
+}
+
+int Settings::getGrabAdaptiveRateIdle()
+{
+	return getValidGrabSlowdown(value(Profile::Key::Grab::AdaptiveRateIdle).toInt());
+}
+
+void Settings::setGrabAdaptiveRateIdle(int value)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValue(Profile::Key::Grab::AdaptiveRateIdle, getValidGrabSlowdown(value));
+	emit m_this->grabAdaptiveRateIdleChanged(getValidGrabSlowdown(value));
+}
+
+int Settings::getGrabAdaptiveRateCpuBudget()
+{
+	return getValidGrabAdaptiveRateCpuBudget(value(Profile::Key::Grab::AdaptiveRateCpuBudget).toInt());
+}
+
+void Settings::setGrabAdaptiveRateCpuBudget(int value)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValue(Profile::Key::Grab::AdaptiveRateCpuBudget, getValidGrabAdaptiveRateCpuBudget(value));
+	emit m_this->grabAdaptiveRateCpuBudgetChanged(getValidGrabAdaptiveRateCpuBudget(value));
+}
+
+QString Settings::getGrabZoneResampling()
+{
+	return value(Profile::Key::Grab::ZoneResampling).toString();
+}
+
+void Settings::setGrabZoneResampling(const QString &segments)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << segments;
+	setValue(Profile::Key::Grab::ZoneResampling, segments);
+	emit m_this->grabZoneResamplingChanged(segments);
+}
+
+QString Settings::getGrabZoneResamplingInterpolation()
+{
+	return value(Profile::Key::Grab::ZoneResamplingInterpolation).toString();
+}
+
+void Settings::setGrabZoneResamplingInterpolation(const QString &interpolation)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO << interpolation;
+	setValue(Profile::Key::Grab::ZoneResamplingInterpolation, interpolation);
+	emit m_this->grabZoneResamplingInterpolationChanged(interpolation);
+}
+
 bool Settings::isSendDataOnlyIfColorsChanges()
 {
 	return value(Profile::Key::Grab::IsSendDataOnlyIfColorsChanges).toBool();
@@ -1474,6 +2044,30 @@ void Settings::setDeviceSmooth(int value)
 	emit m_this->deviceSmoothChanged(value);
 }
 
+int Settings::getDeviceHostSmoothingTime()
+{
+	return getValidDeviceHostSmoothingTime(value(Profile::Key::Device::HostSmoothingTime).toInt());
+}
+
+void Settings::setDeviceHostSmoothingTime(int value)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValue(Profile::Key::Device::HostSmoothingTime, getValidDeviceHostSmoothingTime(value));
+	emit m_this->deviceHostSmoothingTimeChanged(getValidDeviceHostSmoothingTime(value));
+}
+
+int Settings::getDeviceHostSmoothingRate()
+{
+	return getValidDeviceHostSmoothingRate(value(Profile::Key::Device::HostSmoothingRate).toInt());
+}
+
+void Settings::setDeviceHostSmoothingRate(int value)
+{
+	DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+	setValue(Profile::Key::Device::HostSmoothingRate, getValidDeviceHostSmoothingRate(value));
+	emit m_this->deviceHostSmoothingRateChanged(getValidDeviceHostSmoothingRate(value));
+}
+
 int Settings::getDeviceColorDepth()
 {
 	return getValidDeviceColorDepth(value(Profile::Key::Device::ColorDepth).toInt());
@@ -1955,6 +2549,24 @@ int Settings::getValidDeviceSmooth(int value)
 	return value;
 }
 
+int Settings::getValidDeviceHostSmoothingTime(int value)
+{
+	if (value < Profile::Device::HostSmoothingTimeMin)
+		value = Profile::Device::HostSmoothingTimeMin;
+	else if (value > Profile::Device::HostSmoothingTimeMax)
+		value = Profile::Device::HostSmoothingTimeMax;
+	return value;
+}
+
+int Settings::getValidDeviceHostSmoothingRate(int value)
+{
+	if (value < Profile::Device::HostSmoothingRateMin)
+		value = Profile::Device::HostSmoothingRateMin;
+	else if (value > Profile::Device::HostSmoothingRateMax)
+		value = Profile::Device::HostSmoothingRateMax;
+	return value;
+}
+
 int Settings::getValidDeviceColorDepth(int value)
 {
 	if (value < Profile::Device::ColorDepthMin)
@@ -1982,6 +2594,15 @@ int Settings::getValidGrabSlowdown(int value)
 	return value;
 }
 
+int Settings::getValidGrabAdaptiveRateCpuBudget(int value)
+{
+	if (value < Profile::Grab::AdaptiveRateCpuBudgetMin)
+		value = Profile::Grab::AdaptiveRateCpuBudgetMin;
+	else if (value > Profile::Grab::AdaptiveRateCpuBudgetMax)
+		value = Profile::Grab::AdaptiveRateCpuBudgetMax;
+	return value;
+}
+
 int Settings::getValidMoodLampSpeed(int value)
 {
 	if (value < Profile::MoodLamp::SpeedMin)
@@ -2113,6 +2734,12 @@ void Settings::initCurrentProfile(bool isResetDefault)
 	setNewOption(Profile::Key::Grab::IsApplyColorTemperatureEnabled,Profile::Grab::IsApplyColorTemperatureEnabledDefault, isResetDefault);
 	setNewOption(Profile::Key::Grab::ColorTemperature,              Profile::Grab::ColorTemperatureDefault, isResetDefault);
 	setNewOption(Profile::Key::Grab::Gamma,                         Profile::Grab::GammaDefault, isResetDefault);
+	setNewOption(Profile::Key::Grab::IsAdaptiveRateEnabled,			Profile::Grab::IsAdaptiveRateEnabledDefault, isResetDefault);
+	setNewOption(Profile::Key::Grab::AdaptiveRateFastest,			Profile::Grab::AdaptiveRateFastestDefault, isResetDefault);
+	setNewOption(Profile::Key::Grab::AdaptiveRateIdle,				Profile::Grab::AdaptiveRateIdleDefault, isResetDefault);
+	setNewOption(Profile::Key::Grab::AdaptiveRateCpuBudget,			Profile::Grab::AdaptiveRateCpuBudgetDefault, isResetDefault);
+	setNewOption(Profile::Key::Grab::ZoneResampling,				Profile::Grab::ZoneResamplingDefault, isResetDefault);
+	setNewOption(Profile::Key::Grab::ZoneResamplingInterpolation,	Profile::Grab::ZoneResamplingInterpolationDefault, isResetDefault);
 	// [MoodLamp]
 	setNewOption(Profile::Key::MoodLamp::IsLiquidMode,				Profile::MoodLamp::IsLiquidModeDefault, isResetDefault);
 	setNewOption(Profile::Key::MoodLamp::Color,						Profile::MoodLamp::ColorDefault, isResetDefault);
@@ -2136,6 +2763,8 @@ void Settings::initCurrentProfile(bool isResetDefault)
 	setNewOption(Profile::Key::Device::Gamma,						Profile::Device::GammaDefault, isResetDefault);
 	setNewOption(Profile::Key::Device::ColorDepth,					Profile::Device::ColorDepthDefault, isResetDefault);
 	setNewOption(Profile::Key::Device::IsDitheringEnabled,			Profile::Device::IsDitheringEnabledDefault, isResetDefault);
+	setNewOption(Profile::Key::Device::HostSmoothingTime,			Profile::Device::HostSmoothingTimeDefault, isResetDefault);
+	setNewOption(Profile::Key::Device::HostSmoothingRate,			Profile::Device::HostSmoothingRateDefault, isResetDefault);
 
 
 	QPoint ledPosition;
@@ -2266,6 +2895,12 @@ void Settings::initDevicesMap()
 	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeDrgb] = Main::Value::ConnectedDevice::DrgbDevice;
 	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeDnrgb] = Main::Value::ConnectedDevice::DnrgbDevice;
 	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeWarls] = Main::Value::ConnectedDevice::WarlsDevice;
+	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeDdp] = Main::Value::ConnectedDevice::DdpDevice;
+	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeE131] = Main::Value::ConnectedDevice::E131Device;
+	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeArtNet] = Main::Value::ConnectedDevice::ArtNetDevice;
+	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeAdaptiveUdp] = Main::Value::ConnectedDevice::AdaptiveUdpDevice;
+	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeRecorder] = Main::Value::ConnectedDevice::RecorderDevice;
+	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeNullSink] = Main::Value::ConnectedDevice::NullSinkDevice;
 
 	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeAdalight] = Main::Key::Adalight::NumberOfLeds;
 	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeArdulight] = Main::Key::Ardulight::NumberOfLeds;
@@ -2274,6 +2909,12 @@ void Settings::initDevicesMap()
 	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeDrgb] = Main::Key::Drgb::NumberOfLeds;
 	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeDnrgb] = Main::Key::Dnrgb::NumberOfLeds;
 	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeWarls] = Main::Key::Warls::NumberOfLeds;
+	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeDdp] = Main::Key::Ddp::NumberOfLeds;
+	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeE131] = Main::Key::E131::NumberOfLeds;
+	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeArtNet] = Main::Key::ArtNet::NumberOfLeds;
+	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeAdaptiveUdp] = Main::Key::AdaptiveUdp::NumberOfLeds;
+	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeRecorder] = Main::Key::Recorder::NumberOfLeds;
+	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeNullSink] = Main::Key::NullSink::NumberOfLeds;
 
 	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeAdalight] = Main::Key::Adalight::LedMilliAmps;
 	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeArdulight] = Main::Key::Ardulight::LedMilliAmps;
@@ -2282,6 +2923,12 @@ void Settings::initDevicesMap()
 	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeDrgb] = Main::Key::Drgb::LedMilliAmps;
 	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeDnrgb] = Main::Key::Dnrgb::LedMilliAmps;
 	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeWarls] = Main::Key::Warls::LedMilliAmps;
+	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeDdp] = Main::Key::Ddp::LedMilliAmps;
+	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeE131] = Main::Key::E131::LedMilliAmps;
+	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeArtNet] = Main::Key::ArtNet::LedMilliAmps;
+	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeAdaptiveUdp] = Main::Key::AdaptiveUdp::LedMilliAmps;
+	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeRecorder] = Main::Key::Recorder::LedMilliAmps;
+	m_devicesTypeToKeyLedMilliAmpsMap[SupportedDevices::DeviceTypeNullSink] = Main::Key::NullSink::LedMilliAmps;
 
 	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeAdalight] = Main::Key::Adalight::PowerSupplyAmps;
 	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeArdulight] = Main::Key::Ardulight::PowerSupplyAmps;
@@ -2290,6 +2937,12 @@ void Settings::initDevicesMap()
 	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeDrgb] = Main::Key::Drgb::PowerSupplyAmps;
 	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeDnrgb] = Main::Key::Dnrgb::PowerSupplyAmps;
 	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeWarls] = Main::Key::Warls::PowerSupplyAmps;
+	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeDdp] = Main::Key::Ddp::PowerSupplyAmps;
+	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeE131] = Main::Key::E131::PowerSupplyAmps;
+	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeArtNet] = Main::Key::ArtNet::PowerSupplyAmps;
+	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeAdaptiveUdp] = Main::Key::AdaptiveUdp::PowerSupplyAmps;
+	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeRecorder] = Main::Key::Recorder::PowerSupplyAmps;
+	m_devicesTypeToKeyPowerSupplyAmpsMap[SupportedDevices::DeviceTypeNullSink] = Main::Key::NullSink::PowerSupplyAmps;
 #ifdef ALIEN_FX_SUPPORTED
 	m_devicesTypeToNameMap[SupportedDevices::DeviceTypeAlienFx] = Main::Value::ConnectedDevice::AlienFxDevice;
 	m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeAlienFx] = Main::Key::AlienFx::NumberOfLeds;
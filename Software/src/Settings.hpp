@@ -100,6 +100,10 @@ public:
 	static void setListenOnlyOnLoInterface(bool localOnly);
 	static int getApiPort();
 	static void setApiPort(int apiPort);
+	static bool isApiUdpEnabled();
+	static void setIsApiUdpEnabled(bool isEnabled);
+	static int getApiUdpPort();
+	static void setApiUdpPort(int udpPort);
 	static QString getApiAuthKey();
 	static void setApiKey(const QString & apiKey);
 	static void setIsApiAuthEnabled(bool isEnabled);
@@ -119,6 +123,9 @@ public:
 	static void setConnectedDevice(SupportedDevices::DeviceType device);
 	static QString getConnectedDeviceName();
 	static void setConnectedDeviceName(const QString & deviceName);
+	static SupportedDevices::DeviceType getDeviceTypeByName(const QString & deviceName, bool *ok = nullptr);
+	static QString getDeviceRoutes();
+	static void setDeviceRoutes(const QString & routes);
 	static QStringList getSupportedDevices();
 	static QKeySequence getHotkey(const QString &actionName);
 	static void setHotkey(const QString &actionName, const QKeySequence &keySequence);
@@ -126,6 +133,10 @@ public:
 	static void setAdalightSerialPortName(const QString & port);
 	static int getAdalightSerialPortBaudRate();
 	static void setAdalightSerialPortBaudRate(const QString & baud);
+	static bool isAdalightDeltaFramesEnabled();
+	static void setAdalightDeltaFramesEnabled(bool isEnabled);
+	static bool isAdalightAckEnabled();
+	static void setAdalightAckEnabled(bool isEnabled);
 	static QString getArdulightSerialPortName();
 	static void setArdulightSerialPortName(const QString & port);
 	static int getArdulightSerialPortBaudRate();
@@ -148,6 +159,44 @@ public:
 	static void setWarlsPort(const QString& port);
 	static int getWarlsTimeout();
 	static void setWarlsTimeout(const int timeout);
+	static QString getDdpAddress();
+	static void setDdpAddress(const QString& address);
+	static QString getDdpPort();
+	static void setDdpPort(const QString& port);
+	static int getDdpTimeout();
+	static void setDdpTimeout(const int timeout);
+	static QString getE131Address();
+	static void setE131Address(const QString& address);
+	static QString getE131Port();
+	static void setE131Port(const QString& port);
+	static int getE131Universe();
+	static void setE131Universe(const int universe);
+	static bool isE131MulticastEnabled();
+	static void setE131MulticastEnabled(const bool isEnabled);
+	static bool isE131SyncEnabled();
+	static void setE131SyncEnabled(const bool isEnabled);
+	static QString getArtNetAddress();
+	static void setArtNetAddress(const QString& address);
+	static QString getArtNetPort();
+	static void setArtNetPort(const QString& port);
+	static int getArtNetUniverse();
+	static void setArtNetUniverse(const int universe);
+	static bool isArtNetSyncEnabled();
+	static void setArtNetSyncEnabled(const bool isEnabled);
+	static QString getVirtualSharedMemoryName();
+	static void setVirtualSharedMemoryName(const QString& name);
+	static QString getAdaptiveUdpAddress();
+	static void setAdaptiveUdpAddress(const QString& address);
+	static QString getAdaptiveUdpPort();
+	static void setAdaptiveUdpPort(const QString& port);
+	static int getAdaptiveUdpTimeout();
+	static void setAdaptiveUdpTimeout(const int timeout);
+	static int getAdaptiveUdpRefreshInterval();
+	static void setAdaptiveUdpRefreshInterval(const int interval);
+	static QString getRecorderPath();
+	static void setRecorderPath(const QString& path);
+	static QString getNullSinkEncoder();
+	static void setNullSinkEncoder(const QString& encoder);
 	static int getDeviceLedMilliAmps(const SupportedDevices::DeviceType device);
 	static void setDeviceLedMilliAmps(const SupportedDevices::DeviceType device, const int mamps);
 	static double getDevicePowerSupplyAmps(const SupportedDevices::DeviceType device);
@@ -178,6 +227,18 @@ public:
 	static void setGrabColorTemperature(int value);
 	static double getGrabGamma();
 	static void setGrabGamma(double gamma);
+	static bool isGrabAdaptiveRateEnabled();
+	static void setGrabAdaptiveRateEnabled(bool isEnabled);
+	static int getGrabAdaptiveRateFastest();
+	static void setGrabAdaptiveRateFastest(int value);
+	static int getGrabAdaptiveRateIdle();
+	static void setGrabAdaptiveRateIdle(int value);
+	static int getGrabAdaptiveRateCpuBudget();
+	static void setGrabAdaptiveRateCpuBudget(int value);
+	static QString getGrabZoneResampling();
+	static void setGrabZoneResampling(const QString &segments);
+	static QString getGrabZoneResamplingInterpolation();
+	static void setGrabZoneResamplingInterpolation(const QString &interpolation);
 	static bool isSendDataOnlyIfColorsChanges();
 	static void setSendDataOnlyIfColorsChanges(bool isEnabled);
 	static int getLuminosityThreshold();
@@ -195,6 +256,10 @@ public:
 	static void setDeviceBrightnessCap(int value);
 	static int getDeviceSmooth();
 	static void setDeviceSmooth(int value);
+	static int getDeviceHostSmoothingTime();
+	static void setDeviceHostSmoothingTime(int value);
+	static int getDeviceHostSmoothingRate();
+	static void setDeviceHostSmoothingRate(int value);
 	static int getDeviceColorDepth();
 	static void setDeviceColorDepth(int value);
 	static double getDeviceGamma();
@@ -267,9 +332,12 @@ private:
 	static int getValidDeviceBrightness(int value);
 	static int getValidDeviceBrightnessCap(int value);
 	static int getValidDeviceSmooth(int value);
+	static int getValidDeviceHostSmoothingTime(int value);
+	static int getValidDeviceHostSmoothingRate(int value);
 	static int getValidDeviceColorDepth(int value);
 	static double getValidDeviceGamma(double value);
 	static int getValidGrabSlowdown(int value);
+	static int getValidGrabAdaptiveRateCpuBudget(int value);
 	static int getValidMoodLampSpeed(int value);
 	static int getValidSoundVisualizerLiquidSpeed(int value);
 	static int getValidLuminosityThreshold(int value);
@@ -312,9 +380,12 @@ signals:
 	void debugLevelChanged(int);
 	void updateFirmwareMessageShownChanged(bool isShown);
 	void connectedDeviceChanged(const SupportedDevices::DeviceType device);
+	void deviceRoutesChanged(const QString & routes);
 	void hotkeyChanged(const QString &actionName, const QKeySequence & newKeySequence, const QKeySequence &oldKeySequence);
 	void adalightSerialPortNameChanged(const QString & port);
 	void adalightSerialPortBaudRateChanged(const QString & baud);
+	void adalightDeltaFramesEnabledChanged(bool isEnabled);
+	void adalightAckEnabledChanged(bool isEnabled);
 	void adalightLedMilliAmpsChanged(const int mAmps);
 	void adalightPowerSupplyAmpsChanged(const double amps);
 	void ardulightSerialPortNameChanged(const QString & port);
@@ -336,6 +407,37 @@ signals:
 	void warlsTimeoutChanged(const int timeout);
 	void warlsLedMilliAmpsChanged(const int mAmps);
 	void warlsPowerSupplyAmpsChanged(const double amps);
+	void ddpAddressChanged(const QString& address);
+	void ddpPortChanged(const QString& port);
+	void ddpTimeoutChanged(const int timeout);
+	void ddpLedMilliAmpsChanged(const int mAmps);
+	void ddpPowerSupplyAmpsChanged(const double amps);
+	void e131AddressChanged(const QString& address);
+	void e131PortChanged(const QString& port);
+	void e131UniverseChanged(const int universe);
+	void e131MulticastEnabledChanged(const bool isEnabled);
+	void e131SyncEnabledChanged(const bool isEnabled);
+	void e131LedMilliAmpsChanged(const int mAmps);
+	void e131PowerSupplyAmpsChanged(const double amps);
+	void artNetAddressChanged(const QString& address);
+	void artNetPortChanged(const QString& port);
+	void artNetUniverseChanged(const int universe);
+	void artNetSyncEnabledChanged(const bool isEnabled);
+	void artNetLedMilliAmpsChanged(const int mAmps);
+	void artNetPowerSupplyAmpsChanged(const double amps);
+	void virtualSharedMemoryNameChanged(const QString& name);
+	void adaptiveUdpAddressChanged(const QString& address);
+	void adaptiveUdpPortChanged(const QString& port);
+	void adaptiveUdpTimeoutChanged(const int timeout);
+	void adaptiveUdpRefreshIntervalChanged(const int interval);
+	void adaptiveUdpLedMilliAmpsChanged(const int mAmps);
+	void adaptiveUdpPowerSupplyAmpsChanged(const double amps);
+	void recorderPathChanged(const QString& path);
+	void recorderLedMilliAmpsChanged(const int mAmps);
+	void recorderPowerSupplyAmpsChanged(const double amps);
+	void nullSinkEncoderChanged(const QString& encoder);
+	void nullSinkLedMilliAmpsChanged(const int mAmps);
+	void nullSinkPowerSupplyAmpsChanged(const double amps);
 	void lightpackNumberOfLedsChanged(int numberOfLeds);
 	void lightpackLedMilliAmpsChanged(const int mAmps);
 	void lightpackPowerSupplyAmpsChanged(const double amps);
@@ -344,6 +446,12 @@ signals:
 	void drgbNumberOfLedsChanged(int numberOfLeds);
 	void dnrgbNumberOfLedsChanged(int numberOfLeds);
 	void warlsNumberOfLedsChanged(int numberOfLeds);
+	void ddpNumberOfLedsChanged(int numberOfLeds);
+	void e131NumberOfLedsChanged(int numberOfLeds);
+	void artNetNumberOfLedsChanged(int numberOfLeds);
+	void adaptiveUdpNumberOfLedsChanged(int numberOfLeds);
+	void recorderNumberOfLedsChanged(int numberOfLeds);
+	void nullSinkNumberOfLedsChanged(int numberOfLeds);
 	void virtualNumberOfLedsChanged(int numberOfLeds);
 	void virtualLedMilliAmpsChanged(const int mAmps);
 	void virtualPowerSupplyAmpsChanged(const double amps);
@@ -355,6 +463,12 @@ signals:
 	void grabApplyColorTemperatureChanged(bool isEnabled);
 	void grabColorTemperatureChanged(int value);
 	void grabGammaChanged(double value);
+	void grabAdaptiveRateEnabledChanged(bool isEnabled);
+	void grabAdaptiveRateFastestChanged(int value);
+	void grabAdaptiveRateIdleChanged(int value);
+	void grabAdaptiveRateCpuBudgetChanged(int value);
+	void grabZoneResamplingChanged(const QString &segments);
+	void grabZoneResamplingInterpolationChanged(const QString &interpolation);
 	void sendDataOnlyIfColorsChangesChanged(bool isEnabled);
 	void luminosityThresholdChanged(int value);
 	void minimumLuminosityEnabledChanged(bool value);
@@ -363,6 +477,8 @@ signals:
 	void deviceBrightnessChanged(int value);
 	void deviceBrightnessCapChanged(int value);
 	void deviceSmoothChanged(int value);
+	void deviceHostSmoothingTimeChanged(int value);
+	void deviceHostSmoothingRateChanged(int value);
 	void deviceColorDepthChanged(int value);
 	void deviceGammaChanged(double gamma);
 	void deviceDitheringEnabledChanged(bool isEnabled);
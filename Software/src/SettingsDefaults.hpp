@@ -32,9 +32,9 @@
 #include "enums.hpp"
 
 #ifdef ALIEN_FX_SUPPORTED
-#	define SUPPORTED_DEVICES			"Lightpack,AlienFx,Adalight,Ardulight,Virtual,DRGB,DNRGB,WARLS"
+#	define SUPPORTED_DEVICES			"Lightpack,AlienFx,Adalight,Ardulight,Virtual,DRGB,DNRGB,WARLS,DDP,E131,ArtNet,AdaptiveUDP,Recorder,NullSink"
 #else
-#	define SUPPORTED_DEVICES			"Lightpack,Adalight,Ardulight,Virtual,DRGB,DNRGB,WARLS"
+#	define SUPPORTED_DEVICES			"Lightpack,Adalight,Ardulight,Virtual,DRGB,DNRGB,WARLS,DDP,E131,ArtNet,AdaptiveUDP,Recorder,NullSink"
 #endif
 
 #define _GRABMODE_ENUM(_name_)		::Grab::GrabberType##_name_
@@ -83,6 +83,9 @@ static const bool IsKeepLightsOnAfterScreenOff = true;
 static const bool IsPingDeviceEverySecond = true;
 static const bool IsUpdateFirmwareMessageShown = false;
 static const QString ConnectedDeviceDefault = QStringLiteral("Lightpack");
+// LED ranges for the connected device and extra devices driven next to it,
+// see LedDeviceRouter::parseRoutes(); the connected device gets the whole frame if not listed
+static const QString DeviceRoutesDefault = QLatin1String("");
 static const QString SupportedDevices = QStringLiteral(SUPPORTED_DEVICES); /* comma separated values! */
 static const bool CheckForUpdates = true;
 static const bool InstallUpdates = true;
@@ -99,6 +102,9 @@ namespace Api
 static const bool IsEnabledDefault = false;
 static const bool ListenOnlyOnLoInterfaceDefault = true;
 static const int PortDefault = 3636;
+// colors streamed in datagrams, see ApiUdpStream
+static const bool IsUdpEnabledDefault = false;
+static const int UdpPortDefault = 3636;
 static const QString AuthKey = QLatin1String("");
 // See ApiKey generation in Settings initialization
 }
@@ -113,6 +119,8 @@ static const int NumberOfLedsDefault = 25;
 static const QString ColorSequence = QStringLiteral("RGB");
 static const QString PortDefault = QStringLiteral(SERIAL_PORT_DEFAULT);
 static const QString BaudRateDefault = QStringLiteral("115200");
+static const bool IsDeltaFramesEnabledDefault = false;
+static const bool IsAckEnabledDefault = false;
 }
 namespace Ardulight
 {
@@ -132,6 +140,8 @@ static const int NumberOfLedsDefault = 10;
 namespace Virtual
 {
 static const int NumberOfLedsDefault = 10;
+// POSIX shared memory object every frame is published to, empty for none
+static const QString SharedMemoryNameDefault = QStringLiteral("");
 }
 namespace Drgb
 {
@@ -154,6 +164,52 @@ static const QString AddressDefault = QStringLiteral("127.0.0.1");
 static const QString PortDefault = QStringLiteral("21324");
 static const int TimeoutDefault = 255;
 }
+namespace Ddp
+{
+static const int NumberOfLedsDefault = 10;
+static const QString AddressDefault = QStringLiteral("127.0.0.1");
+static const QString PortDefault = QStringLiteral("4048");
+// not sent, anything but 255 pushes an empty packet when nothing changed to stay in realtime mode
+static const int TimeoutDefault = 2;
+}
+namespace E131
+{
+static const int NumberOfLedsDefault = 10;
+static const QString AddressDefault = QStringLiteral("127.0.0.1");
+static const QString PortDefault = QStringLiteral("5568");
+static const int UniverseDefault = 1;
+static const bool IsMulticastEnabledDefault = false;
+static const bool IsSyncEnabledDefault = false;
+}
+namespace ArtNet
+{
+static const int NumberOfLedsDefault = 10;
+static const QString AddressDefault = QStringLiteral("127.0.0.1");
+static const QString PortDefault = QStringLiteral("6454");
+static const int UniverseDefault = 0;
+static const bool IsSyncEnabledDefault = false;
+}
+namespace AdaptiveUdp
+{
+static const int NumberOfLedsDefault = 10;
+static const QString AddressDefault = QStringLiteral("127.0.0.1");
+static const QString PortDefault = QStringLiteral("21324");
+static const int TimeoutDefault = 255;
+// ms between whole frames that repair lost packets, 0 for never
+static const int RefreshIntervalDefault = 1000;
+}
+namespace Recorder
+{
+static const int NumberOfLedsDefault = 10;
+// empty records to recording.prec in the settings directory
+static const QString PathDefault = QStringLiteral("");
+}
+namespace NullSink
+{
+static const int NumberOfLedsDefault = 10;
+// wire format the frames are encoded with: Lightpack, Adalight, Ardulight, DRGB, DNRGB or DDP
+static const QString EncoderDefault = QStringLiteral("Adalight");
+}
 }
 
 // ProfileName.ini
@@ -190,6 +246,14 @@ static const int ColorTemperatureMax = 10000;
 static const double GammaMin = 0.05;
 static const double GammaDefault = 1.2;
 static const double GammaMax = 10.0;
+static const bool IsAdaptiveRateEnabledDefault = false;
+static const int AdaptiveRateFastestDefault = 16;
+static const int AdaptiveRateIdleDefault = 200;
+static const int AdaptiveRateCpuBudgetMin = 1;
+static const int AdaptiveRateCpuBudgetDefault = 25;
+static const int AdaptiveRateCpuBudgetMax = 100;
+static const QString ZoneResamplingDefault = QLatin1String("");
+static const QString ZoneResamplingInterpolationDefault = QStringLiteral("Linear");
 }
 // [MoodLamp]
 namespace MoodLamp
@@ -243,6 +307,15 @@ static const double GammaDefault = 2.0;
 static const double GammaMax = 10.0;
 
 static const bool IsDitheringEnabledDefault = false;
+
+// host side smoothing for devices without it in firmware, 0 disables
+static const int HostSmoothingTimeMin = 0;
+static const int HostSmoothingTimeDefault = 0;
+static const int HostSmoothingTimeMax = 1000;
+
+static const int HostSmoothingRateMin = 10;
+static const int HostSmoothingRateDefault = 120;
+static const int HostSmoothingRateMax = 240;
 }
 // [LED_i]
 namespace Led
@@ -0,0 +1,171 @@
+/*
+ * TemporalSmoother.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <QtGlobal>
+
+#include "TemporalSmoother.hpp"
+#include "SettingsDefaults.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TEMPORAL_SMOOTHER_SSE2
+#endif
+
+using namespace SettingsScope;
+
+namespace {
+const int FractionBits = 6;
+// largest alpha, just below 1.0 in 0.15 fixed point
+const int16_t AlphaMax = 0x7fff;
+
+// state += floor(diff * alpha), nudged by one towards the target when positive so it always converges;
+// the step never overshoots because alpha < 1
+bool stepScalar(int16_t * const state, const int16_t * const target, const int first, const int count, const int16_t alpha)
+{
+	bool isMoving = false;
+	for (int i = first; i < count; ++i) {
+		const int diff = target[i] - state[i];
+		if (diff == 0)
+			continue;
+		const int delta = ((diff * 2 * alpha) >> 16) + (diff > 0 ? 1 : 0);
+		state[i] += delta;
+		isMoving = isMoving || state[i] != target[i];
+	}
+	return isMoving;
+}
+
+#ifdef TEMPORAL_SMOOTHER_SSE2
+bool stepSse2(int16_t * const state, const int16_t * const target, const int count, const int16_t alpha)
+{
+	const __m128i alpha8 = _mm_set1_epi16(alpha);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i moving = zero;
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i s = _mm_loadu_si128((const __m128i*)&state[i]);
+		const __m128i t = _mm_loadu_si128((const __m128i*)&target[i]);
+		const __m128i diff = _mm_sub_epi16(t, s);
+		// (2 * diff * alpha) >> 16, diff fits 15 bits with 6 fractional bits
+		__m128i delta = _mm_mulhi_epi16(_mm_add_epi16(diff, diff), alpha8);
+		// cmpgt is -1 where diff > 0
+		delta = _mm_sub_epi16(delta, _mm_cmpgt_epi16(diff, zero));
+		s = _mm_add_epi16(s, delta);
+		_mm_storeu_si128((__m128i*)&state[i], s);
+		moving = _mm_or_si128(moving, _mm_xor_si128(s, t));
+	}
+	const bool isMoving = _mm_movemask_epi8(_mm_cmpeq_epi16(moving, zero)) != 0xffff;
+	return stepScalar(state, target, i, count, alpha) || isMoving;
+}
+#endif
+}
+
+TemporalSmoother::TemporalSmoother()
+	: m_timeConstant(Profile::Device::HostSmoothingTimeDefault)
+	, m_outputRate(Profile::Device::HostSmoothingRateDefault)
+	, m_alpha(0)
+	, m_count(0)
+	, m_hasState(false)
+{
+	updateAlpha();
+}
+
+void TemporalSmoother::setTimeConstant(int ms)
+{
+	m_timeConstant = qMax(0, ms);
+	updateAlpha();
+}
+
+void TemporalSmoother::setOutputRate(int hz)
+{
+	m_outputRate = qMax(1, hz);
+	updateAlpha();
+}
+
+void TemporalSmoother::updateAlpha()
+{
+	if (m_timeConstant <= 0) {
+		m_alpha = AlphaMax;
+		return;
+	}
+	const double alpha = 1.0 - std::exp(-(1000.0 / m_outputRate) / m_timeConstant);
+	m_alpha = (int16_t)qBound(1.0, alpha * 32768.0, (double)AlphaMax);
+}
+
+void TemporalSmoother::reset()
+{
+	m_hasState = false;
+}
+
+void TemporalSmoother::setTarget(const QList<QRgb> &colors)
+{
+	if (colors.size() != m_count) {
+		m_count = colors.size();
+		m_state.resize(m_count * 3);
+		m_target.resize(m_count * 3);
+		m_hasState = false;
+	}
+
+	int16_t * const r = m_target.data();
+	int16_t * const g = r + m_count;
+	int16_t * const b = g + m_count;
+	for (int i = 0; i < m_count; ++i) {
+		const QRgb color = colors[i];
+		r[i] = qRed(color) << FractionBits;
+		g[i] = qGreen(color) << FractionBits;
+		b[i] = qBlue(color) << FractionBits;
+	}
+
+	// nothing to fade from, start at the target
+	if (!m_hasState) {
+		m_state = m_target;
+		m_hasState = true;
+	}
+}
+
+bool TemporalSmoother::step(QList<QRgb> &colors)
+{
+	if (!m_hasState)
+		return false;
+
+#ifdef TEMPORAL_SMOOTHER_SSE2
+	const bool isMoving = stepSse2(m_state.data(), m_target.constData(), m_state.size(), m_alpha);
+#else
+	const bool isMoving = stepScalar(m_state.data(), m_target.constData(), 0, m_state.size(), m_alpha);
+#endif
+
+	if (colors.size() != m_count) {
+		colors.clear();
+		colors.reserve(m_count);
+		for (int i = 0; i < m_count; ++i)
+			colors.append(0);
+	}
+
+	const int16_t * const r = m_state.constData();
+	const int16_t * const g = r + m_count;
+	const int16_t * const b = g + m_count;
+	const int round = 1 << (FractionBits - 1);
+	for (int i = 0; i < m_count; ++i)
+		colors[i] = qRgb((r[i] + round) >> FractionBits, (g[i] + round) >> FractionBits, (b[i] + round) >> FractionBits);
+
+	return isMoving;
+}
@@ -0,0 +1,68 @@
+/*
+ * TemporalSmoother.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QList>
+#include <QRgb>
+#include <QVector>
+
+/*!
+	Per-LED exponential moving average for devices without smoothing in firmware.
+	\a step() is called at the output rate and moves every channel towards the last
+	target by 1 - exp(-interval / timeConstant) of the remaining distance.
+	The state is kept in 16 bit fixed point (6 fractional bits).
+*/
+class TemporalSmoother
+{
+public:
+	TemporalSmoother();
+
+	void setTimeConstant(int ms);
+	void setOutputRate(int hz);
+
+	bool isEnabled() const { return m_timeConstant > 0; }
+	int interval() const { return 1000 / m_outputRate; }
+
+	void setTarget(const QList<QRgb> &colors);
+	void reset();
+
+	/*!
+		Advances the filter by one output interval.
+		\param colors receives the smoothed colors
+		\return false once every LED reached its target
+	*/
+	bool step(QList<QRgb> &colors);
+
+private:
+	void updateAlpha();
+
+	int m_timeConstant;
+	int m_outputRate;
+	int16_t m_alpha; // 0.15 fixed point
+
+	int m_count;
+	bool m_hasState;
+	// planar: all red values, then green, then blue
+	QVector<int16_t> m_state;
+	QVector<int16_t> m_target;
+};
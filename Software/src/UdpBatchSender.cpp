@@ -0,0 +1,190 @@
+/*
+ * UdpBatchSender.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "UdpBatchSender.hpp"
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#endif
+
+namespace {
+// the kernel refuses more segments per GSO send (UDP_MAX_SEGMENTS)
+const int MaxSegments = 64;
+}
+
+UdpBatchSender::UdpBatchSender()
+	: m_socket(-1)
+	, m_isGsoEnabled(false)
+	, m_systemCalls(0)
+	, m_error(0)
+{
+}
+
+bool UdpBatchSender::isSupported()
+{
+#ifdef Q_OS_LINUX
+	return true;
+#else
+	return false;
+#endif
+}
+
+void UdpBatchSender::setSocketDescriptor(qintptr socket)
+{
+	m_socket = isSupported() ? socket : -1;
+	clear();
+}
+
+void UdpBatchSender::setGsoEnabled(bool isEnabled)
+{
+#ifdef UDP_SEGMENT
+	m_isGsoEnabled = isEnabled;
+#else
+	Q_UNUSED(isEnabled);
+#endif
+}
+
+void UdpBatchSender::reserve(int packets, int packetSize)
+{
+	m_storage.reserve(packets * packetSize);
+	m_sizes.reserve(packets);
+#ifdef Q_OS_LINUX
+	m_messages.reserve(packets);
+	m_vectors.reserve(packets);
+#endif
+}
+
+void UdpBatchSender::clear()
+{
+	// resize keeps the reserved capacity, clear() would free it
+	m_storage.resize(0);
+	m_sizes.resize(0);
+}
+
+void UdpBatchSender::append(const QByteArray &packet)
+{
+	m_storage.append(packet);
+	m_sizes.append(packet.size());
+}
+
+bool UdpBatchSender::send()
+{
+	if (m_sizes.isEmpty())
+		return true;
+
+	bool ok = false;
+	if (isValid())
+		ok = (m_isGsoEnabled && sendSegmented()) || sendMessages();
+	clear();
+	return ok;
+}
+
+QString UdpBatchSender::errorString() const
+{
+	if (!isValid())
+		return QStringLiteral("no socket");
+	return QString::fromLocal8Bit(strerror(m_error));
+}
+
+bool UdpBatchSender::sendSegmented()
+{
+#ifdef UDP_SEGMENT
+	const int packets = m_sizes.count();
+	if (packets < 2 || packets > MaxSegments)
+		return false;
+	// the kernel cuts the payload into equal segments, only the last may be shorter
+	const int segmentSize = m_sizes.first();
+	for (int i = 1; i < packets; ++i) {
+		if (m_sizes[i] > segmentSize || (m_sizes[i] < segmentSize && i != packets - 1))
+			return false;
+	}
+
+	iovec vector = { m_storage.data(), (size_t)m_storage.size() };
+	char control[CMSG_SPACE(sizeof(uint16_t))];
+	memset(control, 0, sizeof(control));
+	msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &vector;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+
+	cmsghdr *header = CMSG_FIRSTHDR(&message);
+	header->cmsg_level = SOL_UDP;
+	header->cmsg_type = UDP_SEGMENT;
+	header->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+	const uint16_t gsoSize = segmentSize;
+	memcpy(CMSG_DATA(header), &gsoSize, sizeof(gsoSize));
+
+	++m_systemCalls;
+	if (sendmsg(m_socket, &message, 0) == m_storage.size())
+		return true;
+
+	m_error = errno;
+	// old kernel or a device that can't segment, stick to sendmmsg from now on
+	if (m_error == EINVAL || m_error == EIO || m_error == ENOPROTOOPT || m_error == EOPNOTSUPP)
+		m_isGsoEnabled = false;
+	return false;
+#else
+	return false;
+#endif
+}
+
+bool UdpBatchSender::sendMessages()
+{
+#ifdef Q_OS_LINUX
+	const int packets = m_sizes.count();
+	m_messages.resize(packets);
+	m_vectors.resize(packets);
+
+	// storage may have moved while appending, point into it only now
+	char *data = m_storage.data();
+	for (int i = 0; i < packets; ++i) {
+		m_vectors[i].iov_base = data;
+		m_vectors[i].iov_len = m_sizes[i];
+		data += m_sizes[i];
+
+		memset(&m_messages[i], 0, sizeof(mmsghdr));
+		m_messages[i].msg_hdr.msg_iov = &m_vectors[i];
+		m_messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	int sent = 0;
+	while (sent < packets) {
+		++m_systemCalls;
+		const int result = sendmmsg(m_socket, m_messages.data() + sent, packets - sent, 0);
+		if (result < 0) {
+			if (errno == EINTR)
+				continue;
+			m_error = errno;
+			return false;
+		}
+		sent += result;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,85 @@
+/*
+ * UdpBatchSender.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+/*!
+	Sends all datagrams of one frame through a connected UDP socket in a single system
+	call: one sendmmsg() on Linux, or, with segmentation offload enabled and every packet
+	but the last of the same size, one UDP_SEGMENT (GSO) send. Packets are copied into
+	storage that is kept between frames.
+	Elsewhere isSupported() is false and callers keep writing through QUdpSocket.
+*/
+class UdpBatchSender
+{
+public:
+	UdpBatchSender();
+
+	static bool isSupported();
+
+	/*!
+		\param socket descriptor of a connected UDP socket, -1 for none
+	*/
+	void setSocketDescriptor(qintptr socket);
+	bool isValid() const { return m_socket >= 0; }
+
+	void setGsoEnabled(bool isEnabled);
+	bool isGsoEnabled() const { return m_isGsoEnabled; }
+
+	void reserve(int packets, int packetSize);
+	void clear();
+	void append(const QByteArray &packet);
+	int count() const { return m_sizes.count(); }
+
+	/*!
+		Sends the appended packets and clears them.
+		\return true if every packet was handed to the kernel
+	*/
+	bool send();
+
+	int systemCalls() const { return m_systemCalls; }
+	QString errorString() const;
+
+private:
+	bool sendSegmented();
+	bool sendMessages();
+
+	qintptr m_socket;
+	bool m_isGsoEnabled;
+	QByteArray m_storage;
+	QVector<int> m_sizes;
+#ifdef Q_OS_LINUX
+	QVector<mmsghdr> m_messages;
+	QVector<iovec> m_vectors;
+#endif
+	int m_systemCalls;
+	int m_error;
+};
@@ -90,6 +90,12 @@ enum DeviceType {
 	DeviceTypeDrgb,
 	DeviceTypeDnrgb,
 	DeviceTypeWarls,
+	DeviceTypeDdp,
+	DeviceTypeE131,
+	DeviceTypeArtNet,
+	DeviceTypeAdaptiveUdp,
+	DeviceTypeRecorder,
+	DeviceTypeNullSink,
 
 	DeviceTypesCount,
 	DefaultDeviceType = DeviceTypeLightpack
@@ -108,6 +114,12 @@ enum Devices
 	Drgb        = 490,
 	Dnrgb       = 1500,
 	Warls       = 255,
+	Ddp         = 1500,
+	E131        = 1500,
+	ArtNet      = 1500,
+	AdaptiveUdp = 1500,
+	Recorder    = 1500,
+	NullSink    = 1500,
 
 	Lightpack4	= 8,
 	Lightpack5	= 10,
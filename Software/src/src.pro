@@ -77,7 +77,12 @@ unix:!macx{
         error("pkg-config not found")
     }
     CONFIG    += link_pkgconfig
-    PKGCONFIG += libusb-1.0
+    # hidraw sees uhid devices too, see tests/simulator
+    CONFIG(hidraw) {
+        PKGCONFIG += hidapi-hidraw
+    } else {
+        PKGCONFIG += libusb-1.0
+    }
 
     DESKTOP = $$(XDG_CURRENT_DESKTOP)
 
@@ -190,9 +195,15 @@ win32 {
     }
 }
 
+unix {
+    # shared memory frames of the virtual device
+    SOURCES += ../common/LedFrameRing.c
+    !macx:LIBS += -lrt
+}
+
 unix:!macx{
     # Linux version using libusb and hidapi codes
-    SOURCES += hidapi/linux/hid-libusb.c
+    !CONFIG(hidraw):SOURCES += hidapi/linux/hid-libusb.c
     # For X11 grabber
     LIBS +=-lXext -lX11
 
@@ -291,19 +302,42 @@ SOURCES += \
     LedDeviceAdalight.cpp \
     LedDeviceArdulight.cpp \
     LedDeviceVirtual.cpp \
+    LedFrameRingWriter.cpp \
     AbstractLedDeviceUdp.cpp \
     LedDeviceDrgb.cpp \
     LedDeviceDnrgb.cpp \
     LedDeviceWarls.cpp \
+    LedDeviceDdp.cpp \
+    AbstractLedDeviceDmx.cpp \
+    LedDeviceE131.cpp \
+    LedDeviceArtNet.cpp \
+    LedDeviceAdaptiveUdp.cpp \
+    HidReportWriter.cpp \
+    LedDeviceRecorder.cpp \
+    FrameRecording.cpp \
+    FrameReplayer.cpp \
+    LedDeviceNullSink.cpp \
+    LatencyHistogram.cpp \
     ColorButton.cpp \
     ApiServer.cpp \
     ApiServerSetColorTask.cpp \
+    ApiBinaryProtocol.cpp \
+    ApiUdpStream.cpp \
     MoodLampManager.cpp \
     MoodLamp.cpp \
     LiquidColorGenerator.cpp \
     LedDeviceManager.cpp \
+    LedDeviceRouter.cpp \
+    FrameMailbox.cpp \
+    LedDeviceCommandQueue.cpp \
+    LedWireEncoder.cpp \
+    AdalightDeltaCodec.cpp \
+    SerialFramePacer.cpp \
+    UdpBatchSender.cpp \
     SelectWidget.cpp \
     GrabManager.cpp \
+    GrabRateGovernor.cpp \
+    TemporalSmoother.cpp \
     AbstractLedDevice.cpp \
     PluginsManager.cpp \
     Plugin.cpp \
@@ -334,6 +368,8 @@ HEADERS += \
     version.h \
     TimeEvaluations.hpp \
     GrabManager.hpp \
+    GrabRateGovernor.hpp \
+    TemporalSmoother.hpp \
     GrabWidget.hpp \
     GrabConfigWidget.hpp \
     debug.h \
@@ -347,10 +383,25 @@ HEADERS += \
     LedDeviceDrgb.hpp \
     LedDeviceDnrgb.hpp \
     LedDeviceWarls.hpp \
+    LedDeviceDdp.hpp \
+    AbstractLedDeviceDmx.hpp \
+    LedDeviceE131.hpp \
+    LedDeviceArtNet.hpp \
+    LedDeviceAdaptiveUdp.hpp \
+    HidReportWriter.hpp \
+    LedDeviceRecorder.hpp \
+    FrameRecording.hpp \
+    FrameReplayer.hpp \
+    LedDeviceNullSink.hpp \
+    LatencyHistogram.hpp \
     LedDeviceVirtual.hpp \
+    LedFrameRingWriter.hpp \
     ColorButton.hpp \
     ../common/defs.h \
+    ../common/LedFrameRing.h \
     enums.hpp         ApiServer.hpp     ApiServerSetColorTask.hpp \
+    ApiBinaryProtocol.hpp \
+    ApiUdpStream.hpp \
     hidapi/hidapi.h \
     ../../CommonHeaders/COMMANDS.h \
     ../../CommonHeaders/USB_ID.h \
@@ -358,6 +409,13 @@ HEADERS += \
     MoodLamp.hpp \
     LiquidColorGenerator.hpp \
     LedDeviceManager.hpp \
+    LedDeviceRouter.hpp \
+    FrameMailbox.hpp \
+    LedDeviceCommandQueue.hpp \
+    LedWireEncoder.hpp \
+    AdalightDeltaCodec.hpp \
+    SerialFramePacer.hpp \
+    UdpBatchSender.hpp \
     SelectWidget.hpp \
     ../common/D3D10GrabberDefs.hpp \
     AbstractLedDevice.hpp \
@@ -53,6 +53,14 @@ void ConfigureDevicePowerPage::initializePage()
 		device = SupportedDevices::DeviceTypeDnrgb;
 	else if (field(QStringLiteral("isWarls")).toBool())
 		device = SupportedDevices::DeviceTypeWarls;
+	else if (field(QStringLiteral("isDdp")).toBool())
+		device = SupportedDevices::DeviceTypeDdp;
+	else if (field(QStringLiteral("isE131")).toBool())
+		device = SupportedDevices::DeviceTypeE131;
+	else if (field(QStringLiteral("isArtNet")).toBool())
+		device = SupportedDevices::DeviceTypeArtNet;
+	else if (field(QStringLiteral("isAdaptiveUdp")).toBool())
+		device = SupportedDevices::DeviceTypeAdaptiveUdp;
 	else if (field(QStringLiteral("isLightpack")).toBool())
 		device = SupportedDevices::DeviceTypeLightpack;
 	else if (field(QStringLiteral("isAdalight")).toBool())
@@ -78,6 +86,14 @@ bool ConfigureDevicePowerPage::validatePage()
 		device = SupportedDevices::DeviceTypeDnrgb;
 	else if (field(QStringLiteral("isWarls")).toBool())
 		device = SupportedDevices::DeviceTypeWarls;
+	else if (field(QStringLiteral("isDdp")).toBool())
+		device = SupportedDevices::DeviceTypeDdp;
+	else if (field(QStringLiteral("isE131")).toBool())
+		device = SupportedDevices::DeviceTypeE131;
+	else if (field(QStringLiteral("isArtNet")).toBool())
+		device = SupportedDevices::DeviceTypeArtNet;
+	else if (field(QStringLiteral("isAdaptiveUdp")).toBool())
+		device = SupportedDevices::DeviceTypeAdaptiveUdp;
 	else if (field(QStringLiteral("isLightpack")).toBool())
 		device = SupportedDevices::DeviceTypeLightpack;
 	else if (field(QStringLiteral("isAdalight")).toBool())
@@ -32,6 +32,10 @@
 #include "LedDeviceDrgb.hpp"
 #include "LedDeviceDnrgb.hpp"
 #include "LedDeviceWarls.hpp"
+#include "LedDeviceDdp.hpp"
+#include "LedDeviceE131.hpp"
+#include "LedDeviceArtNet.hpp"
+#include "LedDeviceAdaptiveUdp.hpp"
 #include "Wizard.hpp"
 
 using namespace SettingsScope;
@@ -65,6 +69,24 @@ void ConfigureUdpDevicePage::initializePage()
 		currentPort = Settings::getWarlsPort();
 		currentTimeout = Settings::getWarlsTimeout();
 	}
+	else if (field(QStringLiteral("isDdp")).toBool()) {
+		currentAddress = Settings::getDdpAddress();
+		currentPort = Settings::getDdpPort();
+		currentTimeout = Settings::getDdpTimeout();
+	}
+	else if (field(QStringLiteral("isE131")).toBool()) {
+		currentAddress = Settings::getE131Address();
+		currentPort = Settings::getE131Port();
+	}
+	else if (field(QStringLiteral("isArtNet")).toBool()) {
+		currentAddress = Settings::getArtNetAddress();
+		currentPort = Settings::getArtNetPort();
+	}
+	else if (field(QStringLiteral("isAdaptiveUdp")).toBool()) {
+		currentAddress = Settings::getAdaptiveUdpAddress();
+		currentPort = Settings::getAdaptiveUdpPort();
+		currentTimeout = Settings::getAdaptiveUdpTimeout();
+	}
 
 	if (!currentAddress.isEmpty())
 		ui->leAddress->setText(currentAddress);
@@ -100,6 +122,20 @@ bool ConfigureUdpDevicePage::validatePage()
 	else if (field(QStringLiteral("isWarls")).toBool()) {
 		_transSettings->ledDevice.reset(new LedDeviceWarls(address, port, timeout));
 	}
+	else if (field(QStringLiteral("isDdp")).toBool()) {
+		_transSettings->ledDevice.reset(new LedDeviceDdp(address, port, timeout));
+	}
+	// universe, multicast and sync are kept from the settings
+	else if (field(QStringLiteral("isE131")).toBool()) {
+		_transSettings->ledDevice.reset(new LedDeviceE131(address, port, Settings::getE131Universe(),
+			Settings::isE131MulticastEnabled(), Settings::isE131SyncEnabled()));
+	}
+	else if (field(QStringLiteral("isArtNet")).toBool()) {
+		_transSettings->ledDevice.reset(new LedDeviceArtNet(address, port, Settings::getArtNetUniverse(), Settings::isArtNetSyncEnabled()));
+	}
+	else if (field(QStringLiteral("isAdaptiveUdp")).toBool()) {
+		_transSettings->ledDevice.reset(new LedDeviceAdaptiveUdp(address, port, timeout, Settings::getAdaptiveUdpRefreshInterval()));
+	}
 	else {
 		QMessageBox::information(NULL, QStringLiteral("Wrong device"), QStringLiteral("Try to restart the wizard"));
 		qCritical() << "couldn't create LedDevice, unexpected state, device is not selected or device is not configurable";
@@ -151,6 +151,28 @@ bool GlobalColorCoefPage::validatePage()
 		Settings::setWarlsPort(field(QStringLiteral("port")).toString());
 		Settings::setWarlsTimeout(field(QStringLiteral("timeout")).toInt());
 	}
+	else if (deviceName.compare(QStringLiteral("ddp"), Qt::CaseInsensitive) == 0) {
+		devType = SupportedDevices::DeviceTypeDdp;
+		Settings::setDdpAddress(field(QStringLiteral("address")).toString());
+		Settings::setDdpPort(field(QStringLiteral("port")).toString());
+		Settings::setDdpTimeout(field(QStringLiteral("timeout")).toInt());
+	}
+	else if (deviceName.compare(QStringLiteral("e131"), Qt::CaseInsensitive) == 0) {
+		devType = SupportedDevices::DeviceTypeE131;
+		Settings::setE131Address(field(QStringLiteral("address")).toString());
+		Settings::setE131Port(field(QStringLiteral("port")).toString());
+	}
+	else if (deviceName.compare(QStringLiteral("artnet"), Qt::CaseInsensitive) == 0) {
+		devType = SupportedDevices::DeviceTypeArtNet;
+		Settings::setArtNetAddress(field(QStringLiteral("address")).toString());
+		Settings::setArtNetPort(field(QStringLiteral("port")).toString());
+	}
+	else if (deviceName.compare(QStringLiteral("adaptiveudp"), Qt::CaseInsensitive) == 0) {
+		devType = SupportedDevices::DeviceTypeAdaptiveUdp;
+		Settings::setAdaptiveUdpAddress(field(QStringLiteral("address")).toString());
+		Settings::setAdaptiveUdpPort(field(QStringLiteral("port")).toString());
+		Settings::setAdaptiveUdpTimeout(field(QStringLiteral("timeout")).toInt());
+	}
 	else {
 		devType = SupportedDevices::DeviceTypeVirtual;
 	}
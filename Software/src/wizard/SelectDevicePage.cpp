@@ -65,6 +65,18 @@ void SelectDevicePage::initializePage()
     registerField(QStringLiteral("isWarls"), ui->rbWarls);
 	if (deviceType == SupportedDevices::DeviceTypeWarls)
 		ui->rbWarls->setChecked(true);
+    registerField(QStringLiteral("isDdp"), ui->rbDdp);
+	if (deviceType == SupportedDevices::DeviceTypeDdp)
+		ui->rbDdp->setChecked(true);
+    registerField(QStringLiteral("isE131"), ui->rbE131);
+	if (deviceType == SupportedDevices::DeviceTypeE131)
+		ui->rbE131->setChecked(true);
+    registerField(QStringLiteral("isArtNet"), ui->rbArtNet);
+	if (deviceType == SupportedDevices::DeviceTypeArtNet)
+		ui->rbArtNet->setChecked(true);
+    registerField(QStringLiteral("isAdaptiveUdp"), ui->rbAdaptiveUdp);
+	if (deviceType == SupportedDevices::DeviceTypeAdaptiveUdp)
+		ui->rbAdaptiveUdp->setChecked(true);
 }
 
 void SelectDevicePage::cleanupPage()
@@ -75,6 +87,10 @@ void SelectDevicePage::cleanupPage()
     setField(QStringLiteral("isDrgb"), false);
     setField(QStringLiteral("isDnrgb"), false);
     setField(QStringLiteral("isWarls"), false);
+    setField(QStringLiteral("isDdp"), false);
+    setField(QStringLiteral("isE131"), false);
+    setField(QStringLiteral("isArtNet"), false);
+    setField(QStringLiteral("isAdaptiveUdp"), false);
 }
 
 bool SelectDevicePage::validatePage()
@@ -89,7 +105,8 @@ int SelectDevicePage::nextId() const
 {
 	if (ui->rbVirtual->isChecked())
 		return Page_ChooseProfile;
-    else if (ui->rbDrgb->isChecked() || ui->rbDnrgb->isChecked() || ui->rbWarls->isChecked())
+    else if (ui->rbDrgb->isChecked() || ui->rbDnrgb->isChecked() || ui->rbWarls->isChecked() || ui->rbDdp->isChecked()
+             || ui->rbE131->isChecked() || ui->rbArtNet->isChecked() || ui->rbAdaptiveUdp->isChecked())
         return Page_ConfigureUdpDevice;
 	else
 		return Page_ConfigureDevice;
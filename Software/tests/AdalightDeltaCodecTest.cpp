@@ -0,0 +1,190 @@
+/*
+ * AdalightDeltaCodecTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+#include <cstring>
+
+#include "AdalightDeltaCodecTest.hpp"
+#include "AdalightDeltaCodec.hpp"
+
+namespace {
+const int LedsCount = 300;
+
+// mostly static picture with a few LEDs and a solid block changing
+class Scene
+{
+public:
+	Scene() : m_leds(LedsCount * 3, 0), m_seed(1) {}
+
+	const QByteArray & next(int changes)
+	{
+		for (int i = 0; i < changes; ++i) {
+			char *led = m_leds.data() + random() % LedsCount * 3;
+			led[0] = (char)random();
+			led[1] = (char)random();
+			led[2] = (char)random();
+		}
+		const char fill = (char)random();
+		for (int i = 100; i < 140; ++i)
+			memset(m_leds.data() + i * 3, fill, 3);
+		return m_leds;
+	}
+
+	const QByteArray & leds() const { return m_leds; }
+
+private:
+	unsigned random()
+	{
+		m_seed = m_seed * 1103515245 + 12345;
+		return m_seed >> 16;
+	}
+
+	QByteArray m_leds;
+	unsigned m_seed;
+};
+}
+
+void AdalightDeltaCodecTest::testRoundTrip()
+{
+	Scene scene;
+	AdalightDeltaEncoder encoder;
+	AdalightDeltaDecoder decoder;
+
+	for (int frame = 0; frame < 500; ++frame) {
+		const QByteArray &leds = scene.next(frame % 50 == 0 ? LedsCount : frame % 7);
+		const QByteArray wire = encoder.encode(leds.constData(), LedsCount);
+
+		// split like a serial port would
+		const int cut = frame % wire.size();
+		decoder.feed(wire.left(cut));
+		QCOMPARE(decoder.feed(wire.mid(cut)), 1);
+		QCOMPARE(decoder.leds(), leds);
+	}
+	QCOMPARE(decoder.framesRejected(), 0);
+}
+
+void AdalightDeltaCodecTest::testStaticContentIsSmall()
+{
+	Scene scene;
+	AdalightDeltaEncoder encoder;
+
+	const QByteArray key = encoder.encode(scene.next(LedsCount).constData(), LedsCount);
+	QVERIFY(encoder.isLastKeyFrame());
+
+	int bytes = 0;
+	for (int frame = 0; frame < 30; ++frame) {
+		bytes += encoder.encode(scene.next(3).constData(), LedsCount).size();
+		QVERIFY(!encoder.isLastKeyFrame());
+	}
+	// a classic frame is 6 + 900 bytes
+	QVERIFY2(bytes / 30 < (6 + LedsCount * 3) / 10, qPrintable(QString::number(bytes / 30)));
+
+	encoder.setKeyFrameInterval(1);
+	encoder.encode(scene.next(0).constData(), LedsCount);
+	QVERIFY(encoder.isLastKeyFrame());
+}
+
+void AdalightDeltaCodecTest::testCorruptFrameWaitsForKeyFrame()
+{
+	Scene scene;
+	AdalightDeltaEncoder encoder;
+	encoder.setKeyFrameInterval(5);
+	AdalightDeltaDecoder decoder;
+
+	decoder.feed(encoder.encode(scene.next(LedsCount).constData(), LedsCount));
+	QByteArray corrupt = encoder.encode(scene.next(5).constData(), LedsCount);
+	corrupt[corrupt.size() - 1] = corrupt[corrupt.size() - 1] ^ 0x40;
+	QCOMPARE(decoder.feed(corrupt), 0);
+	QVERIFY(decoder.framesRejected() > 0);
+
+	// deltas on top of the lost one are ignored
+	QCOMPARE(decoder.feed(encoder.encode(scene.next(5).constData(), LedsCount)), 0);
+
+	int frames = 0;
+	while (!encoder.isLastKeyFrame())
+		frames += decoder.feed(encoder.encode(scene.next(5).constData(), LedsCount));
+	QCOMPARE(frames, 1);
+	QCOMPARE(decoder.leds(), scene.leds());
+}
+
+void AdalightDeltaCodecTest::testClassicFrame()
+{
+	AdalightDeltaDecoder decoder;
+	const QByteArray leds("\x01\x02\x03\x04\x05\x06", 6);
+	QByteArray frame("Ada");
+	frame.append((char)0).append((char)1).append((char)(0 ^ 1 ^ 0x55));
+
+	QCOMPARE(decoder.feed(QByteArray("noise") + frame + leds), 1);
+	QCOMPARE(decoder.leds(), leds);
+}
+
+void AdalightDeltaCodecTest::testThroughPty()
+{
+#ifdef Q_OS_UNIX
+	const int master = posix_openpt(O_RDWR | O_NOCTTY);
+	QVERIFY(master >= 0);
+	QVERIFY(grantpt(master) == 0 && unlockpt(master) == 0);
+	const int slave = ::open(ptsname(master), O_RDWR | O_NOCTTY);
+	QVERIFY(slave >= 0);
+
+	// what QSerialPort does to the port
+	termios tio;
+	tcgetattr(slave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+
+	Scene scene;
+	AdalightDeltaEncoder encoder;
+	AdalightDeltaDecoder decoder;
+	int bytes = 0;
+	for (int frame = 0; frame < 200; ++frame) {
+		const QByteArray &leds = scene.next(frame % 5);
+		const QByteArray &wire = encoder.encode(leds.constData(), LedsCount);
+		QCOMPARE((int)::write(slave, wire.constData(), wire.size()), wire.size());
+		bytes += wire.size();
+
+		while (decoder.framesDecoded() <= frame) {
+			pollfd fd = { master, POLLIN, 0 };
+			QVERIFY(poll(&fd, 1, 1000) == 1);
+			char buffer[256];
+			const ssize_t received = ::read(master, buffer, sizeof(buffer));
+			QVERIFY(received > 0);
+			decoder.feed(QByteArray(buffer, (int)received));
+		}
+		QCOMPARE(decoder.leds(), leds);
+	}
+	QCOMPARE(decoder.framesRejected(), 0);
+	QVERIFY(bytes < 200 * (6 + LedsCount * 3) / 5);
+
+	::close(slave);
+	::close(master);
+#else
+	QSKIP("needs a pty");
+#endif
+}
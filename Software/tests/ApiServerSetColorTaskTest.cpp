@@ -0,0 +1,290 @@
+/*
+ * ApiServerSetColorTaskTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <climits>
+#include <random>
+#include <QElapsedTimer>
+
+#include "ApiServerSetColorTaskTest.hpp"
+#include "ApiServerSetColorTask.hpp"
+#include "ApiBinaryProtocol.hpp"
+#include "enums.hpp"
+
+namespace {
+const int LedsCount = MaximumNumberOfLeds::AbsoluteMaximum;
+
+QByteArray setColor(int ledsCount)
+{
+	QByteArray buffer;
+	for (int i = 0; i < ledsCount; i++)
+		buffer += QStringLiteral("%1-%2,%3,%4;").arg(i + 1).arg(i % 256).arg(255 - i % 256).arg(i * 7 % 256).toUtf8();
+	return buffer;
+}
+
+// the colors of setColor()
+QList<QRgb> setColorColors(int ledsCount)
+{
+	QList<QRgb> colors;
+	for (int i = 0; i < ledsCount; i++)
+		colors << qRgb(i % 256, 255 - i % 256, i * 7 % 256);
+	return colors;
+}
+
+// what ApiServer does with a setcolor command or a binary SetColors payload
+bool handleSetColors(ApiServerSetColorTask &task, const QByteArray &command, bool isBinary)
+{
+	if (!isBinary) {
+		task.startParseSetColorTask(command);
+		return true;
+	}
+
+	int firstLed = 0;
+	QByteArray rgb;
+	if (!ApiBinaryProtocol::decodeSetColors(command, &firstLed, &rgb))
+		return false;
+	task.startSetColorsTask(firstLed, rgb);
+	return true;
+}
+
+// -1 if \a digits are not a decimal number
+int toNumber(QByteArray digits)
+{
+	if (digits.isEmpty())
+		return -1;
+	for (const char c : digits)
+		if (c < '0' || c > '9')
+			return -1;
+	while (digits.size() > 1 && digits.startsWith('0'))
+		digits.remove(0, 1);
+	return digits.size() > 9 ? INT_MAX : digits.toInt();
+}
+
+// the grammar spelled out with splits, slow but obviously right
+bool isValid(const QByteArray &buffer, int ledsCount)
+{
+	QList<QByteArray> entries = buffer.split(';');
+	if (entries.last().isEmpty())
+		entries.removeLast();
+
+	for (const QByteArray &entry : entries) {
+		const QList<QByteArray> parts = entry.split('-');
+		if (parts.count() != 2 || parts[0].startsWith('0'))
+			return false;
+		const QList<QByteArray> rgb = parts[1].split(',');
+		if (rgb.count() != 3)
+			return false;
+
+		const int led = toNumber(parts[0]);
+		if (led < 1 || led > ledsCount)
+			return false;
+		for (const QByteArray &channel : rgb) {
+			const int value = toNumber(channel);
+			if (value < 0 || value > 255)
+				return false;
+		}
+	}
+	return true;
+}
+}
+
+void ApiServerSetColorTaskTest::testParse_data()
+{
+	QTest::addColumn<QByteArray>("buffer");
+	QTest::addColumn<int>("count");
+	QTest::addColumn<int>("led");
+	QTest::addColumn<uint>("color");
+
+	QTest::newRow("empty") << QByteArray() << 0 << 0 << 0u;
+	QTest::newRow("no semicolon") << QByteArray("1-1,2,3") << 1 << 0 << qRgb(1, 2, 3);
+	QTest::newRow("semicolon") << QByteArray("1-1,2,3;") << 1 << 0 << qRgb(1, 2, 3);
+	QTest::newRow("leading zeros") << QByteArray("2-001,02,255;") << 1 << 1 << qRgb(1, 2, 255);
+	QTest::newRow("4 digits") << QByteArray("1-0,0,0;1500-9,8,7") << 2 << 1499 << qRgb(9, 8, 7);
+	QTest::newRow("same led") << QByteArray("7-1,1,1;7-2,2,2;") << 2 << 6 << qRgb(2, 2, 2);
+}
+
+void ApiServerSetColorTaskTest::testParse()
+{
+	QFETCH(QByteArray, buffer);
+	QFETCH(int, count);
+	QFETCH(int, led);
+	QFETCH(uint, color);
+
+	QVector<ApiServerSetColorTask::LedColor> result;
+	QVERIFY(ApiServerSetColorTask::parseSetColor(buffer, LedsCount, &result));
+	QCOMPARE(result.count(), count);
+	if (count > 0) {
+		QCOMPARE(result.last().led, led);
+		QCOMPARE(result.last().color, (QRgb)color);
+	}
+}
+
+void ApiServerSetColorTaskTest::testParseInvalid_data()
+{
+	QTest::addColumn<QByteArray>("buffer");
+
+	QTest::newRow("led 0") << QByteArray("0-1,1,1;");
+	QTest::newRow("leading zero led") << QByteArray("01-1,1,1;");
+	QTest::newRow("past the last led") << QByteArray("1501-1,1,1;");
+	QTest::newRow("huge led") << QByteArray("99999999999999999999-1,1,1;");
+	QTest::newRow("no led") << QByteArray("-1,1,1;");
+	QTest::newRow("two channels") << QByteArray("1-1,1;");
+	QTest::newRow("four channels") << QByteArray("1-1,1,1,1;");
+	QTest::newRow("empty channel") << QByteArray("1-1,,1;");
+	QTest::newRow("256") << QByteArray("1-1,1,256;");
+	QTest::newRow("huge channel") << QByteArray("1-1,100000000000000000000000,1;");
+	QTest::newRow("empty entry") << QByteArray("1-1,1,1;;2-1,1,1");
+	QTest::newRow("unfinished entry") << QByteArray("1-1,1,1;2-");
+	QTest::newRow("dots") << QByteArray("1-1.1.1");
+	QTest::newRow("space") << QByteArray("1-1, 1,1");
+}
+
+void ApiServerSetColorTaskTest::testParseInvalid()
+{
+	QFETCH(QByteArray, buffer);
+
+	QVector<ApiServerSetColorTask::LedColor> result;
+	QVERIFY(!ApiServerSetColorTask::parseSetColor(buffer, LedsCount, &result));
+}
+
+void ApiServerSetColorTaskTest::testFuzz()
+{
+	std::mt19937 generator(1);
+	const char alphabet[] = "0123456789-,;";
+	const QByteArray valid = setColor(30);
+	QVector<ApiServerSetColorTask::LedColor> result;
+
+	// random strings of the command's own characters
+	for (int i = 0; i < 100000; i++) {
+		QByteArray buffer(generator() % 24, 0);
+		for (char &c : buffer)
+			c = alphabet[generator() % (sizeof(alphabet) - 1)];
+		QVERIFY2(ApiServerSetColorTask::parseSetColor(buffer, 20, &result) == isValid(buffer, 20), buffer.constData());
+	}
+
+	// valid commands with a byte changed, cut or doubled
+	for (int i = 0; i < 20000; i++) {
+		QByteArray buffer = valid;
+		const int at = generator() % buffer.size();
+		switch (generator() % 3) {
+		case 0: buffer[at] = (char)generator(); break;
+		case 1: buffer.truncate(at); break;
+		default: buffer.insert(at, buffer.at(at));
+		}
+		QVERIFY2(ApiServerSetColorTask::parseSetColor(buffer, 30, &result) == isValid(buffer, 30), buffer.constData());
+	}
+}
+
+void ApiServerSetColorTaskTest::testInvalidCommandChangesNothing()
+{
+	ApiServerSetColorTask task;
+	task.setApiDeviceNumberOfLeds(3);
+	QSignalSpy done(&task, &ApiServerSetColorTask::taskParseSetColorDone);
+	QSignalSpy isSuccess(&task, &ApiServerSetColorTask::taskParseSetColorIsSuccess);
+
+	task.startParseSetColorTask("1-1,1,1;3-3,3,3");
+	QCOMPARE(isSuccess.takeLast().first().toBool(), true);
+
+	// the first entry is fine, the second is not
+	task.startParseSetColorTask("1-9,9,9;4-4,4,4");
+	QCOMPARE(isSuccess.takeLast().first().toBool(), false);
+
+	task.startParseSetColorTask("2-2,2,2");
+	QCOMPARE(isSuccess.takeLast().first().toBool(), true);
+
+	QCOMPARE(done.count(), 2);
+	const QList<QRgb> colors = done.last().first().value<QList<QRgb> >();
+	QCOMPARE(colors, QList<QRgb>() << qRgb(1, 1, 1) << qRgb(2, 2, 2) << qRgb(3, 3, 3));
+}
+
+void ApiServerSetColorTaskTest::benchmarkParse_data()
+{
+	QTest::addColumn<int>("ledsCount");
+
+	// time per LED stays the same
+	QTest::newRow("150") << LedsCount / 10;
+	QTest::newRow("1500") << LedsCount;
+}
+
+void ApiServerSetColorTaskTest::benchmarkParse()
+{
+	QFETCH(int, ledsCount);
+
+	const QByteArray buffer = setColor(ledsCount);
+	QVector<ApiServerSetColorTask::LedColor> result;
+
+	QBENCHMARK {
+		QVERIFY(ApiServerSetColorTask::parseSetColor(buffer, LedsCount, &result));
+	}
+	QCOMPARE(result.count(), ledsCount);
+}
+
+void ApiServerSetColorTaskTest::benchmarkSetColorsTask_data()
+{
+	QTest::addColumn<bool>("isBinary");
+
+	// the same 1500 LED frame, the rows give the text to binary ratio of the server side
+	QTest::newRow("text") << false;
+	QTest::newRow("binary") << true;
+}
+
+void ApiServerSetColorTaskTest::benchmarkSetColorsTask()
+{
+	QFETCH(bool, isBinary);
+
+	const QByteArray command = isBinary
+		? ApiBinaryProtocol::encodeColors(setColorColors(LedsCount))
+		: setColor(LedsCount);
+	ApiServerSetColorTask task;
+	task.setApiDeviceNumberOfLeds(LedsCount);
+
+	QBENCHMARK {
+		QVERIFY(handleSetColors(task, command, isBinary));
+	}
+
+	QSignalSpy done(&task, &ApiServerSetColorTask::taskParseSetColorDone);
+	QVERIFY(handleSetColors(task, command, isBinary));
+	QCOMPARE(done.last().first().value<QList<QRgb> >(), setColorColors(LedsCount));
+}
+
+void ApiServerSetColorTaskTest::testBinarySetColorsIsCheaper()
+{
+	const int frames = 200;
+	const QByteArray text = setColor(LedsCount);
+	const QByteArray binary = ApiBinaryProtocol::encodeColors(setColorColors(LedsCount));
+	ApiServerSetColorTask task;
+	task.setApiDeviceNumberOfLeds(LedsCount);
+
+	// compared with each other, so a slow machine slows both down alike
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < frames; i++)
+		QVERIFY(handleSetColors(task, text, false));
+	const qint64 textNs = timer.nsecsElapsed();
+
+	timer.restart();
+	for (int i = 0; i < frames; i++)
+		QVERIFY(handleSetColors(task, binary, true));
+	const qint64 binaryNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+	QVERIFY2(binaryNs * 2 < textNs, qPrintable(QStringLiteral("text/binary: %1").arg(double(textNs) / binaryNs)));
+}
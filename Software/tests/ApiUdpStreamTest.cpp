@@ -0,0 +1,185 @@
+/*
+ * ApiUdpStreamTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QElapsedTimer>
+#include <QUdpSocket>
+#include <QtEndian>
+
+#include "ApiUdpStreamTest.hpp"
+#include "ApiUdpStream.hpp"
+
+namespace {
+const int LedsCount = 3;
+
+QByteArray datagram(quint64 token, quint32 sequence, quint16 firstLed, const QList<QRgb> &colors)
+{
+	QByteArray result(ApiUdpStream::HeaderSize, Qt::Uninitialized);
+	uchar *header = reinterpret_cast<uchar *>(result.data());
+	qToLittleEndian<quint64>(token, header);
+	qToLittleEndian<quint32>(sequence, header + ApiUdpStream::TokenSize);
+	qToLittleEndian<quint16>(firstLed, header + ApiUdpStream::TokenSize + ApiUdpStream::SequenceSize);
+
+	for (const QRgb color : colors)
+		result.append((char)qRed(color)).append((char)qGreen(color)).append((char)qBlue(color));
+	return result;
+}
+
+// stream on a free local port with one session
+class Stream
+{
+public:
+	Stream()
+		: spy(&stream, &ApiUdpStream::colorsReceived)
+	{
+		stream.setNumberOfLeds(LedsCount);
+		isListening = stream.listen(QHostAddress::LocalHost, 0);
+		token = stream.addSession(QStringLiteral("API1"));
+	}
+
+	void send(const QByteArray &data)
+	{
+		sender.writeDatagram(data, QHostAddress::LocalHost, stream.port());
+	}
+
+	// colors of the newest emission once \a count of them have come
+	QList<QRgb> waitColors(int count = 1)
+	{
+		while (spy.count() < count)
+			if (!spy.wait(1000))
+				return QList<QRgb>();
+		return spy.last().at(1).value<QList<QRgb> >();
+	}
+
+	ApiUdpStream stream;
+	QSignalSpy spy;
+	QUdpSocket sender;
+	quint64 token;
+	bool isListening;
+};
+}
+
+void ApiUdpStreamTest::testFrame()
+{
+	Stream s;
+	QVERIFY(s.isListening);
+
+	const QList<QRgb> colors = QList<QRgb>() << qRgb(1, 2, 3) << qRgb(4, 5, 6) << qRgb(7, 8, 9);
+	s.send(datagram(s.token, 1, 0, colors));
+
+	QCOMPARE(s.waitColors(), colors);
+	QCOMPARE(s.spy.last().at(0).toString(), QStringLiteral("API1"));
+	QCOMPARE(s.stream.addSession(QStringLiteral("API1")), s.token);
+	QVERIFY(s.stream.addSession(QStringLiteral("API2")) != s.token);
+}
+
+void ApiUdpStreamTest::testPartialFrame()
+{
+	Stream s;
+	QVERIFY(s.isListening);
+
+	s.send(datagram(s.token, 1, 0, QList<QRgb>() << qRgb(1, 1, 1) << qRgb(2, 2, 2) << qRgb(3, 3, 3)));
+	QVERIFY(!s.waitColors().isEmpty());
+
+	s.send(datagram(s.token, 2, 1, QList<QRgb>() << qRgb(9, 9, 9)));
+	QCOMPARE(s.waitColors(2), QList<QRgb>() << qRgb(1, 1, 1) << qRgb(9, 9, 9) << qRgb(3, 3, 3));
+}
+
+void ApiUdpStreamTest::testDropped_data()
+{
+	QTest::addColumn<QByteArray>("data");
+
+	const QList<QRgb> first = QList<QRgb>() << qRgb(66, 66, 66);
+
+	QTest::newRow("unknown token") << datagram(1, 11, 0, first);
+	QTest::newRow("same sequence") << datagram(0, 10, 0, first);
+	QTest::newRow("older sequence") << datagram(0, 9, 0, first);
+	QTest::newRow("past the end") << datagram(0, 11, 0, first + first + first + first);
+	QTest::newRow("partial led") << datagram(0, 11, 0, first).append((char)1);
+	QTest::newRow("short header") << datagram(0, 11, 0, QList<QRgb>()).left(ApiUdpStream::HeaderSize - 1);
+}
+
+void ApiUdpStreamTest::testDropped()
+{
+	QFETCH(QByteArray, data);
+
+	Stream s;
+	QVERIFY(s.isListening);
+
+	// token 0 in the rows is the session's one
+	if (qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(data.constData())) == 0 && data.size() >= ApiUdpStream::TokenSize)
+		qToLittleEndian<quint64>(s.token, reinterpret_cast<uchar *>(data.data()));
+
+	s.send(datagram(s.token, 10, 0, QList<QRgb>() << qRgb(1, 1, 1)));
+	QVERIFY(!s.waitColors().isEmpty());
+
+	// the dropped datagram, then a good one behind it
+	s.send(data);
+	s.send(datagram(s.token, 12, 2, QList<QRgb>() << qRgb(2, 2, 2)));
+
+	QCOMPARE(s.waitColors(2), QList<QRgb>() << qRgb(1, 1, 1) << 0 << qRgb(2, 2, 2));
+	QCOMPARE(s.stream.datagramsDropped(), (quint64)1);
+}
+
+void ApiUdpStreamTest::testSequenceWraps()
+{
+	Stream s;
+	QVERIFY(s.isListening);
+
+	s.send(datagram(s.token, 0xfffffffe, 0, QList<QRgb>() << qRgb(1, 1, 1)));
+	QVERIFY(!s.waitColors().isEmpty());
+
+	s.send(datagram(s.token, 1, 0, QList<QRgb>() << qRgb(2, 2, 2)));
+	QCOMPARE(s.waitColors(2).first(), qRgb(2, 2, 2));
+}
+
+void ApiUdpStreamTest::testNewestWins()
+{
+	Stream s;
+	QVERIFY(s.isListening);
+
+	for (quint32 sequence = 1; sequence <= 50; sequence++)
+		s.send(datagram(s.token, sequence, 0, QList<QRgb>() << qRgb(sequence, 0, 0)));
+
+	// datagrams waiting together come out as one frame
+	QElapsedTimer timer;
+	timer.start();
+	while (s.waitColors(s.spy.count() + 1).value(0) != qRgb(50, 0, 0) && timer.elapsed() < 1000)
+		;
+
+	QVERIFY(!s.spy.isEmpty());
+	QCOMPARE(s.spy.last().at(1).value<QList<QRgb> >().first(), qRgb(50, 0, 0));
+	QVERIFY(s.spy.count() < 50);
+	QCOMPARE(s.stream.datagramsDropped(), (quint64)0);
+}
+
+void ApiUdpStreamTest::testRemovedSession()
+{
+	Stream s;
+	QVERIFY(s.isListening);
+
+	s.stream.removeSession(QStringLiteral("API1"));
+	s.send(datagram(s.token, 1, 0, QList<QRgb>() << qRgb(1, 1, 1)));
+
+	QVERIFY(!s.spy.wait(200));
+	QCOMPARE(s.stream.datagramsDropped(), (quint64)1);
+}
@@ -0,0 +1,139 @@
+/*
+ * FrameMailboxTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "FrameMailboxTest.hpp"
+#include "FrameMailbox.hpp"
+
+namespace {
+QList<QRgb> frame(int count, QRgb color)
+{
+	QList<QRgb> result;
+	for (int i = 0; i < count; ++i)
+		result << color;
+	return result;
+}
+
+class Producer : public QThread
+{
+public:
+	Producer(FrameMailbox *mailbox, int frames) : m_mailbox(mailbox), m_frames(frames) {}
+
+protected:
+	void run() override
+	{
+		QList<QRgb> colors = frame(100, 0);
+		for (int n = 1; n <= m_frames; ++n) {
+			for (int i = 0; i < colors.size(); ++i)
+				colors[i] = n;
+			m_mailbox->post(colors);
+		}
+	}
+
+private:
+	FrameMailbox *m_mailbox;
+	int m_frames;
+};
+}
+
+void FrameMailboxTest::testLatestWins()
+{
+	FrameMailbox mailbox(10);
+	QList<QRgb> colors;
+
+	QVERIFY(!mailbox.take(colors));
+
+	mailbox.post(frame(10, 1));
+	mailbox.post(frame(10, 2));
+	mailbox.post(frame(10, 3));
+	QVERIFY(mailbox.take(colors));
+	QCOMPARE(colors, frame(10, 3));
+	QVERIFY(!mailbox.take(colors));
+
+	// larger than the capacity still works
+	mailbox.post(frame(20, 4));
+	QVERIFY(mailbox.take(colors));
+	QCOMPARE(colors, frame(20, 4));
+}
+
+void FrameMailboxTest::testSingleWakeup()
+{
+	FrameMailbox mailbox(10);
+	QList<QRgb> colors;
+
+	QVERIFY(mailbox.post(frame(10, 1)));
+	QVERIFY(!mailbox.post(frame(10, 2)));
+	QVERIFY(mailbox.take(colors));
+	QVERIFY(mailbox.post(frame(10, 3)));
+}
+
+void FrameMailboxTest::testKeptFrameKeepsBuffers()
+{
+	FrameMailbox mailbox(10);
+	QList<QRgb> colors;
+	QList<QRgb> saved;
+
+	mailbox.post(frame(10, 1));
+	QVERIFY(mailbox.take(colors));
+	FrameMailbox::copyFrame(colors, saved);
+	const QRgb *colorsData = &colors.at(0);
+	const QRgb *savedData = &saved.at(0);
+	QVERIFY(colorsData != savedData);
+
+	// the consumer keeps the frame between takes, like LedDeviceManager::sendColors()
+	for (QRgb n = 2; n < 5; ++n) {
+		mailbox.post(frame(10, n));
+		QVERIFY(mailbox.take(colors));
+		FrameMailbox::copyFrame(colors, saved);
+		QCOMPARE(&colors.at(0), colorsData);
+		QCOMPARE(&saved.at(0), savedData);
+		QCOMPARE(saved, frame(10, n));
+	}
+}
+
+void FrameMailboxTest::testConcurrentFramesAreWhole()
+{
+	const int frames = 200000;
+	FrameMailbox mailbox(100);
+	Producer producer(&mailbox, frames);
+
+	QList<QRgb> colors;
+	QRgb last = 0;
+	QElapsedTimer timer;
+	timer.start();
+	producer.start();
+	while (last != (QRgb)frames && timer.elapsed() < 10000) {
+		if (!mailbox.take(colors)) {
+			QThread::yieldCurrentThread();
+			continue;
+		}
+		QCOMPARE(colors.size(), 100);
+		// never torn, never older than what was seen before
+		QCOMPARE(colors.last(), colors.first());
+		QVERIFY(colors.first() > last);
+		last = colors.first();
+	}
+	QVERIFY(producer.wait(10000));
+	QCOMPARE(last, (QRgb)frames);
+}
@@ -0,0 +1,293 @@
+/*
+ * FrameRecordingTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "FrameRecordingTest.hpp"
+#include "FrameRecording.hpp"
+#include "FrameReplayer.hpp"
+#include "LedDeviceRecorder.hpp"
+
+namespace {
+QList<QRgb> frame(int count, int seed)
+{
+	QList<QRgb> colors;
+	for (int i = 0; i < count; ++i)
+		colors << qRgb((seed + i) & 0xff, (seed * 3 + i) & 0xff, (seed * 7 + i) & 0xff);
+	return colors;
+}
+
+QList<QRgb> black(int count)
+{
+	QList<QRgb> colors;
+	for (int i = 0; i < count; ++i)
+		colors << qRgb(0, 0, 0);
+	return colors;
+}
+
+QByteArray record(const QList<QPair<qint64, QList<QRgb> > > &frames)
+{
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	FrameRecordingWriter writer;
+	writer.start(&buffer);
+	for (const auto &timedFrame : frames) {
+		if (timedFrame.second.isEmpty())
+			writer.writeOff(timedFrame.first);
+		else
+			writer.writeFrame(timedFrame.first, timedFrame.second);
+	}
+	writer.flush();
+	return buffer.data();
+}
+}
+
+void FrameRecordingTest::testRoundTrip()
+{
+	QList<QPair<qint64, QList<QRgb> > > frames;
+	frames << qMakePair(qint64(0), frame(10, 1))
+		<< qMakePair(qint64(8333), frame(10, 2))
+		<< qMakePair(qint64(16666), frame(10, 2))
+		// switched off, then a frame with another LED count
+		<< qMakePair(qint64(20000), QList<QRgb>())
+		<< qMakePair(qint64(1000000), frame(300, 3))
+		<< qMakePair(qint64(1008333), black(300));
+
+	FrameRecordingReader reader(record(frames));
+	QVERIFY(reader.isValid());
+
+	for (int pass = 0; pass < 2; ++pass) {
+		FrameRecordingReader::Record result;
+		for (const auto &timedFrame : frames) {
+			QVERIFY(reader.readNext(result));
+			QCOMPARE(result.timeUs, timedFrame.first);
+			if (timedFrame.second.isEmpty()) {
+				QCOMPARE(result.type, FrameRecording::RecordOff);
+			} else {
+				QCOMPARE(result.type, FrameRecording::RecordFrame);
+				QCOMPARE(result.colors, timedFrame.second);
+			}
+		}
+		QVERIFY(!reader.readNext(result));
+		QVERIFY(!reader.hasError());
+		reader.rewind();
+	}
+}
+
+void FrameRecordingTest::testOnlyChangesAreStored()
+{
+	const int ledsCount = 1500;
+	const QList<QRgb> first = frame(ledsCount, 1);
+	QList<QRgb> second = first;
+	for (int i = 0; i < ledsCount; i += 100)
+		second[i] = qRgb(1, 2, 3);
+
+	QList<QPair<qint64, QList<QRgb> > > frames;
+	frames << qMakePair(qint64(0), first);
+	const int keyFrameSize = record(frames).size();
+	frames << qMakePair(qint64(8333), second);
+	const int deltaSize = record(frames).size() - keyFrameSize;
+	frames << qMakePair(qint64(16666), second);
+	const int repeatSize = record(frames).size() - keyFrameSize - deltaSize;
+
+	QVERIFY(keyFrameSize <= FrameRecording::HeaderSize + 10 + ledsCount * 3);
+	// 15 changed LEDs in 15 runs
+	QVERIFY(deltaSize <= 8 + 15 * (3 + 3));
+	// type, time, count and one run
+	QVERIFY(repeatSize <= 8);
+
+	// the alpha channel isn't part of a color
+	QList<QRgb> transparent = second;
+	for (QRgb &color : transparent)
+		color &= 0x00ffffff;
+	const int beforeAlpha = record(frames).size();
+	frames << qMakePair(qint64(25000), transparent);
+	QVERIFY(record(frames).size() - beforeAlpha <= 8);
+}
+
+void FrameRecordingTest::testDamagedRecording()
+{
+	QList<QPair<qint64, QList<QRgb> > > frames;
+	frames << qMakePair(qint64(0), frame(50, 1)) << qMakePair(qint64(1000), frame(50, 2));
+	const QByteArray data = record(frames);
+
+	QVERIFY(!FrameRecordingReader(QByteArray("nothing to see here")).isValid());
+	QVERIFY(!FrameRecordingReader(data.left(FrameRecording::HeaderSize - 1)).isValid());
+
+	// the first frame survives, the cut one is reported
+	FrameRecordingReader reader(data.left(data.size() - 10));
+	FrameRecordingReader::Record result;
+	QVERIFY(reader.readNext(result));
+	QCOMPARE(result.colors, frame(50, 1));
+	QVERIFY(!reader.readNext(result));
+	QVERIFY(reader.hasError());
+
+	QByteArray unknownType = data;
+	unknownType[FrameRecording::HeaderSize] = 0x7f;
+	FrameRecordingReader unknownReader(unknownType);
+	QVERIFY(!unknownReader.readNext(result));
+	QVERIFY(unknownReader.hasError());
+}
+
+void FrameRecordingTest::testRecorderDevice()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString path = dir.filePath(QStringLiteral("frames.prec"));
+
+	LedDeviceRecorder recorder(path);
+	QSignalSpy opened(&recorder, &AbstractLedDevice::openDeviceSuccess);
+	QSignalSpy completed(&recorder, &AbstractLedDevice::commandCompleted);
+	recorder.open();
+	QCOMPARE(opened.count(), 1);
+	QCOMPARE(opened[0][0].toBool(), true);
+
+	recorder.setColors(frame(20, 1));
+	recorder.setColors(frame(20, 2));
+	recorder.switchOffLeds();
+	// colors are recorded before any color modification
+	recorder.setGamma(3.0, false);
+	recorder.setBrightness(10, false);
+	recorder.setColors(frame(20, 3));
+	recorder.close();
+	QCOMPARE(recorder.framesCount(), 3);
+	QCOMPARE(completed.count(), 4);
+
+	FrameReplayer replayer;
+	QVERIFY(replayer.load(path));
+
+	QFile file(path);
+	QVERIFY(file.open(QIODevice::ReadOnly));
+	FrameRecordingReader reader(file.readAll());
+	FrameRecordingReader::Record result;
+	QList<FrameRecording::RecordType> types;
+	QList<QList<QRgb> > colors;
+	qint64 timeUs = -1;
+	while (reader.readNext(result)) {
+		QVERIFY(result.timeUs >= timeUs);
+		timeUs = result.timeUs;
+		types << result.type;
+		if (result.type == FrameRecording::RecordFrame)
+			colors << result.colors;
+	}
+	QVERIFY(!reader.hasError());
+	QCOMPARE(types, QList<FrameRecording::RecordType>() << FrameRecording::RecordFrame << FrameRecording::RecordFrame
+		<< FrameRecording::RecordOff << FrameRecording::RecordFrame);
+	QCOMPARE(colors, QList<QList<QRgb> >() << frame(20, 1) << frame(20, 2) << frame(20, 3));
+}
+
+void FrameRecordingTest::benchmarkRecorder()
+{
+	// one second of every LED changing at 120 Hz, has to take well below a second
+	const int ledsCount = 1500;
+	QList<QList<QRgb> > frames;
+	for (int i = 0; i < 120; ++i)
+		frames << frame(ledsCount, i);
+
+	FrameRecordingWriter writer;
+	QBENCHMARK {
+		QBuffer buffer;
+		buffer.open(QIODevice::WriteOnly);
+		writer.start(&buffer);
+		for (int i = 0; i < frames.count(); ++i)
+			QVERIFY(writer.writeFrame(i * 8333, frames[i]));
+		QVERIFY(writer.flush());
+	}
+	QCOMPARE(writer.framesCount(), 120);
+}
+
+void FrameRecordingTest::testReplayCadence()
+{
+	QList<QPair<qint64, QList<QRgb> > > frames;
+	frames << qMakePair(qint64(0), frame(5, 1))
+		<< qMakePair(qint64(40000), frame(5, 2))
+		<< qMakePair(qint64(60000), QList<QRgb>())
+		<< qMakePair(qint64(80000), frame(5, 3));
+
+	FrameReplayer replayer;
+	QVERIFY(replayer.setRecording(record(frames)));
+	QVERIFY(!replayer.setRecording(QByteArray("PREC")));
+	QVERIFY(replayer.setRecording(record(frames)));
+	replayer.setSpeed(2.0);
+
+	QList<QList<QRgb> > received;
+	QList<qint64> receivedAtMs;
+	QStringList events;
+	QElapsedTimer clock;
+	connect(&replayer, &FrameReplayer::frameReady, this, [&](const QList<QRgb> &colors) {
+		received << colors;
+		receivedAtMs << clock.elapsed();
+		events << QStringLiteral("frame");
+	});
+	connect(&replayer, &FrameReplayer::ledsSwitchedOff, this, [&]() { events << QStringLiteral("off"); });
+	connect(&replayer, &FrameReplayer::ledsSwitchedOn, this, [&]() { events << QStringLiteral("on"); });
+	QSignalSpy finished(&replayer, &FrameReplayer::finished);
+
+	clock.start();
+	replayer.start();
+	QVERIFY(replayer.isRunning());
+	QVERIFY(finished.wait(2000));
+	QVERIFY(!replayer.isRunning());
+
+	QCOMPARE(events, QStringList() << "frame" << "frame" << "off" << "on" << "frame");
+	QCOMPARE(received, QList<QList<QRgb> >() << frame(5, 1) << frame(5, 2) << frame(5, 3));
+	QCOMPARE(replayer.recordsCount(), 4);
+	// twice as fast: 20 ms and 40 ms after the start
+	QVERIFY(receivedAtMs[1] >= 19);
+	QVERIFY(receivedAtMs[2] >= 39);
+	QVERIFY(receivedAtMs[2] < 500);
+}
+
+void FrameRecordingTest::testReplayAsFastAsPossible()
+{
+	QList<QPair<qint64, QList<QRgb> > > frames;
+	for (int i = 0; i < 100; ++i)
+		frames << qMakePair(qint64(i) * 1000000, frame(50, i));
+
+	FrameReplayer replayer;
+	QVERIFY(replayer.setRecording(record(frames)));
+	replayer.setSpeed(0);
+
+	int count = 0;
+	const QMetaObject::Connection counting = connect(&replayer, &FrameReplayer::frameReady, this, [&](const QList<QRgb> &colors) {
+		QCOMPARE(colors, frames[count].second);
+		++count;
+	});
+	QSignalSpy finished(&replayer, &FrameReplayer::finished);
+
+	// 100 seconds of recording
+	replayer.start();
+	QVERIFY(finished.wait(2000));
+	QCOMPARE(count, 100);
+
+	// stopping from a slot ends the replay
+	disconnect(counting);
+	connect(&replayer, &FrameReplayer::frameReady, &replayer, &FrameReplayer::stop);
+	replayer.start();
+	QTest::qWait(50);
+	QVERIFY(!replayer.isRunning());
+	QCOMPARE(replayer.recordsCount(), 1);
+}
@@ -1,4 +1,5 @@
 #include "GrabCalculationTest.hpp"
+#include "ZoneResampler.hpp"
 
 void GrabCalculationTest::testCase1()
 {
@@ -7,3 +8,150 @@ void GrabCalculationTest::testCase1()
 	QRgb result = Grab::Calculations::calculateAvgColor(buf, BufferFormatArgb, 16, QRect(0,0,4,1));
 	QVERIFY2(result == QColor(0xfa, 0xfa, 0xfa).rgb(), qPrintable(QString("Failure. calculateAvgColor returned wrong errorcode %1").arg(result, 1, 16)));
 }
+
+void GrabCalculationTest::testScaleByMaxChannel()
+{
+	// over-brighten by 50%, saturating the brightest channel at 255
+	const double factor = 1.5;
+	uint32_t lut[256];
+	Grab::Calculations::buildScaleByMaxChannelLut(factor, lut);
+
+	// odd count to cover the non-SIMD tail
+	const int count = 37;
+	uint32_t r[count], g[count], b[count];
+	for (int i = 0; i < count; ++i) {
+		r[i] = (i * 7) % 256;
+		g[i] = (i * 13) % 256;
+		b[i] = (i * 29) % 256;
+	}
+	uint32_t r0[count], g0[count], b0[count];
+	memcpy(r0, r, sizeof(r));
+	memcpy(g0, g, sizeof(g));
+	memcpy(b0, b, sizeof(b));
+
+	Grab::Calculations::scaleByMaxChannel(r, g, b, count, lut);
+
+	for (int i = 0; i < count; ++i) {
+		const uint32_t highest = qMax(r0[i], qMax(g0[i], b0[i]));
+		const double scale = qMin(factor, 255.0 / highest);
+		QVERIFY(r[i] <= 255 && g[i] <= 255 && b[i] <= 255);
+		QVERIFY(qAbs((int)(r0[i] * scale) - (int)r[i]) <= 1);
+		QVERIFY(qAbs((int)(g0[i] * scale) - (int)g[i]) <= 1);
+		QVERIFY(qAbs((int)(b0[i] * scale) - (int)b[i]) <= 1);
+	}
+}
+
+void GrabCalculationTest::testScaleByMaxChannelReaches255()
+{
+	// every brightest channel that over-brightening saturates ends at 255, not 254
+	const double factors[] = { 1.05, 1.5, 6.0 };
+	for (const double factor : factors) {
+		uint32_t lut[256];
+		Grab::Calculations::buildScaleByMaxChannelLut(factor, lut);
+
+		const int count = 256;
+		uint32_t r[count], g[count], b[count];
+		for (int i = 0; i < count; ++i) {
+			r[i] = i;
+			g[i] = i / 2;
+			b[i] = 0;
+		}
+		Grab::Calculations::scaleByMaxChannel(r, g, b, count, lut);
+
+		for (int i = 1; i < count; ++i) {
+			if (i * factor >= 255.0)
+				QCOMPARE(r[i], (uint32_t)255);
+			else
+				QVERIFY(r[i] < 255);
+			QVERIFY(g[i] <= r[i]);
+		}
+	}
+}
+
+void GrabCalculationTest::testMaskedAvgColor()
+{
+	const int count = 11;
+	uint32_t r[count], g[count], b[count], mask[count];
+	for (int i = 0; i < count; ++i) {
+		const bool isEnabled = i % 2 == 0;
+		r[i] = isEnabled ? 200 : 10;
+		g[i] = isEnabled ? 100 : 10;
+		b[i] = isEnabled ? 50 : 10;
+		mask[i] = isEnabled ? 0xffffffffU : 0;
+	}
+	QCOMPARE(Grab::Calculations::calculateMaskedAvgColor(r, g, b, mask, count), qRgb(200, 100, 50));
+
+	memset(mask, 0, sizeof(mask));
+	QCOMPARE(Grab::Calculations::calculateMaskedAvgColor(r, g, b, mask, count), qRgb(0, 0, 0));
+}
+
+void GrabCalculationTest::testZoneResamplerSegments()
+{
+	const QList<Grab::ZoneResampler::Segment> segments = Grab::ZoneResampler::parseSegments(QStringLiteral("64:300, 36:170r"));
+	QCOMPARE(segments.size(), 2);
+	QCOMPARE(segments[0].zones, 64);
+	QCOMPARE(segments[0].leds, 300);
+	QVERIFY(!segments[0].isReversed);
+	QCOMPARE(segments[1].zones, 36);
+	QCOMPARE(segments[1].leds, 170);
+	QVERIFY(segments[1].isReversed);
+
+	QVERIFY(Grab::ZoneResampler::parseSegments(QStringLiteral("64:x")).isEmpty());
+	QVERIFY(Grab::ZoneResampler::parseSegments(QString()).isEmpty());
+}
+
+void GrabCalculationTest::testZoneResamplerLinear()
+{
+	// 2 zones stretched over 4 LEDs, 3 zones copied onto 3 reversed LEDs
+	Grab::ZoneResampler resampler;
+	resampler.configure(Grab::ZoneResampler::parseSegments(QStringLiteral("2:4,3:3r")), Grab::ZoneResampler::InterpolationLinear);
+	QCOMPARE(resampler.zoneCount(), 5);
+	QCOMPARE(resampler.ledCount(), 7);
+
+	const QList<QRgb> zones = QList<QRgb>()
+		<< qRgb(0, 0, 0) << qRgb(255, 255, 255)
+		<< qRgb(10, 0, 0) << qRgb(20, 0, 0) << qRgb(30, 0, 0);
+	QList<QRgb> leds;
+	QVERIFY(resampler.resample(zones, leds));
+
+	const QList<int> expected = QList<int>() << 0 << 64 << 191 << 255 << 30 << 20 << 10;
+	QCOMPARE(leds.size(), expected.size());
+	for (int i = 0; i < leds.size(); ++i)
+		QCOMPARE(qRed(leds[i]), expected[i]);
+
+	// not enough zones
+	QVERIFY(!resampler.resample(zones.mid(0, 3), leds));
+}
+
+void GrabCalculationTest::testZoneResamplerFlatColor()
+{
+	Grab::ZoneResampler resampler;
+	resampler.configure(Grab::ZoneResampler::parseSegments(QStringLiteral("64:1500")), Grab::ZoneResampler::InterpolationCubic);
+
+	QList<QRgb> zones;
+	for (int i = 0; i < 64; ++i)
+		zones << qRgb(77, 128, 200);
+	QList<QRgb> leds;
+	QVERIFY(resampler.resample(zones, leds));
+	QCOMPARE(leds.size(), 1500);
+	for (int i = 0; i < leds.size(); ++i)
+		QCOMPARE(leds[i], qRgb(77, 128, 200));
+}
+
+void GrabCalculationTest::testZoneResamplerValues()
+{
+	// per-zone settings (white balance) line up with the resampled colors
+	Grab::ZoneResampler resampler;
+	resampler.configure(Grab::ZoneResampler::parseSegments(QStringLiteral("2:4,3:3r")), Grab::ZoneResampler::InterpolationLinear);
+
+	const QVector<double> zones = QVector<double>() << 0.0 << 1.0 << 0.1 << 0.2 << 0.3;
+	QVector<double> leds;
+	QVERIFY(resampler.resample(zones, leds));
+
+	const QVector<double> expected = QVector<double>() << 0.0 << 0.25 << 0.75 << 1.0 << 0.3 << 0.2 << 0.1;
+	QCOMPARE(leds.size(), expected.size());
+	for (int i = 0; i < leds.size(); ++i)
+		QVERIFY(qAbs(leds[i] - expected[i]) < 1e-3);
+
+	QVERIFY(!resampler.resample(zones.mid(0, 3), leds));
+}
@@ -40,5 +40,12 @@ public:
 	
 private Q_SLOTS:
 	void testCase1();
+	void testScaleByMaxChannel();
+	void testScaleByMaxChannelReaches255();
+	void testMaskedAvgColor();
+	void testZoneResamplerSegments();
+	void testZoneResamplerLinear();
+	void testZoneResamplerFlatColor();
+	void testZoneResamplerValues();
 };
 
@@ -0,0 +1,92 @@
+/*
+ * GrabRateGovernorTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GrabRateGovernorTest.hpp"
+#include "GrabRateGovernor.hpp"
+
+namespace {
+QList<QRgb> frame(int count, QRgb color)
+{
+	QList<QRgb> result;
+	for (int i = 0; i < count; ++i)
+		result << color;
+	return result;
+}
+}
+
+void GrabRateGovernorTest::testDisabledKeepsBaseInterval()
+{
+	GrabRateGovernor governor;
+	governor.setBaseInterval(50);
+	governor.setEnabled(false);
+
+	QCOMPARE(governor.update(frame(10, qRgb(0, 0, 0)), frame(10, qRgb(255, 255, 255)), 1000), 50);
+	QCOMPARE(governor.interval(), 50);
+}
+
+void GrabRateGovernorTest::testMotionRaisesRate()
+{
+	GrabRateGovernor governor;
+	governor.setBaseInterval(50);
+	governor.setFastestInterval(16);
+	governor.setIdleInterval(200);
+	governor.setCpuBudget(100);
+	governor.setEnabled(true);
+
+	QCOMPARE(governor.update(frame(10, qRgb(0, 0, 0)), frame(10, qRgb(200, 0, 0)), 1000), 16);
+	QCOMPARE(governor.lastMotion(), 200);
+}
+
+void GrabRateGovernorTest::testStaticDropsToIdle()
+{
+	GrabRateGovernor governor;
+	governor.setBaseInterval(50);
+	governor.setFastestInterval(16);
+	governor.setIdleInterval(200);
+	governor.setCpuBudget(100);
+	governor.setEnabled(true);
+
+	const QList<QRgb> still = frame(10, qRgb(10, 20, 30));
+	int interval = governor.interval();
+	for (int i = 0; i < 100; ++i) {
+		const int next = governor.update(still, still, 1000);
+		QVERIFY(next >= interval);
+		interval = next;
+	}
+	QCOMPARE(interval, 200);
+
+	// motion brings the rate back up immediately
+	QCOMPARE(governor.update(still, frame(10, qRgb(255, 255, 255)), 1000), 16);
+}
+
+void GrabRateGovernorTest::testCpuBudget()
+{
+	GrabRateGovernor governor;
+	governor.setBaseInterval(50);
+	governor.setFastestInterval(5);
+	governor.setIdleInterval(200);
+	governor.setCpuBudget(10);
+	governor.setEnabled(true);
+
+	// 4ms per frame at 10% budget can't go faster than 40ms
+	QCOMPARE(governor.update(frame(10, qRgb(0, 0, 0)), frame(10, qRgb(255, 255, 255)), 4000000), 40);
+}
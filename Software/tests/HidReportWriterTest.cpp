@@ -0,0 +1,222 @@
+/*
+ * HidReportWriterTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QThread>
+#include <atomic>
+
+#include "HidReportWriterTest.hpp"
+#include "HidReportWriter.hpp"
+
+namespace {
+// stands in for hidapi: every write takes one USB transaction
+class MockHidBackend : public HidReportWriter::Backend
+{
+public:
+	explicit MockHidBackend(int devices, unsigned long latencyUs = 0)
+		: m_latencyUs(latencyUs)
+		, m_reports(devices)
+		, m_writes(devices, 0)
+		, m_failures(devices, 0)
+	{
+	}
+
+	static hid_device * device(int index) { return reinterpret_cast<hid_device *>(quintptr(index + 1)); }
+
+	int write(hid_device *device, const unsigned char *data, size_t length) override
+	{
+		const int index = int(reinterpret_cast<quintptr>(device)) - 1;
+		const int busy = ++m_busy;
+		int maxBusy = m_maxBusy;
+		while (busy > maxBusy && !m_maxBusy.compare_exchange_weak(maxBusy, busy)) {}
+
+		if (m_latencyUs > 0)
+			QThread::usleep(m_latencyUs);
+
+		// each device is only written from one thread at a time
+		int result = (int)length;
+		if (m_failures[index] > 0) {
+			--m_failures[index];
+			result = -1;
+		} else {
+			m_reports[index] = QByteArray(reinterpret_cast<const char *>(data), (int)length);
+			++m_writes[index];
+		}
+		--m_busy;
+		return result;
+	}
+
+	// the next \a count writes to \a index fail
+	void fail(int index, int count) { m_failures[index] = count; }
+	const QByteArray & report(int index) const { return m_reports[index]; }
+	int writes(int index) const { return m_writes[index]; }
+	int maxConcurrentWrites() const { return m_maxBusy; }
+
+private:
+	const unsigned long m_latencyUs;
+	QVector<QByteArray> m_reports;
+	QVector<int> m_writes;
+	QVector<int> m_failures;
+	std::atomic<int> m_busy{0};
+	std::atomic<int> m_maxBusy{0};
+};
+
+QList<hid_device*> devices(int count)
+{
+	QList<hid_device*> result;
+	for (int i = 0; i < count; ++i)
+		result << MockHidBackend::device(i);
+	return result;
+}
+
+void fillReports(HidReportWriter &writer, int frame)
+{
+	for (int i = 0; i < writer.count(); ++i)
+		memset(writer.report(i), (frame * 16 + i) & 0xff, HidReportWriter::ReportSize);
+}
+}
+
+void HidReportWriterTest::testReportsReachTheirDevices()
+{
+	MockHidBackend backend(4);
+	HidReportWriter writer(backend);
+	writer.setDevices(devices(4));
+
+	for (int frame = 0; frame < 100; ++frame) {
+		fillReports(writer, frame);
+		QVERIFY(writer.writeReports(4));
+		for (int i = 0; i < 4; ++i) {
+			QVERIFY(writer.isWritten(i));
+			QCOMPARE(backend.report(i), QByteArray(HidReportWriter::ReportSize, (char)((frame * 16 + i) & 0xff)));
+		}
+	}
+	for (int i = 0; i < 4; ++i)
+		QCOMPARE(backend.writes(i), 100);
+}
+
+void HidReportWriterTest::testFewerReportsThanDevices()
+{
+	MockHidBackend backend(4);
+	HidReportWriter writer(backend);
+	writer.setDevices(devices(4));
+
+	fillReports(writer, 1);
+	QVERIFY(writer.writeReports(2));
+	QCOMPARE(backend.writes(0), 1);
+	QCOMPARE(backend.writes(1), 1);
+	QCOMPARE(backend.writes(2), 0);
+	QCOMPARE(backend.writes(3), 0);
+
+	// the workers that sat out still take the next frame
+	QVERIFY(writer.writeReports(4));
+	QCOMPARE(backend.writes(3), 1);
+}
+
+void HidReportWriterTest::testRetryAndFailure()
+{
+	MockHidBackend backend(4);
+	HidReportWriter writer(backend);
+	writer.setDevices(devices(4));
+
+	// one error is retried, two are not
+	backend.fail(1, 1);
+	backend.fail(3, 2);
+	fillReports(writer, 2);
+	QVERIFY(!writer.writeReports(4));
+	QVERIFY(writer.isWritten(0));
+	QVERIFY(writer.isWritten(1));
+	QVERIFY(writer.isWritten(2));
+	QVERIFY(!writer.isWritten(3));
+	QCOMPARE(backend.writes(1), 1);
+	QCOMPARE(backend.writes(3), 0);
+
+	QVERIFY(writer.writeReports(4));
+	QVERIFY(writer.isWritten(3));
+}
+
+void HidReportWriterTest::testChangingDevices()
+{
+	MockHidBackend backend(4);
+	HidReportWriter writer(backend);
+
+	for (const int count : { 4, 1, 0, 3, 4 }) {
+		writer.setDevices(devices(count));
+		QCOMPARE(writer.count(), count);
+		fillReports(writer, count);
+		QVERIFY(writer.writeReports(count));
+		for (int i = 0; i < count; ++i)
+			QCOMPARE(backend.report(i), QByteArray(HidReportWriter::ReportSize, (char)((count * 16 + i) & 0xff)));
+	}
+	writer.setDevices(QList<hid_device*>());
+}
+
+void HidReportWriterTest::testFrameTakesOneTransaction()
+{
+	const int units = 4;
+	const int frames = 50;
+	const unsigned long latencyUs = 2000;
+
+	MockHidBackend backend(units, latencyUs);
+	HidReportWriter writer(backend);
+	writer.setDevices(devices(units));
+
+	for (int frame = 0; frame < frames; ++frame) {
+		fillReports(writer, frame);
+		QVERIFY(writer.writeReports(units));
+	}
+
+	// the writes of all units overlap instead of taking units * latency per frame
+	QCOMPARE(backend.maxConcurrentWrites(), units);
+	for (int i = 0; i < units; ++i)
+		QCOMPARE(backend.writes(i), frames);
+}
+
+void HidReportWriterTest::testEncodeColors()
+{
+	// LED 1 is the 5th slot of a report, LED 11 the 1st of the second one
+	QList<StructRgb> colors;
+	for (int i = 0; i < 11; i++)
+		colors << StructRgb();
+	colors[0].r = 0xabc;
+	colors[0].g = 0x123;
+	colors[0].b = 0xfff;
+	colors[10].r = 0x010;
+
+	QByteArray reports(HidReportWriter::reportsCount(colors.count()) * HidReportWriter::ReportSize, (char)0x55);
+	QCOMPARE(reports.size(), 2 * HidReportWriter::ReportSize);
+	HidReportWriter::encodeColors(colors, reinterpret_cast<unsigned char *>(reports.data()));
+
+	const int first = HidReportWriter::DataIndex + 4 * 6;
+	QCOMPARE((quint8)reports[first], (quint8)0xab);
+	QCOMPARE((quint8)reports[first + 1], (quint8)0x12);
+	QCOMPARE((quint8)reports[first + 2], (quint8)0xff);
+	QCOMPARE((quint8)reports[first + 3], (quint8)0x0c);
+	QCOMPARE((quint8)reports[first + 4], (quint8)0x03);
+	QCOMPARE((quint8)reports[first + 5], (quint8)0x0f);
+
+	const int second = HidReportWriter::ReportSize + HidReportWriter::DataIndex + 4 * 6;
+	QCOMPARE((quint8)reports[second], (quint8)0x01);
+
+	// everything else is cleared, the report id and command too
+	QCOMPARE((quint8)reports[0], (quint8)0);
+	QCOMPARE((quint8)reports[HidReportWriter::CommandIndex], (quint8)0);
+	QCOMPARE((quint8)reports[reports.size() - 1], (quint8)0);
+}
@@ -0,0 +1,297 @@
+/*
+ * LedDeviceAdaptiveUdpTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QThread>
+#include <QUdpSocket>
+#include <cstring>
+
+#include "LedDeviceAdaptiveUdpTest.hpp"
+#include "LedDeviceTestUtils.hpp"
+#include "LedDeviceAdaptiveUdp.hpp"
+#include "LedDeviceDnrgb.hpp"
+#include "enums.hpp"
+
+namespace {
+// what WLED does with its realtime UDP protocols
+class WledReceiver
+{
+public:
+	explicit WledReceiver(int ledsCount) : m_leds(ledsCount * 3, 0), m_bytes(0), m_packets(0) {}
+
+	bool feed(const QByteArray &packet)
+	{
+		if (packet.size() < 2)
+			return false;
+		const quint8 *data = reinterpret_cast<const quint8 *>(packet.constData());
+		m_bytes += packet.size() + LedDeviceAdaptiveUdp::PacketOverhead;
+		++m_packets;
+
+		switch (data[0]) {
+		case UdpDevice::Warls:
+			for (int i = 2; i + 4 <= packet.size(); i += 4) {
+				if (data[i] * 3 + 3 > m_leds.size())
+					return false;
+				memcpy(m_leds.data() + data[i] * 3, data + i + 1, 3);
+			}
+			return (packet.size() - 2) % 4 == 0;
+		case UdpDevice::Drgb:
+			if (packet.size() - 2 > m_leds.size())
+				return false;
+			memcpy(m_leds.data(), data + 2, packet.size() - 2);
+			return true;
+		case UdpDevice::Dnrgb: {
+			const int offset = ((data[2] << 8) | data[3]) * 3;
+			if (packet.size() < 4 || offset + packet.size() - 4 > m_leds.size())
+				return false;
+			memcpy(m_leds.data() + offset, data + 4, packet.size() - 4);
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	const QByteArray & leds() const { return m_leds; }
+	int bytes() const { return m_bytes; }
+	int packets() const { return m_packets; }
+
+private:
+	QByteArray m_leds;
+	int m_bytes;
+	int m_packets;
+};
+
+bool feedAll(WledReceiver &wled, const QList<QByteArray> &datagrams)
+{
+	for (const QByteArray &datagram : datagrams) {
+		if (!wled.feed(datagram))
+			return false;
+	}
+	return true;
+}
+
+QByteArray toWire(const QList<QRgb> &colors)
+{
+	QByteArray result;
+	for (const QRgb color : colors)
+		result.append((char)qRed(color)).append((char)qGreen(color)).append((char)qBlue(color));
+	return result;
+}
+
+// only full and zero channels, they survive the color modifications exactly
+class ColorSource
+{
+public:
+	QRgb next()
+	{
+		m_state = m_state * 1103515245 + 12345;
+		const quint32 bits = m_state >> 16;
+		return qRgb(bits & 1 ? 255 : 0, bits & 2 ? 255 : 0, bits & 4 ? 255 : 0);
+	}
+	int next(int bound)
+	{
+		m_state = m_state * 1103515245 + 12345;
+		return (m_state >> 8) % bound;
+	}
+
+private:
+	quint32 m_state{1};
+};
+
+QList<QRgb> randomColors(ColorSource &source, int count)
+{
+	QList<QRgb> colors;
+	for (int i = 0; i < count; ++i)
+		colors << source.next();
+	return colors;
+}
+}
+
+void LedDeviceAdaptiveUdpTest::testWholeFrameFirst()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceAdaptiveUdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 255, 0);
+	setExactColors(&device);
+	device.open();
+
+	ColorSource source;
+	const QList<QRgb> colors = randomColors(source, 300);
+	device.setColors(colors, false);
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 1);
+	QCOMPARE((int)packets[0][0], (int)UdpDevice::Drgb);
+	QCOMPARE((quint8)packets[0][1], (quint8)255);
+	QCOMPARE(packets[0].mid(2), toWire(colors));
+}
+
+void LedDeviceAdaptiveUdpTest::testFewChangesUseWarls()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceAdaptiveUdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 255, 0);
+	setExactColors(&device);
+	device.open();
+
+	QList<QRgb> colors;
+	for (int i = 0; i < 1200; ++i)
+		colors << qRgb(0, 0, 0);
+	device.setColors(colors, false);
+	receiveAll(receiver);
+
+	colors[3] = qRgb(255, 0, 0);
+	colors[100] = qRgb(0, 255, 0);
+	colors[200] = qRgb(0, 0, 255);
+	device.setColors(colors, false);
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 1);
+	QCOMPARE(packets[0], QByteArray::fromHex("01ff" "03ff0000" "6400ff00" "c80000ff"));
+}
+
+void LedDeviceAdaptiveUdpTest::testChangesAboveWarlsUseDnrgb()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceAdaptiveUdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 255, 0);
+	setExactColors(&device);
+	device.open();
+
+	QList<QRgb> colors;
+	for (int i = 0; i < 1200; ++i)
+		colors << qRgb(0, 0, 0);
+	device.setColors(colors, false);
+	receiveAll(receiver);
+
+	// a short gap is cheaper than a second packet
+	colors[1000] = qRgb(255, 255, 255);
+	colors[1004] = qRgb(255, 255, 255);
+	device.setColors(colors, false);
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 1);
+	QCOMPARE(packets[0], QByteArray::fromHex("04ff03e8" "ffffff" "000000000000000000" "ffffff"));
+}
+
+void LedDeviceAdaptiveUdpTest::testReceiverFollowsFrames()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	ColorSource source;
+	for (const int ledsCount : { 10, 300, 491, 1200, 1500 }) {
+		LedDeviceAdaptiveUdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 2, 0);
+		setExactColors(&device);
+		device.open();
+
+		WledReceiver wled(ledsCount);
+		QList<QRgb> colors = randomColors(source, ledsCount);
+		for (int frame = 0; frame < 50; ++frame) {
+			// nothing, a few, a block or everything changes
+			const int changes = frame % 7 == 0 ? ledsCount : source.next(frame % 3 == 0 ? 40 : 4);
+			for (int i = 0; i < changes; ++i)
+				colors[source.next(ledsCount)] = source.next();
+			if (frame % 5 == 0) {
+				const int first = source.next(ledsCount);
+				for (int i = first; i < qMin(ledsCount, first + 30); ++i)
+					colors[i] = source.next();
+			}
+
+			device.setColors(colors, false);
+			const QList<QByteArray> packets = receiveAll(receiver);
+			// the timeout is not infinite, an unchanged frame is an empty packet
+			QVERIFY(!packets.isEmpty());
+			QVERIFY(feedAll(wled, packets));
+			QCOMPARE(wled.leds(), toWire(colors));
+		}
+	}
+}
+
+void LedDeviceAdaptiveUdpTest::testRefresh()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceAdaptiveUdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 255, 400);
+	setExactColors(&device);
+	device.open();
+
+	ColorSource source;
+	const QList<QRgb> colors = randomColors(source, 1200);
+	device.setColors(colors, false);
+	QCOMPARE(receiveAll(receiver).count(), 3);
+
+	device.setColors(colors, false);
+	QCOMPARE(receiveAll(receiver).count(), 0);
+
+	// a receiver that lost packets shows the whole frame again
+	QThread::msleep(400);
+	device.setColors(colors, false);
+	WledReceiver wled(colors.count());
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 3);
+	QVERIFY(feedAll(wled, packets));
+	QCOMPARE(wled.leds(), toWire(colors));
+}
+
+void LedDeviceAdaptiveUdpTest::testStaticSceneBytes()
+{
+	const int ledsCount = 1200;
+	const int frames = 200;
+
+	QUdpSocket adaptiveReceiver;
+	QVERIFY(adaptiveReceiver.bind(QHostAddress::LocalHost, 0));
+	QUdpSocket dnrgbReceiver;
+	QVERIFY(dnrgbReceiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceAdaptiveUdp adaptive(QStringLiteral("127.0.0.1"), QString::number(adaptiveReceiver.localPort()), 255, 0);
+	LedDeviceDnrgb dnrgb(QStringLiteral("127.0.0.1"), QString::number(dnrgbReceiver.localPort()), 255);
+	setExactColors(&adaptive);
+	setExactColors(&dnrgb);
+	adaptive.open();
+	dnrgb.open();
+
+	ColorSource source;
+	QList<QRgb> colors = randomColors(source, ledsCount);
+	adaptive.setColors(colors, false);
+	dnrgb.setColors(colors, false);
+	receiveAll(adaptiveReceiver);
+	receiveAll(dnrgbReceiver);
+
+	// 1% of the LEDs change per frame
+	WledReceiver adaptiveWled(ledsCount);
+	WledReceiver dnrgbWled(ledsCount);
+	for (int frame = 0; frame < frames; ++frame) {
+		for (int i = 0; i < ledsCount / 100; ++i)
+			colors[source.next(ledsCount)] = source.next();
+		adaptive.setColors(colors, false);
+		dnrgb.setColors(colors, false);
+		QVERIFY(feedAll(adaptiveWled, receiveAll(adaptiveReceiver)));
+		QVERIFY(feedAll(dnrgbWled, receiveAll(dnrgbReceiver)));
+	}
+
+	// whole frames as 489 LED DNRGB packets
+	const int wholeFrameBytes = 3 * (LedDeviceAdaptiveUdp::PacketOverhead + 4) + ledsCount * 3;
+	QVERIFY(adaptiveWled.bytes() <= dnrgbWled.bytes());
+	QVERIFY(adaptiveWled.bytes() * 8 < wholeFrameBytes * frames);
+}
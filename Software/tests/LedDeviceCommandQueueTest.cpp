@@ -0,0 +1,90 @@
+/*
+ * LedDeviceCommandQueueTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceCommandQueueTest.hpp"
+#include "LedDeviceCommandQueue.hpp"
+
+using namespace LedDeviceCommands;
+
+void LedDeviceCommandQueueTest::testLatestValueWins()
+{
+	LedDeviceCommandQueue queue;
+	for (int i = 0; i <= 100; ++i)
+		QVERIFY(queue.append(SetSmoothSlowdown, i));
+
+	const QList<Cmd> cmds = queue.takeNext();
+	QCOMPARE(cmds, QList<Cmd>() << SetSmoothSlowdown);
+	QCOMPARE(queue.value(SetSmoothSlowdown).toInt(), 100);
+	QVERIFY(queue.isEmpty());
+}
+
+void LedDeviceCommandQueueTest::testRedundantValueIsDropped()
+{
+	LedDeviceCommandQueue queue;
+	queue.append(SetBrightness, 50);
+	queue.takeNext();
+
+	QVERIFY(!queue.append(SetBrightness, 50));
+	QVERIFY(queue.isEmpty());
+
+	// dragged away and back before it was sent
+	QVERIFY(queue.append(SetBrightness, 60));
+	QVERIFY(!queue.append(SetBrightness, 50));
+	QVERIFY(queue.isEmpty());
+
+	// commands without a value always go through
+	QVERIFY(queue.append(SetColors));
+	queue.takeNext();
+	QVERIFY(queue.append(SetColors));
+
+	queue.invalidate();
+	QVERIFY(queue.append(SetBrightness, 50));
+}
+
+void LedDeviceCommandQueueTest::testHostSideSettingsShareOneTransaction()
+{
+	LedDeviceCommandQueue queue;
+	queue.append(SetColors);
+	queue.append(SetGamma, 2.0);
+	queue.append(SetBrightness, 80);
+	queue.append(SetDitheringEnabled, true);
+
+	const QList<Cmd> cmds = queue.takeNext();
+	QCOMPARE(cmds, QList<Cmd>() << SetGamma << SetBrightness << SetDitheringEnabled << SetColors);
+	QCOMPARE(queue.value(SetGamma).toDouble(), 2.0);
+	QVERIFY(queue.isEmpty());
+}
+
+void LedDeviceCommandQueueTest::testColorsAreNotStalled()
+{
+	LedDeviceCommandQueue queue;
+	queue.append(SetRefreshDelay, 10);
+	queue.append(SetColorDepth, 128);
+	queue.append(SetColors);
+
+	QCOMPARE(queue.takeNext(), QList<Cmd>() << SetColors);
+	queue.append(SetColors);
+	QCOMPARE(queue.takeNext(), QList<Cmd>() << SetRefreshDelay);
+	QCOMPARE(queue.takeNext(), QList<Cmd>() << SetColors);
+	QCOMPARE(queue.takeNext(), QList<Cmd>() << SetColorDepth);
+	QVERIFY(queue.isEmpty());
+}
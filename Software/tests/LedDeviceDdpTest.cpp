@@ -0,0 +1,193 @@
+/*
+ * LedDeviceDdpTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QUdpSocket>
+#include <cstring>
+
+#include "LedDeviceDdpTest.hpp"
+#include "LedDeviceTestUtils.hpp"
+#include "LedDeviceDdp.hpp"
+#include "LedDeviceDnrgb.hpp"
+#include "enums.hpp"
+
+namespace {
+const int LedsCount = MaximumNumberOfLeds::Ddp;
+
+// what a controller does with DDP: stage the data, show it on push
+class DdpReceiver
+{
+public:
+	explicit DdpReceiver(int ledsCount) : m_staging(ledsCount * 3, 0), m_latched(m_staging), m_pushes(0) {}
+
+	bool feed(const QByteArray &packet)
+	{
+		if (packet.size() < LedDeviceDdp::HeaderSize || (packet[0] & 0xc0) != 0x40)
+			return false;
+		const quint8 *header = reinterpret_cast<const quint8 *>(packet.constData());
+		const int offset = (header[4] << 24) | (header[5] << 16) | (header[6] << 8) | header[7];
+		const int length = (header[8] << 8) | header[9];
+		if (packet.size() != LedDeviceDdp::HeaderSize + length || offset + length > m_staging.size())
+			return false;
+
+		memcpy(m_staging.data() + offset, packet.constData() + LedDeviceDdp::HeaderSize, length);
+		if (header[0] & 0x01) {
+			m_latched = m_staging;
+			++m_pushes;
+		}
+		return true;
+	}
+
+	const QByteArray & leds() const { return m_latched; }
+	int pushes() const { return m_pushes; }
+
+private:
+	QByteArray m_staging;
+	QByteArray m_latched;
+	int m_pushes;
+};
+
+QByteArray toWire(const QList<QRgb> &colors)
+{
+	QByteArray result;
+	for (const QRgb color : colors)
+		result.append((char)qRed(color)).append((char)qGreen(color)).append((char)qBlue(color));
+	return result;
+}
+
+QList<QRgb> solid(QRgb color)
+{
+	QList<QRgb> colors;
+	for (int i = 0; i < LedsCount; ++i)
+		colors << color;
+	return colors;
+}
+}
+
+void LedDeviceDdpTest::testHeader()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceDdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 2);
+	setExactColors(&device);
+	device.open();
+
+	device.setColors(QList<QRgb>() << qRgb(255, 0, 0) << qRgb(0, 255, 0) << qRgb(0, 0, 255), false);
+	QList<QByteArray> datagrams = receiveAll(receiver);
+	QCOMPARE(datagrams.count(), 1);
+	// version 1 + push, sequence, RGB 8 bit, default output, offset 0, 9 bytes
+	QCOMPARE(datagrams[0], QByteArray::fromHex("41010b01000000000009" "ff000000ff000000ff"));
+
+	// only the last LED, behind its byte offset
+	device.setColors(QList<QRgb>() << qRgb(255, 0, 0) << qRgb(0, 255, 0) << qRgb(255, 255, 255), false);
+	datagrams = receiveAll(receiver);
+	QCOMPARE(datagrams.count(), 1);
+	QCOMPARE(datagrams[0], QByteArray::fromHex("41020b01000000060003" "ffffff"));
+
+	// nothing changed, an empty push keeps the controller in realtime mode
+	device.setColors(QList<QRgb>() << qRgb(255, 0, 0) << qRgb(0, 255, 0) << qRgb(255, 255, 255), false);
+	datagrams = receiveAll(receiver);
+	QCOMPARE(datagrams.count(), 1);
+	QCOMPARE(datagrams[0], QByteArray::fromHex("41030b01000000000000"));
+}
+
+void LedDeviceDdpTest::testPartialUpdateIsLatched()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceDdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 2);
+	setExactColors(&device);
+	device.open();
+	DdpReceiver controller(LedsCount);
+
+	QList<QRgb> colors = solid(qRgb(255, 0, 0));
+	device.setColors(colors, false);
+	QList<QByteArray> datagrams = receiveAll(receiver);
+	QCOMPARE(datagrams.count(), (LedsCount + LedDeviceDdp::LedsPerPacket - 1) / LedDeviceDdp::LedsPerPacket);
+	for (const QByteArray &datagram : datagrams)
+		QVERIFY(controller.feed(datagram));
+	QCOMPARE(controller.pushes(), 1);
+	QCOMPARE(controller.leds(), toWire(colors));
+
+	// two far apart LEDs go in separate packets, shown together
+	const QByteArray before = controller.leds();
+	colors[10] = qRgb(0, 0, 255);
+	colors[LedsCount - 10] = qRgb(0, 0, 255);
+	device.setColors(colors, false);
+	datagrams = receiveAll(receiver);
+	QCOMPARE(datagrams.count(), 2);
+	QVERIFY(controller.feed(datagrams[0]));
+	QCOMPARE(controller.leds(), before);
+	QVERIFY(controller.feed(datagrams[1]));
+	QCOMPARE(controller.pushes(), 2);
+	QCOMPARE(controller.leds(), toWire(colors));
+}
+
+void LedDeviceDdpTest::testPacketsAgainstDnrgb()
+{
+	QUdpSocket ddpReceiver;
+	QVERIFY(ddpReceiver.bind(QHostAddress::LocalHost, 0));
+	QUdpSocket dnrgbReceiver;
+	QVERIFY(dnrgbReceiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceDdp ddp(QStringLiteral("127.0.0.1"), QString::number(ddpReceiver.localPort()), 2);
+	LedDeviceDnrgb dnrgb(QStringLiteral("127.0.0.1"), QString::number(dnrgbReceiver.localPort()), 2);
+	setExactColors(&ddp);
+	setExactColors(&dnrgb);
+	ddp.open();
+	dnrgb.open();
+
+	// a whole new frame
+	QList<QRgb> colors = solid(qRgb(255, 0, 0));
+	ddp.setColors(colors, false);
+	dnrgb.setColors(colors, false);
+	const QList<QByteArray> ddpFull = receiveAll(ddpReceiver);
+	const QList<QByteArray> dnrgbFull = receiveAll(dnrgbReceiver);
+	QVERIFY(ddpFull.count() <= dnrgbFull.count());
+
+	// a few LEDs all over the strip: DNRGB needs a packet per run, DDP spans them
+	for (int i = 0; i < LedsCount; i += 100)
+		colors[i] = qRgb(0, 255, 0);
+	ddp.setColors(colors, false);
+	dnrgb.setColors(colors, false);
+	const QList<QByteArray> ddpScattered = receiveAll(ddpReceiver);
+	const QList<QByteArray> dnrgbScattered = receiveAll(dnrgbReceiver);
+	QCOMPARE(dnrgbScattered.count(), LedsCount / 100);
+	QVERIFY(ddpScattered.count() * 4 < dnrgbScattered.count());
+}
+
+void LedDeviceDdpTest::benchmarkFrame()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceDdp device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 2);
+	setExactColors(&device);
+	device.open();
+
+	const QList<QRgb> frames[] = { solid(qRgb(255, 0, 0)), solid(qRgb(0, 0, 255)) };
+	int frame = 0;
+	QBENCHMARK {
+		device.setColors(frames[++frame & 1], false);
+	}
+}
@@ -0,0 +1,184 @@
+/*
+ * LedDeviceDmxTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QUdpSocket>
+
+#include "LedDeviceDmxTest.hpp"
+#include "LedDeviceTestUtils.hpp"
+#include "LedDeviceE131.hpp"
+#include "LedDeviceArtNet.hpp"
+
+namespace {
+// two full universes and 60 LEDs in a third
+const int LedsCount = 2 * AbstractLedDeviceDmx::LedsPerUniverse + 60;
+
+QList<QRgb> pattern(int count)
+{
+	QList<QRgb> colors;
+	for (int i = 0; i < count; ++i)
+		colors << (i % 2 ? qRgb(255, 0, 255) : qRgb(0, 255, 0));
+	return colors;
+}
+
+QByteArray toWire(const QList<QRgb> &colors, int first, int count)
+{
+	QByteArray result;
+	for (int i = first; i < first + count; ++i)
+		result.append((char)qRed(colors[i])).append((char)qGreen(colors[i])).append((char)qBlue(colors[i]));
+	return result;
+}
+
+int word(const QByteArray &packet, int offset)
+{
+	return ((quint8)packet[offset] << 8) | (quint8)packet[offset + 1];
+}
+
+int littleWord(const QByteArray &packet, int offset)
+{
+	return ((quint8)packet[offset + 1] << 8) | (quint8)packet[offset];
+}
+}
+
+void LedDeviceDmxTest::testE131Universes()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceE131 device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 7, false, false);
+	setExactColors(&device);
+	device.open();
+
+	const QList<QRgb> colors = pattern(LedsCount);
+	device.setColors(colors, false);
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 3);
+
+	for (int i = 0; i < packets.count(); ++i) {
+		const QByteArray &packet = packets[i];
+		const int leds = i < 2 ? AbstractLedDeviceDmx::LedsPerUniverse : 60;
+		QCOMPARE(packet.size(), LedDeviceE131::HeaderSize + leds * 3);
+		QCOMPARE(packet.mid(4, 9), QByteArray("ASC-E1.17"));
+		// root, framing and DMP PDU lengths with flags 0x7
+		QCOMPARE(word(packet, 16), 0x7000 | (packet.size() - 16));
+		QCOMPARE(word(packet, 38), 0x7000 | (packet.size() - 38));
+		QCOMPARE(word(packet, 115), 0x7000 | (packet.size() - 115));
+		QCOMPARE(packet.mid(44, 9), QByteArray("Prismatik"));
+		QCOMPARE((int)(quint8)packet[108], 100);
+		// no sync address
+		QCOMPARE(word(packet, 109), 0);
+		QCOMPARE(word(packet, 113), 7 + i);
+		QCOMPARE((quint8)packet[118], (quint8)0xa1);
+		QCOMPARE(word(packet, 123), leds * 3 + 1);
+		QCOMPARE((int)packet[125], 0);
+		QCOMPARE(packet.mid(LedDeviceE131::HeaderSize), toWire(colors, i * AbstractLedDeviceDmx::LedsPerUniverse, leds));
+	}
+	// the component identifier is the same in every packet
+	QCOMPARE(packets[0].mid(22, 16), packets[2].mid(22, 16));
+}
+
+void LedDeviceDmxTest::testE131Sync()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceE131 device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 1, false, true);
+	setExactColors(&device);
+	device.open();
+
+	device.setColors(pattern(LedsCount), false);
+	device.setColors(pattern(LedsCount), false);
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 8);
+
+	for (int frame = 0; frame < 2; ++frame) {
+		const quint8 sequence = packets[frame * 4][111];
+		for (int i = 0; i < 3; ++i) {
+			const QByteArray &packet = packets[frame * 4 + i];
+			QCOMPARE(word(packet, 109), 1);
+			QCOMPARE((quint8)packet[111], sequence);
+		}
+
+		// the sync packet is the last of a frame
+		const QByteArray &sync = packets[frame * 4 + 3];
+		QCOMPARE(sync.size(), LedDeviceE131::SyncPacketSize);
+		QCOMPARE(sync.mid(18, 4), QByteArray::fromHex("00000008"));
+		QCOMPARE(sync.mid(40, 4), QByteArray::fromHex("00000001"));
+		QCOMPARE((quint8)sync[44], sequence);
+		QCOMPARE(word(sync, 45), 1);
+	}
+	QCOMPARE((quint8)packets[4][111], (quint8)((quint8)packets[0][111] + 1));
+}
+
+void LedDeviceDmxTest::testE131MulticastGroup()
+{
+	QCOMPARE(LedDeviceE131::multicastGroup(1), QHostAddress(QStringLiteral("239.255.0.1")));
+	QCOMPARE(LedDeviceE131::multicastGroup(0x1234), QHostAddress(QStringLiteral("239.255.18.52")));
+}
+
+void LedDeviceDmxTest::testArtNetUniverses()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	// one LED over a universe, the last one needs a pad channel
+	const int ledsCount = AbstractLedDeviceDmx::LedsPerUniverse + 1;
+	LedDeviceArtNet device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 0x123, false);
+	setExactColors(&device);
+	device.open();
+
+	const QList<QRgb> colors = pattern(ledsCount);
+	device.setColors(colors, false);
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 2);
+
+	for (int i = 0; i < packets.count(); ++i) {
+		const QByteArray &packet = packets[i];
+		QCOMPARE(packet.left(8), QByteArray("Art-Net\0", 8));
+		QCOMPARE(littleWord(packet, 8), 0x5000);
+		QCOMPARE(word(packet, 10), 14);
+		// 0 would turn sequencing off
+		QVERIFY(packet[12] != 0);
+		QCOMPARE(littleWord(packet, 14), 0x123 + i);
+	}
+	QCOMPARE(word(packets[0], 16), 510);
+	QCOMPARE(packets[0].mid(LedDeviceArtNet::HeaderSize), toWire(colors, 0, AbstractLedDeviceDmx::LedsPerUniverse));
+	QCOMPARE(word(packets[1], 16), 4);
+	QCOMPARE(packets[1].mid(LedDeviceArtNet::HeaderSize), toWire(colors, AbstractLedDeviceDmx::LedsPerUniverse, 1) + QByteArray(1, 0));
+}
+
+void LedDeviceDmxTest::testArtNetSync()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceArtNet device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 0, true);
+	setExactColors(&device);
+	device.open();
+
+	device.setColors(pattern(LedsCount), false);
+	const QList<QByteArray> packets = receiveAll(receiver);
+	QCOMPARE(packets.count(), 4);
+
+	const QByteArray &sync = packets.last();
+	QCOMPARE(sync.size(), LedDeviceArtNet::SyncPacketSize);
+	QCOMPARE(sync, QByteArray("Art-Net\0", 8) + QByteArray::fromHex("0052000e0000"));
+}
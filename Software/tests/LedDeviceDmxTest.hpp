@@ -0,0 +1,40 @@
+/*
+ * LedDeviceDmxTest.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QtTest>
+
+class LedDeviceDmxTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	LedDeviceDmxTest(){}
+
+private Q_SLOTS:
+	void testE131Universes();
+	void testE131Sync();
+	void testE131MulticastGroup();
+	void testArtNetUniverses();
+	void testArtNetSync();
+};
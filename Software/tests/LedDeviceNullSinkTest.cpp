@@ -0,0 +1,206 @@
+/*
+ * LedDeviceNullSinkTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceNullSinkTest.hpp"
+#include "LedDeviceNullSink.hpp"
+#include "LatencyHistogram.hpp"
+#include "enums.hpp"
+
+namespace {
+QList<QRgb> gradient(int ledsCount, int shift)
+{
+	QList<QRgb> colors;
+	colors.reserve(ledsCount);
+	for (int i = 0; i < ledsCount; i++)
+		colors << qRgb((i + shift) & 0xff, (i * 3 + shift) & 0xff, (i * 7 + shift) & 0xff);
+	return colors;
+}
+}
+
+void LedDeviceNullSinkTest::testHistogramBuckets()
+{
+	int previous = 0;
+	for (qint64 ns = 0; ns < 1 << 20; ns++) {
+		const int bucket = LatencyHistogram::bucket(ns);
+		QVERIFY(bucket == previous || bucket == previous + 1);
+		QVERIFY(ns <= LatencyHistogram::bucketUpperBound(bucket));
+		if (bucket > 0)
+			QVERIFY(ns > LatencyHistogram::bucketUpperBound(bucket - 1));
+		// a bucket is at most 1/SubBuckets of its values wide
+		QVERIFY(LatencyHistogram::bucketUpperBound(bucket) - ns <= ns / LatencyHistogram::SubBuckets);
+		previous = bucket;
+	}
+
+	QCOMPARE(LatencyHistogram::bucket(-5), 0);
+	QCOMPARE(LatencyHistogram::bucket(Q_INT64_C(1) << 50), LatencyHistogram::BucketsCount - 1);
+}
+
+void LedDeviceNullSinkTest::testHistogramPercentiles()
+{
+	LatencyHistogram histogram;
+	QCOMPARE(histogram.percentile(0.5), Q_INT64_C(0));
+	QCOMPARE(histogram.mean(), 0.0);
+
+	for (int ns = 1000; ns >= 1; ns--)
+		histogram.add(ns);
+
+	QCOMPARE(histogram.count(), (quint64)1000);
+	QCOMPARE(histogram.min(), Q_INT64_C(1));
+	QCOMPARE(histogram.max(), Q_INT64_C(1000));
+	QCOMPARE(histogram.mean(), 500.5);
+	QVERIFY(histogram.percentile(0.5) >= 500 && histogram.percentile(0.5) <= 500 + 500 / LatencyHistogram::SubBuckets);
+	QVERIFY(histogram.percentile(0.99) >= 990 && histogram.percentile(0.99) <= 1000);
+	QCOMPARE(histogram.percentile(1.0), Q_INT64_C(1000));
+	QCOMPARE(histogram.percentile(0.0), Q_INT64_C(1));
+
+	histogram.reset();
+	QCOMPARE(histogram.count(), (quint64)0);
+	QCOMPARE(histogram.max(), Q_INT64_C(0));
+}
+
+void LedDeviceNullSinkTest::testEncoders_data()
+{
+	QTest::addColumn<QString>("encoder");
+	QTest::addColumn<int>("bytes");
+	QTest::addColumn<int>("packets");
+
+	const int ledsCount = MaximumNumberOfLeds::NullSink;
+	// a 65 byte HID report per 10 LEDs
+	QTest::newRow("Lightpack") << "Lightpack" << ledsCount / 10 * 65 << ledsCount / 10;
+	QTest::newRow("Adalight") << "Adalight" << 6 + ledsCount * 3 << 1;
+	QTest::newRow("Ardulight") << "Ardulight" << 1 + ledsCount * 3 << 1;
+	QTest::newRow("DRGB") << "DRGB" << 2 + ledsCount * 3 << 1;
+	// 489 and 480 LEDs per packet
+	QTest::newRow("DNRGB") << "DNRGB" << 4 * 4 + ledsCount * 3 << 4;
+	QTest::newRow("DDP") << "DDP" << 4 * 10 + ledsCount * 3 << 4;
+	QTest::newRow("unknown is Adalight") << "foo" << 6 + ledsCount * 3 << 1;
+}
+
+void LedDeviceNullSinkTest::testEncoders()
+{
+	QFETCH(QString, encoder);
+	QFETCH(int, bytes);
+	QFETCH(int, packets);
+
+	LedDeviceNullSink device(encoder);
+	QSignalSpy completed(&device, &AbstractLedDevice::commandCompleted);
+	device.open();
+	device.setColors(gradient(MaximumNumberOfLeds::NullSink, 0));
+
+	QCOMPARE(completed.count(), 1);
+	QCOMPARE(completed.first().first().toBool(), true);
+
+	const LedDeviceNullSink::Statistics stats = LedDeviceNullSink::statistics();
+	QCOMPARE(stats.encoder, LedDeviceNullSink::encoderName(device.encoder()));
+	QCOMPARE(stats.ledsCount, (int)MaximumNumberOfLeds::NullSink);
+	QCOMPARE(stats.bytesPerFrame, bytes);
+	QCOMPARE(stats.packetsPerFrame, packets);
+}
+
+void LedDeviceNullSinkTest::testStatistics()
+{
+	LedDeviceNullSink device(QStringLiteral("DDP"));
+	device.open();
+
+	const int frames = 50;
+	for (int i = 0; i < frames; i++)
+		device.setColors(gradient(300, i));
+
+	LedDeviceNullSink::Statistics stats = LedDeviceNullSink::statistics();
+	QCOMPARE(stats.ledsCount, 300);
+	for (const LatencyHistogram &stage : stats.stages)
+		QCOMPARE(stage.count(), (quint64)frames);
+
+	// the stages make up the whole frame
+	const LatencyHistogram *stages = stats.stages;
+	const double sum = stages[LedDeviceNullSink::StageColorModifications].mean()
+		+ stages[LedDeviceNullSink::StageDithering].mean()
+		+ stages[LedDeviceNullSink::StageEncoding].mean();
+	QVERIFY(qAbs(stages[LedDeviceNullSink::StageTotal].mean() - sum) < 1.0);
+	QVERIFY(stages[LedDeviceNullSink::StageTotal].max() >= stages[LedDeviceNullSink::StageEncoding].max());
+
+	// another LED count is another benchmark
+	device.setColors(gradient(100, 0));
+	stats = LedDeviceNullSink::statistics();
+	QCOMPARE(stats.ledsCount, 100);
+	QCOMPARE(stats.stages[LedDeviceNullSink::StageTotal].count(), (quint64)1);
+
+	// switching off is not a frame
+	device.switchOffLeds();
+	QCOMPARE(LedDeviceNullSink::statistics().stages[LedDeviceNullSink::StageTotal].count(), (quint64)1);
+
+	device.open();
+	QCOMPARE(LedDeviceNullSink::statistics().stages[LedDeviceNullSink::StageTotal].count(), (quint64)0);
+}
+
+void LedDeviceNullSinkTest::testSecondSinkIsRejected()
+{
+	LedDeviceNullSink first(QStringLiteral("DDP"));
+	LedDeviceNullSink second(QStringLiteral("Adalight"));
+	QSignalSpy firstOpened(&first, &AbstractLedDevice::openDeviceSuccess);
+	QSignalSpy secondOpened(&second, &AbstractLedDevice::openDeviceSuccess);
+
+	first.open();
+	second.open();
+	QCOMPARE(firstOpened.first().first().toBool(), true);
+	QCOMPARE(secondOpened.first().first().toBool(), false);
+
+	// the frames of the rejected sink don't mix into the statistics
+	first.setColors(gradient(300, 0));
+	second.setColors(gradient(100, 0));
+	LedDeviceNullSink::Statistics stats = LedDeviceNullSink::statistics();
+	QCOMPARE(stats.encoder, QStringLiteral("DDP"));
+	QCOMPARE(stats.ledsCount, 300);
+	QCOMPARE(stats.stages[LedDeviceNullSink::StageTotal].count(), (quint64)1);
+
+	first.close();
+	second.open();
+	QCOMPARE(secondOpened.last().first().toBool(), true);
+	QCOMPARE(LedDeviceNullSink::statistics().encoder, QStringLiteral("Adalight"));
+}
+
+void LedDeviceNullSinkTest::benchmarkEncoders_data()
+{
+	QTest::addColumn<QString>("encoder");
+	QTest::addColumn<int>("ledsCount");
+
+	for (int i = 0; i < LedDeviceNullSink::EncodersCount; i++) {
+		const QString encoder = LedDeviceNullSink::encoderName((LedDeviceNullSink::Encoder)i);
+		for (const int ledsCount : { 10, 300, 1500 })
+			QTest::newRow(qPrintable(QStringLiteral("%1 %2").arg(encoder).arg(ledsCount))) << encoder << ledsCount;
+	}
+}
+
+void LedDeviceNullSinkTest::benchmarkEncoders()
+{
+	QFETCH(QString, encoder);
+	QFETCH(int, ledsCount);
+
+	LedDeviceNullSink device(encoder);
+	device.open();
+
+	const QList<QRgb> frames[] = { gradient(ledsCount, 0), gradient(ledsCount, 1) };
+	int frame = 0;
+	QBENCHMARK {
+		device.setColors(frames[++frame & 1]);
+	}
+}
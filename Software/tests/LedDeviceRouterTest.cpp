@@ -0,0 +1,205 @@
+/*
+ * LedDeviceRouterTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QAtomicInt>
+#include <QUdpSocket>
+
+#include "LedDeviceRouterTest.hpp"
+#include "LedDeviceRouter.hpp"
+#include "LedDeviceVirtual.hpp"
+#include "LedDeviceDrgb.hpp"
+#include "enums.hpp"
+
+namespace {
+const QRgb Red = qRgb(255, 0, 0);
+const QRgb Green = qRgb(0, 255, 0);
+const QRgb Blue = qRgb(0, 0, 255);
+const QRgb Yellow = qRgb(255, 255, 0);
+const QRgb Cyan = qRgb(0, 255, 255);
+const QRgb White = qRgb(255, 255, 255);
+
+QList<QRgb> testFrame()
+{
+	return QList<QRgb>() << Red << Green << Blue << Yellow << Cyan << White << Red << Green << Blue << Yellow;
+}
+
+// device output goes through gamma and 12 bit renormalization
+bool isSameColor(QRgb a, QRgb b)
+{
+	return qAbs(qRed(a) - qRed(b)) <= 1 && qAbs(qGreen(a) - qGreen(b)) <= 1 && qAbs(qBlue(a) - qBlue(b)) <= 1;
+}
+
+// writes of all SlowDevice instances in progress and the most seen at once
+QAtomicInt g_slowWrites;
+QAtomicInt g_slowWritesMax;
+
+class SlowDevice : public LedDeviceVirtual
+{
+public:
+	void setColors(const QList<QRgb> &colors) override
+	{
+		const int writes = g_slowWrites.fetchAndAddOrdered(1) + 1;
+		int max = g_slowWritesMax.loadAcquire();
+		while (writes > max && !g_slowWritesMax.testAndSetOrdered(max, writes))
+			max = g_slowWritesMax.loadAcquire();
+
+		QThread::msleep(100);
+		g_slowWrites.fetchAndAddOrdered(-1);
+		LedDeviceVirtual::setColors(colors);
+	}
+};
+
+class CloseThreadDevice : public LedDeviceVirtual
+{
+public:
+	CloseThreadDevice(QThread **closedIn) : m_closedIn(closedIn) {}
+
+	void close() override
+	{
+		*m_closedIn = QThread::currentThread();
+		LedDeviceVirtual::close();
+	}
+
+private:
+	QThread **m_closedIn;
+};
+}
+
+void LedDeviceRouterTest::initTestCase()
+{
+	qRegisterMetaType< QList<QRgb> >("QList<QRgb>");
+}
+
+void LedDeviceRouterTest::testParseRoutes()
+{
+	const QList<LedDeviceRouter::Route> routes = LedDeviceRouter::parseRoutes(" Lightpack:0-9, DNRGB:10-69r,Virtual:3-3m , bad, DRGB:5-2, Adalight:7rm");
+
+	QCOMPARE(routes.size(), 4);
+	QCOMPARE(routes[0].device, QString("Lightpack"));
+	QCOMPARE(routes[0].first, 0);
+	QCOMPARE(routes[0].count, 10);
+	QVERIFY(!routes[0].isReversed && !routes[0].isMirrored);
+	QCOMPARE(routes[1].device, QString("DNRGB"));
+	QCOMPARE(routes[1].first, 10);
+	QCOMPARE(routes[1].count, 60);
+	QVERIFY(routes[1].isReversed && !routes[1].isMirrored);
+	QCOMPARE(routes[2].count, 1);
+	QVERIFY(!routes[2].isReversed && routes[2].isMirrored);
+	QCOMPARE(routes[3].first, 7);
+	QCOMPARE(routes[3].count, 1);
+	QVERIFY(routes[3].isReversed && routes[3].isMirrored);
+
+	QCOMPARE(LedDeviceRouter::routedCount(routes), 10 + 60 + 2 + 2);
+	QVERIFY(LedDeviceRouter::parseRoutes("").isEmpty());
+}
+
+void LedDeviceRouterTest::testRoute()
+{
+	const QList<QRgb> frame = testFrame();
+	QList<QRgb> colors;
+
+	LedDeviceRouter::route(frame, LedDeviceRouter::parseRoutes("X:0-9"), colors);
+	QCOMPARE(colors, frame);
+	// whole frame in order is passed on without a copy
+	QVERIFY(colors.constBegin() == frame.constBegin());
+
+	LedDeviceRouter::route(frame, LedDeviceRouter::parseRoutes("X:1-3r"), colors);
+	QCOMPARE(colors, QList<QRgb>() << Yellow << Blue << Green);
+
+	LedDeviceRouter::route(frame, LedDeviceRouter::parseRoutes("X:4-5m,X:0-0"), colors);
+	QCOMPARE(colors, QList<QRgb>() << Cyan << White << White << Cyan << Red);
+
+	// out of the frame is black
+	LedDeviceRouter::route(frame, LedDeviceRouter::parseRoutes("X:9-10"), colors);
+	QCOMPARE(colors, QList<QRgb>() << Yellow << 0);
+}
+
+void LedDeviceRouterTest::testFanOutToVirtualAndUdp()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceVirtual *virtualDevice = new LedDeviceVirtual();
+	virtualDevice->setGamma(1.0, false);
+	LedDeviceDrgb *udpDevice = new LedDeviceDrgb(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 1);
+	udpDevice->setGamma(1.0, false);
+
+	QList<QRgb> virtualColors;
+	connect(virtualDevice, &AbstractLedDevice::colorsUpdated, this, [&virtualColors](QList<QRgb> colors) {
+		virtualColors = colors;
+	});
+
+	LedDeviceRouter router;
+	router.addOutput(virtualDevice, LedDeviceRouter::parseRoutes("Virtual:0-3"));
+	router.addOutput(udpDevice, LedDeviceRouter::parseRoutes("DRGB:4-9r"));
+	QCOMPARE(router.outputsCount(), 2);
+
+	QSignalSpy completed(&router, &LedDeviceRouter::frameCompleted);
+	router.setColors(testFrame());
+	QTRY_VERIFY(completed.count() > 0);
+	QVERIFY(!router.isBusy());
+
+	QTRY_COMPARE(virtualColors.size(), 4);
+	for (int i = 0; i < 4; ++i)
+		QVERIFY(isSameColor(virtualColors[i], testFrame()[i]));
+
+	QTRY_VERIFY(receiver.hasPendingDatagrams());
+	QByteArray datagram(receiver.pendingDatagramSize(), 0);
+	receiver.readDatagram(datagram.data(), datagram.size());
+	QCOMPARE(datagram.size(), 2 + 6 * 3);
+	QCOMPARE((int)datagram[0], (int)UdpDevice::Drgb);
+	for (int i = 0; i < 6; ++i) {
+		const QRgb expected = testFrame()[9 - i];
+		const QRgb received = qRgb((uchar)datagram[2 + i * 3], (uchar)datagram[3 + i * 3], (uchar)datagram[4 + i * 3]);
+		QVERIFY(isSameColor(received, expected));
+	}
+}
+
+void LedDeviceRouterTest::testOutputsRunInParallel()
+{
+	LedDeviceRouter router;
+	for (int i = 0; i < 3; ++i)
+		router.addOutput(new SlowDevice(), LedDeviceRouter::parseRoutes("Virtual:0-9"));
+
+	QSignalSpy completed(&router, &LedDeviceRouter::frameCompleted);
+	g_slowWritesMax.storeRelease(0);
+	router.setColors(testFrame());
+	QTRY_VERIFY(completed.count() > 0);
+
+	// the three 100 ms writes overlapped instead of running one after another
+	QCOMPARE(g_slowWritesMax.loadAcquire(), 3);
+}
+
+void LedDeviceRouterTest::testClearClosesInOutputThread()
+{
+	QThread *closedIn = nullptr;
+	QPointer<CloseThreadDevice> device = new CloseThreadDevice(&closedIn);
+
+	LedDeviceRouter router;
+	router.addOutput(device, LedDeviceRouter::parseRoutes("Virtual:0-9"));
+	router.clear();
+
+	QVERIFY(closedIn != nullptr);
+	QVERIFY(closedIn != QThread::currentThread());
+	QVERIFY(device.isNull());
+	QCOMPARE(router.outputsCount(), 0);
+}
@@ -0,0 +1,51 @@
+/*
+ * LedDeviceTestUtils.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QUdpSocket>
+
+#include "AbstractLedDevice.hpp"
+
+// full and zero channels pass all color modifications unchanged
+inline void setExactColors(AbstractLedDevice *device)
+{
+	device->setGamma(1.0, false);
+	device->setBrightness(100, false);
+	device->setLuminosityThreshold(0, false);
+	device->setMinimumLuminosityThresholdEnabled(false, false);
+	device->setDitheringEnabled(false, false);
+}
+
+// every datagram that arrives until none came for 100 ms
+inline QList<QByteArray> receiveAll(QUdpSocket &receiver)
+{
+	QList<QByteArray> datagrams;
+	while (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(100)) {
+		QByteArray datagram(receiver.pendingDatagramSize(), 0);
+		receiver.readDatagram(datagram.data(), datagram.size());
+		datagrams << datagram;
+	}
+	return datagrams;
+}
@@ -0,0 +1,241 @@
+/*
+ * LedFrameRingTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include "LedFrameRingTest.hpp"
+#include "LedDeviceTestUtils.hpp"
+#include "LedFrameRingWriter.hpp"
+#include "LedDeviceVirtual.hpp"
+#include "enums.hpp"
+#include "common/LedFrameRing.h"
+
+namespace {
+QString ringName(const char *test)
+{
+	return QStringLiteral("/prismatik-test-%1-%2").arg(QCoreApplication::applicationPid()).arg(QLatin1String(test));
+}
+
+QList<StructRgb> frame(int count, unsigned seed)
+{
+	QList<StructRgb> colors;
+	for (int i = 0; i < count; ++i) {
+		StructRgb color;
+		color.r = (seed + i) & 0xff;
+		color.g = (seed * 3 + i) & 0xff;
+		color.b = (seed * 7 + i) & 0xff;
+		colors << color;
+	}
+	return colors;
+}
+
+QByteArray toRgb(const QList<StructRgb> &colors)
+{
+	QByteArray result;
+	for (const StructRgb &color : colors)
+		result.append((char)color.r).append((char)color.g).append((char)color.b);
+	return result;
+}
+
+QByteArray read(const LedFrameRing &ring, quint64 *sequence = nullptr)
+{
+	QByteArray rgb(ring.header->maxLeds * 3, 0);
+	uint64_t latest = 0;
+	const int count = led_frame_ring_read(&ring, reinterpret_cast<uint8_t *>(rgb.data()), ring.header->maxLeds, &latest, nullptr);
+	if (sequence)
+		*sequence = latest;
+	return count < 0 ? QByteArray() : rgb.left(count * 3);
+}
+
+// publishes a frame after a delay, like the device thread does
+class DelayedWriter : public QThread
+{
+public:
+	DelayedWriter(LedFrameRingWriter &writer, const QList<StructRgb> &colors) : m_writer(writer), m_colors(colors) {}
+
+protected:
+	void run() override
+	{
+		msleep(20);
+		m_writer.write(m_colors);
+	}
+
+private:
+	LedFrameRingWriter &m_writer;
+	QList<StructRgb> m_colors;
+};
+}
+
+void LedFrameRingTest::testFramesReachReader()
+{
+	const QString name = ringName("frames");
+	LedFrameRingWriter writer;
+	QVERIFY(writer.open(name, 16));
+
+	LedFrameRing ring;
+	// the leading slash is optional
+	QCOMPARE(led_frame_ring_open(&ring, name.mid(1).toLocal8Bit().constData()), 0);
+	QCOMPARE(ring.header->maxLeds, 16u);
+
+	quint64 sequence = 42;
+	QCOMPARE(read(ring, &sequence), QByteArray());
+
+	const uint64_t before = led_frame_ring_now_us();
+	const QList<StructRgb> colors = frame(10, 1);
+	QCOMPARE(writer.write(colors), 1ull);
+	QCOMPARE(read(ring, &sequence), toRgb(colors));
+	QCOMPARE(sequence, 1ull);
+
+	uint64_t latest = 0;
+	const LedFrameRingSlot *slot = led_frame_ring_latest(&ring, &latest);
+	QVERIFY(slot != nullptr);
+	QCOMPARE(latest, (uint64_t)1);
+	QCOMPARE(slot->ledsCount, 10u);
+	QVERIFY(slot->timestampUs >= before && slot->timestampUs <= led_frame_ring_now_us());
+
+	// LEDs beyond the capacity are dropped, the reader can take fewer
+	const QList<StructRgb> tooMany = frame(20, 2);
+	QCOMPARE(writer.write(tooMany), 2ull);
+	QCOMPARE(read(ring), toRgb(tooMany.mid(0, 16)));
+	QByteArray rgb(3 * 4, 0);
+	QCOMPARE(led_frame_ring_read(&ring, reinterpret_cast<uint8_t *>(rgb.data()), 4, nullptr, nullptr), 4);
+	QCOMPARE(rgb, toRgb(tooMany.mid(0, 4)));
+
+	led_frame_ring_close(&ring);
+}
+
+void LedFrameRingTest::testLappedReader()
+{
+	const QString name = ringName("lapped");
+	LedFrameRingWriter writer;
+	QVERIFY(writer.open(name, 8, 4));
+
+	LedFrameRing ring;
+	QCOMPARE(led_frame_ring_open(&ring, name.toLocal8Bit().constData()), 0);
+
+	for (unsigned i = 1; i <= 10; ++i)
+		writer.write(frame(8, i));
+
+	quint64 sequence = 0;
+	QCOMPARE(read(ring, &sequence), toRgb(frame(8, 10)));
+	QCOMPARE(sequence, 10ull);
+
+	uint64_t latest = 0;
+	const LedFrameRingSlot *slot = led_frame_ring_latest(&ring, &latest);
+	QCOMPARE(latest, (uint64_t)10);
+	QVERIFY(led_frame_ring_is_valid(slot, latest));
+
+	// frames 11 to 13 use the other slots, 14 reuses the one held by the reader
+	for (unsigned i = 11; i <= 13; ++i)
+		writer.write(frame(8, i));
+	QVERIFY(led_frame_ring_is_valid(slot, latest));
+	writer.write(frame(8, 14));
+	QVERIFY(!led_frame_ring_is_valid(slot, latest));
+
+	QCOMPARE(read(ring, &sequence), toRgb(frame(8, 14)));
+	QCOMPARE(sequence, 14ull);
+
+	led_frame_ring_close(&ring);
+}
+
+void LedFrameRingTest::testWaitForFrame()
+{
+	const QString name = ringName("wait");
+	LedFrameRingWriter writer;
+	QVERIFY(writer.open(name, 8));
+
+	LedFrameRing ring;
+	QCOMPARE(led_frame_ring_open(&ring, name.toLocal8Bit().constData()), 0);
+
+	QCOMPARE(led_frame_ring_wait(&ring, 0, 10), (int)LED_FRAME_RING_TIMEOUT);
+
+	DelayedWriter delayed(writer, frame(8, 5));
+	delayed.start();
+	QCOMPARE(led_frame_ring_wait(&ring, 0, 5000), (int)LED_FRAME_RING_OK);
+	delayed.wait();
+
+	quint64 sequence = 0;
+	QCOMPARE(read(ring, &sequence), toRgb(frame(8, 5)));
+	QCOMPARE(sequence, 1ull);
+
+	// an already published frame does not block
+	QCOMPARE(led_frame_ring_wait(&ring, 0, -1), (int)LED_FRAME_RING_OK);
+	QCOMPARE(led_frame_ring_wait(&ring, 1, 10), (int)LED_FRAME_RING_TIMEOUT);
+
+	led_frame_ring_close(&ring);
+}
+
+void LedFrameRingTest::testClose()
+{
+	const QString name = ringName("close");
+	LedFrameRingWriter writer;
+	QVERIFY(writer.open(name, 8));
+	writer.write(frame(8, 1));
+
+	LedFrameRing ring;
+	QCOMPARE(led_frame_ring_open(&ring, name.toLocal8Bit().constData()), 0);
+
+	writer.close();
+	QVERIFY(!writer.isOpen());
+	QCOMPARE(writer.write(frame(8, 2)), 0ull);
+
+	// the mapping stays readable, the reader is told to reopen
+	QCOMPARE(led_frame_ring_wait(&ring, 1, -1), (int)LED_FRAME_RING_CLOSED);
+	uint8_t rgb[8 * 3];
+	QCOMPARE(led_frame_ring_read(&ring, rgb, 8, nullptr, nullptr), (int)LED_FRAME_RING_CLOSED);
+	led_frame_ring_close(&ring);
+
+	LedFrameRing reopened;
+	QCOMPARE(led_frame_ring_open(&reopened, name.toLocal8Bit().constData()), -1);
+
+	// a new writer replaces the ring under the same name
+	QVERIFY(writer.open(name, 8));
+	QCOMPARE(led_frame_ring_open(&reopened, name.toLocal8Bit().constData()), 0);
+	QCOMPARE(reopened.header->sequence, (uint64_t)0);
+	led_frame_ring_close(&reopened);
+}
+
+void LedFrameRingTest::testVirtualDevicePublishes()
+{
+	const QString name = ringName("virtual");
+	LedDeviceVirtual device(name);
+	setExactColors(&device);
+	device.open();
+
+	LedFrameRing ring;
+	QCOMPARE(led_frame_ring_open(&ring, name.toLocal8Bit().constData()), 0);
+	QCOMPARE(ring.header->maxLeds, (uint32_t)MaximumNumberOfLeds::Virtual);
+
+	device.setColors(QList<QRgb>() << qRgb(255, 0, 0) << qRgb(0, 255, 0) << qRgb(0, 0, 255));
+	QCOMPARE(read(ring), QByteArray::fromHex("ff000000ff000000ff"));
+
+	device.switchOffLeds();
+	quint64 sequence = 0;
+	QCOMPARE(read(ring, &sequence), QByteArray(9, 0));
+	QCOMPARE(sequence, 2ull);
+
+	device.close();
+	QCOMPARE(led_frame_ring_wait(&ring, sequence, -1), (int)LED_FRAME_RING_CLOSED);
+	led_frame_ring_close(&ring);
+}
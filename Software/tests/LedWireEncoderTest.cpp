@@ -0,0 +1,162 @@
+/*
+ * LedWireEncoderTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QUdpSocket>
+
+#include "LedWireEncoderTest.hpp"
+#include "LedDeviceTestUtils.hpp"
+#include "LedWireEncoder.hpp"
+#include "LedDeviceDnrgb.hpp"
+#include "LedDeviceWarls.hpp"
+#include "enums.hpp"
+
+namespace {
+StructRgb rgb(unsigned r, unsigned g, unsigned b)
+{
+	StructRgb color;
+	color.r = r;
+	color.g = g;
+	color.b = b;
+	return color;
+}
+
+QByteArray bytes(std::initializer_list<int> values)
+{
+	QByteArray result;
+	for (const int value : values)
+		result.append((char)value);
+	return result;
+}
+
+QByteArray receive(QUdpSocket &receiver)
+{
+	if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(1000))
+		return QByteArray();
+	QByteArray datagram(receiver.pendingDatagramSize(), 0);
+	receiver.readDatagram(datagram.data(), datagram.size());
+	return datagram;
+}
+}
+
+void LedWireEncoderTest::testAdalightFrame()
+{
+	// "Ada", LED count - 1 (hi, lo), checksum
+	const QByteArray header = bytes({'A', 'd', 'a', 0, 1, 0 ^ 1 ^ 0x55});
+
+	LedWireEncoder encoder;
+	encoder.setHeader(header);
+	encoder.setColorSequence(QStringLiteral("GRB"));
+
+	const QList<StructRgb> colors = QList<StructRgb>() << rgb(1, 2, 3) << rgb(250, 251, 252);
+	QCOMPARE(encoder.encode(colors), header + bytes({2, 1, 3, 251, 250, 252}));
+
+	encoder.setColorSequence(QStringLiteral("BRG"));
+	QCOMPARE(encoder.encode(colors), header + bytes({3, 1, 2, 252, 250, 251}));
+
+	// unknown sequences were sent as RGB before
+	encoder.setColorSequence(QStringLiteral("XYZ"));
+	QCOMPARE(encoder.encode(colors), header + bytes({1, 2, 3, 250, 251, 252}));
+}
+
+void LedWireEncoderTest::testArdulightFrame()
+{
+	LedWireEncoder encoder;
+	encoder.setHeader(bytes({255}));
+	encoder.setMaxValue(254);
+	encoder.setColorSequence(QStringLiteral("BGR"));
+
+	const QList<StructRgb> colors = QList<StructRgb>() << rgb(255, 0, 254) << rgb(7, 255, 8);
+	QCOMPARE(encoder.encode(colors), bytes({255, 254, 0, 254, 8, 254, 7}));
+}
+
+void LedWireEncoderTest::testDrgbFrame()
+{
+	LedWireEncoder encoder;
+	encoder.setHeader(bytes({UdpDevice::Drgb, 1}));
+
+	QList<StructRgb> colors = QList<StructRgb>() << rgb(1, 2, 3) << rgb(4, 5, 6) << rgb(7, 8, 9);
+	QCOMPARE(encoder.encode(colors), bytes({UdpDevice::Drgb, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+	// fewer LEDs reuse the buffer, the header stays in place
+	colors.removeLast();
+	QCOMPARE(encoder.encode(colors), bytes({UdpDevice::Drgb, 1, 1, 2, 3, 4, 5, 6}));
+
+	encoder.setHeader(bytes({UdpDevice::Drgb, 255}));
+	QCOMPARE(encoder.encode(colors, 1, 1), bytes({UdpDevice::Drgb, 255, 4, 5, 6}));
+}
+
+void LedWireEncoderTest::testDnrgbPackets()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceDnrgb device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 2);
+	setExactColors(&device);
+	device.open();
+
+	device.setColors(QList<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 0, 0) << qRgb(255, 0, 0), false);
+	QCOMPARE(receive(receiver), bytes({UdpDevice::Dnrgb, 2, 0, 0, 255, 255, 255, 0, 0, 0, 255, 0, 0}));
+
+	// only the changed LED, behind its start index
+	device.setColors(QList<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 255, 0) << qRgb(255, 0, 0), false);
+	QCOMPARE(receive(receiver), bytes({UdpDevice::Dnrgb, 2, 0, 1, 0, 255, 0}));
+
+	// nothing changed, keeps the device from timing out
+	device.setColors(QList<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 255, 0) << qRgb(255, 0, 0), false);
+	QCOMPARE(receive(receiver), bytes({UdpDevice::Dnrgb, 2, 0, 0}));
+}
+
+void LedWireEncoderTest::testWarlsPackets()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	LedDeviceWarls device(QStringLiteral("127.0.0.1"), QString::number(receiver.localPort()), 2);
+	setExactColors(&device);
+	device.open();
+
+	device.setColors(QList<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 0, 0) << qRgb(255, 0, 0), false);
+	QCOMPARE(receive(receiver), bytes({UdpDevice::Warls, 2, 0, 255, 255, 255, 1, 0, 0, 0, 2, 255, 0, 0}));
+
+	device.setColors(QList<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 255, 0) << qRgb(255, 0, 0), false);
+	QCOMPARE(receive(receiver), bytes({UdpDevice::Warls, 2, 1, 0, 255, 0}));
+
+	device.setColors(QList<QRgb>() << qRgb(255, 255, 255) << qRgb(0, 255, 0) << qRgb(255, 0, 0), false);
+	QCOMPARE(receive(receiver), bytes({UdpDevice::Warls, 2}));
+}
+
+void LedWireEncoderTest::benchmarkEncode()
+{
+	QList<StructRgb> colors;
+	for (int i = 0; i < MaximumNumberOfLeds::AbsoluteMaximum; ++i)
+		colors << rgb(i & 0xff, (i * 3) & 0xff, (i * 7) & 0xff);
+
+	LedWireEncoder encoder;
+	encoder.setHeader(bytes({'A', 'd', 'a', 0, 0, 0}));
+	encoder.setColorSequence(QStringLiteral("GRB"));
+	encoder.reserve(colors.count());
+
+	QBENCHMARK {
+		encoder.encode(colors);
+	}
+	QCOMPARE(encoder.encode(colors).size(), 6 + colors.count() * 3);
+}
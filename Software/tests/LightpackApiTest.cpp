@@ -33,8 +33,15 @@
 #include "Settings.hpp"
 #include "enums.hpp"
 #include "SettingsWindowMockup.hpp"
+#include "LedDeviceNullSink.hpp"
+#include "ApiBinaryProtocol.hpp"
+#include "ApiUdpStream.hpp"
 
 #include <stdlib.h>
+
+namespace {
+const int SignalWaitTimeoutMs = 1000;
+}
 #include <iostream>
 #include "LightpackApiTest.hpp"
 
@@ -233,6 +240,35 @@ void LightpackApiTest::testCase_GetProfile()
 	QVERIFY(result == cmdProfileCheckResult);
 }
 
+void LightpackApiTest::testCase_GetDeviceStats()
+{
+	LedDeviceNullSink device(QStringLiteral("DRGB"));
+	device.open();
+	for (int i = 0; i < 20; i++)
+		device.setColors(QList<QRgb>() << qRgb(i, 0, 0) << qRgb(0, i, 0) << qRgb(0, 0, i));
+
+	writeCommand(m_socket, ApiServer::CmdGetDeviceStats);
+	QString result = readResult(m_socket);
+	QVERIFY(m_sockReadLineOk);
+	QVERIFY2(result.startsWith(QStringLiteral("%1encoder=DRGB;leds=3;bytes=11;packets=1;frames=20;maxfps=").arg(ApiServer::CmdResultDeviceStats)), qPrintable(result));
+	QVERIFY(result.contains(QStringLiteral(";total=")));
+	QVERIFY(result.endsWith(QStringLiteral("\r\n")));
+
+	writeCommand(m_socket, QByteArray(ApiServer::CmdGetDeviceHistogram).append("total").constData());
+	result = readResult(m_socket);
+	QVERIFY(m_sockReadLineOk);
+	QVERIFY2(result.startsWith(QStringLiteral("%1total:").arg(ApiServer::CmdResultDeviceHistogram)), qPrintable(result));
+
+	// the bucket counts add up to the frames
+	int frames = 0;
+	const QString buckets = result.mid(qstrlen(ApiServer::CmdResultDeviceHistogram) + qstrlen("total:")).trimmed();
+	for (const QString &bucket : buckets.split(';'))
+		frames += bucket.section('-', 1).toInt();
+	QCOMPARE(frames, 20);
+
+	QVERIFY(writeCommandWithCheck(m_socket, QByteArray(ApiServer::CmdGetDeviceHistogram) + "foo", ApiServer::CmdSetResult_Error));
+}
+
 void LightpackApiTest::testCase_Lock()
 {
 	QTcpSocket sockTryLock;
@@ -674,6 +710,253 @@ void LightpackApiTest::testCase_SetStatus()
 	QVERIFY(unlock(m_socket));
 }
 
+void LightpackApiTest::testCase_SetColorAsync()
+{
+	QVERIFY(lock(m_socket));
+
+	QTcpSocket sockOther;
+	sockOther.connectToHost("127.0.0.1", 3636);
+	QVERIFY(checkVersion(&sockOther));
+
+	// setcolors in one write, with a command of the same client right behind them
+	const int setColorsCount = 50;
+	QByteArray commands;
+	for (int i = 0; i < setColorsCount; i++)
+		commands += ApiServer::CmdSetColor + QStringLiteral("1-%1,%1,%1;\n").arg(i).toUtf8();
+	commands += ApiServer::CmdGetStatusAPI;
+	commands += "\n";
+	m_socket->write(commands);
+
+	// nobody else waits for them
+	QVERIFY(writeCommandWithCheck(&sockOther, ApiServer::CmdGetStatusAPI, ApiServer::CmdResultStatusAPI_Busy));
+
+	const QList<QByteArray> results = readResults(m_socket, setColorsCount + 1);
+	QCOMPARE(results.count(), setColorsCount + 1);
+	for (int i = 0; i < setColorsCount; i++)
+		QCOMPARE(results[i], QByteArray(ApiServer::CmdSetResult_Ok));
+	QCOMPARE(results.last(), QByteArray(ApiServer::CmdResultStatusAPI_Busy));
+
+	processEventsFromLittle();
+
+	QCOMPARE(m_little->m_colors[0], qRgb(setColorsCount - 1, setColorsCount - 1, setColorsCount - 1));
+
+	QVERIFY(unlock(m_socket));
+}
+
+void LightpackApiTest::testCase_Pipelining()
+{
+	QVERIFY(lock(m_socket));
+
+	// a mix of commands in one write, the unlock waits behind the last setcolor
+	const int rounds = 100;
+	QByteArray commands;
+	QList<QByteArray> expected;
+	for (int i = 0; i < rounds; i++)
+	{
+		commands += ApiServer::CmdSetBrightness + QByteArray::number(i % 101) + "\n";
+		expected << ApiServer::CmdSetResult_Ok;
+		commands += ApiServer::CmdSetGamma + QByteArray::number(1.0 + i % 3, 'f', 1) + "\n";
+		expected << ApiServer::CmdSetResult_Ok;
+		commands += "\n";
+		commands += ApiServer::CmdSetColor + QStringLiteral("1-%1,%1,%1;\n").arg(i).toUtf8();
+		expected << ApiServer::CmdSetResult_Ok;
+		commands += "nosuchcommand\n";
+		expected << ApiServer::CmdUnknown;
+		commands += QByteArray(ApiServer::CmdGetStatusAPI) + "\n";
+		expected << ApiServer::CmdResultStatusAPI_Busy;
+	}
+	commands += QByteArray(ApiServer::CmdUnlock) + "\n";
+	expected << ApiServer::CmdResultUnlock_Success;
+
+	m_socket->write(commands);
+
+	const QList<QByteArray> results = readResults(m_socket, expected.count());
+	QCOMPARE(results.count(), expected.count());
+	for (int i = 0; i < expected.count(); i++)
+		QCOMPARE(results[i], expected[i]);
+
+	processEventsFromLittle();
+
+	QCOMPARE(m_little->m_brightness, (rounds - 1) % 101);
+	QCOMPARE(m_little->m_gamma, 1.0 + (rounds - 1) % 3);
+	QCOMPARE(m_little->m_colors[0], qRgb(rounds - 1, rounds - 1, rounds - 1));
+}
+
+void LightpackApiTest::testCase_Binary()
+{
+	QVERIFY(lock(m_socket));
+	QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdBinary, ApiServer::CmdResultBinary_Ok));
+
+	// LEDs 2 and 3
+	QByteArray payload;
+	payload.append((char)1).append((char)0);
+	payload.append((char)10).append((char)20).append((char)30);
+	payload.append((char)200).append((char)100).append((char)0);
+	m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeSetColors, payload));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusOk));
+
+	processEventsFromLittle();
+
+	QCOMPARE(m_little->m_colors[1], qRgb(10, 20, 30));
+	QCOMPARE(m_little->m_colors[2], qRgb(200, 100, 0));
+
+	m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeGetColors, QByteArray()));
+	const QByteArray colors = readFrame(m_socket, ApiBinaryProtocol::OpcodeGetColors);
+	QCOMPARE(colors.size(), ApiBinaryProtocol::StartIndexSize + m_interfaceApi->GetColors().count() * ApiBinaryProtocol::BytesPerLed);
+	QCOMPARE(colors.mid(ApiBinaryProtocol::StartIndexSize + ApiBinaryProtocol::BytesPerLed, 6), payload.mid(ApiBinaryProtocol::StartIndexSize));
+
+	m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeGetFps, QByteArray()));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeGetFps).size(), 4);
+
+	// past the last LED, a partial LED and an unknown opcode
+	payload[0] = (char)0xff;
+	m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeSetColors, payload));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusError));
+	m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeSetColors, QByteArray(4, 0)));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusError));
+	m_socket->write(ApiBinaryProtocol::frame(42, QByteArray()));
+	QCOMPARE(readFrame(m_socket, 42), QByteArray(1, ApiBinaryProtocol::StatusUnknown));
+
+	// back to text, the command right behind the frame is already a text one
+	m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeText, QByteArray()) + ApiServer::CmdUnlock + "\n");
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeText), QByteArray(1, ApiBinaryProtocol::StatusOk));
+	QByteArray result = readResult(m_socket);
+	QVERIFY(result == ApiServer::CmdResultUnlock_Success);
+}
+
+void LightpackApiTest::testCase_BinarySetColorsOrder()
+{
+	QVERIFY(lock(m_socket));
+	QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdBinary, ApiServer::CmdResultBinary_Ok));
+
+	// the invalid one is rejected on the spot, its reply still comes after the first one's
+	QByteArray payload(ApiBinaryProtocol::StartIndexSize, 0);
+	payload.append((char)10).append((char)20).append((char)30);
+	const QByteArray valid = ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeSetColors, payload);
+	const QByteArray invalid = ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeSetColors, QByteArray(1, 0));
+	m_socket->write(valid + invalid + valid + invalid);
+
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusOk));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusError));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusOk));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusError));
+
+	m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeText, QByteArray()));
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeText), QByteArray(1, ApiBinaryProtocol::StatusOk));
+	QVERIFY(unlock(m_socket));
+}
+
+void LightpackApiTest::testCase_BinaryNotLocked()
+{
+	QTcpSocket sockLock;
+	sockLock.connectToHost("127.0.0.1", 3636);
+	QVERIFY(checkVersion(&sockLock));
+
+	const QByteArray setColors = ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeSetColors, QByteArray(5, 0));
+
+	QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdBinary, ApiServer::CmdResultBinary_Ok));
+	m_socket->write(setColors);
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusNotLocked));
+
+	QVERIFY(lock(&sockLock));
+	m_socket->write(setColors);
+	QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusBusy));
+	QVERIFY(unlock(&sockLock));
+
+	// a size no SetColors can have ends the connection
+	m_socket->write(QByteArray(ApiBinaryProtocol::HeaderSize, (char)0xff));
+	QVERIFY(m_socket->waitForDisconnected(1000));
+}
+
+void LightpackApiTest::testCase_UdpStream()
+{
+	QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdUdpStream, ApiServer::CmdSetResult_NotLocked));
+
+	QVERIFY(lock(m_socket));
+
+	writeCommand(m_socket, ApiServer::CmdUdpStream);
+	QString result = readResult(m_socket);
+	QVERIFY(m_sockReadLineOk);
+	QVERIFY2(result.startsWith(ApiServer::CmdResultUdpStream), qPrintable(result));
+
+	// "PORT;TOKEN"
+	const QStringList fields = result.mid(qstrlen(ApiServer::CmdResultUdpStream)).trimmed().split(';');
+	QCOMPARE(fields.count(), 2);
+	const quint16 port = fields[0].toUShort();
+	QCOMPARE(port, (quint16)3636);
+	bool ok = false;
+	const quint64 token = fields[1].toULongLong(&ok, 16);
+	QVERIFY(ok);
+
+	// LED 2
+	QByteArray datagram(ApiUdpStream::HeaderSize, 0);
+	qToLittleEndian<quint64>(token, reinterpret_cast<uchar *>(datagram.data()));
+	qToLittleEndian<quint32>(1, reinterpret_cast<uchar *>(datagram.data()) + ApiUdpStream::TokenSize);
+	qToLittleEndian<quint16>(1, reinterpret_cast<uchar *>(datagram.data()) + ApiUdpStream::TokenSize + ApiUdpStream::SequenceSize);
+	datagram.append((char)10).append((char)20).append((char)30);
+
+	QUdpSocket sender;
+	sender.writeDatagram(datagram, QHostAddress::LocalHost, port);
+
+	processEventsFromLittle();
+
+	QCOMPARE(m_little->m_colors[1], qRgb(10, 20, 30));
+
+	QVERIFY(unlock(m_socket));
+}
+
+void LightpackApiTest::benchmark_SetColor_data()
+{
+	QTest::addColumn<bool>("isBinary");
+
+	QTest::newRow("text") << false;
+	QTest::newRow("binary") << true;
+}
+
+void LightpackApiTest::benchmark_SetColor()
+{
+	// the whole round trip, ApiServerSetColorTaskTest::benchmarkSetColorsTask() times the server side
+	QFETCH(bool, isBinary);
+
+	const int ledsCount = MaximumNumberOfLeds::AbsoluteMaximum;
+	emit m_apiServer->updateApiDeviceNumberOfLeds(ledsCount);
+
+	QVERIFY(lock(m_socket));
+
+	QByteArray command;
+	if (isBinary)
+	{
+		QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdBinary, ApiServer::CmdResultBinary_Ok));
+
+		QByteArray payload(ApiBinaryProtocol::StartIndexSize, 0);
+		for (int i = 0; i < ledsCount; i++)
+			payload.append((char)i).append((char)(255 - i % 256)).append((char)(i * 7));
+		command = ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeSetColors, payload);
+	} else {
+		command = ApiServer::CmdSetColor;
+		for (int i = 0; i < ledsCount; i++)
+			command += QStringLiteral("%1-%2,%3,%4;").arg(i + 1).arg(i % 256).arg(255 - i % 256).arg(i * 7 % 256).toUtf8();
+		command += "\n";
+	}
+
+	QBENCHMARK {
+		m_socket->write(command);
+		if (isBinary)
+			QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeSetColors), QByteArray(1, ApiBinaryProtocol::StatusOk));
+		else
+			QCOMPARE(readResult(m_socket), QByteArray(ApiServer::CmdSetResult_Ok));
+	}
+
+	if (isBinary)
+	{
+		m_socket->write(ApiBinaryProtocol::frame(ApiBinaryProtocol::OpcodeText, QByteArray()));
+		QCOMPARE(readFrame(m_socket, ApiBinaryProtocol::OpcodeText), QByteArray(1, ApiBinaryProtocol::StatusOk));
+	}
+	QVERIFY(unlock(m_socket));
+
+	emit m_apiServer->updateApiDeviceNumberOfLeds(Settings::getNumberOfLeds(Settings::getConnectedDevice()));
+}
+
 void LightpackApiTest::testCase_ApiAuthorization()
 {
 	QString testKey = "test-key";
@@ -704,6 +987,18 @@ QByteArray LightpackApiTest::readResult(QTcpSocket * socket)
 	return socket->readLine();
 }
 
+QList<QByteArray> LightpackApiTest::readResults(QTcpSocket * socket, int count)
+{
+	QList<QByteArray> results;
+	while (results.count() < count
+		   && (socket->canReadLine() || socket->waitForReadyRead(1000)))
+	{
+		while (socket->canReadLine())
+			results.append(socket->readLine());
+	}
+	return results;
+}
+
 void LightpackApiTest::writeCommand(QTcpSocket * socket, const char * cmd)
 {
 	socket->write(cmd);
@@ -718,6 +1013,22 @@ bool LightpackApiTest::writeCommandWithCheck(QTcpSocket * socket, const QByteArr
 	return (m_sockReadLineOk && read == result);
 }
 
+QByteArray LightpackApiTest::readFrame(QTcpSocket * socket, quint8 opcode)
+{
+	quint8 readOpcode = 0;
+	QByteArray payload;
+	bool isMalformed = false;
+
+	while (!ApiBinaryProtocol::readFrame(socket, &readOpcode, &payload, &isMalformed))
+	{
+		if (isMalformed || !socket->waitForReadyRead(1000))
+			return QByteArray("no frame");
+	}
+	if (readOpcode != opcode)
+		return QByteArray("wrong opcode");
+	return payload;
+}
+
 QString LightpackApiTest::getProfilesResultString()
 {
 	QStringList profiles = Settings::findAllProfiles();
@@ -735,9 +1046,9 @@ void LightpackApiTest::processEventsFromLittle()
 	timer.start();
 	m_little->m_isDone = false;
 
-	while (m_little->m_isDone == false && timer.elapsed() < ApiServer::SignalWaitTimeoutMs)
+	while (m_little->m_isDone == false && timer.elapsed() < SignalWaitTimeoutMs)
 	{
-		QApplication::processEvents(QEventLoop::WaitForMoreEvents, ApiServer::SignalWaitTimeoutMs);
+		QApplication::processEvents(QEventLoop::WaitForMoreEvents, SignalWaitTimeoutMs);
 	}
 }
 
@@ -40,6 +40,7 @@ private Q_SLOTS:
 	void testCase_GetStatusAPI();
 	void testCase_GetProfiles();
 	void testCase_GetProfile();
+	void testCase_GetDeviceStats();
 
 	void testCase_Lock();
 	void testCase_Unlock();
@@ -69,11 +70,23 @@ private Q_SLOTS:
 
 	void testCase_SetProfile();
 	void testCase_SetStatus();
+	void testCase_SetColorAsync();
+	void testCase_Pipelining();
 
+	void testCase_Binary();
+	void testCase_BinarySetColorsOrder();
+	void testCase_BinaryNotLocked();
+	void testCase_UdpStream();
+
+	void benchmark_SetColor();
+	void benchmark_SetColor_data();
+
+	// sets an api key, keep it last
 	void testCase_ApiAuthorization();
 
 private:
 	QByteArray readResult(QTcpSocket * socket);
+	QList<QByteArray> readResults(QTcpSocket * socket, int count);
 	void writeCommand(QTcpSocket * socket, const char * cmd);
 	bool writeCommandWithCheck(QTcpSocket * socket, const QByteArray & command, const QByteArray & result);
 
@@ -84,6 +97,7 @@ private:
 	bool lock(QTcpSocket * socket);
 	bool unlock(QTcpSocket * socket);
 	bool setGamma(QTcpSocket * socket, QString gammaStr);
+	QByteArray readFrame(QTcpSocket * socket, quint8 opcode);
 
 private:
 	ApiServer *m_apiServer;
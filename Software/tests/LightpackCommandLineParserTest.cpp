@@ -102,3 +102,20 @@ void LightpackCommandLineParserTest::testCase_parseDebuglevel()
 		QCOMPARE(parser.debugLevel(), levelValues[i]);
 	}
 }
+
+void LightpackCommandLineParserTest::testCase_parseReplay()
+{
+	LightpackCommandLineParser parser;
+	QVERIFY(parser.parse(QStringList() << "app.binary" << "--replay" << "movie.prec"));
+	QVERIFY(parser.isSetReplay());
+	QCOMPARE(parser.replayPath(), QString("movie.prec"));
+	QCOMPARE(parser.replaySpeed(), 1.0);
+
+	LightpackCommandLineParser fastParser;
+	QVERIFY(fastParser.parse(QStringList() << "app.binary" << "--replay=movie.prec" << "--replay-speed=0"));
+	QCOMPARE(fastParser.replaySpeed(), 0.0);
+
+	LightpackCommandLineParser badParser;
+	QVERIFY(!badParser.parse(QStringList() << "app.binary" << "--replay=movie.prec" << "--replay-speed=fast"));
+	QVERIFY(!badParser.errorText().isEmpty());
+}
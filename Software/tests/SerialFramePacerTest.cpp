@@ -0,0 +1,272 @@
+/*
+ * SerialFramePacerTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+
+#include "SerialFramePacerTest.hpp"
+#include "SerialFramePacer.hpp"
+
+namespace {
+const qint64 Ms = 1000000;
+}
+
+void SerialFramePacerTest::testLineTime()
+{
+	// 300 LEDs as a classic Adalight frame at 115200 8N1
+	QCOMPARE(SerialFramePacer::lineTimeNs(906, 115200), 906LL * 10 * 1000000000 / 115200);
+	QCOMPARE(SerialFramePacer::lineTimeNs(100, 1000000), 1 * Ms);
+}
+
+void SerialFramePacerTest::testDropsWhileLineBusy()
+{
+	SerialFramePacer pacer;
+	pacer.setBaudRate(1000000);
+	QVERIFY(pacer.isReady(0));
+
+	pacer.frameWritten(1000, 5 * Ms);
+	QCOMPARE(pacer.waitNs(5 * Ms), 10 * Ms);
+	QCOMPARE(pacer.waitNs(12 * Ms), 3 * Ms);
+	QVERIFY(pacer.isReady(15 * Ms));
+
+	// a forced write queues behind the frame on the line
+	pacer.frameWritten(1000, 6 * Ms);
+	QCOMPARE(pacer.waitNs(6 * Ms), 19 * Ms);
+
+	pacer.reset();
+	QVERIFY(pacer.isReady(6 * Ms));
+}
+
+void SerialFramePacerTest::testAck()
+{
+	SerialFramePacer pacer;
+	pacer.setBaudRate(1000000);
+	pacer.setAckEnabled(true);
+
+	pacer.frameWritten(1000, 0);
+	QVERIFY(pacer.isAwaitingAck());
+	QVERIFY(!pacer.isReady(11 * Ms));
+
+	pacer.ackReceived();
+	QVERIFY(!pacer.isAwaitingAck());
+	QVERIFY(pacer.isReady(11 * Ms));
+
+	// a slow controller holds the line past the wire time
+	pacer.frameWritten(1000, 20 * Ms);
+	QVERIFY(!pacer.isReady(50 * Ms));
+	pacer.ackReceived();
+	QVERIFY(pacer.isReady(50 * Ms));
+}
+
+void SerialFramePacerTest::testAckTimeout()
+{
+	SerialFramePacer pacer;
+	pacer.setBaudRate(1000000);
+	pacer.setAckEnabled(true);
+	pacer.setAckTimeout(40);
+
+	pacer.frameWritten(1000, 0);
+	QCOMPARE(pacer.waitNs(0), 50 * Ms);
+	QVERIFY(pacer.isReady(50 * Ms));
+
+	pacer.setAckEnabled(false);
+	pacer.frameWritten(1000, 50 * Ms);
+	QVERIFY(!pacer.isAwaitingAck());
+	QVERIFY(pacer.isReady(60 * Ms));
+}
+
+void SerialFramePacerTest::testOfferFrame()
+{
+	SerialFramePacer pacer;
+	pacer.setBaudRate(1000000);
+
+	// nothing written yet, a stale port buffer doesn't hold the first frame
+	QCOMPARE(pacer.offerFrame(0, 100), 0);
+	pacer.frameWritten(1000, 0);
+	QVERIFY(!pacer.isFrameDeferred());
+
+	// the line is busy for 10 ms, the timer is rounded up
+	QCOMPARE(pacer.offerFrame(2500000, 0), 8);
+	QVERIFY(pacer.isFrameDeferred());
+
+	// line time is over but the port still buffers: wait for bytesWritten() instead of polling
+	QCOMPARE(pacer.offerFrame(10 * Ms, 50), (int)SerialFramePacer::RetryOnBytesWritten);
+	QVERIFY(pacer.isFrameDeferred());
+
+	QCOMPARE(pacer.offerFrame(10 * Ms, 0), 0);
+	pacer.frameWritten(1000, 10 * Ms);
+	QVERIFY(!pacer.isFrameDeferred());
+
+	// a forced write after reset() ignores the port buffer
+	QVERIFY(pacer.offerFrame(11 * Ms, 50) > 0);
+	pacer.reset();
+	QVERIFY(!pacer.isFrameDeferred());
+	QCOMPARE(pacer.offerFrame(11 * Ms, 50), 0);
+}
+
+#ifdef Q_OS_UNIX
+namespace {
+const int BaudRate = 115200;
+// 60 LEDs with a classic Adalight header
+const int FrameSize = 6 + 60 * 3;
+const int OfferIntervalMs = 2;
+const int RunMs = 600;
+
+struct PtyRun
+{
+	int offered = 0;
+	int written = 0;
+	int received = 0;
+	qint64 maxLatencyNs = 0;
+};
+
+/*
+	Offers a frame every OfferIntervalMs to the slave side of a pty and reads the
+	master side no faster than a UART at BaudRate would deliver it.
+	Without a pacer every frame is written.
+*/
+bool runThrottledPty(SerialFramePacer *pacer, PtyRun &run)
+{
+	const int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+		return false;
+	const int slave = ::open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (slave < 0) {
+		::close(master);
+		return false;
+	}
+	termios tio;
+	tcgetattr(slave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+
+	// frames start with 0xff and a 14 bit sequence number, the rest is never 0xff
+	QByteArray frame(FrameSize, 0);
+	frame[0] = (char)0xff;
+	QVector<qint64> writtenAt(1 << 14, 0);
+	QByteArray outgoing;
+
+	QElapsedTimer clock;
+	clock.start();
+	qint64 nextOfferNs = 0;
+	qint64 lastNs = 0;
+	double credit = 0;
+	int position = 0;
+	int sequence = 0;
+	bool ok = true;
+
+	while (ok && clock.nsecsElapsed() < RunMs * Ms) {
+		const qint64 nowNs = clock.nsecsElapsed();
+
+		if (nowNs >= nextOfferNs) {
+			nextOfferNs += OfferIntervalMs * Ms;
+			++run.offered;
+			if (pacer == nullptr || pacer->isReady(nowNs)) {
+				frame[1] = (char)((run.written >> 7) & 0x7f);
+				frame[2] = (char)(run.written & 0x7f);
+				writtenAt[run.written & 0x3fff] = nowNs;
+				++run.written;
+				outgoing.append(frame);
+				if (pacer)
+					pacer->frameWritten(frame.size(), nowNs);
+			}
+		}
+
+		// like QSerialPort, keep what the OS does not take yet
+		if (!outgoing.isEmpty()) {
+			const ssize_t bytes = ::write(slave, outgoing.constData(), outgoing.size());
+			if (bytes > 0)
+				outgoing.remove(0, (int)bytes);
+			else if (bytes < 0 && errno != EAGAIN)
+				ok = false;
+		}
+
+		// the wire only moves bytes while there is something to send
+		pollfd fd = { master, POLLIN, 0 };
+		if (poll(&fd, 1, 0) == 1) {
+			credit += (nowNs - lastNs) * (BaudRate / 10.0) / 1e9;
+			char buffer[64];
+			const int budget = qMin((int)credit, (int)sizeof(buffer));
+			const ssize_t received = budget > 0 ? ::read(master, buffer, budget) : 0;
+			for (ssize_t i = 0; i < received; ++i) {
+				if (position == 0 && (unsigned char)buffer[i] != 0xff) {
+					ok = false;
+					break;
+				}
+				if (position == 1)
+					sequence = buffer[i] << 7;
+				else if (position == 2)
+					sequence |= buffer[i];
+				if (++position == FrameSize) {
+					position = 0;
+					++run.received;
+					run.maxLatencyNs = qMax(run.maxLatencyNs, nowNs - writtenAt[sequence]);
+				}
+			}
+			credit -= qMax<ssize_t>(0, received);
+		} else {
+			credit = 0;
+		}
+		lastNs = nowNs;
+		usleep(200);
+	}
+
+	::close(slave);
+	::close(master);
+	return ok;
+}
+}
+#endif
+
+void SerialFramePacerTest::testThrottledPty()
+{
+#ifdef Q_OS_UNIX
+	const qint64 lineTimeNs = SerialFramePacer::lineTimeNs(FrameSize, BaudRate);
+
+	SerialFramePacer pacer;
+	pacer.setBaudRate(BaudRate);
+	PtyRun paced;
+	QVERIFY(runThrottledPty(&pacer, paced));
+
+	// intermediate frames are dropped and the line stays busy
+	QVERIFY(paced.written < paced.offered / 4);
+	QVERIFY2(paced.written > RunMs * Ms / lineTimeNs * 3 / 4, qPrintable(QString::number(paced.written)));
+	QVERIFY(paced.received >= paced.written - 1);
+	// one frame deep: a frame is read right after the one before it
+	QVERIFY2(paced.maxLatencyNs < lineTimeNs * 2 + 5 * Ms, qPrintable(QString::number(paced.maxLatencyNs / Ms)));
+
+	// for reference, writing every frame queues them up in the OS buffer
+	PtyRun unpaced;
+	QVERIFY(runThrottledPty(nullptr, unpaced));
+	QVERIFY2(unpaced.maxLatencyNs > lineTimeNs * 4, qPrintable(QString::number(unpaced.maxLatencyNs / Ms)));
+#else
+	QSKIP("needs a pty");
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * TemporalSmootherTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TemporalSmootherTest.hpp"
+#include "TemporalSmoother.hpp"
+
+namespace {
+QList<QRgb> frame(int count, QRgb color)
+{
+	QList<QRgb> result;
+	for (int i = 0; i < count; ++i)
+		result << color;
+	return result;
+}
+}
+
+void TemporalSmootherTest::testFirstFrameIsImmediate()
+{
+	TemporalSmoother smoother;
+	smoother.setTimeConstant(100);
+	smoother.setOutputRate(100);
+
+	QList<QRgb> colors;
+	smoother.setTarget(frame(20, qRgb(10, 20, 30)));
+	QVERIFY(!smoother.step(colors));
+	QCOMPARE(colors, frame(20, qRgb(10, 20, 30)));
+}
+
+void TemporalSmootherTest::testConvergesWithoutOvershoot()
+{
+	TemporalSmoother smoother;
+	smoother.setTimeConstant(50);
+	smoother.setOutputRate(100);
+
+	// odd count covers both the vector body and the scalar tail
+	QList<QRgb> colors;
+	smoother.setTarget(frame(13, qRgb(0, 255, 100)));
+	smoother.step(colors);
+	smoother.setTarget(frame(13, qRgb(255, 0, 101)));
+
+	int steps = 0;
+	int lastRed = 0;
+	while (smoother.step(colors)) {
+		QVERIFY(++steps < 1000);
+		QVERIFY(qRed(colors[12]) >= lastRed);
+		QVERIFY(qGreen(colors[12]) <= 255);
+		lastRed = qRed(colors[12]);
+	}
+	QCOMPARE(colors, frame(13, qRgb(255, 0, 101)));
+}
+
+void TemporalSmootherTest::testTimeConstant()
+{
+	TemporalSmoother smoother;
+	smoother.setTimeConstant(100);
+	smoother.setOutputRate(100);
+
+	QList<QRgb> colors;
+	smoother.setTarget(frame(8, qRgb(0, 0, 0)));
+	smoother.step(colors);
+	smoother.setTarget(frame(8, qRgb(200, 200, 200)));
+
+	// after one time constant ~63% of the way
+	for (int i = 0; i < 10; ++i)
+		smoother.step(colors);
+	QVERIFY(qAbs(qRed(colors[0]) - 126) <= 3);
+}
@@ -7,6 +7,26 @@
 #include "HooksTest.h"
 #endif
 #include "LightpackCommandLineParserTest.hpp"
+#include "GrabRateGovernorTest.hpp"
+#include "TemporalSmootherTest.hpp"
+#include "LedDeviceRouterTest.hpp"
+#include "FrameMailboxTest.hpp"
+#include "LedDeviceCommandQueueTest.hpp"
+#include "LedWireEncoderTest.hpp"
+#include "AdalightDeltaCodecTest.hpp"
+#include "SerialFramePacerTest.hpp"
+#include "UdpBatchSenderTest.hpp"
+#include "LedDeviceDdpTest.hpp"
+#include "LedDeviceDmxTest.hpp"
+#include "LedDeviceAdaptiveUdpTest.hpp"
+#include "HidReportWriterTest.hpp"
+#include "FrameRecordingTest.hpp"
+#include "LedDeviceNullSinkTest.hpp"
+#include "ApiServerSetColorTaskTest.hpp"
+#include "ApiUdpStreamTest.hpp"
+#ifdef Q_OS_UNIX
+#include "LedFrameRingTest.hpp"
+#endif
 #include "debug.h"
 
 #include <iostream>
@@ -33,6 +53,26 @@ int main(int argc, char *argv[])
 	tests.append(new LightpackApiTest());
 	tests.append(new AppVersionTest());
 	tests.append(new LightpackCommandLineParserTest());
+	tests.append(new GrabRateGovernorTest());
+	tests.append(new TemporalSmootherTest());
+	tests.append(new LedDeviceRouterTest());
+	tests.append(new FrameMailboxTest());
+	tests.append(new LedDeviceCommandQueueTest());
+	tests.append(new LedWireEncoderTest());
+	tests.append(new AdalightDeltaCodecTest());
+	tests.append(new SerialFramePacerTest());
+	tests.append(new UdpBatchSenderTest());
+	tests.append(new LedDeviceDdpTest());
+	tests.append(new LedDeviceDmxTest());
+	tests.append(new LedDeviceAdaptiveUdpTest());
+	tests.append(new HidReportWriterTest());
+	tests.append(new FrameRecordingTest());
+	tests.append(new LedDeviceNullSinkTest());
+	tests.append(new ApiServerSetColorTaskTest());
+	tests.append(new ApiUdpStreamTest());
+#ifdef Q_OS_UNIX
+	tests.append(new LedFrameRingTest());
+#endif
 
 	for(int i=0; i < tests.size(); i++) {
 		if (QTest::qExec(tests[i], argc, argv)) {
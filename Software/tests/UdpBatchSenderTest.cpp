@@ -0,0 +1,182 @@
+/*
+ * UdpBatchSenderTest.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QUdpSocket>
+
+#include "UdpBatchSenderTest.hpp"
+#include "LedDeviceTestUtils.hpp"
+#include "UdpBatchSender.hpp"
+#include "LedDeviceDnrgb.hpp"
+#include "enums.hpp"
+
+namespace {
+// a full DNRGB packet: header, start index, 489 LEDs
+const int PacketSize = 4 + 489 * 3;
+const int FramePackets = 4;
+
+QByteArray receive(QUdpSocket &receiver)
+{
+	if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(1000))
+		return QByteArray();
+	QByteArray datagram(receiver.pendingDatagramSize(), 0);
+	receiver.readDatagram(datagram.data(), datagram.size());
+	return datagram;
+}
+
+QByteArray packet(int index, int size)
+{
+	QByteArray result(size, (char)index);
+	result[0] = (char)0xa0;
+	return result;
+}
+
+class DnrgbProbe : public LedDeviceDnrgb
+{
+public:
+	DnrgbProbe(const QString& port) : LedDeviceDnrgb(QStringLiteral("127.0.0.1"), port, 2) {}
+	int systemCalls() const { return m_batchSender.systemCalls(); }
+};
+}
+
+void UdpBatchSenderTest::testOneSystemCall()
+{
+	if (!UdpBatchSender::isSupported())
+		QSKIP("needs sendmmsg");
+
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+	QUdpSocket socket;
+	socket.connectToHost(QHostAddress::LocalHost, receiver.localPort(), QIODevice::WriteOnly);
+	QCOMPARE(socket.state(), QAbstractSocket::ConnectedState);
+
+	UdpBatchSender sender;
+	sender.setSocketDescriptor(socket.socketDescriptor());
+	sender.reserve(FramePackets, PacketSize);
+	// packets of different sizes can't be segmented, they still go in one call
+	for (int i = 0; i < FramePackets; ++i)
+		sender.append(packet(i, PacketSize - i * 100));
+	QCOMPARE(sender.count(), FramePackets);
+	QVERIFY(sender.send());
+	QCOMPARE(sender.systemCalls(), 1);
+	QCOMPARE(sender.count(), 0);
+
+	for (int i = 0; i < FramePackets; ++i)
+		QCOMPARE(receive(receiver), packet(i, PacketSize - i * 100));
+}
+
+void UdpBatchSenderTest::testSegmentationOffload()
+{
+	if (!UdpBatchSender::isSupported())
+		QSKIP("needs sendmmsg");
+
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+	QUdpSocket socket;
+	socket.connectToHost(QHostAddress::LocalHost, receiver.localPort(), QIODevice::WriteOnly);
+
+	UdpBatchSender sender;
+	sender.setSocketDescriptor(socket.socketDescriptor());
+	sender.setGsoEnabled(true);
+	for (int i = 0; i < FramePackets - 1; ++i)
+		sender.append(packet(i, PacketSize));
+	sender.append(packet(FramePackets - 1, 40));
+	QVERIFY(sender.send());
+	// kernels without UDP_SEGMENT fall back to sendmmsg
+	QCOMPARE(sender.systemCalls(), sender.isGsoEnabled() ? 1 : 2);
+
+	// the receiver can't tell the difference
+	for (int i = 0; i < FramePackets - 1; ++i)
+		QCOMPARE(receive(receiver), packet(i, PacketSize));
+	QCOMPARE(receive(receiver), packet(FramePackets - 1, 40));
+}
+
+void UdpBatchSenderTest::testDnrgbFrame()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+	DnrgbProbe device(QString::number(receiver.localPort()));
+	setExactColors(&device);
+	device.open();
+
+	QList<QRgb> colors;
+	for (int i = 0; i < MaximumNumberOfLeds::Dnrgb; ++i)
+		colors << qRgb(255, 0, 0);
+	device.setColors(colors, false);
+
+	int leds = 0;
+	for (int i = 0; i < FramePackets; ++i) {
+		const QByteArray datagram = receive(receiver);
+		QVERIFY(datagram.size() > 4);
+		QCOMPARE((int)(quint8)datagram[0], (int)UdpDevice::Dnrgb);
+		QCOMPARE(((quint8)datagram[2] << 8) | (quint8)datagram[3], leds);
+		leds += (datagram.size() - 4) / 3;
+	}
+	QCOMPARE(leds, MaximumNumberOfLeds::Dnrgb);
+	QVERIFY(!receiver.hasPendingDatagrams());
+	if (UdpBatchSender::isSupported())
+		QVERIFY(device.systemCalls() <= 2);
+}
+
+void UdpBatchSenderTest::benchmarkPacketByPacket()
+{
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+	QUdpSocket socket;
+	socket.connectToHost(QHostAddress::LocalHost, receiver.localPort(), QIODevice::WriteOnly);
+
+	QList<QByteArray> frame;
+	for (int i = 0; i < FramePackets; ++i)
+		frame << packet(i, PacketSize);
+
+	QBENCHMARK {
+		for (const QByteArray &buffer : frame)
+			socket.write(buffer);
+	}
+}
+
+void UdpBatchSenderTest::benchmarkBatched()
+{
+	if (!UdpBatchSender::isSupported())
+		QSKIP("needs sendmmsg");
+
+	QUdpSocket receiver;
+	QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+	QUdpSocket socket;
+	socket.connectToHost(QHostAddress::LocalHost, receiver.localPort(), QIODevice::WriteOnly);
+
+	QList<QByteArray> frame;
+	for (int i = 0; i < FramePackets; ++i)
+		frame << packet(i, PacketSize);
+
+	UdpBatchSender sender;
+	sender.setSocketDescriptor(socket.socketDescriptor());
+	sender.reserve(FramePackets, PacketSize);
+	int frames = 0;
+	QBENCHMARK {
+		for (const QByteArray &buffer : frame)
+			sender.append(buffer);
+		sender.send();
+		++frames;
+	}
+	QCOMPARE(sender.systemCalls(), frames);
+}
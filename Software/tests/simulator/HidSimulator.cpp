@@ -0,0 +1,214 @@
+/*
+ * HidSimulator.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QSocketNotifier>
+#include <QtAlgorithms>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <linux/uhid.h>
+
+#include "HidSimulator.hpp"
+#include "SimulatorStats.hpp"
+
+#include "../../../CommonHeaders/COMMANDS.h"
+#include "../../../CommonHeaders/USB_ID.h"
+
+namespace {
+// vendor defined, a 64 byte input and a 64 byte output report without report ids
+const quint8 ReportDescriptor[] = {
+	0x06, 0x00, 0xff,       // Usage Page (Vendor Defined 0xFF00)
+	0x09, 0x01,             // Usage (1)
+	0xa1, 0x01,             // Collection (Application)
+	0x09, 0x02,             //   Usage (2)
+	0x15, 0x00,             //   Logical Minimum (0)
+	0x26, 0xff, 0x00,       //   Logical Maximum (255)
+	0x75, 0x08,             //   Report Size (8)
+	0x95, 0x40,             //   Report Count (64)
+	0x81, 0x02,             //   Input (Data, Variable, Absolute)
+	0x09, 0x03,             //   Usage (3)
+	0x15, 0x00,             //   Logical Minimum (0)
+	0x26, 0xff, 0x00,       //   Logical Maximum (255)
+	0x75, 0x08,             //   Report Size (8)
+	0x95, 0x40,             //   Report Count (64)
+	0x91, 0x02,             //   Output (Data, Variable, Absolute)
+	0xc0                    // End Collection
+};
+
+bool writeEvent(int fd, const struct uhid_event &event)
+{
+	return ::write(fd, &event, sizeof(event)) == (ssize_t)sizeof(event);
+}
+}
+
+HidSimulator::HidSimulator(int devicesCount, SimulatorStats &stats, const Faults &faults, QObject *parent)
+	: Simulator(stats, faults, parent)
+	, m_devicesCount(qBound(1, devicesCount, 64))
+{
+}
+
+HidSimulator::~HidSimulator()
+{
+	for (const int fd : m_fds) {
+		struct uhid_event event;
+		memset(&event, 0, sizeof(event));
+		event.type = UHID_DESTROY;
+		writeEvent(fd, event);
+		::close(fd);
+	}
+}
+
+bool HidSimulator::start(QString *error)
+{
+	for (int device = 0; device < m_devicesCount; device++) {
+		if (!create(device, error))
+			return false;
+	}
+	printf("devices=%d\n", m_devicesCount);
+	fflush(stdout);
+	return true;
+}
+
+bool HidSimulator::create(int device, QString *error)
+{
+	const int fd = ::open("/dev/uhid", O_RDWR | O_CLOEXEC | O_NONBLOCK);
+	if (fd < 0) {
+		*error = QStringLiteral("can't open /dev/uhid: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+		return false;
+	}
+	m_fds.append(fd);
+
+	struct uhid_event event;
+	memset(&event, 0, sizeof(event));
+	event.type = UHID_CREATE2;
+	snprintf(reinterpret_cast<char *>(event.u.create2.name), sizeof(event.u.create2.name), "%s", USB_PRODUCT_STRING);
+	snprintf(reinterpret_cast<char *>(event.u.create2.phys), sizeof(event.u.create2.phys), "lightpack-simulator/%d", device);
+	// hidapi tells the Lightpacks apart by serial number
+	snprintf(reinterpret_cast<char *>(event.u.create2.uniq), sizeof(event.u.create2.uniq), "SIM%04d", device);
+	event.u.create2.rd_size = sizeof(ReportDescriptor);
+	memcpy(event.u.create2.rd_data, ReportDescriptor, sizeof(ReportDescriptor));
+	event.u.create2.bus = BUS_USB;
+	event.u.create2.vendor = USB_VENDOR_ID;
+	event.u.create2.product = USB_PRODUCT_ID;
+	if (!writeEvent(fd, event)) {
+		*error = QStringLiteral("can't create uhid device %1: %2").arg(device).arg(QString::fromLocal8Bit(strerror(errno)));
+		return false;
+	}
+
+	QSocketNotifier *notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+	connect(notifier, &QSocketNotifier::activated, this, [this, fd]() { readEvent(fd); });
+	m_notifiers.append(notifier);
+	return true;
+}
+
+void HidSimulator::readEvent(int fd)
+{
+	struct uhid_event event;
+	const ssize_t bytes = ::read(fd, &event, sizeof(event));
+	if (bytes <= 0)
+		return;
+
+	const int device = m_fds.indexOf(fd);
+	struct uhid_event reply;
+	memset(&reply, 0, sizeof(reply));
+	switch (event.type) {
+	case UHID_OPEN:
+		// what the firmware reports without being asked
+		sendVersion(fd);
+		break;
+	case UHID_OUTPUT:
+		processingDelay();
+		handleReport(device, event.u.output.data, event.u.output.size);
+		break;
+	case UHID_SET_REPORT:
+		processingDelay();
+		handleReport(device, event.u.set_report.data, event.u.set_report.size);
+		reply.type = UHID_SET_REPORT_REPLY;
+		reply.u.set_report_reply.id = event.u.set_report.id;
+		writeEvent(fd, reply);
+		break;
+	case UHID_GET_REPORT:
+		reply.type = UHID_GET_REPORT_REPLY;
+		reply.u.get_report_reply.id = event.u.get_report.id;
+		reply.u.get_report_reply.size = ReportSize;
+		reply.u.get_report_reply.data[INDEX_FW_VER_MAJOR] = FirmwareMajor;
+		reply.u.get_report_reply.data[INDEX_FW_VER_MINOR] = FirmwareMinor;
+		writeEvent(fd, reply);
+		break;
+	default:
+		break;
+	}
+}
+
+void HidSimulator::handleReport(int device, const quint8 *data, int size)
+{
+	// hidraw passes the report id 0 of a device without numbered reports
+	if (size == ReportSize + 1) {
+		data++;
+		size--;
+	}
+	m_stats.bytesReceived(size);
+	if (size < 1 || device < 0) {
+		m_stats.frameRejected();
+		return;
+	}
+	if (data[0] != CMD_UPDATE_LEDS)
+		return;
+
+	const qint64 nowNs = m_stats.nowNs();
+	const quint64 bit = Q_UINT64_C(1) << device;
+	// this device is a frame ahead, the last one did not reach every device
+	if (m_frameDevices & bit)
+		endFrame(m_frameLastNs);
+
+	if (m_frameDevices == 0)
+		m_frameFirstNs = nowNs;
+	m_frameLastNs = nowNs;
+	m_frameDevices |= bit;
+
+	const quint64 allDevices = m_devicesCount == 64 ? ~Q_UINT64_C(0) : (Q_UINT64_C(1) << m_devicesCount) - 1;
+	if (m_frameDevices == allDevices) {
+		m_stats.skewMeasured(m_frameLastNs - m_frameFirstNs);
+		endFrame(m_frameLastNs);
+	}
+}
+
+void HidSimulator::endFrame(qint64 atNs)
+{
+	frameDone(qPopulationCount(m_frameDevices) * LedsPerDevice, atNs);
+	m_frameDevices = 0;
+}
+
+void HidSimulator::sendVersion(int fd)
+{
+	struct uhid_event event;
+	memset(&event, 0, sizeof(event));
+	event.type = UHID_INPUT2;
+	event.u.input2.size = ReportSize;
+	event.u.input2.data[INDEX_FW_VER_MAJOR] = FirmwareMajor;
+	event.u.input2.data[INDEX_FW_VER_MINOR] = FirmwareMinor;
+	writeEvent(fd, event);
+}
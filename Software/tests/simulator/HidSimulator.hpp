@@ -0,0 +1,69 @@
+/*
+ * HidSimulator.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QList>
+#include "Simulator.hpp"
+
+class QSocketNotifier;
+
+/*!
+	Lightpacks made with Linux uhid: each one is a HID device with the VID, PID and the
+	64 byte reports of the firmware, visible to hidapi's hidraw backend (Prismatik built
+	with CONFIG+=hidraw). Several devices are chained like the Lightpacks of a large
+	setup, a frame is complete when each of them got its CMD_UPDATE_LEDS report and
+	the time between the first and the last report is the skew.
+	Opening /dev/uhid usually requires root.
+*/
+class HidSimulator : public Simulator
+{
+	Q_OBJECT
+public:
+	HidSimulator(int devicesCount, SimulatorStats &stats, const Faults &faults, QObject *parent = 0);
+	~HidSimulator();
+
+	bool start(QString *error);
+
+	constexpr static const int LedsPerDevice = 10;
+	constexpr static const int ReportSize = 64;
+	constexpr static const quint8 FirmwareMajor = 7;
+	constexpr static const quint8 FirmwareMinor = 5;
+
+private slots:
+	void readEvent(int fd);
+
+private:
+	bool create(int device, QString *error);
+	void handleReport(int device, const quint8 *data, int size);
+	void sendVersion(int fd);
+	void endFrame(qint64 atNs);
+
+	const int m_devicesCount;
+	QList<int> m_fds;
+	QList<QSocketNotifier *> m_notifiers;
+	// devices whose report of the current frame arrived, and when the first and last came
+	quint64 m_frameDevices{0};
+	qint64 m_frameFirstNs{-1};
+	qint64 m_frameLastNs{-1};
+};
@@ -0,0 +1,188 @@
+/*
+ * SerialSimulator.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QDebug>
+#include <QFile>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "SerialSimulator.hpp"
+#include "SimulatorStats.hpp"
+
+namespace {
+const int ReadChunk = 4096;
+// start, 8 data and stop bits
+const int BitsPerByte = 10;
+// the line credit does not pile up beyond a UART FIFO worth of bytes
+const double MaxLineCredit = 64;
+const char AckByte = 'A';
+}
+
+SerialSimulator::SerialSimulator(Protocol protocol, int ledsCount, const QString &linkPath, SimulatorStats &stats, const Faults &faults, QObject *parent)
+	: Simulator(stats, faults, parent)
+	, m_protocol(protocol)
+	, m_ledsCount(ledsCount)
+	, m_linkPath(linkPath)
+{
+}
+
+SerialSimulator::~SerialSimulator()
+{
+	if (!m_linkPath.isEmpty())
+		QFile::remove(m_linkPath);
+	if (m_slave >= 0)
+		::close(m_slave);
+	if (m_master >= 0)
+		::close(m_master);
+}
+
+bool SerialSimulator::start(QString *error)
+{
+	m_master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0) {
+		*error = QStringLiteral("can't create a pseudo terminal: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+		return false;
+	}
+	const QString slavePath = QString::fromLocal8Bit(ptsname(m_master));
+
+	m_slave = ::open(ptsname(m_master), O_RDWR | O_NOCTTY);
+	if (m_slave < 0) {
+		*error = QStringLiteral("can't open %1: %2").arg(slavePath, QString::fromLocal8Bit(strerror(errno)));
+		return false;
+	}
+	// bytes pass unchanged, like a serial port in raw mode
+	struct termios options;
+	tcgetattr(m_slave, &options);
+	cfmakeraw(&options);
+	tcsetattr(m_slave, TCSANOW, &options);
+
+	if (!m_linkPath.isEmpty()) {
+		QFile::remove(m_linkPath);
+		if (!QFile::link(slavePath, m_linkPath)) {
+			*error = QStringLiteral("can't link %1 to %2").arg(m_linkPath, slavePath);
+			return false;
+		}
+	}
+	printf("port=%s\n", qPrintable(m_linkPath.isEmpty() ? slavePath : m_linkPath));
+	fflush(stdout);
+
+	if (m_faults.baudRate > 0) {
+		m_pacer = new QTimer(this);
+		m_pacer->setTimerType(Qt::PreciseTimer);
+		m_pacer->setInterval(1);
+		connect(m_pacer, &QTimer::timeout, this, &SerialSimulator::readPaced);
+		m_lineClock.start();
+		m_pacer->start();
+	} else {
+		m_notifier = new QSocketNotifier(m_master, QSocketNotifier::Read, this);
+		connect(m_notifier, &QSocketNotifier::activated, this, &SerialSimulator::readAvailable);
+	}
+	return true;
+}
+
+void SerialSimulator::readAvailable()
+{
+	read(ReadChunk);
+}
+
+void SerialSimulator::readPaced()
+{
+	const double bytesPerNs = m_faults.baudRate / (double)BitsPerByte / 1e9;
+	m_lineCredit = qMin(m_lineCredit + m_lineClock.nsecsElapsed() * bytesPerNs, MaxLineCredit);
+	m_lineClock.start();
+
+	const int bytes = (int)m_lineCredit;
+	if (bytes > 0)
+		read(bytes);
+}
+
+void SerialSimulator::read(int maxBytes)
+{
+	char buffer[ReadChunk];
+	const ssize_t bytes = ::read(m_master, buffer, qMin(maxBytes, ReadChunk));
+	if (bytes <= 0)
+		return;
+
+	m_lineCredit = qMax(0.0, m_lineCredit - bytes);
+	m_stats.bytesReceived(bytes);
+
+	const QByteArray data(buffer, (int)bytes);
+	if (m_protocol == Adalight)
+		feedAdalight(data);
+	else
+		feedArdulight(data);
+}
+
+void SerialSimulator::feedAdalight(const QByteArray &data)
+{
+	const int frames = m_adalight.feed(data);
+	for (; m_adalightRejected < m_adalight.framesRejected(); m_adalightRejected++)
+		m_stats.frameRejected();
+
+	for (int i = 0; i < frames; i++) {
+		frameDone(m_adalight.leds().size() / 3);
+		processingDelay();
+		ack();
+	}
+}
+
+void SerialSimulator::feedArdulight(const QByteArray &data)
+{
+	for (const char byte : data) {
+		if ((quint8)byte == 255) {
+			// without a LED count the next frame ends this one
+			if (m_ledsCount == 0 && m_ardulightBytes >= 3 && m_ardulightBytes % 3 == 0) {
+				frameDone(m_ardulightBytes / 3);
+				processingDelay();
+				ack();
+			} else if (m_ardulightBytes > 0) {
+				m_stats.frameRejected();
+			}
+			m_ardulightBytes = 0;
+			continue;
+		}
+		if (m_ardulightBytes < 0)
+			continue;
+
+		m_ardulightBytes++;
+		if (m_ledsCount > 0 && m_ardulightBytes == m_ledsCount * 3) {
+			frameDone(m_ledsCount);
+			processingDelay();
+			ack();
+			m_ardulightBytes = -1;
+		}
+	}
+}
+
+void SerialSimulator::ack()
+{
+	if (m_faults.isAckEnabled && ::write(m_master, &AckByte, 1) != 1)
+		qWarning() << Q_FUNC_INFO << "can't write the ack:" << strerror(errno);
+}
@@ -0,0 +1,86 @@
+/*
+ * SerialSimulator.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include "Simulator.hpp"
+#include "AdalightDeltaCodec.hpp"
+
+class QSocketNotifier;
+class QTimer;
+
+/*!
+	Adalight or Ardulight controller behind a pseudo terminal. Prismatik opens the
+	slave side as its serial port, classic and extended Adalight frames are decoded by
+	AdalightDeltaDecoder, Ardulight frames start with 255.
+	With Faults::baudRate the master side is read no faster than the line rate, so a
+	sender that outruns the line fills the pty buffer and blocks, as it would on a
+	real port.
+*/
+class SerialSimulator : public Simulator
+{
+	Q_OBJECT
+public:
+	enum Protocol {
+		Adalight,
+		Ardulight
+	};
+
+	/*!
+		\param ledsCount LEDs of an Ardulight frame, 0 to end a frame at the next 255
+		\param linkPath symlink created to the slave, e.g. a stable name for the settings
+	*/
+	SerialSimulator(Protocol protocol, int ledsCount, const QString &linkPath, SimulatorStats &stats, const Faults &faults, QObject *parent = 0);
+	~SerialSimulator();
+
+	bool start(QString *error);
+
+private slots:
+	void readAvailable();
+	void readPaced();
+
+private:
+	void read(int maxBytes);
+	void feedAdalight(const QByteArray &data);
+	void feedArdulight(const QByteArray &data);
+	void ack();
+
+	const Protocol m_protocol;
+	const int m_ledsCount;
+	const QString m_linkPath;
+	int m_master{-1};
+	// kept open so the master does not see a hangup between two sessions of Prismatik
+	int m_slave{-1};
+	QSocketNotifier *m_notifier{nullptr};
+	QTimer *m_pacer{nullptr};
+	QElapsedTimer m_lineClock;
+	double m_lineCredit{0};
+
+	AdalightDeltaDecoder m_adalight;
+	int m_adalightRejected{0};
+	// Ardulight triples of the frame being received, -1 until a 255 is seen
+	int m_ardulightBytes{-1};
+};
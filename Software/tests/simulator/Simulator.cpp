@@ -0,0 +1,53 @@
+/*
+ * Simulator.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QThread>
+#include "Simulator.hpp"
+#include "SimulatorStats.hpp"
+
+Simulator::Simulator(SimulatorStats &stats, const Faults &faults, QObject *parent)
+	: QObject(parent)
+	, m_stats(stats)
+	, m_faults(faults)
+	, m_random(faults.seed)
+{
+}
+
+void Simulator::frameDone(int ledsCount, qint64 atNs)
+{
+	m_stats.frameReceived(ledsCount, atNs);
+	emit frameReceived();
+}
+
+void Simulator::processingDelay()
+{
+	if (m_faults.delayUs > 0)
+		QThread::usleep(m_faults.delayUs);
+}
+
+bool Simulator::isPacketLost()
+{
+	if (m_faults.lossPercent <= 0)
+		return false;
+	return std::uniform_int_distribution<int>(0, 99)(m_random) < m_faults.lossPercent;
+}
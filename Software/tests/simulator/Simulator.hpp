@@ -0,0 +1,74 @@
+/*
+ * Simulator.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QObject>
+#include <random>
+
+class SimulatorStats;
+
+/*!
+	A simulated LED device, the receiving end of one of the protocols Prismatik speaks.
+	Faults are injected on the receiving side, the way a real controller misbehaves.
+*/
+class Simulator : public QObject
+{
+	Q_OBJECT
+public:
+	struct Faults
+	{
+		// time spent on each frame or packet before the next one is read
+		int delayUs{0};
+		// percentage of UDP packets thrown away
+		int lossPercent{0};
+		// serial line rate, the port is read no faster than this; 0 for unlimited
+		int baudRate{0};
+		// one byte is written back per frame, as an Adalight with acks does
+		bool isAckEnabled{false};
+		quint32 seed{1};
+	};
+
+	Simulator(SimulatorStats &stats, const Faults &faults, QObject *parent = 0);
+
+	/*!
+		Starts listening, prints where to on stdout.
+		\return false with \a error set if the endpoint can't be created
+	*/
+	virtual bool start(QString *error) = 0;
+
+signals:
+	void frameReceived();
+
+protected:
+	void frameDone(int ledsCount, qint64 atNs = -1);
+	// sleeps for Faults::delayUs
+	void processingDelay();
+	bool isPacketLost();
+
+	SimulatorStats &m_stats;
+	const Faults m_faults;
+
+private:
+	std::mt19937 m_random;
+};
@@ -0,0 +1,77 @@
+/*
+ * SimulatorStats.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QTextStream>
+#include "SimulatorStats.hpp"
+
+namespace {
+QString percentiles(const LatencyHistogram &histogram)
+{
+	return QStringLiteral("%1,%2,%3,%4")
+		.arg(histogram.percentile(0.5))
+		.arg(histogram.percentile(0.9))
+		.arg(histogram.percentile(0.99))
+		.arg(histogram.max());
+}
+}
+
+SimulatorStats::SimulatorStats()
+{
+	m_clock.start();
+}
+
+void SimulatorStats::frameReceived(int ledsCount, qint64 atNs)
+{
+	if (atNs < 0)
+		atNs = nowNs();
+
+	if (m_lastFrameNs >= 0)
+		m_intervals.add(atNs - m_lastFrameNs);
+	else
+		m_firstFrameNs = atNs;
+	m_lastFrameNs = atNs;
+	m_frames++;
+	m_ledsCount = ledsCount;
+
+	if (m_log)
+		*m_log << atNs << ',' << ledsCount << ',' << m_frameBytes << '\n';
+	m_frameBytes = 0;
+}
+
+QString SimulatorStats::summary() const
+{
+	const double seconds = (m_lastFrameNs - m_firstFrameNs) / 1e9;
+	const double fps = m_frames > 1 && seconds > 0 ? (m_frames - 1) / seconds : 0.0;
+
+	QString result = QStringLiteral("frames=%1;leds=%2;bytes=%3;rejected=%4;dropped=%5;fps=%6;interval=%7")
+		.arg(m_frames)
+		.arg(m_ledsCount)
+		.arg(m_bytes)
+		.arg(m_rejected)
+		.arg(m_dropped)
+		.arg(fps, 0, 'f', 1)
+		.arg(percentiles(m_intervals));
+	if (m_skew.count() > 0)
+		result += QStringLiteral(";skew=%1").arg(percentiles(m_skew));
+	return result;
+}
@@ -0,0 +1,81 @@
+/*
+ * SimulatorStats.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include "LatencyHistogram.hpp"
+
+class QTextStream;
+
+/*!
+	What a simulated device received and when: frames, bytes, injected and malformed
+	traffic and the time between frames. With a log every frame is also written as
+	"ns since start,LEDs,bytes" for offline analysis.
+*/
+class SimulatorStats
+{
+public:
+	SimulatorStats();
+
+	void setLog(QTextStream *log) { m_log = log; }
+
+	qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+
+	// bytes as they come off the wire, frames or not
+	void bytesReceived(int bytes) { m_bytes += bytes; m_frameBytes += bytes; }
+
+	/*!
+		A complete frame of \a ledsCount LEDs arrived at \a atNs (now if -1), it is
+		made of the bytes received since the previous frame.
+	*/
+	void frameReceived(int ledsCount, qint64 atNs = -1);
+	void frameRejected() { m_rejected++; }
+	// lost on purpose, see Simulator::Faults
+	void packetDropped() { m_dropped++; }
+	// time between the first and the last part of a frame that spans several devices
+	void skewMeasured(qint64 ns) { m_skew.add(ns); }
+
+	quint64 frames() const { return m_frames; }
+	const LatencyHistogram & intervals() const { return m_intervals; }
+
+	/*!
+		One line of "key=value;" pairs, durations are p50,p90,p99,max in nanoseconds.
+	*/
+	QString summary() const;
+
+private:
+	QElapsedTimer m_clock;
+	QTextStream *m_log{nullptr};
+	LatencyHistogram m_intervals;
+	LatencyHistogram m_skew;
+	quint64 m_frames{0};
+	quint64 m_bytes{0};
+	quint64 m_rejected{0};
+	quint64 m_dropped{0};
+	int m_frameBytes{0};
+	int m_ledsCount{0};
+	qint64 m_firstFrameNs{-1};
+	qint64 m_lastFrameNs{-1};
+};
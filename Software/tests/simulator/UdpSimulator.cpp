@@ -0,0 +1,158 @@
+/*
+ * UdpSimulator.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QTimer>
+#include <QUdpSocket>
+#include <stdio.h>
+
+#include "UdpSimulator.hpp"
+#include "SimulatorStats.hpp"
+#include "enums.hpp"
+
+namespace {
+const int WledHeaderSize = 2;
+const int DnrgbHeaderSize = 4;
+const int DdpHeaderSize = 10;
+const quint8 DdpVersionMask = 0xc0;
+const quint8 DdpVersion1 = 0x40;
+const quint8 DdpPush = 0x01;
+}
+
+UdpSimulator::UdpSimulator(quint16 port, int burstGapUs, SimulatorStats &stats, const Faults &faults, QObject *parent)
+	: Simulator(stats, faults, parent)
+	, m_port(port)
+	, m_burstGapUs(burstGapUs)
+{
+}
+
+bool UdpSimulator::start(QString *error)
+{
+	m_socket = new QUdpSocket(this);
+	if (!m_socket->bind(QHostAddress::Any, m_port)) {
+		*error = QStringLiteral("can't listen on UDP port %1: %2").arg(m_port).arg(m_socket->errorString());
+		return false;
+	}
+	// room for a few frames of DNRGB packets while the receiver is slow
+	m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1 << 20);
+
+	m_burstTimer = new QTimer(this);
+	m_burstTimer->setSingleShot(true);
+	m_burstTimer->setTimerType(Qt::PreciseTimer);
+	m_burstTimer->setInterval(qMax(1, m_burstGapUs / 1000));
+	connect(m_burstTimer, &QTimer::timeout, this, &UdpSimulator::endFrame);
+	connect(m_socket, &QUdpSocket::readyRead, this, &UdpSimulator::readDatagrams);
+
+	printf("port=%u\n", m_socket->localPort());
+	fflush(stdout);
+	return true;
+}
+
+void UdpSimulator::readDatagrams()
+{
+	QByteArray packet;
+	while (m_socket->hasPendingDatagrams()) {
+		packet.resize((int)m_socket->pendingDatagramSize());
+		const qint64 size = m_socket->readDatagram(packet.data(), packet.size());
+		if (size < 0)
+			break;
+		const qint64 nowNs = m_stats.nowNs();
+
+		// a burst ended while the receiver was busy
+		if (m_frameLeds > 0 && nowNs - m_lastPacketNs > m_burstGapUs * Q_INT64_C(1000))
+			endFrame();
+
+		if (isPacketLost()) {
+			m_stats.packetDropped();
+			continue;
+		}
+		m_stats.bytesReceived((int)size);
+		if (!parse(packet, nowNs))
+			m_stats.frameRejected();
+		processingDelay();
+	}
+}
+
+bool UdpSimulator::parse(const QByteArray &packet, qint64 atNs)
+{
+	const quint8 *data = reinterpret_cast<const quint8 *>(packet.constData());
+	const int size = packet.size();
+	if (size < WledHeaderSize)
+		return false;
+
+	if ((data[0] & DdpVersionMask) == DdpVersion1) {
+		if (size < DdpHeaderSize)
+			return false;
+		const int offset = (data[4] << 24) | (data[5] << 16) | (data[6] << 8) | data[7];
+		const int length = (data[8] << 8) | data[9];
+		if (size != DdpHeaderSize + length || offset % 3 != 0 || length % 3 != 0)
+			return false;
+		updateLeds((offset + length) / 3, atNs);
+		if (data[0] & DdpPush)
+			endFrame();
+		return true;
+	}
+
+	switch (data[0]) {
+	case UdpDevice::Warls:
+		if ((size - WledHeaderSize) % 4 != 0)
+			return false;
+		for (int i = WledHeaderSize; i < size; i += 4)
+			updateLeds(data[i] + 1, atNs);
+		// a frame where nothing changed is just the header
+		if (size == WledHeaderSize)
+			updateLeds(0, atNs);
+		return true;
+	case UdpDevice::Drgb:
+		if ((size - WledHeaderSize) % 3 != 0)
+			return false;
+		updateLeds((size - WledHeaderSize) / 3, atNs);
+		endFrame();
+		return true;
+	case UdpDevice::Dnrgb: {
+		if (size < DnrgbHeaderSize || (size - DnrgbHeaderSize) % 3 != 0)
+			return false;
+		const int first = (data[2] << 8) | data[3];
+		updateLeds(first + (size - DnrgbHeaderSize) / 3, atNs);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+void UdpSimulator::updateLeds(int endLed, qint64 atNs)
+{
+	// an empty packet still is a frame, it keeps the receiver from timing out
+	m_frameLeds = qMax(qMax(m_frameLeds, endLed), 1);
+	m_lastPacketNs = atNs;
+	m_burstTimer->start();
+}
+
+void UdpSimulator::endFrame()
+{
+	m_burstTimer->stop();
+	if (m_frameLeds == 0)
+		return;
+	frameDone(m_frameLeds, m_lastPacketNs);
+	m_frameLeds = 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * UdpSimulator.hpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include "Simulator.hpp"
+
+class QTimer;
+class QUdpSocket;
+
+/*!
+	WLED realtime receiver for WARLS, DRGB and DNRGB packets, and DDP on the same port.
+	A DRGB packet and a DDP push end a frame. WARLS and DNRGB frames may take several
+	packets, sent back to back, so a frame ends when no packet came for \a burstGapUs.
+	Faults::lossPercent of the packets are dropped before they are looked at.
+*/
+class UdpSimulator : public Simulator
+{
+	Q_OBJECT
+public:
+	UdpSimulator(quint16 port, int burstGapUs, SimulatorStats &stats, const Faults &faults, QObject *parent = 0);
+
+	bool start(QString *error);
+
+private slots:
+	void readDatagrams();
+	void endFrame();
+
+private:
+	// \return false if the packet is malformed
+	bool parse(const QByteArray &packet, qint64 atNs);
+	void updateLeds(int endLed, qint64 atNs);
+
+	const quint16 m_port;
+	const int m_burstGapUs;
+	QUdpSocket *m_socket{nullptr};
+	QTimer *m_burstTimer{nullptr};
+	// LEDs covered by the frame being received, and when its last packet came
+	int m_frameLeds{0};
+	qint64 m_lastPacketNs{-1};
+};
@@ -0,0 +1,157 @@
+/*
+ * main.cpp
+ *
+ *	Project: Lightpack
+ *
+ *	Lightpack a USB content-driving ambient lighting system
+ *
+ *	Lightpack is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 2 of the License, or
+ *	(at your option) any later version.
+ *
+ *	Lightpack is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with this program.	If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QSocketNotifier>
+#include <QTextStream>
+#include <QTimer>
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "SerialSimulator.hpp"
+#include "UdpSimulator.hpp"
+#include "SimulatorStats.hpp"
+#ifdef Q_OS_LINUX
+#include "HidSimulator.hpp"
+#endif
+
+namespace {
+int g_signalPipe[2] = { -1, -1 };
+
+void onSignal(int)
+{
+	const char byte = 0;
+	if (::write(g_signalPipe[1], &byte, 1) != 1)
+		_exit(1);
+}
+}
+
+/*
+	Stand-in devices for benchmarks and CI: Prismatik is pointed at one of them instead
+	of a real strip, and the simulator prints what arrived and when once it exits.
+*/
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName(QStringLiteral("LightpackSimulator"));
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QStringLiteral(
+		"Simulated LED devices for Prismatik.\n"
+		"Prints where it listens (port=...), then on exit a summary line of "
+		"\"key=value;\" pairs, durations are p50,p90,p99,max in nanoseconds."));
+	parser.addHelpOption();
+	parser.addPositionalArgument(QStringLiteral("device"), QStringLiteral("adalight, ardulight, udp or lightpack"));
+
+	const QCommandLineOption linkOption(QStringLiteral("link"), QStringLiteral("Serial: symlink to the pseudo terminal."), QStringLiteral("path"));
+	const QCommandLineOption ledsOption(QStringLiteral("leds"), QStringLiteral("Ardulight: LEDs per frame, by default a frame ends at the next 255."), QStringLiteral("count"), QStringLiteral("0"));
+	const QCommandLineOption baudOption(QStringLiteral("baud"), QStringLiteral("Serial: line rate the port is read at, 0 for unlimited."), QStringLiteral("rate"), QStringLiteral("0"));
+	const QCommandLineOption ackOption(QStringLiteral("ack"), QStringLiteral("Serial: write back a byte per frame."));
+	const QCommandLineOption portOption(QStringLiteral("port"), QStringLiteral("UDP: port to listen on."), QStringLiteral("port"), QStringLiteral("21324"));
+	const QCommandLineOption gapOption(QStringLiteral("burst-gap-us"), QStringLiteral("UDP: silence that ends a multi-packet frame."), QStringLiteral("us"), QStringLiteral("2000"));
+	const QCommandLineOption lossOption(QStringLiteral("loss"), QStringLiteral("UDP: percentage of packets dropped."), QStringLiteral("percent"), QStringLiteral("0"));
+	const QCommandLineOption devicesOption(QStringLiteral("devices"), QStringLiteral("Lightpack: number of chained devices."), QStringLiteral("count"), QStringLiteral("1"));
+	const QCommandLineOption delayOption(QStringLiteral("delay-us"), QStringLiteral("Time spent on each frame or packet."), QStringLiteral("us"), QStringLiteral("0"));
+	const QCommandLineOption seedOption(QStringLiteral("seed"), QStringLiteral("Seed of the injected faults."), QStringLiteral("seed"), QStringLiteral("1"));
+	const QCommandLineOption framesOption(QStringLiteral("frames"), QStringLiteral("Exit after this many frames."), QStringLiteral("count"), QStringLiteral("0"));
+	const QCommandLineOption durationOption(QStringLiteral("duration-ms"), QStringLiteral("Exit after this long."), QStringLiteral("ms"), QStringLiteral("0"));
+	const QCommandLineOption logOption(QStringLiteral("log"), QStringLiteral("Write \"ns,LEDs,bytes\" of every frame to a file."), QStringLiteral("path"));
+	parser.addOptions({ linkOption, ledsOption, baudOption, ackOption, portOption, gapOption, lossOption,
+		devicesOption, delayOption, seedOption, framesOption, durationOption, logOption });
+	parser.process(app);
+
+	const QStringList positional = parser.positionalArguments();
+	if (positional.count() != 1)
+		parser.showHelp(1);
+	const QString device = positional.first();
+
+	Simulator::Faults faults;
+	faults.delayUs = parser.value(delayOption).toInt();
+	faults.lossPercent = parser.value(lossOption).toInt();
+	faults.baudRate = parser.value(baudOption).toInt();
+	faults.isAckEnabled = parser.isSet(ackOption);
+	faults.seed = parser.value(seedOption).toUInt();
+
+	SimulatorStats stats;
+	QFile logFile;
+	QTextStream log;
+	if (parser.isSet(logOption)) {
+		logFile.setFileName(parser.value(logOption));
+		if (!logFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			fprintf(stderr, "can't write %s\n", qPrintable(logFile.fileName()));
+			return 1;
+		}
+		log.setDevice(&logFile);
+		stats.setLog(&log);
+	}
+
+	Simulator *simulator = nullptr;
+	if (device == QLatin1String("adalight") || device == QLatin1String("ardulight")) {
+		simulator = new SerialSimulator(device == QLatin1String("adalight") ? SerialSimulator::Adalight : SerialSimulator::Ardulight,
+			parser.value(ledsOption).toInt(), parser.value(linkOption), stats, faults, &app);
+	} else if (device == QLatin1String("udp")) {
+		simulator = new UdpSimulator(parser.value(portOption).toUShort(), parser.value(gapOption).toInt(), stats, faults, &app);
+#ifdef Q_OS_LINUX
+	} else if (device == QLatin1String("lightpack")) {
+		simulator = new HidSimulator(parser.value(devicesOption).toInt(), stats, faults, &app);
+#endif
+	} else {
+		fprintf(stderr, "unknown device %s\n", qPrintable(device));
+		return 1;
+	}
+
+	QString error;
+	if (!simulator->start(&error)) {
+		fprintf(stderr, "%s\n", qPrintable(error));
+		return 1;
+	}
+
+	const quint64 framesLimit = parser.value(framesOption).toULongLong();
+	if (framesLimit > 0) {
+		QObject::connect(simulator, &Simulator::frameReceived, &app, [&stats, framesLimit]() {
+			if (stats.frames() == framesLimit)
+				QCoreApplication::quit();
+		});
+	}
+	const int duration = parser.value(durationOption).toInt();
+	if (duration > 0)
+		QTimer::singleShot(duration, &app, &QCoreApplication::quit);
+
+	// Ctrl+C and kill still print the summary
+	if (::pipe(g_signalPipe) == 0) {
+		QSocketNotifier *notifier = new QSocketNotifier(g_signalPipe[0], QSocketNotifier::Read, &app);
+		QObject::connect(notifier, &QSocketNotifier::activated, &app, &QCoreApplication::quit);
+		signal(SIGINT, onSignal);
+		signal(SIGTERM, onSignal);
+	}
+
+	const int result = app.exec();
+	delete simulator;
+	log.flush();
+
+	printf("%s\n", qPrintable(stats.summary()));
+	return result;
+}
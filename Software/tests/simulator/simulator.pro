@@ -0,0 +1,44 @@
+#-------------------------------------------------
+#
+# Simulated Adalight, Ardulight, WLED UDP and Lightpack HID devices
+#
+#-------------------------------------------------
+
+QT          = core network
+
+TARGET      = LightpackSimulator
+DESTDIR     = bin
+
+CONFIG     += console c++17
+CONFIG     -= app_bundle
+
+include(../../build-config.prf)
+
+OBJECTS_DIR = stuff
+MOC_DIR     = stuff
+
+INCLUDEPATH += . \
+               ../../src \
+               ../../../CommonHeaders
+
+HEADERS += \
+    ../../src/LatencyHistogram.hpp \
+    ../../src/AdalightDeltaCodec.hpp \
+    SimulatorStats.hpp \
+    Simulator.hpp \
+    SerialSimulator.hpp \
+    UdpSimulator.hpp
+
+SOURCES += \
+    ../../src/LatencyHistogram.cpp \
+    ../../src/AdalightDeltaCodec.cpp \
+    SimulatorStats.cpp \
+    Simulator.cpp \
+    SerialSimulator.cpp \
+    UdpSimulator.cpp \
+    main.cpp
+
+linux {
+    HEADERS += HidSimulator.hpp
+    SOURCES += HidSimulator.cpp
+}
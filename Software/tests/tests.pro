@@ -30,6 +30,14 @@ DEFINES += SRCDIR=\\\"$$PWD/\\\"
 
 LIBS += -L../lib -lprismatik-math -lgrab
 
+# the null sink builds the serial devices' headers
+win32|macx {
+    QT += serialport
+}
+unix:!macx {
+    LIBS += -L../qtserialport/lib -lQt5SerialPort
+}
+
 win32 {
     CONFIG(msvc):DEFINES += _CRT_SECURE_NO_WARNINGS _CRT_NONSTDC_NO_DEPRECATE
     LIBS += -ladvapi32
@@ -37,6 +45,7 @@ win32 {
 
 INCLUDEPATH += . \
                ../src \
+               ../src/hidapi \
                ../hooks \
                ../grab/include \
                ../math/include \
@@ -47,29 +56,109 @@ HEADERS += \
     ../common/defs.h \
     ../src/enums.hpp \
     ../src/ApiServerSetColorTask.hpp \
+    ../src/ApiBinaryProtocol.hpp \
+    ../src/ApiUdpStream.hpp \
     ../src/ApiServer.hpp \
     ../src/debug.h \
     ../src/Settings.hpp \
     ../src/Plugin.hpp \
     ../src/LightpackPluginInterface.hpp \
     ../src/LightpackCommandLineParser.hpp \
+    ../src/GrabRateGovernor.hpp \
+    ../src/TemporalSmoother.hpp \
+    ../src/LedDeviceRouter.hpp \
+    ../src/FrameMailbox.hpp \
+    ../src/LedDeviceCommandQueue.hpp \
+    ../src/LedWireEncoder.hpp \
+    ../src/AdalightDeltaCodec.hpp \
+    ../src/SerialFramePacer.hpp \
+    ../src/LedDeviceAdalight.hpp \
+    ../src/LedDeviceArdulight.hpp \
+    ../src/UdpBatchSender.hpp \
+    ../src/LedDeviceDnrgb.hpp \
+    ../src/LedDeviceWarls.hpp \
+    ../src/LedDeviceDdp.hpp \
+    ../src/AbstractLedDeviceDmx.hpp \
+    ../src/LedDeviceE131.hpp \
+    ../src/LedDeviceArtNet.hpp \
+    ../src/LedDeviceAdaptiveUdp.hpp \
+    ../src/HidReportWriter.hpp \
+    ../src/AbstractLedDevice.hpp \
+    ../src/AbstractLedDeviceUdp.hpp \
+    ../src/LedDeviceDrgb.hpp \
+    ../src/LedDeviceVirtual.hpp \
+    ../src/LedFrameRingWriter.hpp \
+    ../src/FrameRecording.hpp \
+    ../src/FrameReplayer.hpp \
+    ../src/LedDeviceRecorder.hpp \
+    ../src/LatencyHistogram.hpp \
+    ../src/LedDeviceNullSink.hpp \
     ../grab/include/calculations.hpp \
     ../math/include/PrismatikMath.hpp \
     SettingsWindowMockup.hpp \
+    LedDeviceTestUtils.hpp \
     GrabCalculationTest.hpp \
     LightpackApiTest.hpp \
     lightpackmathtest.hpp \
     AppVersionTest.hpp \
     ../src/UpdatesProcessor.hpp \
-    LightpackCommandLineParserTest.hpp
+    LightpackCommandLineParserTest.hpp \
+    GrabRateGovernorTest.hpp \
+    TemporalSmootherTest.hpp \
+    LedDeviceRouterTest.hpp \
+    FrameMailboxTest.hpp \
+    LedDeviceCommandQueueTest.hpp \
+    LedWireEncoderTest.hpp \
+    AdalightDeltaCodecTest.hpp \
+    SerialFramePacerTest.hpp \
+    UdpBatchSenderTest.hpp \
+    LedDeviceDdpTest.hpp \
+    LedDeviceDmxTest.hpp \
+    LedDeviceAdaptiveUdpTest.hpp \
+    HidReportWriterTest.hpp \
+    FrameRecordingTest.hpp \
+    LedDeviceNullSinkTest.hpp \
+    ApiServerSetColorTaskTest.hpp \
+    ApiUdpStreamTest.hpp
 
 SOURCES += \
     ../src/ApiServerSetColorTask.cpp \
+    ../src/ApiBinaryProtocol.cpp \
+    ../src/ApiUdpStream.cpp \
     ../src/ApiServer.cpp \
     ../src/Settings.cpp \
     ../src/Plugin.cpp \
     ../src/LightpackPluginInterface.cpp \
     ../src/LightpackCommandLineParser.cpp \
+    ../src/GrabRateGovernor.cpp \
+    ../src/TemporalSmoother.cpp \
+    ../src/LedDeviceRouter.cpp \
+    ../src/FrameMailbox.cpp \
+    ../src/LedDeviceCommandQueue.cpp \
+    ../src/LedWireEncoder.cpp \
+    ../src/AdalightDeltaCodec.cpp \
+    ../src/SerialFramePacer.cpp \
+    ../src/LedDeviceAdalight.cpp \
+    ../src/LedDeviceArdulight.cpp \
+    ../src/UdpBatchSender.cpp \
+    ../src/LedDeviceDnrgb.cpp \
+    ../src/LedDeviceWarls.cpp \
+    ../src/LedDeviceDdp.cpp \
+    ../src/AbstractLedDeviceDmx.cpp \
+    ../src/LedDeviceE131.cpp \
+    ../src/LedDeviceArtNet.cpp \
+    ../src/LedDeviceAdaptiveUdp.cpp \
+    ../src/HidReportWriter.cpp \
+    ../src/AbstractLedDevice.cpp \
+    ../src/AbstractLedDeviceUdp.cpp \
+    ../src/LedDeviceDrgb.cpp \
+    ../src/LedDeviceVirtual.cpp \
+    ../src/LedFrameRingWriter.cpp \
+    ../src/FrameRecording.cpp \
+    ../src/FrameReplayer.cpp \
+    ../src/LedDeviceRecorder.cpp \
+    ../src/LatencyHistogram.cpp \
+    ../src/LedDeviceNullSink.cpp \
     LightpackApiTest.cpp \
     SettingsWindowMockup.cpp \
     GrabCalculationTest.cpp \
@@ -77,7 +166,36 @@ SOURCES += \
     TestsMain.cpp \
     AppVersionTest.cpp \
     ../src/UpdatesProcessor.cpp \
-    LightpackCommandLineParserTest.cpp
+    LightpackCommandLineParserTest.cpp \
+    GrabRateGovernorTest.cpp \
+    TemporalSmootherTest.cpp \
+    LedDeviceRouterTest.cpp \
+    FrameMailboxTest.cpp \
+    LedDeviceCommandQueueTest.cpp \
+    LedWireEncoderTest.cpp \
+    AdalightDeltaCodecTest.cpp \
+    SerialFramePacerTest.cpp \
+    UdpBatchSenderTest.cpp \
+    LedDeviceDdpTest.cpp \
+    LedDeviceDmxTest.cpp \
+    LedDeviceAdaptiveUdpTest.cpp \
+    HidReportWriterTest.cpp \
+    FrameRecordingTest.cpp \
+    LedDeviceNullSinkTest.cpp \
+    ApiServerSetColorTaskTest.cpp \
+    ApiUdpStreamTest.cpp
+
+unix {
+    HEADERS += \
+        ../common/LedFrameRing.h \
+        LedFrameRingTest.hpp
+
+    SOURCES += \
+        ../common/LedFrameRing.c \
+        LedFrameRingTest.cpp
+
+    !macx:LIBS += -lrt
+}
 
 win32{
     HEADERS += \